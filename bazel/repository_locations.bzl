@@ -237,6 +237,11 @@ REPOSITORY_LOCATIONS = dict(
         strip_prefix = "subpar-2.0.0",
         urls = ["https://github.com/google/subpar/archive/2.0.0.tar.gz"],
     ),
+    com_googlesource_code_re2 = dict(
+        sha256 = "38bc0426ee15b5ed67957017fd18201965df0721327be13f60496f2b356e3e01",
+        strip_prefix = "re2-2019-08-01",
+        urls = ["https://github.com/google/re2/archive/2019-08-01.tar.gz"],
+    ),
     com_googlesource_quiche = dict(
         # Static snapshot of https://quiche.googlesource.com/quiche/+archive/7bf7c3c358eb954e463bde14ea27444f4bd8ea05.tar.gz
         sha256 = "36fe180d532a9ccb18cd32328af5231636c7408104523f9ed5eebbad75f1e039",
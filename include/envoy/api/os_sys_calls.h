@@ -16,6 +16,11 @@
 #include "envoy/common/pure.h"
 #include "envoy/common/platform.h"
 
+#if !defined(__linux__)
+// recvmmsg() and sendmmsg() are Linux specific. Elsewhere the calls fail with ENOSYS.
+struct mmsghdr;
+#endif
+
 namespace Envoy {
 namespace Api {
 
@@ -103,10 +108,30 @@ public:
    */
   virtual SysCallSizeResult sendmsg(int fd, const msghdr* message, int flags) PURE;
 
+  /**
+   * @see man 2 recvmsg
+   */
+  virtual SysCallSizeResult recvmsg(int sockfd, msghdr* message, int flags) PURE;
+
   /**
    * @see man 2 getsockname
    */
   virtual SysCallIntResult getsockname(int sockfd, sockaddr* addr, socklen_t* addrlen) PURE;
+
+  /**
+   * @see man 2 recvmmsg. The timeout is not supported as it is only meaningful for blocking
+   * sockets. Fails with ENOSYS where the call is not available.
+   * @return the number of messages received.
+   */
+  virtual SysCallIntResult recvmmsg(int sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                    int flags) PURE;
+
+  /**
+   * @see man 2 sendmmsg. Fails with ENOSYS where the call is not available.
+   * @return the number of messages sent.
+   */
+  virtual SysCallIntResult sendmmsg(int sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                    int flags) PURE;
 };
 
 typedef std::unique_ptr<OsSysCalls> OsSysCallsPtr;
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/common/pure.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Regex {
+
+/**
+ * A compiled regex expression matcher which uses an abstract regex engine.
+ */
+class CompiledMatcher {
+public:
+  virtual ~CompiledMatcher() = default;
+
+  /**
+   * @param value supplies the value to match.
+   * @return whether the value matches the compiled regex. The entire value must match, i.e. the
+   *         regex is implicitly anchored at both ends.
+   */
+  virtual bool match(absl::string_view value) const PURE;
+};
+
+using CompiledMatcherPtr = std::unique_ptr<const CompiledMatcher>;
+using CompiledMatcherSharedPtr = std::shared_ptr<const CompiledMatcher>;
+
+} // namespace Regex
+} // namespace Envoy
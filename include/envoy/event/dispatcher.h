@@ -29,8 +29,13 @@ namespace Event {
  */
 // clang-format off
 #define ALL_DISPATCHER_STATS(HISTOGRAM)                                                            \
+  HISTOGRAM(callback_duration_us)                                                                  \
   HISTOGRAM(loop_duration_us)                                                                      \
-  HISTOGRAM(poll_delay_us)
+  HISTOGRAM(poll_delay_us)                                                                         \
+  HISTOGRAM(poll_duration_us)                                                                      \
+  HISTOGRAM(post_latency_us)                                                                       \
+  HISTOGRAM(post_queue_depth)                                                                      \
+  HISTOGRAM(time_to_first_callback_us)
 // clang-format on
 
 /**
@@ -222,6 +222,8 @@ struct Http1Settings {
   bool accept_http_10_{false};
   // Set a default host if no Host: header is present for HTTP/1.0 requests.`
   std::string default_host_for_http_10_;
+  // Parse complete, bodyless request heads with a vectorized scanner rather than http_parser.
+  bool fast_request_parsing_{false};
 };
 
 /**
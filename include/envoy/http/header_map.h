@@ -172,6 +172,14 @@ public:
    */
   void setReference(const std::string& ref_value);
 
+  /**
+   * Set the value of the string to a reference to a span of memory.
+   * @param ref_value MUST point to data that will live beyond the lifetime of any request/response
+   *        using the string. A header map can guarantee this for memory it did not allocate by
+   *        pinning the memory holding it (see HeaderMapImpl::pinMemory()).
+   */
+  void setReference(absl::string_view ref_value);
+
   /**
    * @return the size of the string, not including the null terminator.
    */
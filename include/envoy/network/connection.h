@@ -299,6 +299,24 @@ public:
    *         occurred an empty string is returned.
    */
   virtual absl::string_view transportFailureReason() const PURE;
+
+  /**
+   * Get the socket of a connection whose bytes can be moved without passing through the
+   * connection, e.g. with splice(2). That is the case when the transport socket does not
+   * transform the bytes, no network filter besides a single read filter sees them and nothing is
+   * buffered. The caller then reads and writes the socket itself: it should disable reads on the
+   * connection and report the bytes it moves with addSplicedBytes().
+   * @return IoHandle* the socket, or nullptr if the bytes must pass through the connection.
+   */
+  virtual IoHandle* spliceableIoHandle() PURE;
+
+  /**
+   * Account for bytes moved directly on the socket returned by spliceableIoHandle(). This updates
+   * the connection stats and runs the bytes sent callbacks.
+   * @param bytes_read supplies the number of bytes read from the socket.
+   * @param bytes_written supplies the number of bytes written to the socket.
+   */
+  virtual void addSplicedBytes(uint64_t bytes_read, uint64_t bytes_written) PURE;
 };
 
 typedef std::unique_ptr<Connection> ConnectionPtr;
@@ -1,13 +1,19 @@
 #pragma once
 
 #include "envoy/api/io_error.h"
+#include "envoy/api/os_sys_calls_common.h"
 #include "envoy/common/pure.h"
+#include "envoy/event/file_event.h"
 
 namespace Envoy {
 namespace Buffer {
 struct RawSlice;
 } // namespace Buffer
 
+namespace Event {
+class Dispatcher;
+} // namespace Event
+
 namespace Network {
 namespace Address {
 class Instance;
@@ -77,6 +83,40 @@ public:
    */
   virtual Api::IoCallUint64Result sendmsg(const Buffer::RawSlice* slices, uint64_t num_slice,
                                           int flags, const Address::Instance& address) PURE;
+
+  /**
+   * Shut down part of a full-duplex connection. Data already accepted by writev() is sent first.
+   * @param how supplies SHUT_RD, SHUT_WR or SHUT_RDWR.
+   * @return a Api::SysCallIntResult with rc_ = 0 for success and rc_ = -1 for failure. If the call
+   *   is successful, errno_ shouldn't be used.
+   */
+  virtual Api::SysCallIntResult shutdown(int how) PURE;
+
+  /**
+   * Create a file event that reports the readiness of this handle. Handles that do their own I/O
+   * scheduling report readiness for the data they buffer rather than for the underlying fd.
+   * @param dispatcher supplies the dispatcher the event runs on.
+   * @param cb supplies the callback to fire when the handle is ready.
+   * @param trigger specifies whether to edge or level trigger.
+   * @param events supplies a logical OR of FileReadyType events that the file event should
+   *               initially listen on.
+   */
+  virtual Event::FileEventPtr createFileEvent(Event::Dispatcher& dispatcher,
+                                              Event::FileReadyCb cb,
+                                              Event::FileTriggerType trigger, uint32_t events) PURE;
+
+  /**
+   * @return bool whether system calls may be made on fd() directly, bypassing this handle. Handles
+   *         that do their own I/O scheduling may hold data that the fd has not seen yet.
+   */
+  virtual bool allowsDirectFdIo() const PURE;
+
+  /**
+   * Have close() write out the data that writev() accepted but that the handle still buffers,
+   * before the socket is closed. Without this, close() drops that data. Handles that do not buffer
+   * writes have nothing to do.
+   */
+  virtual void flushWritesOnClose() PURE;
 };
 
 typedef std::unique_ptr<IoHandle> IoHandlePtr;
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/api/io_error.h"
 #include "envoy/common/exception.h"
@@ -41,6 +42,13 @@ public:
   virtual Socket& socket() PURE;
   virtual const Socket& socket() const PURE;
 
+  /**
+   * @param worker_index supplies the index of a worker.
+   * @return Socket* the SO_REUSEPORT listen socket that only the given worker accepts on, or
+   *         nullptr if all workers accept on socket().
+   */
+  virtual Socket* workerSocket(uint32_t worker_index) PURE;
+
   /**
    * @return bool specifies whether the listener should actually listen on the port.
    *         A listener that doesn't listen on a port can only receive connections
@@ -223,6 +231,17 @@ public:
    * sender.
    */
   virtual Api::IoCallUint64Result send(const UdpSendData& data) PURE;
+
+  /**
+   * Send several datagrams through the underlying udp socket, using as few syscalls as the
+   * platform allows.
+   *
+   * @param data Supplies the datagrams to send, in order.
+   * @return the number of datagrams sent, all of which have their buffers drained. Sending stops
+   * at the first datagram that can not be sent, which can be retried by the sender. If no
+   * datagram was sent, the error code of the underlying send api.
+   */
+  virtual Api::IoCallUint64Result sendBatch(const std::vector<UdpSendData>& data) PURE;
 };
 
 /**
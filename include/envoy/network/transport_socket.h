@@ -145,6 +145,12 @@ public:
    * @return the const SSL connection data if this is an SSL connection, or nullptr if it is not.
    */
   virtual const Ssl::ConnectionInfo* ssl() const PURE;
+
+  /**
+   * @return bool whether the transport socket reads and writes bytes unchanged, so that they may
+   *         be moved on the underlying socket without passing through it.
+   */
+  virtual bool passthrough() const PURE;
 };
 
 typedef std::unique_ptr<TransportSocket> TransportSocketPtr;
@@ -54,6 +54,21 @@ public:
                      Network::Address::SocketType socket_type,
                      const Network::Socket::OptionsSharedPtr& options, bool bind_to_port) PURE;
 
+  /**
+   * Creates the listen socket of a single worker for a listener that gives every worker its own
+   * SO_REUSEPORT socket. The socket of worker 0 is created with createListenSocket().
+   * @param address supplies the socket's address.
+   * @param socket_type the type of socket (stream or datagram) to create.
+   * @param options to be set on the created socket just before calling 'bind()'.
+   * @param worker_index supplies the index of the worker that will accept on the socket.
+   * @return Network::SocketSharedPtr an initialized and bound socket.
+   */
+  virtual Network::SocketSharedPtr
+  createWorkerListenSocket(Network::Address::InstanceConstSharedPtr address,
+                           Network::Address::SocketType socket_type,
+                           const Network::Socket::OptionsSharedPtr& options,
+                           uint32_t worker_index) PURE;
+
   /**
    * Creates a list of filter factories.
    * @param filters supplies the proto configuration.
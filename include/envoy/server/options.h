@@ -177,6 +177,17 @@ public:
    */
   virtual bool cpusetThreadsEnabled() const PURE;
 
+  /**
+   * @return bool indicating whether accepted connections should do their I/O through io_uring.
+   */
+  virtual bool ioUringEnabled() const PURE;
+
+  /**
+   * @return std::chrono::milliseconds the resolution of the timing wheel that worker timers are
+   *         kept in, or 0 if they are kept in the libevent timer heap.
+   */
+  virtual std::chrono::milliseconds timerWheelResolution() const PURE;
+
   /**
    * Converts the Options in to CommandLineOptions proto message defined in server_info.proto.
    * @return CommandLineOptionsPtr the protobuf representation of the options.
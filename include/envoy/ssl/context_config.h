@@ -57,6 +57,11 @@ public:
    */
   virtual unsigned maxProtocolVersion() const PURE;
 
+  /**
+   * @return true if the keys of established connections should be handed to kernel TLS.
+   */
+  virtual bool kernelTlsEnabled() const PURE;
+
   /**
    * @return true if the ContextConfig is able to provide secrets to create SSL context,
    * and false if dynamic secrets are expected but are not downloaded from SDS server yet.
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <memory>
 
@@ -33,6 +34,13 @@ public:
    */
   virtual const Router::MetadataMatchCriteria* metadataMatchCriteria() PURE;
 
+  /**
+   * @return bool whether the criteria returned by metadataMatchCriteria() were created for this
+   *         request, e.g. by merging request metadata into the route's, rather than being shared
+   *         by requests. Load balancers only cache lookups by shared criteria.
+   */
+  virtual bool metadataMatchCriteriaPerRequest() const PURE;
+
   /**
    * @return const Network::Connection* the incoming connection or nullptr to use during load
    * balancing.
@@ -92,6 +100,16 @@ public:
    *        is missing and use sensible defaults.
    */
   virtual HostConstSharedPtr chooseHost(LoadBalancerContext* context) PURE;
+
+  /**
+   * Report how long a host took to respond to a request. Load balancers that don't steer by
+   * latency ignore it.
+   * @param host supplies the host, as chosen by chooseHost().
+   * @param response_time supplies the time from sending the request to receiving the whole
+   *        response.
+   */
+  virtual void putResponseTime(const HostDescription& host,
+                               std::chrono::microseconds response_time) PURE;
 };
 
 typedef std::unique_ptr<LoadBalancer> LoadBalancerPtr;
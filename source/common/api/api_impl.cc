@@ -10,16 +10,17 @@ namespace Envoy {
 namespace Api {
 
 Impl::Impl(Thread::ThreadFactory& thread_factory, Stats::Store& store,
-           Event::TimeSystem& time_system, Filesystem::Instance& file_system)
+           Event::TimeSystem& time_system, Filesystem::Instance& file_system, bool use_io_uring)
     : thread_factory_(thread_factory), store_(store), time_system_(time_system),
-      file_system_(file_system) {}
+      file_system_(file_system), use_io_uring_(use_io_uring) {}
 
 Event::DispatcherPtr Impl::allocateDispatcher() {
-  return std::make_unique<Event::DispatcherImpl>(*this, time_system_);
+  return std::make_unique<Event::DispatcherImpl>(*this, time_system_, use_io_uring_);
 }
 
 Event::DispatcherPtr Impl::allocateDispatcher(Buffer::WatermarkFactoryPtr&& factory) {
-  return std::make_unique<Event::DispatcherImpl>(std::move(factory), *this, time_system_);
+  return std::make_unique<Event::DispatcherImpl>(std::move(factory), *this, time_system_,
+                                                 use_io_uring_);
 }
 
 } // namespace Api
@@ -16,8 +16,12 @@ namespace Api {
  */
 class Impl : public Api {
 public:
+  /**
+   * @param use_io_uring supplies whether the dispatchers allocated by this Api drive the I/O of
+   *        accepted connections with io_uring.
+   */
   Impl(Thread::ThreadFactory& thread_factory, Stats::Store& store, Event::TimeSystem& time_system,
-       Filesystem::Instance& file_system);
+       Filesystem::Instance& file_system, bool use_io_uring = false);
 
   // Api::Api
   Event::DispatcherPtr allocateDispatcher() override;
@@ -32,6 +36,7 @@ private:
   Stats::Store& store_;
   Event::TimeSystem& time_system_;
   Filesystem::Instance& file_system_;
+  const bool use_io_uring_;
 };
 
 } // namespace Api
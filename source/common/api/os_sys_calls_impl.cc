@@ -5,6 +5,8 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include "common/common/macros.h"
+
 namespace Envoy {
 namespace Api {
 
@@ -88,10 +90,43 @@ SysCallSizeResult OsSysCallsImpl::sendmsg(int fd, const msghdr* message, int fla
   return {rc, errno};
 }
 
+SysCallSizeResult OsSysCallsImpl::recvmsg(int sockfd, msghdr* message, int flags) {
+  const ssize_t rc = ::recvmsg(sockfd, message, flags);
+  return {rc, errno};
+}
+
 SysCallIntResult OsSysCallsImpl::getsockname(int sockfd, sockaddr* addr, socklen_t* addrlen) {
   const int rc = ::getsockname(sockfd, addr, addrlen);
   return {rc, errno};
 }
 
+SysCallIntResult OsSysCallsImpl::recvmmsg(int sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                          int flags) {
+#if defined(__linux__)
+  const int rc = ::recvmmsg(sockfd, msgvec, vlen, flags, nullptr);
+  return {rc, errno};
+#else
+  UNREFERENCED_PARAMETER(sockfd);
+  UNREFERENCED_PARAMETER(msgvec);
+  UNREFERENCED_PARAMETER(vlen);
+  UNREFERENCED_PARAMETER(flags);
+  return {-1, ENOSYS};
+#endif
+}
+
+SysCallIntResult OsSysCallsImpl::sendmmsg(int sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                          int flags) {
+#if defined(__linux__)
+  const int rc = ::sendmmsg(sockfd, msgvec, vlen, flags);
+  return {rc, errno};
+#else
+  UNREFERENCED_PARAMETER(sockfd);
+  UNREFERENCED_PARAMETER(msgvec);
+  UNREFERENCED_PARAMETER(vlen);
+  UNREFERENCED_PARAMETER(flags);
+  return {-1, ENOSYS};
+#endif
+}
+
 } // namespace Api
 } // namespace Envoy
@@ -30,7 +30,12 @@ public:
   SysCallSizeResult sendto(int fd, const void* buffer, size_t size, int flags, const sockaddr* addr,
                            socklen_t addrlen) override;
   SysCallSizeResult sendmsg(int fd, const msghdr* message, int flags) override;
+  SysCallSizeResult recvmsg(int sockfd, msghdr* message, int flags) override;
   SysCallIntResult getsockname(int sockfd, sockaddr* addr, socklen_t* addrlen) override;
+  SysCallIntResult recvmmsg(int sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                            int flags) override;
+  SysCallIntResult sendmmsg(int sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                            int flags) override;
 };
 
 typedef ThreadSafeSingleton<OsSysCallsImpl> OsSysCallsSingleton;
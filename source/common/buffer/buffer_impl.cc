@@ -588,6 +588,29 @@ void OwnedImpl::appendSliceForTest(absl::string_view data) {
   appendSliceForTest(data.data(), data.size());
 }
 
+std::shared_ptr<const Slice> OwnedImpl::shareSlice(const void* data) {
+  if (old_impl_) {
+    return nullptr;
+  }
+  const uint8_t* mem = static_cast<const uint8_t*>(data);
+  for (size_t slice_index = 0; slice_index < slices_.size(); slice_index++) {
+    SlicePtr& slice = slices_[slice_index];
+    if (mem < slice->data() || mem >= slice->data() + slice->dataSize()) {
+      continue;
+    }
+    const SharedSlice* shared = dynamic_cast<const SharedSlice*>(slice.get());
+    if (shared == nullptr) {
+      // Put a view of the slice in its place, so that this buffer can not write over the content
+      // of the slice, even after draining it.
+      auto view = std::make_unique<SharedSlice>(std::move(slice));
+      shared = view.get();
+      slice = std::move(view);
+    }
+    return shared->memory();
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
 void OwnedImpl::useOldImpl(bool use_old_impl) { use_old_impl_ = use_old_impl; }
 
 bool OwnedImpl::isSameBufferImpl(const Instance& rhs) const {
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <deque>
+#include <memory>
 #include <string>
 
 #include "envoy/buffer/buffer.h"
@@ -59,7 +60,7 @@ public:
   void drain(uint64_t size) {
     ASSERT(data_ + size <= reservable_);
     data_ += size;
-    if (data_ == reservable_) {
+    if (data_ == reservable_ && drained_space_reusable_) {
       // All the data in the slice has been drained. Reset the offsets so all
       // the data can be reused.
       data_ = 0;
@@ -97,7 +98,7 @@ public:
     // Verify the semantics that drain() enforces: if the slice is empty, either because
     // no data has been added or because all the added data has been drained, the data
     // section is at the very start of the slice.
-    ASSERT(!(dataSize() == 0 && data_ > 0));
+    ASSERT(!(dataSize() == 0 && data_ > 0) || !drained_space_reusable_);
     uint64_t available_size = capacity_ - reservable_;
     if (available_size == 0) {
       return {nullptr, 0};
@@ -153,6 +154,9 @@ public:
    * @return number of bytes copied (may be a smaller than size, may even be zero).
    */
   uint64_t prepend(const void* data, uint64_t size) {
+    if (!drained_space_reusable_) {
+      return 0;
+    }
     const uint8_t* src = static_cast<const uint8_t*>(data);
     uint64_t copy_size;
     if (dataSize() == 0) {
@@ -189,10 +193,39 @@ protected:
 
   /** Total number of bytes in the slice */
   uint64_t capacity_;
+
+  /**
+   * Whether the space in front of the content may be written to again, by drain() resetting the
+   * offsets or by prepend(). Content may still be appended either way.
+   */
+  bool drained_space_reusable_{true};
 };
 
 using SlicePtr = std::unique_ptr<Slice>;
 
+/**
+ * A slice whose memory is shared with references to its content outside of the buffer holding it
+ * (see OwnedImpl::shareSlice()). Content may still be appended to it, but the memory of the
+ * content it had when shared is never written to again.
+ */
+class SharedSlice : public Slice {
+public:
+  SharedSlice(SlicePtr&& slice)
+      : Slice(0, slice->dataSize(), slice->dataSize() + slice->reservableSize()),
+        slice_(std::move(slice)) {
+    base_ = slice_->data();
+    drained_space_reusable_ = false;
+  }
+
+  /**
+   * @return std::shared_ptr<const Slice> the owner of the memory of the slice.
+   */
+  std::shared_ptr<const Slice> memory() const { return slice_; }
+
+private:
+  const std::shared_ptr<Slice> slice_;
+};
+
 class OwnedSlice : public Slice, public InlineStorage {
 public:
   /**
@@ -522,6 +555,16 @@ public:
    */
   void appendSliceForTest(absl::string_view data);
 
+  /**
+   * Share the memory of the slice holding the given content, so that the content can be
+   * referenced in place after it has been drained from the buffer.
+   * @param data supplies a pointer into the content of the buffer, e.g. from getRawSlices().
+   * @return std::shared_ptr<const Slice> keeping the memory of the slice alive and its current
+   *         content unchanged, or nullptr if the buffer uses the evbuffer implementation, whose
+   *         memory can not be shared.
+   */
+  std::shared_ptr<const Slice> shareSlice(const void* data);
+
   // Support for choosing the buffer implementation at runtime.
   // TODO(brian-pane) remove this once the new implementation has been
   // running in production for a while.
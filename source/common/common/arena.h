@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "common/common/assert.h"
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+
+/**
+ * Deleter for objects created in an Arena. It only runs the destructor; the memory is released
+ * along with the arena.
+ */
+template <class T> struct ArenaDeleter {
+  void operator()(T* object) const { object->~T(); }
+};
+
+template <class T> using ArenaPtr = std::unique_ptr<T, ArenaDeleter<T>>;
+
+/**
+ * A bump allocator for objects that share a lifetime, such as the state of a single HTTP stream.
+ * Memory is carved out of an optional inline block (see InlineArena) and then out of heap blocks
+ * of doubling size. Individual deallocation is a no-op: all memory is released at once when the
+ * arena is destroyed. Objects placed in the arena must be destroyed before it.
+ */
+class Arena : NonCopyable {
+public:
+  Arena() = default;
+  ~Arena() {
+    while (heap_blocks_ != nullptr) {
+      HeapBlock* next = heap_blocks_->next_;
+      free(heap_blocks_);
+      heap_blocks_ = next;
+    }
+  }
+
+  /**
+   * Allocate memory from the arena.
+   * @param size supplies the number of bytes to allocate.
+   * @param alignment supplies the required alignment, which must be a power of two.
+   * @return void* the allocated memory, which remains valid until the arena is destroyed.
+   */
+  void* allocate(size_t size, size_t alignment) {
+    ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+    uintptr_t start = alignUp(current_, alignment);
+    if (current_ == nullptr || start + size > reinterpret_cast<uintptr_t>(end_)) {
+      newHeapBlock(size + alignment - 1);
+      start = alignUp(current_, alignment);
+    }
+    current_ = reinterpret_cast<char*>(start + size);
+    bytes_allocated_ += size;
+    return reinterpret_cast<void*>(start);
+  }
+
+  /**
+   * Construct an object in the arena.
+   * @param args supplies the constructor arguments.
+   * @return ArenaPtr<T> the object, which must be released before the arena is destroyed.
+   */
+  template <class T, class... Args> ArenaPtr<T> create(Args&&... args) {
+    return ArenaPtr<T>(new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...));
+  }
+
+  /**
+   * @return uint64_t the number of bytes handed out by allocate(), excluding alignment padding.
+   */
+  uint64_t bytesAllocated() const { return bytes_allocated_; }
+
+  /**
+   * @return uint32_t the number of heap blocks the arena has allocated.
+   */
+  uint32_t heapBlocks() const { return heap_block_count_; }
+
+protected:
+  Arena(char* block, size_t size) : current_(block), end_(block + size) {}
+
+private:
+  struct HeapBlock {
+    HeapBlock* next_;
+  };
+
+  // Heap block data starts after the header at the maximum fundamental alignment.
+  static constexpr size_t HeapBlockHeaderSize =
+      (sizeof(HeapBlock) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+  static constexpr size_t MinHeapBlockSize = 1024;
+
+  static uintptr_t alignUp(const char* pointer, size_t alignment) {
+    return (reinterpret_cast<uintptr_t>(pointer) + alignment - 1) & ~(alignment - 1);
+  }
+
+  void newHeapBlock(size_t min_size) {
+    const size_t size = std::max(next_heap_block_size_, min_size);
+    next_heap_block_size_ = size * 2;
+    HeapBlock* block = static_cast<HeapBlock*>(malloc(HeapBlockHeaderSize + size));
+    RELEASE_ASSERT(block != nullptr, "");
+    block->next_ = heap_blocks_;
+    heap_blocks_ = block;
+    heap_block_count_++;
+    current_ = reinterpret_cast<char*>(block) + HeapBlockHeaderSize;
+    end_ = current_ + size;
+  }
+
+  char* current_{};
+  char* end_{};
+  HeapBlock* heap_blocks_{};
+  size_t next_heap_block_size_{MinHeapBlockSize};
+  uint64_t bytes_allocated_{};
+  uint32_t heap_block_count_{};
+};
+
+/**
+ * An Arena whose first Size bytes are stored inline, so that an owner which typically needs no
+ * more than that performs no separate heap allocation at all.
+ */
+template <size_t Size> class InlineArena : public Arena {
+public:
+  InlineArena() : Arena(block_, Size) {}
+
+private:
+  alignas(std::max_align_t) char block_[Size];
+};
+
+/**
+ * Standard library allocator backed by an Arena, e.g. for the nodes of a std::list that lives no
+ * longer than the arena.
+ */
+template <class T> class ArenaAllocator {
+public:
+  using value_type = T;
+
+  explicit ArenaAllocator(Arena& arena) : arena_(&arena) {}
+  template <class U> ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena_) {}
+
+  T* allocate(size_t n) { return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T))); }
+  void deallocate(T*, size_t) {}
+
+  template <class U> bool operator==(const ArenaAllocator<U>& rhs) const {
+    return arena_ == rhs.arena_;
+  }
+  template <class U> bool operator!=(const ArenaAllocator<U>& rhs) const {
+    return arena_ != rhs.arena_;
+  }
+
+private:
+  template <class U> friend class ArenaAllocator;
+
+  Arena* arena_;
+};
+
+} // namespace Envoy
@@ -8,11 +8,13 @@
 namespace Envoy {
 /**
  * Mixin class that allows an object contained in a unique pointer to be easily linked and unlinked
- * from lists.
+ * from lists. The list type may be overridden to use a different deleter or allocator, e.g. for
+ * objects placed in an Arena.
  */
-template <class T> class LinkedObject {
+template <class T, class List = std::list<std::unique_ptr<T>>> class LinkedObject {
 public:
-  typedef std::list<std::unique_ptr<T>> ListType;
+  typedef List ListType;
+  typedef typename ListType::value_type PtrType;
 
   /**
    * @return the list iterator for the object.
@@ -44,7 +46,7 @@ public:
    * @param item supplies the item to move in.
    * @param list supplies the list to move the item into.
    */
-  void moveIntoList(std::unique_ptr<T>&& item, ListType& list) {
+  void moveIntoList(PtrType&& item, ListType& list) {
     ASSERT(!inserted_);
     inserted_ = true;
     entry_ = list.emplace(list.begin(), std::move(item));
@@ -55,7 +57,7 @@ public:
    * @param item supplies the item to move in.
    * @param list supplies the list to move the item into.
    */
-  void moveIntoListBack(std::unique_ptr<T>&& item, ListType& list) {
+  void moveIntoListBack(PtrType&& item, ListType& list) {
     ASSERT(!inserted_);
     inserted_ = true;
     entry_ = list.emplace(list.end(), std::move(item));
@@ -65,11 +67,11 @@ public:
    * Remove this item from a list.
    * @param list supplies the list to remove from. This item should be in this list.
    */
-  std::unique_ptr<T> removeFromList(ListType& list) {
+  PtrType removeFromList(ListType& list) {
     ASSERT(inserted_);
     ASSERT(std::find(list.begin(), list.end(), *entry_) != list.end());
 
-    std::unique_ptr<T> removed = std::move(*entry_);
+    PtrType removed = std::move(*entry_);
     list.erase(entry_);
     inserted_ = false;
     return removed;
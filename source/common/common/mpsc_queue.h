@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+
+/**
+ * An unbounded multiple producer, single consumer queue of intrusive nodes, after Dmitry Vyukov's
+ * non-intrusive MPSC node-based queue. Pushing is wait-free: one atomic exchange and one store.
+ * Popping is lock-free, but can not see a node whose producer has exchanged it in and not yet
+ * linked it, in which case pop() returns nullptr while the queue is not empty. Callers that need
+ * to know when to look again keep a count of their own; see Event::DispatcherImpl::post().
+ *
+ * The queue does not own its nodes. Nodes that are still queued when the queue is destroyed must
+ * be popped and freed by the owner first.
+ */
+class MpscQueue : NonCopyable {
+public:
+  class Node {
+  private:
+    friend class MpscQueue;
+    std::atomic<Node*> next_{nullptr};
+  };
+
+  MpscQueue() : head_(&stub_), tail_(&stub_) {}
+
+  /**
+   * Add a node to the queue. May be called from any thread.
+   * @param node supplies the node, which must not be on any queue.
+   */
+  void push(Node& node) {
+    node.next_.store(nullptr, std::memory_order_relaxed);
+    Node* prev = head_.exchange(&node, std::memory_order_acq_rel);
+    // From here until the store below, the consumer can not get past prev.
+    prev->next_.store(&node, std::memory_order_release);
+  }
+
+  /**
+   * Remove the oldest node from the queue. Must only be called from the consumer thread.
+   * @return Node* the node, or nullptr if the queue is empty or a push is in progress.
+   */
+  Node* pop() {
+    Node* tail = tail_;
+    Node* next = tail->next_.load(std::memory_order_acquire);
+    if (tail == &stub_) {
+      if (next == nullptr) {
+        return nullptr;
+      }
+      tail_ = next;
+      tail = next;
+      next = next->next_.load(std::memory_order_acquire);
+    }
+    if (next != nullptr) {
+      tail_ = next;
+      return tail;
+    }
+    if (tail != head_.load(std::memory_order_acquire)) {
+      // A producer has exchanged in a node after tail, and not linked it yet.
+      return nullptr;
+    }
+    // tail is the last node. Put the stub behind it, so that it can be handed out.
+    push(stub_);
+    next = tail->next_.load(std::memory_order_acquire);
+    if (next != nullptr) {
+      tail_ = next;
+      return tail;
+    }
+    return nullptr;
+  }
+
+private:
+  Node stub_;
+  // Producers append at head_, the consumer removes from tail_.
+  std::atomic<Node*> head_;
+  Node* tail_;
+};
+
+} // namespace Envoy
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <regex>
+#include <string>
+
+#include "envoy/common/regex.h"
+#include "envoy/type/matcher/regex.pb.h"
+
+namespace Envoy {
+namespace Regex {
+
+/**
+ * Utilities for constructing regex matchers.
+ */
+class Utility {
+public:
+  /**
+   * Default RE2 program size budget used when max_program_size is not configured.
+   */
+  static constexpr uint32_t DefaultMaxProgramSize = 100;
+
+  /**
+   * Constructs a std::regex based compiled matcher. This is used for the legacy string based regex
+   * fields, which follow the ECMAScript grammar.
+   * @param regex supplies the regular expression to compile.
+   * @param flags supplies the std::regex parser flags.
+   * @throw EnvoyException if the regex string is invalid.
+   */
+  static CompiledMatcherPtr parseStdRegexAsCompiledMatcher(const std::string& regex,
+                                                           std::regex::flag_type flags =
+                                                               std::regex::optimize);
+
+  /**
+   * Constructs a compiled matcher using the engine selected in the configuration.
+   * @param matcher supplies the regex configuration.
+   * @throw EnvoyException if the regex string is invalid or if it exceeds the configured program
+   *        size budget.
+   */
+  static CompiledMatcherPtr parseRegex(const envoy::type::matcher::RegexMatcher& matcher);
+};
+
+} // namespace Regex
+} // namespace Envoy
@@ -0,0 +1,123 @@
+#include "common/event/callback_tracker.h"
+
+#include <cxxabi.h>
+
+#include <cstdlib>
+#include <list>
+
+#include "common/common/assert.h"
+#include "common/common/lock_guard.h"
+#include "common/common/macros.h"
+
+namespace Envoy {
+namespace Event {
+
+namespace {
+
+Thread::MutexBasicLockable& registryLock() {
+  MUTABLE_CONSTRUCT_ON_FIRST_USE(Thread::MutexBasicLockable);
+}
+
+std::list<CallbackTracker*>& registry() {
+  MUTABLE_CONSTRUCT_ON_FIRST_USE(std::list<CallbackTracker*>);
+}
+
+} // namespace
+
+constexpr uint32_t CallbackTracker::SlowCallbackRingSize;
+constexpr std::chrono::microseconds CallbackTracker::SlowCallbackThreshold;
+thread_local CallbackTracker* CallbackTracker::current_ = nullptr;
+
+CallbackTracker::CallbackTracker(const std::string& name, DispatcherStats& stats,
+                                 TimeSource& time_source)
+    : name_(name), stats_(stats), time_source_(time_source) {
+  Thread::LockGuard lock(registryLock());
+  registry().push_back(this);
+}
+
+CallbackTracker::~CallbackTracker() {
+  if (current_ == this) {
+    current_ = nullptr;
+  }
+  Thread::LockGuard lock(registryLock());
+  registry().remove(this);
+}
+
+void CallbackTracker::onPollDone() {
+  awaiting_first_callback_ = true;
+  poll_done_ = time_source_.monotonicTime();
+}
+
+void CallbackTracker::untrackCurrentScope() {
+  CallbackTracker* tracker = current_;
+  if (tracker == nullptr || tracker->innermost_ == nullptr || tracker->innermost_->untracked_) {
+    return;
+  }
+  tracker->innermost_->untracked_ = true;
+  tracker->depth_--;
+}
+
+void CallbackTracker::begin(Scope& scope, const char* kind, const std::type_info& source) {
+  scope.kind_ = kind;
+  scope.source_ = &source;
+  scope.start_ = time_source_.monotonicTime();
+  scope.parent_ = innermost_;
+  innermost_ = &scope;
+  if (depth_++ == 0 && awaiting_first_callback_) {
+    awaiting_first_callback_ = false;
+    stats_.time_to_first_callback_us_.recordValue(
+        std::chrono::duration_cast<std::chrono::microseconds>(scope.start_ - poll_done_).count());
+  }
+}
+
+void CallbackTracker::end(Scope& scope) {
+  ASSERT(innermost_ == &scope);
+  innermost_ = scope.parent_;
+  if (scope.untracked_) {
+    return;
+  }
+  ASSERT(depth_ > 0);
+  const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+      time_source_.monotonicTime() - scope.start_);
+  if (--depth_ == 0) {
+    stats_.callback_duration_us_.recordValue(duration.count());
+  }
+  if (duration >= SlowCallbackThreshold) {
+    const SystemTime start_time = time_source_.systemTime() - duration;
+    Thread::LockGuard lock(ring_lock_);
+    ring_[ring_count_++ % SlowCallbackRingSize] =
+        SlowCallback{start_time, duration, scope.kind_, scope.source_};
+  }
+}
+
+std::vector<CallbackTracker::SlowCallback> CallbackTracker::slowCallbacks() const {
+  Thread::LockGuard lock(ring_lock_);
+  std::vector<SlowCallback> callbacks;
+  const uint64_t first =
+      ring_count_ > SlowCallbackRingSize ? ring_count_ - SlowCallbackRingSize : 0;
+  for (uint64_t i = first; i < ring_count_; i++) {
+    callbacks.push_back(ring_[i % SlowCallbackRingSize]);
+  }
+  return callbacks;
+}
+
+void CallbackTracker::forEach(const std::function<void(const CallbackTracker&)>& cb) {
+  Thread::LockGuard lock(registryLock());
+  for (const CallbackTracker* tracker : registry()) {
+    cb(*tracker);
+  }
+}
+
+std::string CallbackTracker::sourceName(const std::type_info& source) {
+  int status;
+  char* demangled = abi::__cxa_demangle(source.name(), nullptr, nullptr, &status);
+  if (demangled == nullptr) {
+    return source.name();
+  }
+  std::string name(demangled);
+  ::free(demangled);
+  return name;
+}
+
+} // namespace Event
+} // namespace Envoy
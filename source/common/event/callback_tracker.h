@@ -0,0 +1,153 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/event/dispatcher.h"
+
+#include "common/common/non_copyable.h"
+#include "common/common/thread.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * Times the callbacks that an event loop runs, for the callback_duration_us and
+ * time_to_first_callback_us dispatcher stats, and keeps a ring of the most recent callbacks that
+ * took longer than SlowCallbackThreshold. A dispatcher creates one when its stats are initialized,
+ * and makes it current on its thread; callbacks are only timed while a tracker is current.
+ *
+ * Trackers register themselves, so that the admin /slow_callbacks handler can read the rings of
+ * all dispatchers from the main thread.
+ */
+class CallbackTracker : NonCopyable {
+public:
+  static constexpr uint32_t SlowCallbackRingSize = 32;
+  static constexpr std::chrono::microseconds SlowCallbackThreshold{1000};
+
+  struct SlowCallback {
+    SystemTime start_time_;
+    std::chrono::microseconds duration_;
+    const char* kind_;
+    const std::type_info* source_;
+  };
+
+  /**
+   * @param name supplies the name the tracker is listed under, i.e. the dispatcher's stats prefix.
+   * @param stats supplies the dispatcher stats to record to.
+   * @param time_source supplies the clock callbacks are timed with.
+   */
+  CallbackTracker(const std::string& name, DispatcherStats& stats, TimeSource& time_source);
+  ~CallbackTracker();
+
+  /**
+   * Times a callback while in scope, if a tracker is current on this thread. Nested scopes, e.g.
+   * the deferred deletes that a callback runs through clearDeferredDeleteList(), are recorded as
+   * slow callbacks of their own, but only the outermost one counts towards the stats.
+   */
+  class Scope : NonCopyable {
+  public:
+    template <class Callback>
+    Scope(const char* kind, const Callback& callback) : tracker_(current_) {
+      if (tracker_ != nullptr) {
+        tracker_->begin(*this, kind, sourceType(callback));
+      }
+    }
+    ~Scope() {
+      if (tracker_ != nullptr) {
+        tracker_->end(*this);
+      }
+    }
+
+  private:
+    friend class CallbackTracker;
+
+    template <class R, class... Args>
+    static const std::type_info& sourceType(const std::function<R(Args...)>& callback) {
+      return callback.target_type();
+    }
+    static const std::type_info& sourceType(const DeferredDeletable& deletable) {
+      return typeid(deletable);
+    }
+
+    CallbackTracker* const tracker_;
+    const char* kind_{};
+    const std::type_info* source_{};
+    MonotonicTime start_;
+    Scope* parent_{};
+    bool untracked_{};
+  };
+
+  /**
+   * Make this tracker the one that times callbacks on the calling thread, or stop timing them if
+   * nullptr.
+   */
+  static void setCurrent(CallbackTracker* tracker) { current_ = tracker; }
+
+  /**
+   * @return CallbackTracker* the tracker current on the calling thread, if any.
+   */
+  static CallbackTracker* current() { return current_; }
+
+  /**
+   * Stop timing the innermost scope on the calling thread. This is for callbacks that only drive
+   * other callbacks, such as the post timer running the posted callbacks: the callbacks it runs are
+   * then each timed as an outermost callback, and the driver is neither counted nor kept as slow.
+   * The driver still ends the wait for the first callback after polling, as it started first.
+   */
+  static void untrackCurrentScope();
+
+  /**
+   * Called after the event loop polls, to start the wait for the first callback.
+   */
+  void onPollDone();
+
+  /**
+   * @return std::vector<SlowCallback> the recent slow callbacks, oldest first. This may be called
+   *         from any thread.
+   */
+  std::vector<SlowCallback> slowCallbacks() const;
+
+  /**
+   * @return const std::string& the name of the tracker.
+   */
+  const std::string& name() const { return name_; }
+
+  /**
+   * Run a callback for each live tracker, with the registry locked.
+   */
+  static void forEach(const std::function<void(const CallbackTracker&)>& cb);
+
+  /**
+   * @return std::string a readable, demangled name for the type of a callback.
+   */
+  static std::string sourceName(const std::type_info& source);
+
+private:
+  void begin(Scope& scope, const char* kind, const std::type_info& source);
+  void end(Scope& scope);
+
+  static thread_local CallbackTracker* current_;
+
+  const std::string name_;
+  DispatcherStats& stats_;
+  TimeSource& time_source_;
+  uint32_t depth_{};
+  Scope* innermost_{};
+  // Set by onPollDone(), until the first callback after polling starts.
+  bool awaiting_first_callback_{};
+  MonotonicTime poll_done_;
+  mutable Thread::MutexBasicLockable ring_lock_;
+  std::array<SlowCallback, SlowCallbackRingSize> ring_ GUARDED_BY(ring_lock_);
+  uint64_t ring_count_ GUARDED_BY(ring_lock_){};
+};
+
+} // namespace Event
+} // namespace Envoy
@@ -3,15 +3,16 @@
 #include <chrono>
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <string>
 #include <vector>
 
 #include "envoy/api/api.h"
+#include "envoy/common/exception.h"
 #include "envoy/network/listen_socket.h"
 #include "envoy/network/listener.h"
 
 #include "common/buffer/buffer_impl.h"
-#include "common/common/lock_guard.h"
 #include "common/common/thread.h"
 #include "common/event/file_event_impl.h"
 #include "common/event/libevent_scheduler.h"
@@ -20,6 +21,7 @@
 #include "common/filesystem/watcher_impl.h"
 #include "common/network/connection_impl.h"
 #include "common/network/dns_impl.h"
+#include "common/network/io_uring_socket_handle_impl.h"
 #include "common/network/listener_impl.h"
 #include "common/network/udp_listener_impl.h"
 
@@ -28,18 +30,45 @@
 namespace Envoy {
 namespace Event {
 
-DispatcherImpl::DispatcherImpl(Api::Api& api, Event::TimeSystem& time_system)
-    : DispatcherImpl(std::make_unique<Buffer::WatermarkBufferFactory>(), api, time_system) {}
+constexpr uint32_t DispatcherImpl::MaxDeferredDeletesPerIteration;
+
+DispatcherImpl::DispatcherImpl(Api::Api& api, Event::TimeSystem& time_system, bool use_io_uring)
+    : DispatcherImpl(std::make_unique<Buffer::WatermarkBufferFactory>(), api, time_system,
+                     use_io_uring) {}
 
 DispatcherImpl::DispatcherImpl(Buffer::WatermarkFactoryPtr&& factory, Api::Api& api,
-                               Event::TimeSystem& time_system)
+                               Event::TimeSystem& time_system, bool use_io_uring)
     : api_(api), buffer_factory_(std::move(factory)),
       scheduler_(time_system.createScheduler(base_scheduler_)),
-      deferred_delete_timer_(createTimer([this]() -> void { clearDeferredDeleteList(); })),
-      post_timer_(createTimer([this]() -> void { runPostCallbacks(); })),
-      current_to_delete_(&to_delete_1_) {}
+      // The deletes and posted callbacks that these timers run are each timed on their own.
+      deferred_delete_timer_(base_scheduler_.createTimerImpl([this]() -> void {
+        CallbackTracker::untrackCurrentScope();
+        runDeferredDelete(MaxDeferredDeletesPerIteration);
+      })),
+      post_timer_(base_scheduler_.createTimerImpl([this]() -> void {
+        CallbackTracker::untrackCurrentScope();
+        runPostCallbacks();
+      })),
+      current_to_delete_(&to_delete_1_), deleting_(&to_delete_2_), use_io_uring_(use_io_uring) {}
+
+DispatcherImpl::~DispatcherImpl() {
+  // Callbacks that never got to run are dropped, as the event loop is gone.
+  while (MpscQueue::Node* node = post_queue_.pop()) {
+    delete static_cast<PostNode*>(node);
+  }
+}
 
-DispatcherImpl::~DispatcherImpl() {}
+Network::IoUringWorker* DispatcherImpl::ioUringWorker() {
+  if (use_io_uring_ && io_uring_worker_ == nullptr && !io_uring_failed_) {
+    try {
+      io_uring_worker_ = std::make_unique<Network::IoUringWorker>(*this);
+    } catch (const EnvoyException& e) {
+      ENVOY_LOG(warn, "io_uring is not available, using libevent I/O: {}", e.what());
+      io_uring_failed_ = true;
+    }
+  }
+  return io_uring_worker_.get();
+}
 
 void DispatcherImpl::initializeStats(Stats::Scope& scope, const std::string& prefix) {
   // This needs to be run in the dispatcher's thread, so that we have a thread id to log.
@@ -48,40 +77,57 @@ void DispatcherImpl::initializeStats(Stats::Scope& scope, const std::string& pre
     stats_ = std::make_unique<DispatcherStats>(
         DispatcherStats{ALL_DISPATCHER_STATS(POOL_HISTOGRAM_PREFIX(scope, stats_prefix_ + "."))});
     base_scheduler_.initializeStats(stats_.get());
+    callback_tracker_ = std::make_unique<CallbackTracker>(stats_prefix_, *stats_, timeSource());
+    CallbackTracker::setCurrent(callback_tracker_.get());
+    record_post_latency_ = true;
     ENVOY_LOG(debug, "running {} on thread {}", stats_prefix_, run_tid_->debugString());
   });
 }
 
 void DispatcherImpl::clearDeferredDeleteList() {
-  ASSERT(isThreadSafe());
-  std::vector<DeferredDeletablePtr>* to_delete = current_to_delete_;
+  runDeferredDelete(std::numeric_limits<uint64_t>::max());
+}
 
-  size_t num_to_delete = to_delete->size();
-  if (deferred_deleting_ || !num_to_delete) {
+void DispatcherImpl::runDeferredDelete(uint64_t limit) {
+  ASSERT(isThreadSafe());
+  if (deferred_deleting_) {
     return;
   }
-
-  ENVOY_LOG(trace, "clearing deferred deletion list (size={})", num_to_delete);
-
-  // Swap the current deletion vector so that if we do deferred delete while we are deleting, we
-  // use the other vector. We will get another callback to delete that vector.
-  if (current_to_delete_ == &to_delete_1_) {
-    current_to_delete_ = &to_delete_2_;
-  } else {
-    current_to_delete_ = &to_delete_1_;
-  }
-
   deferred_deleting_ = true;
 
-  // Calling clear() on the vector does not specify which order destructors run in. We want to
-  // destroy in FIFO order so just do it manually. This required 2 passes over the vector which is
-  // not optimal but can be cleaned up later if needed.
-  for (size_t i = 0; i < num_to_delete; i++) {
-    (*to_delete)[i].reset();
+  // Finish the list that a previous run stopped in, if any, and then take the current one. Take it
+  // only once, so that if we do deferred delete while we are deleting, we use the other vector. We
+  // will get another callback to delete that vector.
+  bool swapped = false;
+  while (true) {
+    if (deleting_index_ == deleting_->size()) {
+      deleting_->clear();
+      deleting_index_ = 0;
+      if (swapped || current_to_delete_->empty()) {
+        break;
+      }
+      ENVOY_LOG(trace, "clearing deferred deletion list (size={})", current_to_delete_->size());
+      std::swap(current_to_delete_, deleting_);
+      swapped = true;
+    }
+    if (limit == 0) {
+      break;
+    }
+    // Calling clear() on the vector does not specify which order destructors run in. We want to
+    // destroy in FIFO order so just do it manually.
+    DeferredDeletablePtr& to_delete = (*deleting_)[deleting_index_++];
+    {
+      CallbackTracker::Scope scope("deferred_delete", *to_delete);
+      to_delete.reset();
+    }
+    limit--;
   }
 
-  to_delete->clear();
   deferred_deleting_ = false;
+  if (deleting_index_ < deleting_->size()) {
+    // Let the event loop poll for I/O before going on.
+    deferred_delete_timer_->enableTimerNextIteration();
+  }
 }
 
 Network::ConnectionPtr
@@ -130,7 +176,7 @@ DispatcherImpl::createListener(Network::Socket& socket, Network::ListenerCallbac
 Network::ListenerPtr DispatcherImpl::createUdpListener(Network::Socket& socket,
                                                        Network::UdpListenerCallbacks& cb) {
   ASSERT(isThreadSafe());
-  return Network::ListenerPtr{new Network::UdpListenerImpl(*this, socket, cb)};
+  return Network::ListenerPtr{new Network::UdpListenerImpl(*this, socket, cb, true)};
 }
 
 TimerPtr DispatcherImpl::createTimer(TimerCb cb) {
@@ -155,14 +201,16 @@ SignalEventPtr DispatcherImpl::listenForSignal(int signal_num, SignalCb cb) {
 }
 
 void DispatcherImpl::post(std::function<void()> callback) {
-  bool do_post;
-  {
-    Thread::LockGuard lock(post_lock_);
-    do_post = post_callbacks_.empty();
-    post_callbacks_.push_back(callback);
+  auto node = std::make_unique<PostNode>(std::move(callback));
+  if (record_post_latency_.load(std::memory_order_relaxed)) {
+    node->posted_at_ = api_.timeSource().monotonicTime();
   }
+  // Count the callback before linking it, so that runPostCallbacks() never pops more callbacks
+  // than are counted. It comes back for a counted callback that is not linked yet.
+  const bool was_empty = post_depth_.fetch_add(1, std::memory_order_acq_rel) == 0;
+  post_queue_.push(*node.release());
 
-  if (do_post) {
+  if (was_empty) {
     post_timer_->enableTimer(std::chrono::milliseconds(0));
   }
 }
@@ -174,28 +222,49 @@ void DispatcherImpl::run(RunType type) {
   // callbacks that have to get run before the initial event loop starts running. libevent does
   // not guarantee that events are run in any particular order. So even if we post() and call
   // event_base_once() before some other event, the other event might get called first.
+  CallbackTracker* previous_tracker = CallbackTracker::current();
+  CallbackTracker::setCurrent(callback_tracker_.get());
   runPostCallbacks();
   base_scheduler_.run(type);
+  CallbackTracker::setCurrent(previous_tracker);
 }
 
 void DispatcherImpl::runPostCallbacks() {
-  while (true) {
-    // It is important that this declaration is inside the body of the loop so that the callback is
-    // destructed while post_lock_ is not held. If callback is declared outside the loop and reused
-    // for each iteration, the previous iteration's callback is destructed when callback is
-    // re-assigned, which happens while holding the lock. This can lead to a deadlock (via
-    // recursive mutex acquisition) if destroying the callback runs a destructor, which through some
-    // callstack calls post() on this dispatcher.
-    std::function<void()> callback;
-    {
-      Thread::LockGuard lock(post_lock_);
-      if (post_callbacks_.empty()) {
-        return;
+  uint64_t depth = post_depth_.load(std::memory_order_acquire);
+  if (depth == 0) {
+    return;
+  }
+  if (stats_ != nullptr) {
+    stats_->post_queue_depth_.recordValue(depth);
+  }
+
+  // Run until the count of pending callbacks drops to zero, which includes the callbacks that are
+  // posted while running.
+  while (depth > 0) {
+    uint64_t ran = 0;
+    while (MpscQueue::Node* node = post_queue_.pop()) {
+      // The node, and with it the callback, is destroyed before the next one is popped, and
+      // destroying the callback may post() again.
+      std::unique_ptr<PostNode> post(static_cast<PostNode*>(node));
+      if (stats_ != nullptr && post->posted_at_ != MonotonicTime()) {
+        stats_->post_latency_us_.recordValue(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                api_.timeSource().monotonicTime() - post->posted_at_)
+                .count());
+      }
+      {
+        CallbackTracker::Scope scope("post", post->callback_);
+        post->callback_();
       }
-      callback = post_callbacks_.front();
-      post_callbacks_.pop_front();
+      ran++;
+    }
+    depth = post_depth_.fetch_sub(ran, std::memory_order_acq_rel) - ran;
+    if (ran == 0 && depth > 0) {
+      // A post() has counted its callback, but not finished linking it into the queue. Come back
+      // for it rather than spinning.
+      post_timer_->enableTimerNextIteration();
+      return;
     }
-    callback();
   }
 }
 
@@ -1,8 +1,8 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
-#include <list>
 #include <memory>
 #include <vector>
 
@@ -14,11 +14,18 @@
 #include "envoy/stats/scope.h"
 
 #include "common/common/logger.h"
+#include "common/common/mpsc_queue.h"
 #include "common/common/thread.h"
+#include "common/event/callback_tracker.h"
 #include "common/event/libevent.h"
 #include "common/event/libevent_scheduler.h"
+#include "common/event/timer_impl.h"
 
 namespace Envoy {
+namespace Network {
+class IoUringWorker;
+} // namespace Network
+
 namespace Event {
 
 /**
@@ -26,9 +33,14 @@ namespace Event {
  */
 class DispatcherImpl : Logger::Loggable<Logger::Id::main>, public Dispatcher {
 public:
-  DispatcherImpl(Api::Api& api, Event::TimeSystem& time_system);
+  /**
+   * @param use_io_uring supplies whether connections accepted by the listeners of this dispatcher
+   *        have their reads and writes driven by an io_uring instead of by readv/writev on libevent
+   *        readiness.
+   */
+  DispatcherImpl(Api::Api& api, Event::TimeSystem& time_system, bool use_io_uring = false);
   DispatcherImpl(Buffer::WatermarkFactoryPtr&& factory, Api::Api& api,
-                 Event::TimeSystem& time_system);
+                 Event::TimeSystem& time_system, bool use_io_uring = false);
   ~DispatcherImpl();
 
   /**
@@ -36,6 +48,18 @@ public:
    */
   event_base& base() { return base_scheduler_.base(); }
 
+  /**
+   * The most deferred deletes that run in one event loop iteration. The rest run in the following
+   * iterations, so that a burst of closed connections does not hold up I/O for the live ones.
+   */
+  static constexpr uint32_t MaxDeferredDeletesPerIteration = 1000;
+
+  /**
+   * @return Network::IoUringWorker* the io_uring driver of this dispatcher, created on first use,
+   *         or nullptr if io_uring is not selected or can not be used on this host.
+   */
+  Network::IoUringWorker* ioUringWorker();
+
   // Event::Dispatcher
   TimeSource& timeSource() override { return api_.timeSource(); }
   void initializeStats(Stats::Scope& scope, const std::string& prefix) override;
@@ -67,7 +91,18 @@ public:
   Buffer::WatermarkFactory& getWatermarkFactory() override { return *buffer_factory_; }
 
 private:
+  // A posted callback, on post_queue_.
+  struct PostNode : public MpscQueue::Node {
+    PostNode(std::function<void()>&& callback) : callback_(std::move(callback)) {}
+
+    std::function<void()> callback_;
+    // When the callback was posted, if post latency is recorded.
+    MonotonicTime posted_at_;
+  };
+
   void runPostCallbacks();
+  // Deletes up to limit deferred deletables, oldest first.
+  void runDeferredDelete(uint64_t limit);
 
   // Validate that an operation is thread safe, i.e. it's invoked on the same thread that the
   // dispatcher run loop is executing on. We allow run_tid_ == nullptr for tests where we don't
@@ -77,18 +112,33 @@ private:
   Api::Api& api_;
   std::string stats_prefix_;
   std::unique_ptr<DispatcherStats> stats_;
+  std::unique_ptr<CallbackTracker> callback_tracker_;
   Thread::ThreadIdPtr run_tid_;
   Buffer::WatermarkFactoryPtr buffer_factory_;
   LibeventScheduler base_scheduler_;
   SchedulerPtr scheduler_;
-  TimerPtr deferred_delete_timer_;
-  TimerPtr post_timer_;
+  // Declared ahead of the deferred delete lists, whose connections may still hand it sockets when
+  // they are destroyed.
+  std::unique_ptr<Network::IoUringWorker> io_uring_worker_;
+  bool io_uring_failed_{};
+  // These come from the base scheduler, as post() arms post_timer_ from any thread, and the
+  // deferred delete timer needs enableTimerNextIteration().
+  std::unique_ptr<TimerImpl> deferred_delete_timer_;
+  std::unique_ptr<TimerImpl> post_timer_;
   std::vector<DeferredDeletablePtr> to_delete_1_;
   std::vector<DeferredDeletablePtr> to_delete_2_;
+  // Deferred deletes are added to current_to_delete_. The other list is being deleted, up to
+  // deleting_index_, when a run stopped at MaxDeferredDeletesPerIteration.
   std::vector<DeferredDeletablePtr>* current_to_delete_;
-  Thread::MutexBasicLockable post_lock_;
-  std::list<std::function<void()>> post_callbacks_ GUARDED_BY(post_lock_);
+  std::vector<DeferredDeletablePtr>* deleting_;
+  size_t deleting_index_{};
+  MpscQueue post_queue_;
+  // The number of posted callbacks that have not run yet. post() wakes the dispatcher up when it
+  // raises this from zero.
+  std::atomic<uint64_t> post_depth_{};
+  std::atomic<bool> record_post_latency_{};
   bool deferred_deleting_{};
+  const bool use_io_uring_;
 };
 
 } // namespace Event
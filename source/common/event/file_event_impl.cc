@@ -3,6 +3,7 @@
 #include <cstdint>
 
 #include "common/common/assert.h"
+#include "common/event/callback_tracker.h"
 #include "common/event/dispatcher_impl.h"
 
 #include "event2/event.h"
@@ -62,6 +63,7 @@ void FileEventImpl::assignEvents(uint32_t events) {
         }
 
         ASSERT(events);
+        CallbackTracker::Scope scope("file_event", event->cb_);
         event->cb_(events);
       },
       this);
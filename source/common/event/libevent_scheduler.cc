@@ -1,6 +1,7 @@
 #include "common/event/libevent_scheduler.h"
 
 #include "common/common/assert.h"
+#include "common/event/callback_tracker.h"
 #include "common/event/timer_impl.h"
 
 #include "event2/util.h"
@@ -19,9 +20,11 @@ LibeventScheduler::LibeventScheduler() : libevent_(event_base_new()) {
   RELEASE_ASSERT(Libevent::Global::initialized(), "");
 }
 
-TimerPtr LibeventScheduler::createTimer(const TimerCb& cb) {
+TimerPtr LibeventScheduler::createTimer(const TimerCb& cb) { return createTimerImpl(cb); };
+
+std::unique_ptr<TimerImpl> LibeventScheduler::createTimerImpl(const TimerCb& cb) {
   return std::make_unique<TimerImpl>(libevent_, cb);
-};
+}
 
 void LibeventScheduler::run(Dispatcher::RunType mode) {
   int flag = 0;
@@ -84,9 +87,15 @@ void LibeventScheduler::onCheck(evwatch*, const evwatch_check_cb_info*, void* ar
   // from above to compute the actual polling duration, and store it for the next iteration of the
   // event loop to compute the loop duration.
   evutil_gettimeofday(&self->check_time_, nullptr);
+  timeval delta;
+  evutil_timersub(&self->check_time_, &self->prepare_time_, &delta);
+  recordTimeval(self->stats_->poll_duration_us_, delta);
+  if (CallbackTracker* tracker = CallbackTracker::current()) {
+    tracker->onPollDone();
+  }
+
   if (self->timeout_set_) {
-    timeval delta, delay;
-    evutil_timersub(&self->check_time_, &self->prepare_time_, &delta);
+    timeval delay;
     evutil_timersub(&delta, &self->timeout_, &delay);
 
     // Delay can be negative, meaning polling completed early. This happens in normal operation,
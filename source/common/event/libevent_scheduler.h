@@ -4,6 +4,7 @@
 #include "envoy/event/timer.h"
 
 #include "common/event/libevent.h"
+#include "common/event/timer_impl.h"
 
 #include "event2/event.h"
 #include "event2/watch.h"
@@ -19,6 +20,12 @@ public:
   // Scheduler
   TimerPtr createTimer(const TimerCb& cb) override;
 
+  /**
+   * @return std::unique_ptr<TimerImpl> a libevent timer, for owners that use more than the Timer
+   *         interface of it.
+   */
+  std::unique_ptr<TimerImpl> createTimerImpl(const TimerCb& cb);
+
   /**
    * Runs the event loop.
    *
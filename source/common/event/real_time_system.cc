@@ -4,6 +4,7 @@
 
 #include "common/common/assert.h"
 #include "common/event/timer_impl.h"
+#include "common/event/timer_wheel.h"
 
 namespace Envoy {
 namespace Event {
@@ -20,7 +21,12 @@ private:
 
 } // namespace
 
+std::chrono::milliseconds RealTimeSystem::timer_wheel_tick_{0};
+
 SchedulerPtr RealTimeSystem::createScheduler(Scheduler& base_scheduler) {
+  if (timer_wheel_tick_.count() > 0) {
+    return std::make_unique<TimerWheel>(base_scheduler, time_source_, timer_wheel_tick_);
+  }
   return std::make_unique<RealScheduler>(base_scheduler);
 }
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+
 #include "envoy/event/timer.h"
 
 #include "common/common/utility.h"
@@ -12,6 +14,14 @@ namespace Event {
  */
 class RealTimeSystem : public TimeSystem {
 public:
+  /**
+   * Select whether dispatchers created from now on keep their timers in a TimerWheel with the
+   * given resolution, instead of directly in the libevent timer heap. This is meant to be set once
+   * at startup.
+   * @param tick supplies the resolution of the wheel, or 0 to use libevent timers.
+   */
+  static void useTimerWheel(std::chrono::milliseconds tick) { timer_wheel_tick_ = tick; }
+
   // TimeSystem
   SchedulerPtr createScheduler(Scheduler&) override;
 
@@ -21,6 +31,8 @@ public:
 
 private:
   RealTimeSource time_source_;
+
+  static std::chrono::milliseconds timer_wheel_tick_;
 };
 
 } // namespace Event
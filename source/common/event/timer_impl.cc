@@ -3,6 +3,7 @@
 #include <chrono>
 
 #include "common/common/assert.h"
+#include "common/event/callback_tracker.h"
 
 #include "event2/event.h"
 
@@ -21,7 +22,12 @@ TimerImpl::TimerImpl(Libevent::BasePtr& libevent, TimerCb cb) : cb_(cb) {
   ASSERT(cb_);
   evtimer_assign(
       &raw_event_, libevent.get(),
-      [](evutil_socket_t, short, void* arg) -> void { static_cast<TimerImpl*>(arg)->cb_(); }, this);
+      [](evutil_socket_t, short, void* arg) -> void {
+        TimerImpl* timer = static_cast<TimerImpl*>(arg);
+        CallbackTracker::Scope scope("timer", timer->cb_);
+        timer->cb_();
+      },
+      this);
 }
 
 void TimerImpl::disableTimer() { event_del(&raw_event_); }
@@ -36,6 +42,13 @@ void TimerImpl::enableTimer(const std::chrono::milliseconds& d) {
   }
 }
 
+void TimerImpl::enableTimerNextIteration() {
+  // libevent moves expired timers to the active list after polling, and runs the events that are
+  // already active before that, so a zero timeout waits for the next poll.
+  timeval tv{};
+  event_add(&raw_event_, &tv);
+}
+
 bool TimerImpl::enabled() { return 0 != evtimer_pending(&raw_event_, nullptr); }
 
 } // namespace Event
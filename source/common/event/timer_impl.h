@@ -30,6 +30,13 @@ public:
   void enableTimer(const std::chrono::milliseconds& d) override;
   bool enabled() override;
 
+  /**
+   * Run the callback on the next iteration of the event loop, once it has polled for I/O. When
+   * called from a callback, enableTimer(0) instead runs it before the current iteration ends, so
+   * this is what work that yields to I/O between batches uses.
+   */
+  void enableTimerNextIteration();
+
 private:
   TimerCb cb_;
 };
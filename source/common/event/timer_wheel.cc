@@ -0,0 +1,295 @@
+#include "common/event/timer_wheel.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+#include "common/event/callback_tracker.h"
+
+namespace Envoy {
+namespace Event {
+
+namespace {
+
+// Durations are capped so that expiry ticks can not overflow. This is more than 30 years.
+constexpr uint64_t MaxDurationMs = uint64_t(1) << 40;
+
+uint64_t rotateRight(uint64_t value, uint32_t bits) {
+  return bits == 0 ? value : (value >> bits) | (value << (64 - bits));
+}
+
+} // namespace
+
+constexpr uint32_t TimerWheel::SlotBits;
+constexpr uint32_t TimerWheel::SlotsPerLevel;
+constexpr uint32_t TimerWheel::Levels;
+
+WheelTimerImpl::WheelTimerImpl(TimerWheel& wheel, TimerCb cb) : wheel_(wheel), cb_(cb) {
+  ASSERT(cb_);
+}
+
+WheelTimerImpl::~WheelTimerImpl() { disableTimer(); }
+
+void WheelTimerImpl::disableTimer() {
+  if (list_ != nullptr) {
+    wheel_.disarm(*this);
+  }
+}
+
+void WheelTimerImpl::enableTimer(const std::chrono::milliseconds& d) { wheel_.arm(*this, d); }
+
+TimerWheel::TimerWheel(Scheduler& base_scheduler, TimeSource& time_source,
+                       std::chrono::milliseconds tick)
+    : time_source_(time_source),
+      tick_ns_(std::chrono::duration_cast<std::chrono::nanoseconds>(tick).count()),
+      start_(time_source.monotonicTime()),
+      driver_(base_scheduler.createTimer([this]() -> void {
+        // The timers the wheel runs are each timed on their own.
+        CallbackTracker::untrackCurrentScope();
+        advance();
+      })) {
+  ASSERT(tick.count() > 0);
+  static_assert(SlotsPerLevel == 64, "occupancy is tracked in one uint64_t per level");
+}
+
+TimerWheel::~TimerWheel() {
+  // Detach the timers that are still armed, so that destroying them later does not touch the
+  // wheel.
+  auto detach = [](List& list) {
+    while (list != nullptr) {
+      unlink(*list);
+    }
+  };
+  for (auto& level : slots_) {
+    for (List& list : level) {
+      detach(list);
+    }
+  }
+  detach(overflow_);
+  detach(ready_);
+}
+
+TimerPtr TimerWheel::createTimer(const TimerCb& cb) {
+  return std::make_unique<WheelTimerImpl>(*this, cb);
+}
+
+void TimerWheel::push(List& list, WheelTimerImpl& timer) {
+  if (list == nullptr) {
+    timer.prev_ = &timer;
+    timer.next_ = &timer;
+    list = &timer;
+  } else {
+    // Append, so that timers that expire on the same tick run in the order they were armed.
+    WheelTimerImpl* tail = list->prev_;
+    timer.prev_ = tail;
+    timer.next_ = list;
+    tail->next_ = &timer;
+    list->prev_ = &timer;
+  }
+  timer.list_ = &list;
+}
+
+void TimerWheel::unlink(WheelTimerImpl& timer) {
+  List& list = *timer.list_;
+  if (timer.next_ == &timer) {
+    list = nullptr;
+  } else {
+    timer.prev_->next_ = timer.next_;
+    timer.next_->prev_ = timer.prev_;
+    if (list == &timer) {
+      list = timer.next_;
+    }
+  }
+  timer.list_ = nullptr;
+  timer.slot_ = -1;
+}
+
+uint64_t TimerWheel::elapsedNs() const {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(time_source_.monotonicTime() -
+                                                              start_)
+      .count();
+}
+
+void TimerWheel::arm(WheelTimerImpl& timer, std::chrono::milliseconds d) {
+  if (timer.list_ != nullptr) {
+    disarm(timer);
+  }
+  size_++;
+
+  if (d.count() <= 0) {
+    push(ready_, timer);
+    if (!advancing_ && driver_tick_ != 0) {
+      driver_tick_ = 0;
+      driver_->enableTimer(std::chrono::milliseconds(0));
+    }
+    return;
+  }
+
+  const uint64_t duration_ns = std::min<uint64_t>(d.count(), MaxDurationMs) * 1000000;
+  const uint64_t expiry_ns = elapsedNs() + duration_ns;
+  // Round up, so that timers never fire early, and never expire on a tick that has already run.
+  timer.expiry_ = std::max((expiry_ns + tick_ns_ - 1) / tick_ns_, current_ + 1);
+  const uint64_t wake = insert(timer);
+  if (!advancing_ && wake < driver_tick_) {
+    armDriver(wake);
+  }
+}
+
+void TimerWheel::disarm(WheelTimerImpl& timer) {
+  ASSERT(timer.list_ != nullptr);
+  const int32_t slot = timer.slot_;
+  List& list = *timer.list_;
+  unlink(timer);
+  if (slot >= 0 && list == nullptr) {
+    occupied_[slot / SlotsPerLevel] &= ~(uint64_t(1) << (slot % SlotsPerLevel));
+  }
+  size_--;
+  // The driver is left armed. If this was the next timer to expire, it wakes up for nothing and
+  // rearms for the next one.
+}
+
+uint64_t TimerWheel::insert(WheelTimerImpl& timer) {
+  // Zero when cascading a timer that expires on the tick being run.
+  const uint64_t delta = timer.expiry_ - current_;
+  for (uint32_t level = 0; level < Levels; level++) {
+    const uint32_t shift = level * SlotBits;
+    if (delta >> (shift + SlotBits) == 0) {
+      const uint32_t slot = (timer.expiry_ >> shift) & (SlotsPerLevel - 1);
+      push(slots_[level][slot], timer);
+      timer.slot_ = level * SlotsPerLevel + slot;
+      occupied_[level] |= uint64_t(1) << slot;
+      return (timer.expiry_ >> shift) << shift;
+    }
+  }
+  push(overflow_, timer);
+  const uint32_t top_shift = Levels * SlotBits;
+  return ((current_ >> top_shift) + 1) << top_shift;
+}
+
+void TimerWheel::cascade(uint32_t level) {
+  const uint32_t shift = level * SlotBits;
+  const uint32_t slot = (current_ >> shift) & (SlotsPerLevel - 1);
+  List& list = slots_[level][slot];
+  // Every timer goes to a lower level, since it expires less than a slot from now.
+  while (list != nullptr) {
+    WheelTimerImpl& timer = *list;
+    unlink(timer);
+    insert(timer);
+  }
+  occupied_[level] &= ~(uint64_t(1) << slot);
+}
+
+void TimerWheel::runList(List& list) {
+  // Move the timers to a list of their own first, so that timers that callbacks arm for the next
+  // loop iteration are not run in this one.
+  List pending = nullptr;
+  while (list != nullptr) {
+    WheelTimerImpl& timer = *list;
+    unlink(timer);
+    push(pending, timer);
+  }
+  while (pending != nullptr) {
+    WheelTimerImpl& timer = *pending;
+    unlink(timer);
+    size_--;
+    CallbackTracker::Scope scope("timer", timer.cb_);
+    timer.cb_();
+  }
+}
+
+uint64_t TimerWheel::nextTick() const {
+  uint64_t next = UINT64_MAX;
+  for (uint32_t level = 0; level < Levels; level++) {
+    if (occupied_[level] == 0) {
+      continue;
+    }
+    // A slot comes up 1 to SlotsPerLevel slots after the current one, which for level 0 is when
+    // its timers expire and for the others when they cascade.
+    const uint32_t shift = level * SlotBits;
+    const uint64_t current_slot = current_ >> shift;
+    const uint64_t rotated =
+        rotateRight(occupied_[level], (current_slot + 1) & (SlotsPerLevel - 1));
+    const uint64_t distance = __builtin_ctzll(rotated) + 1;
+    next = std::min(next, (current_slot + distance) << shift);
+  }
+  if (overflow_ != nullptr) {
+    const uint32_t top_shift = Levels * SlotBits;
+    next = std::min(next, ((current_ >> top_shift) + 1) << top_shift);
+  }
+  return next;
+}
+
+void TimerWheel::advance() {
+  advancing_ = true;
+  driver_tick_ = UINT64_MAX;
+  runList(ready_);
+
+  const uint64_t target = elapsedNs() / tick_ns_;
+  while (current_ < target) {
+    // Skip over the ticks where no slot needs to be looked at.
+    const uint64_t next = nextTick();
+    if (next > target) {
+      current_ = target;
+      break;
+    }
+    current_ = next;
+
+    const uint32_t top_shift = Levels * SlotBits;
+    if (overflow_ != nullptr && (current_ & ((uint64_t(1) << top_shift) - 1)) == 0) {
+      // Re-insert from a list of their own, as timers still out of range go back to overflow_.
+      List overflow = nullptr;
+      while (overflow_ != nullptr) {
+        WheelTimerImpl& timer = *overflow_;
+        unlink(timer);
+        push(overflow, timer);
+      }
+      while (overflow != nullptr) {
+        WheelTimerImpl& timer = *overflow;
+        unlink(timer);
+        insert(timer);
+      }
+    }
+    // Cascade from the top, so that timers moving down several levels end up in the right slot.
+    for (uint32_t level = Levels - 1; level > 0; level--) {
+      if ((current_ & ((uint64_t(1) << (level * SlotBits)) - 1)) == 0) {
+        cascade(level);
+      }
+    }
+
+    const uint32_t slot = current_ & (SlotsPerLevel - 1);
+    runList(slots_[0][slot]);
+    // Callbacks can only arm timers for later ticks, so the slot stays empty.
+    occupied_[0] &= ~(uint64_t(1) << slot);
+  }
+
+  advancing_ = false;
+  scheduleDriver();
+}
+
+void TimerWheel::scheduleDriver() {
+  if (ready_ != nullptr) {
+    driver_tick_ = 0;
+    driver_->enableTimer(std::chrono::milliseconds(0));
+    return;
+  }
+  const uint64_t next = nextTick();
+  if (next == UINT64_MAX) {
+    driver_tick_ = UINT64_MAX;
+    driver_->disableTimer();
+    return;
+  }
+  armDriver(next);
+}
+
+void TimerWheel::armDriver(uint64_t tick) {
+  driver_tick_ = tick;
+  const uint64_t deadline_ns = tick * tick_ns_;
+  const uint64_t elapsed_ns = elapsedNs();
+  // Round up, and keep at least 1ms, as a zero duration makes the driver run right away rather
+  // than once the deadline has passed.
+  const uint64_t wait_ms =
+      deadline_ns > elapsed_ns ? (deadline_ns - elapsed_ns + 999999) / 1000000 : 1;
+  driver_->enableTimer(std::chrono::milliseconds(wait_ms));
+}
+
+} // namespace Event
+} // namespace Envoy
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/common/time.h"
+#include "envoy/event/timer.h"
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Event {
+
+class TimerWheel;
+
+/**
+ * A timer in a TimerWheel. Arming and disarming it takes constant time.
+ */
+class WheelTimerImpl : public Timer, NonCopyable {
+public:
+  WheelTimerImpl(TimerWheel& wheel, TimerCb cb);
+  ~WheelTimerImpl();
+
+  // Timer
+  void disableTimer() override;
+  void enableTimer(const std::chrono::milliseconds& d) override;
+  bool enabled() override { return list_ != nullptr; }
+
+private:
+  friend class TimerWheel;
+
+  TimerWheel& wheel_;
+  const TimerCb cb_;
+  // The tick this timer expires at.
+  uint64_t expiry_{};
+  // The list this timer is on, if it is armed, and its neighbours on it. Lists are circular.
+  WheelTimerImpl** list_{};
+  // The index of the wheel slot the list belongs to, or -1 for other lists.
+  int32_t slot_{-1};
+  WheelTimerImpl* prev_{};
+  WheelTimerImpl* next_{};
+};
+
+/**
+ * A hierarchical timing wheel, which keeps many timers behind a single timer of the base
+ * scheduler. Timers are hashed into slots of Levels wheels of SlotsPerLevel slots each, where
+ * level k holds the timers that expire between SlotsPerLevel^k and SlotsPerLevel^(k+1) ticks from
+ * now. When time reaches the start of a level k slot, its timers move down to lower levels, and
+ * timers in a level 0 slot fire when time reaches it. Timers further out than the top level are
+ * kept on an overflow list that is looked at once per revolution of the top level.
+ *
+ * Arming and disarming a timer is O(1), where the base scheduler's min-heap is O(log n), which
+ * matters for connection and stream timeouts that are re-armed on every read or write. Expiry is
+ * rounded up to the next tick, so a timer fires up to one tick late. Timers armed with a zero
+ * duration run on the next event loop iteration, as they do with the base scheduler.
+ */
+class TimerWheel : public Scheduler, NonCopyable {
+public:
+  static constexpr uint32_t SlotBits = 6;
+  static constexpr uint32_t SlotsPerLevel = 1 << SlotBits;
+  static constexpr uint32_t Levels = 5;
+
+  /**
+   * @param base_scheduler supplies the scheduler of the timer that drives the wheel.
+   * @param time_source supplies the time the wheel advances to.
+   * @param tick supplies the resolution of the wheel, which must be at least 1ms.
+   */
+  TimerWheel(Scheduler& base_scheduler, TimeSource& time_source, std::chrono::milliseconds tick);
+  ~TimerWheel();
+
+  // Scheduler
+  TimerPtr createTimer(const TimerCb& cb) override;
+
+  /**
+   * Run the timers that are due, and the ones armed with a zero duration. This is what the
+   * driving timer does, and is exposed for tests.
+   */
+  void advance();
+
+  /**
+   * @return uint64_t the number of armed timers.
+   */
+  uint64_t size() const { return size_; }
+
+private:
+  friend class WheelTimerImpl;
+
+  typedef WheelTimerImpl* List;
+
+  void arm(WheelTimerImpl& timer, std::chrono::milliseconds d);
+  void disarm(WheelTimerImpl& timer);
+  // Puts the timer in the slot for its expiry relative to the current tick, and returns the tick
+  // at which that slot is looked at.
+  uint64_t insert(WheelTimerImpl& timer);
+  // Moves the timers of a slot down to lower levels.
+  void cascade(uint32_t level);
+  // Runs the timers on the list, which may be armed, disarmed or destroyed by earlier callbacks.
+  void runList(List& list);
+  // Returns the earliest tick at which a slot needs to be looked at.
+  uint64_t nextTick() const;
+  void scheduleDriver();
+  void armDriver(uint64_t tick);
+  uint64_t elapsedNs() const;
+
+  static void push(List& list, WheelTimerImpl& timer);
+  static void unlink(WheelTimerImpl& timer);
+
+  TimeSource& time_source_;
+  const uint64_t tick_ns_;
+  const MonotonicTime start_;
+  const TimerPtr driver_;
+  // The tick up to which timers have run.
+  uint64_t current_{};
+  // The tick the driver is armed for, 0 if it is activated for zero duration timers, or
+  // UINT64_MAX if it is not armed.
+  uint64_t driver_tick_{UINT64_MAX};
+  uint64_t size_{};
+  bool advancing_{};
+  std::array<std::array<List, SlotsPerLevel>, Levels> slots_{};
+  // Bit i is set if slot i of the level is not empty.
+  std::array<uint64_t, Levels> occupied_{};
+  List overflow_{};
+  // Timers armed with a zero duration.
+  List ready_{};
+};
+
+} // namespace Event
+} // namespace Envoy
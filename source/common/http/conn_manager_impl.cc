@@ -41,7 +41,7 @@ namespace Http {
 
 namespace {
 
-template <class T> using FilterList = std::list<std::unique_ptr<T>>;
+template <class T> using FilterList = std::list<ArenaPtr<T>, ArenaAllocator<ArenaPtr<T>>>;
 
 // Shared helper for recording the latest filter used.
 template <class T>
@@ -401,9 +401,14 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
     : connection_manager_(connection_manager),
       snapped_route_config_(connection_manager.config_.routeConfigProvider().config()),
       stream_id_(connection_manager.random_generator_.random()),
+      decoder_filters_(ArenaAllocator<ActiveStreamDecoderFilterPtr>(arena_)),
+      encoder_filters_(ArenaAllocator<ActiveStreamEncoderFilterPtr>(arena_)),
+      access_log_handlers_(ArenaAllocator<AccessLog::InstanceSharedPtr>(arena_)),
       request_response_timespan_(new Stats::Timespan(
           connection_manager_.stats_.named_.downstream_rq_time_, connection_manager_.timeSource())),
       stream_info_(connection_manager_.codec_->protocol(), connection_manager_.timeSource()),
+      watermark_callbacks_(ArenaAllocator<DownstreamWatermarkCallbacks*>(arena_)),
+      spare_watermark_callbacks_(ArenaAllocator<DownstreamWatermarkCallbacks*>(arena_)),
       upstream_options_(std::make_shared<Network::Socket::Options>()) {
   connection_manager_.stats_.named_.downstream_rq_total_.inc();
   connection_manager_.stats_.named_.downstream_rq_active_.inc();
@@ -511,14 +516,16 @@ void ConnectionManagerImpl::ActiveStream::onRequestTimeout() {
 
 void ConnectionManagerImpl::ActiveStream::addStreamDecoderFilterWorker(
     StreamDecoderFilterSharedPtr filter, bool dual_filter) {
-  ActiveStreamDecoderFilterPtr wrapper(new ActiveStreamDecoderFilter(*this, filter, dual_filter));
+  ActiveStreamDecoderFilterPtr wrapper =
+      arena_.create<ActiveStreamDecoderFilter>(*this, filter, dual_filter);
   filter->setDecoderFilterCallbacks(*wrapper);
   wrapper->moveIntoListBack(std::move(wrapper), decoder_filters_);
 }
 
 void ConnectionManagerImpl::ActiveStream::addStreamEncoderFilterWorker(
     StreamEncoderFilterSharedPtr filter, bool dual_filter) {
-  ActiveStreamEncoderFilterPtr wrapper(new ActiveStreamEncoderFilter(*this, filter, dual_filter));
+  ActiveStreamEncoderFilterPtr wrapper =
+      arena_.create<ActiveStreamEncoderFilter>(*this, filter, dual_filter);
   filter->setEncoderFilterCallbacks(*wrapper);
   wrapper->moveIntoList(std::move(wrapper), encoder_filters_);
 }
@@ -823,9 +830,9 @@ void ConnectionManagerImpl::ActiveStream::traceRequest() {
 void ConnectionManagerImpl::ActiveStream::decodeHeaders(ActiveStreamDecoderFilter* filter,
                                                         HeaderMap& headers, bool end_stream) {
   // Headers filter iteration should always start with the next filter if available.
-  std::list<ActiveStreamDecoderFilterPtr>::iterator entry =
+  ActiveStreamDecoderFilterList::iterator entry =
       commonDecodePrefix(filter, FilterIterationStartState::AlwaysStartFromNext);
-  std::list<ActiveStreamDecoderFilterPtr>::iterator continue_data_entry = decoder_filters_.end();
+  ActiveStreamDecoderFilterList::iterator continue_data_entry = decoder_filters_.end();
 
   for (; entry != decoder_filters_.end(); entry++) {
     ASSERT(!(state_.filter_call_state_ & FilterCallState::DecodeHeaders));
@@ -895,7 +902,7 @@ void ConnectionManagerImpl::ActiveStream::decodeData(
   auto trailers_added_entry = decoder_filters_.end();
   const bool trailers_exists_at_start = request_trailers_ != nullptr;
   // Filter iteration may start at the current filter.
-  std::list<ActiveStreamDecoderFilterPtr>::iterator entry =
+  ActiveStreamDecoderFilterList::iterator entry =
       commonDecodePrefix(filter, filter_iteration_start_state);
 
   for (; entry != decoder_filters_.end(); entry++) {
@@ -1037,7 +1044,7 @@ void ConnectionManagerImpl::ActiveStream::decodeTrailers(ActiveStreamDecoderFilt
   }
 
   // Filter iteration may start at the current filter.
-  std::list<ActiveStreamDecoderFilterPtr>::iterator entry =
+  ActiveStreamDecoderFilterList::iterator entry =
       commonDecodePrefix(filter, FilterIterationStartState::CanStartFromCurrent);
 
   for (; entry != decoder_filters_.end(); entry++) {
@@ -1076,7 +1083,7 @@ void ConnectionManagerImpl::ActiveStream::disarmRequestTimeout() {
   }
 }
 
-std::list<ConnectionManagerImpl::ActiveStreamEncoderFilterPtr>::iterator
+ConnectionManagerImpl::ActiveStreamEncoderFilterList::iterator
 ConnectionManagerImpl::ActiveStream::commonEncodePrefix(
     ActiveStreamEncoderFilter* filter, bool end_stream,
     FilterIterationStartState filter_iteration_start_state) {
@@ -1097,7 +1104,7 @@ ConnectionManagerImpl::ActiveStream::commonEncodePrefix(
   return std::next(filter->entry());
 }
 
-std::list<ConnectionManagerImpl::ActiveStreamDecoderFilterPtr>::iterator
+ConnectionManagerImpl::ActiveStreamDecoderFilterList::iterator
 ConnectionManagerImpl::ActiveStream::commonDecodePrefix(
     ActiveStreamDecoderFilter* filter, FilterIterationStartState filter_iteration_start_state) {
   if (!filter) {
@@ -1180,7 +1187,7 @@ void ConnectionManagerImpl::ActiveStream::encode100ContinueHeaders(
   // end-stream, and because there are normal headers coming there's no need for
   // complex continuation logic.
   // 100-continue filter iteration should always start with the next filter if available.
-  std::list<ActiveStreamEncoderFilterPtr>::iterator entry =
+  ActiveStreamEncoderFilterList::iterator entry =
       commonEncodePrefix(filter, false, FilterIterationStartState::AlwaysStartFromNext);
   for (; entry != encoder_filters_.end(); entry++) {
     ASSERT(!(state_.filter_call_state_ & FilterCallState::Encode100ContinueHeaders));
@@ -1213,9 +1220,9 @@ void ConnectionManagerImpl::ActiveStream::encodeHeaders(ActiveStreamEncoderFilte
   disarmRequestTimeout();
 
   // Headers filter iteration should always start with the next filter if available.
-  std::list<ActiveStreamEncoderFilterPtr>::iterator entry =
+  ActiveStreamEncoderFilterList::iterator entry =
       commonEncodePrefix(filter, end_stream, FilterIterationStartState::AlwaysStartFromNext);
-  std::list<ActiveStreamEncoderFilterPtr>::iterator continue_data_entry = encoder_filters_.end();
+  ActiveStreamEncoderFilterList::iterator continue_data_entry = encoder_filters_.end();
 
   for (; entry != encoder_filters_.end(); entry++) {
     ASSERT(!(state_.filter_call_state_ & FilterCallState::EncodeHeaders));
@@ -1361,7 +1368,7 @@ void ConnectionManagerImpl::ActiveStream::encodeMetadata(ActiveStreamEncoderFilt
 
   // Metadata currently go through all filters.
   ASSERT(filter == nullptr);
-  std::list<ActiveStreamEncoderFilterPtr>::iterator entry = encoder_filters_.begin();
+  ActiveStreamEncoderFilterList::iterator entry = encoder_filters_.begin();
   for (; entry != encoder_filters_.end(); entry++) {
     FilterMetadataStatus status = (*entry)->handle_->encodeMetadata(*metadata_map_ptr);
     ENVOY_STREAM_LOG(trace, "encode metadata called: filter={} status={}", *this,
@@ -1421,7 +1428,7 @@ void ConnectionManagerImpl::ActiveStream::encodeData(
   }
 
   // Filter iteration may start at the current filter.
-  std::list<ActiveStreamEncoderFilterPtr>::iterator entry =
+  ActiveStreamEncoderFilterList::iterator entry =
       commonEncodePrefix(filter, end_stream, filter_iteration_start_state);
   auto trailers_added_entry = encoder_filters_.end();
 
@@ -1496,7 +1503,7 @@ void ConnectionManagerImpl::ActiveStream::encodeTrailers(ActiveStreamEncoderFilt
   }
 
   // Filter iteration may start at the current filter.
-  std::list<ActiveStreamEncoderFilterPtr>::iterator entry =
+  ActiveStreamEncoderFilterList::iterator entry =
       commonEncodePrefix(filter, true, FilterIterationStartState::CanStartFromCurrent);
   for (; entry != encoder_filters_.end(); entry++) {
     // If the filter pointed by entry has stopped for all frame type, return now.
@@ -1932,16 +1939,28 @@ void ConnectionManagerImpl::ActiveStreamDecoderFilter::addDownstreamWatermarkCal
   // expect the same callbacks to not be registered twice.
   ASSERT(std::find(parent_.watermark_callbacks_.begin(), parent_.watermark_callbacks_.end(),
                    &watermark_callbacks) == parent_.watermark_callbacks_.end());
-  parent_.watermark_callbacks_.emplace(parent_.watermark_callbacks_.end(), &watermark_callbacks);
+  if (parent_.spare_watermark_callbacks_.empty()) {
+    parent_.watermark_callbacks_.emplace_back(&watermark_callbacks);
+  } else {
+    parent_.watermark_callbacks_.splice(parent_.watermark_callbacks_.end(),
+                                        parent_.spare_watermark_callbacks_,
+                                        parent_.spare_watermark_callbacks_.begin());
+    parent_.watermark_callbacks_.back() = &watermark_callbacks;
+  }
   for (uint32_t i = 0; i < parent_.high_watermark_count_; ++i) {
     watermark_callbacks.onAboveWriteBufferHighWatermark();
   }
 }
 void ConnectionManagerImpl::ActiveStreamDecoderFilter::removeDownstreamWatermarkCallbacks(
     DownstreamWatermarkCallbacks& watermark_callbacks) {
-  ASSERT(std::find(parent_.watermark_callbacks_.begin(), parent_.watermark_callbacks_.end(),
-                   &watermark_callbacks) != parent_.watermark_callbacks_.end());
-  parent_.watermark_callbacks_.remove(&watermark_callbacks);
+  auto it = std::find(parent_.watermark_callbacks_.begin(), parent_.watermark_callbacks_.end(),
+                      &watermark_callbacks);
+  ASSERT(it != parent_.watermark_callbacks_.end());
+  if (it != parent_.watermark_callbacks_.end()) {
+    // Keep the node for the next callbacks rather than leaving it to the arena.
+    parent_.spare_watermark_callbacks_.splice(parent_.spare_watermark_callbacks_.begin(),
+                                              parent_.watermark_callbacks_, it);
+  }
 }
 
 bool ConnectionManagerImpl::ActiveStreamDecoderFilter::recreateStream() {
@@ -26,6 +26,7 @@
 #include "envoy/upstream/upstream.h"
 
 #include "common/buffer/watermark_buffer.h"
+#include "common/common/arena.h"
 #include "common/common/linked_object.h"
 #include "common/grpc/common.h"
 #include "common/http/conn_manager_config.h"
@@ -172,12 +173,18 @@ private:
     const bool dual_filter_ : 1;
   };
 
+  struct ActiveStreamDecoderFilter;
+  typedef ArenaPtr<ActiveStreamDecoderFilter> ActiveStreamDecoderFilterPtr;
+  typedef std::list<ActiveStreamDecoderFilterPtr, ArenaAllocator<ActiveStreamDecoderFilterPtr>>
+      ActiveStreamDecoderFilterList;
+
   /**
    * Wrapper for a stream decoder filter.
    */
-  struct ActiveStreamDecoderFilter : public ActiveStreamFilterBase,
-                                     public StreamDecoderFilterCallbacks,
-                                     LinkedObject<ActiveStreamDecoderFilter> {
+  struct ActiveStreamDecoderFilter
+      : public ActiveStreamFilterBase,
+        public StreamDecoderFilterCallbacks,
+        LinkedObject<ActiveStreamDecoderFilter, ActiveStreamDecoderFilterList> {
     ActiveStreamDecoderFilter(ActiveStream& parent, StreamDecoderFilterSharedPtr filter,
                               bool dual_filter)
         : ActiveStreamFilterBase(parent, dual_filter), handle_(filter) {}
@@ -269,14 +276,18 @@ private:
     bool is_grpc_request_{};
   };
 
-  typedef std::unique_ptr<ActiveStreamDecoderFilter> ActiveStreamDecoderFilterPtr;
+  struct ActiveStreamEncoderFilter;
+  typedef ArenaPtr<ActiveStreamEncoderFilter> ActiveStreamEncoderFilterPtr;
+  typedef std::list<ActiveStreamEncoderFilterPtr, ArenaAllocator<ActiveStreamEncoderFilterPtr>>
+      ActiveStreamEncoderFilterList;
 
   /**
    * Wrapper for a stream encoder filter.
    */
-  struct ActiveStreamEncoderFilter : public ActiveStreamFilterBase,
-                                     public StreamEncoderFilterCallbacks,
-                                     LinkedObject<ActiveStreamEncoderFilter> {
+  struct ActiveStreamEncoderFilter
+      : public ActiveStreamFilterBase,
+        public StreamEncoderFilterCallbacks,
+        LinkedObject<ActiveStreamEncoderFilter, ActiveStreamEncoderFilterList> {
     ActiveStreamEncoderFilter(ActiveStream& parent, StreamEncoderFilterSharedPtr filter,
                               bool dual_filter)
         : ActiveStreamFilterBase(parent, dual_filter), handle_(filter) {}
@@ -322,8 +333,6 @@ private:
     StreamEncoderFilterSharedPtr handle_;
   };
 
-  typedef std::unique_ptr<ActiveStreamEncoderFilter> ActiveStreamEncoderFilterPtr;
-
   /**
    * Wraps a single active stream on the connection. These are either full request/response pairs
    * or pushes.
@@ -344,11 +353,11 @@ private:
     void addStreamEncoderFilterWorker(StreamEncoderFilterSharedPtr filter, bool dual_filter);
     void chargeStats(const HeaderMap& headers);
     // Returns the encoder filter to start iteration with.
-    std::list<ActiveStreamEncoderFilterPtr>::iterator
+    ActiveStreamEncoderFilterList::iterator
     commonEncodePrefix(ActiveStreamEncoderFilter* filter, bool end_stream,
                        FilterIterationStartState filter_iteration_start_state);
     // Returns the decoder filter to start iteration with.
-    std::list<ActiveStreamDecoderFilterPtr>::iterator
+    ActiveStreamDecoderFilterList::iterator
     commonDecodePrefix(ActiveStreamDecoderFilter* filter,
                        FilterIterationStartState filter_iteration_start_state);
     const Network::Connection* connection();
@@ -501,9 +510,13 @@ private:
     HeaderMapPtr request_headers_;
     Buffer::WatermarkBufferPtr buffered_request_data_;
     HeaderMapPtr request_trailers_;
-    std::list<ActiveStreamDecoderFilterPtr> decoder_filters_;
-    std::list<ActiveStreamEncoderFilterPtr> encoder_filters_;
-    std::list<AccessLog::InstanceSharedPtr> access_log_handlers_;
+    // Holds the filter wrappers and the nodes of the lists below, so that setting up the filter
+    // chain usually needs no heap allocation beyond the stream itself. It must outlive them.
+    InlineArena<1024> arena_;
+    ActiveStreamDecoderFilterList decoder_filters_;
+    ActiveStreamEncoderFilterList encoder_filters_;
+    std::list<AccessLog::InstanceSharedPtr, ArenaAllocator<AccessLog::InstanceSharedPtr>>
+        access_log_handlers_;
     Stats::TimespanPtr request_response_timespan_;
     // Per-stream idle timeout.
     Event::TimerPtr stream_idle_timer_;
@@ -514,7 +527,12 @@ private:
     StreamInfo::StreamInfoImpl stream_info_;
     absl::optional<Router::RouteConstSharedPtr> cached_route_;
     absl::optional<Upstream::ClusterInfoConstSharedPtr> cached_cluster_info_;
-    std::list<DownstreamWatermarkCallbacks*> watermark_callbacks_{};
+    std::list<DownstreamWatermarkCallbacks*, ArenaAllocator<DownstreamWatermarkCallbacks*>>
+        watermark_callbacks_;
+    // The nodes of removed watermark callbacks, which are reused for the next ones. The router
+    // adds callbacks for every retry and hedge, and arena memory is only released with the stream.
+    std::list<DownstreamWatermarkCallbacks*, ArenaAllocator<DownstreamWatermarkCallbacks*>>
+        spare_watermark_callbacks_;
     uint32_t buffer_limit_{0};
     uint32_t high_watermark_count_{0};
     const std::string* decorated_operation_{nullptr};
@@ -246,6 +246,14 @@ void HeaderString::setReference(const std::string& ref_value) {
   ASSERT(valid());
 }
 
+void HeaderString::setReference(absl::string_view ref_value) {
+  freeDynamic();
+  type_ = Type::Reference;
+  buffer_.ref_ = ref_value.data();
+  string_length_ = ref_value.size();
+  ASSERT(valid());
+}
+
 // Specialization needed for HeaderMapImpl::HeaderList::insert() when key is LowerCaseString.
 // A fully specialized template must be defined once in the program, hence this may not be in
 // a header file.
@@ -451,6 +459,14 @@ void HeaderMapImpl::setReferenceKey(const LowerCaseString& key, const std::strin
   ASSERT(new_value.empty()); // NOLINT(bugprone-use-after-move)
 }
 
+void HeaderMapImpl::pinMemory(const std::shared_ptr<const void>& memory, uint64_t size) {
+  if (!pinned_memory_.empty() && pinned_memory_.back() == memory) {
+    return;
+  }
+  pinned_memory_.push_back(memory);
+  pinned_byte_size_ += size;
+}
+
 uint64_t HeaderMapImpl::byteSize() const {
   uint64_t byte_size = 0;
   for (const HeaderEntryImpl& header : headers_) {
@@ -5,6 +5,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/http/header_map.h"
 
@@ -56,6 +57,21 @@ public:
    */
   void addViaMove(HeaderString&& key, HeaderString&& value);
 
+  /**
+   * Keep memory alive for the lifetime of the map. This allows a codec to add header values that
+   * reference received data in place (see HeaderString::setReference()) instead of copying it.
+   * Pinning the memory most recently pinned again is a no-op.
+   * @param memory supplies the owner of the memory. The memory must not be modified while pinned.
+   * @param size supplies the number of bytes the owner keeps alive.
+   */
+  void pinMemory(const std::shared_ptr<const void>& memory, uint64_t size);
+
+  /**
+   * @return uint64_t the number of bytes kept alive via pinMemory(). This may be considerably more
+   *         than the bytes referenced by header values.
+   */
+  uint64_t pinnedByteSize() const { return pinned_byte_size_; }
+
   /**
    * For testing. Equality is based on equality of the backing list. This is an exact match
    * comparison (order matters).
@@ -197,6 +213,8 @@ protected:
 
   AllInlineHeaders inline_headers_;
   HeaderList headers_;
+  std::vector<std::shared_ptr<const void>> pinned_memory_;
+  uint64_t pinned_byte_size_{};
 
   ALL_INLINE_HEADERS(DEFINE_INLINE_HEADER_FUNCS)
 };
@@ -20,6 +20,12 @@ namespace Envoy {
 namespace Http {
 namespace Http1 {
 
+namespace {
+// Header values up to this size fit in the inline storage of a HeaderString and are copied. Larger
+// values reference the received data to avoid a heap allocation.
+constexpr size_t MaxCopiedHeaderValueSize = 128;
+} // namespace
+
 const std::string StreamEncoderImpl::CRLF = "\r\n";
 const std::string StreamEncoderImpl::LAST_CHUNK = "0\r\n\r\n";
 
@@ -321,21 +327,66 @@ const ToLowerTable& ConnectionImpl::toLowerTable() {
 
 ConnectionImpl::ConnectionImpl(Network::Connection& connection, http_parser_type type,
                                uint32_t max_headers_kb)
-    : connection_(connection), output_buffer_([&]() -> void { this->onBelowLowWatermark(); },
-                                              [&]() -> void { this->onAboveHighWatermark(); }),
+    : connection_(connection), pinned_bytes_account_(std::make_shared<PinnedBytesAccount>(*this)),
+      output_buffer_([&]() -> void { this->onBelowLowWatermark(); },
+                     [&]() -> void { this->onAboveHighWatermark(); }),
       max_headers_kb_(max_headers_kb) {
   output_buffer_.setWatermarks(connection.bufferLimit());
   http_parser_init(&parser_, type);
   parser_.data = this;
 }
 
+ConnectionImpl::~ConnectionImpl() { pinned_bytes_account_->connection_ = nullptr; }
+
+bool ConnectionImpl::PinnedBytesAccount::connectionOpen() {
+  if (connection_ != nullptr &&
+      connection_->connection_.state() != Network::Connection::State::Open) {
+    // Reading is neither needed nor allowed to be enabled again on a closing connection.
+    connection_ = nullptr;
+  }
+  return connection_ != nullptr;
+}
+
+void ConnectionImpl::PinnedBytesAccount::charge(uint64_t bytes) {
+  bytes_ += bytes;
+  if (read_disabled_ || !connectionOpen()) {
+    return;
+  }
+  const uint32_t limit = connection_->bufferLimit();
+  if (limit > 0 && bytes_ > limit) {
+    read_disabled_ = true;
+    connection_->readDisable(true);
+  }
+}
+
+void ConnectionImpl::PinnedBytesAccount::release(uint64_t bytes) {
+  ASSERT(bytes_ >= bytes);
+  bytes_ -= bytes;
+  if (!read_disabled_ || !connectionOpen()) {
+    return;
+  }
+  if (bytes_ <= connection_->bufferLimit() / 2) {
+    read_disabled_ = false;
+    connection_->readDisable(false);
+  }
+}
+
 void ConnectionImpl::completeLastHeader() {
   ENVOY_CONN_LOG(trace, "completed header: key={} value={}", connection_,
-                 current_header_field_.getStringView(), current_header_value_.getStringView());
+                 current_header_field_.getStringView(), currentHeaderValue());
   if (!current_header_field_.empty()) {
+    current_header_map_byte_size_ += current_header_field_.size() + currentHeaderValue().size();
     toLowerTable().toLowerCase(current_header_field_.buffer(), current_header_field_.size());
-    current_header_map_->addViaMove(std::move(current_header_field_),
-                                    std::move(current_header_value_));
+    if (!current_header_value_reference_.empty()) {
+      // The slice holding the value was pinned by the header map when the value was received.
+      HeaderString value;
+      value.setReference(current_header_value_reference_);
+      current_header_value_reference_ = {};
+      current_header_map_->addViaMove(std::move(current_header_field_), std::move(value));
+    } else {
+      current_header_map_->addViaMove(std::move(current_header_field_),
+                                      std::move(current_header_value_));
+    }
   }
 
   header_parsing_state_ = HeaderParsingState::Field;
@@ -374,18 +425,23 @@ void ConnectionImpl::dispatch(Buffer::Instance& data) {
 
   ssize_t total_parsed = 0;
   if (data.length() > 0) {
+    // Header values may reference the data in place, by pinning the slice holding them, which
+    // only the slices of an OwnedImpl allow.
+    dispatch_buffer_ = dynamic_cast<Buffer::OwnedImpl*>(&data);
+
     uint64_t num_slices = data.getRawSlices(nullptr, 0);
     STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
     data.getRawSlices(slices.begin(), num_slices);
     for (const Buffer::RawSlice& slice : slices) {
       total_parsed += dispatchSlice(static_cast<const char*>(slice.mem_), slice.len_);
     }
+    dispatch_buffer_ = nullptr;
+    data.drain(total_parsed);
   } else {
     dispatchSlice(nullptr, 0);
   }
 
   ENVOY_CONN_LOG(trace, "parsed {} bytes", connection_, total_parsed);
-  data.drain(total_parsed);
 
   // If an upgrade has been handled and there is body data or early upgrade
   // payload to send on, send it on.
@@ -393,14 +449,50 @@ void ConnectionImpl::dispatch(Buffer::Instance& data) {
 }
 
 size_t ConnectionImpl::dispatchSlice(const char* slice, size_t len) {
-  ssize_t rc = http_parser_execute(&parser_, &settings_, slice, len);
+  size_t fast_parsed = 0;
+  if (fast_request_parsing_ && parser_at_message_start_ && HTTP_PARSER_ERRNO(&parser_) == HPE_OK) {
+    fast_parsed = dispatchFastRequest(slice, len);
+    // A length of zero would tell http_parser that the connection was closed.
+    if (fast_parsed == len || HTTP_PARSER_ERRNO(&parser_) == HPE_PAUSED) {
+      return fast_parsed;
+    }
+  }
+
+  ssize_t rc = http_parser_execute(&parser_, &settings_, slice + fast_parsed, len - fast_parsed);
   if (HTTP_PARSER_ERRNO(&parser_) != HPE_OK && HTTP_PARSER_ERRNO(&parser_) != HPE_PAUSED) {
     sendProtocolError();
     throw CodecProtocolException("http/1.1 protocol error: " +
                                  std::string(http_errno_name(HTTP_PARSER_ERRNO(&parser_))));
   }
 
-  return rc;
+  return fast_parsed + rc;
+}
+
+size_t ConnectionImpl::dispatchFastRequest(const char* slice, size_t len) {
+  if (!FastRequestParser::parse(absl::string_view(slice, len), fast_request_)) {
+    return 0;
+  }
+  ENVOY_CONN_LOG(trace, "fast parsed {} byte request", connection_, fast_request_.size_);
+
+  // Leave http_parser as it would be after parsing the same request, for the code that reads the
+  // message from it.
+  parser_.method = fast_request_.method_;
+  parser_.http_major = 1;
+  parser_.http_minor = 1;
+  parser_.flags = fast_request_.keep_alive_header_ ? F_CONNECTION_KEEP_ALIVE : 0;
+  parser_.content_length = ULLONG_MAX;
+
+  onMessageBeginBase();
+  onUrl(fast_request_.url_.data(), fast_request_.url_.size());
+  for (const FastRequestParser::Header& header : fast_request_.headers_) {
+    onHeaderField(header.field_.data(), header.field_.size());
+    // Empty values are reported too, as http_parser does, so that the next field starts anew.
+    onHeaderValue(header.value_.data(), header.value_.size());
+  }
+  // Accepted requests have no body, so they are complete with their headers.
+  onHeadersCompleteBase();
+  onMessageCompleteBase();
+  return fast_request_.size_;
 }
 
 void ConnectionImpl::onHeaderField(const char* data, size_t length) {
@@ -430,10 +522,22 @@ void ConnectionImpl::onHeaderValue(const char* data, size_t length) {
   }
 
   header_parsing_state_ = HeaderParsingState::Value;
-  current_header_value_.append(data, length);
+  if (length > MaxCopiedHeaderValueSize && current_header_value_.empty() &&
+      current_header_value_reference_.empty() && pinReceivedData(data)) {
+    // Reference the value in place rather than copy it to the heap. If more of the value arrives
+    // in a later callback it is copied after all.
+    current_header_value_reference_ = absl::string_view(data, length);
+  } else {
+    if (!current_header_value_reference_.empty()) {
+      current_header_value_.append(current_header_value_reference_.data(),
+                                   current_header_value_reference_.size());
+      current_header_value_reference_ = {};
+    }
+    current_header_value_.append(data, length);
+  }
 
   const uint32_t total =
-      current_header_field_.size() + current_header_value_.size() + current_header_map_->byteSize();
+      current_header_field_.size() + currentHeaderValue().size() + current_header_map_byte_size_;
   if (total > (max_headers_kb_ * 1024)) {
     error_code_ = Http::Code::RequestHeaderFieldsTooLarge;
     sendProtocolError();
@@ -441,6 +545,23 @@ void ConnectionImpl::onHeaderValue(const char* data, size_t length) {
   }
 }
 
+bool ConnectionImpl::pinReceivedData(const char* data) {
+  if (dispatch_buffer_ == nullptr) {
+    return false;
+  }
+  std::shared_ptr<const Buffer::Slice> slice = dispatch_buffer_->shareSlice(data);
+  if (slice == nullptr) {
+    return false;
+  }
+  // Values received in the same slice share the pin, which the header map then holds once.
+  if (current_pinned_slice_ == nullptr || current_pinned_slice_->slice_ != slice) {
+    current_pinned_slice_ = std::make_shared<PinnedSlice>(std::move(slice), pinned_bytes_account_);
+    uncharged_pinned_slices_.emplace_back(current_pinned_slice_);
+  }
+  current_header_map_->pinMemory(current_pinned_slice_, current_pinned_slice_->size_);
+  return true;
+}
+
 int ConnectionImpl::onHeadersCompleteBase() {
   ENVOY_CONN_LOG(trace, "headers complete", connection_);
   completeLastHeader();
@@ -456,6 +577,7 @@ int ConnectionImpl::onHeadersCompleteBase() {
 
   int rc = onHeadersComplete(std::move(current_header_map_));
   current_header_map_.reset();
+  current_pinned_slice_.reset();
   header_parsing_state_ = HeaderParsingState::Done;
 
   // Returning 2 informs http_parser to not expect a body or further data on this connection.
@@ -472,13 +594,29 @@ void ConnectionImpl::onMessageCompleteBase() {
     http_parser_pause(&parser_, 1);
     return;
   }
+  // http_parser moves on to the next message, unless this one ends the connection.
+  parser_at_message_start_ = http_should_keep_alive(&parser_);
   onMessageComplete();
+
+  // From now on the received data still pinned by the message holds back the ones that follow.
+  // This is done after onMessageComplete(), which may undo the read disables of the stream.
+  for (const std::weak_ptr<PinnedSlice>& weak_slice : uncharged_pinned_slices_) {
+    std::shared_ptr<PinnedSlice> slice = weak_slice.lock();
+    if (slice != nullptr) {
+      slice->charge();
+    }
+  }
+  uncharged_pinned_slices_.clear();
 }
 
 void ConnectionImpl::onMessageBeginBase() {
   ENVOY_CONN_LOG(trace, "message begin", connection_);
   ASSERT(!current_header_map_);
   current_header_map_ = std::make_unique<HeaderMapImpl>();
+  current_pinned_slice_.reset();
+  uncharged_pinned_slices_.clear();
+  parser_at_message_start_ = false;
+  current_header_map_byte_size_ = 0;
   header_parsing_state_ = HeaderParsingState::Field;
   onMessageBegin();
 }
@@ -493,7 +631,9 @@ ServerConnectionImpl::ServerConnectionImpl(Network::Connection& connection,
                                            ServerConnectionCallbacks& callbacks,
                                            Http1Settings settings, uint32_t max_request_headers_kb)
     : ConnectionImpl(connection, HTTP_REQUEST, max_request_headers_kb), callbacks_(callbacks),
-      codec_settings_(settings) {}
+      codec_settings_(settings) {
+  fast_request_parsing_ = codec_settings_.fast_request_parsing_;
+}
 
 void ServerConnectionImpl::onEncodeComplete() {
   ASSERT(active_request_);
@@ -753,6 +893,7 @@ void ClientConnectionImpl::onMessageComplete() {
       while (!connection_.readEnabled()) {
         connection_.readDisable(false);
       }
+      onReadDisablesUnwound();
     }
 
     if (deferred_end_stream_headers_) {
@@ -7,6 +7,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/http/codec.h"
 #include "envoy/network/connection.h"
@@ -17,6 +18,7 @@
 #include "common/http/codec_helper.h"
 #include "common/http/codes.h"
 #include "common/http/header_map_impl.h"
+#include "common/http/http1/fast_request_parser.h"
 
 namespace Envoy {
 namespace Http {
@@ -174,23 +176,99 @@ public:
 protected:
   ConnectionImpl(Network::Connection& connection, http_parser_type type,
                  uint32_t max_request_headers_kb);
+  ~ConnectionImpl();
 
   bool resetStreamCalled() { return reset_stream_called_; }
 
+  /**
+   * Called after all read disables of the connection were undone, including the one for pinned
+   * bytes, if any.
+   */
+  void onReadDisablesUnwound() { pinned_bytes_account_->read_disabled_ = false; }
+
   Network::Connection& connection_;
   http_parser parser_;
   HeaderMapPtr deferred_end_stream_headers_;
   Http::Code error_code_{Http::Code::BadRequest};
   bool handling_upgrade_{};
+  // Whether complete request heads are handed to FastRequestParser before http_parser.
+  bool fast_request_parsing_{};
 
 private:
   enum class HeaderParsingState { Field, Value, Done };
 
+  /**
+   * Accounts for the received bytes that header maps keep alive by referencing values in place,
+   * which are no longer in the read buffer of the connection once parsed. While they are above the
+   * buffer limit of the connection, reading from it is disabled, as it would be if they were still
+   * buffered. Only complete messages are charged, so that a message is never held back by its own
+   * headers while the rest of it is still to be read.
+   */
+  struct PinnedBytesAccount {
+    PinnedBytesAccount(ConnectionImpl& connection) : connection_(&connection) {}
+
+    void charge(uint64_t bytes);
+    void release(uint64_t bytes);
+
+    /**
+     * @return whether reading from the connection can still be disabled and enabled again. Forgets
+     *         the connection once it is no longer open.
+     */
+    bool connectionOpen();
+
+    // Reset when the codec is destroyed or the connection closed, as header maps may outlive both.
+    ConnectionImpl* connection_;
+    uint64_t bytes_{};
+    bool read_disabled_{};
+  };
+
+  /**
+   * A received slice pinned by a header map, charged to the account once the message it belongs to
+   * is complete and for as long as it is pinned after that.
+   */
+  struct PinnedSlice {
+    PinnedSlice(std::shared_ptr<const Buffer::Slice>&& slice,
+                const std::shared_ptr<PinnedBytesAccount>& account)
+        : slice_(std::move(slice)), size_(slice_->dataSize()), account_(account) {}
+    ~PinnedSlice() {
+      if (charged_) {
+        account_->release(size_);
+      }
+    }
+
+    void charge() {
+      ASSERT(!charged_);
+      charged_ = true;
+      account_->charge(size_);
+    }
+
+    const std::shared_ptr<const Buffer::Slice> slice_;
+    const uint64_t size_;
+    const std::shared_ptr<PinnedBytesAccount> account_;
+    bool charged_{};
+  };
+
   /**
    * Called in order to complete an in progress header decode.
    */
   void completeLastHeader();
 
+  /**
+   * Pin the received slice holding data in current_header_map_, so that a header value can
+   * reference it in place.
+   * @param data supplies a pointer into the data being dispatched.
+   * @return bool whether the slice was pinned.
+   */
+  bool pinReceivedData(const char* data);
+
+  /**
+   * @return the value of the header currently being parsed.
+   */
+  absl::string_view currentHeaderValue() const {
+    return current_header_value_reference_.empty() ? current_header_value_.getStringView()
+                                                   : current_header_value_reference_;
+  }
+
   /**
    * Dispatch a memory span.
    * @param slice supplies the start address.
@@ -198,6 +276,15 @@ private:
    */
   size_t dispatchSlice(const char* slice, size_t len);
 
+  /**
+   * Dispatch a request at the start of a memory span with FastRequestParser, through the same
+   * callbacks as http_parser would.
+   * @param slice supplies the start address.
+   * @param len supplies the length of the span.
+   * @return size_t the size of the dispatched request, or 0 if it was left to http_parser.
+   */
+  size_t dispatchFastRequest(const char* slice, size_t len);
+
   /**
    * Called when a request/response is beginning. A base routine happens first then a virtual
    * dispatch is invoked.
@@ -273,9 +360,27 @@ private:
   static const ToLowerTable& toLowerTable();
 
   HeaderMapImplPtr current_header_map_;
+  // Running size of the completed headers in current_header_map_, so that the header size limit
+  // can be checked on every header callback without walking the whole map. Coalesced headers are
+  // counted without their separators; the connection manager does the exact check on the
+  // complete map.
+  uint32_t current_header_map_byte_size_{};
   HeaderParsingState header_parsing_state_{HeaderParsingState::Field};
   HeaderString current_header_field_;
   HeaderString current_header_value_;
+  // Set instead of current_header_value_ when the value references received data in place.
+  absl::string_view current_header_value_reference_;
+  // The data being parsed for the duration of dispatch(), if its slices can be shared.
+  Buffer::OwnedImpl* dispatch_buffer_{};
+  // The received slice that current_header_map_ pinned last.
+  std::shared_ptr<PinnedSlice> current_pinned_slice_;
+  // The slices pinned by the message being parsed, charged to the account when it completes.
+  std::vector<std::weak_ptr<PinnedSlice>> uncharged_pinned_slices_;
+  const std::shared_ptr<PinnedBytesAccount> pinned_bytes_account_;
+  // Whether http_parser is waiting for the start of a new message, and so would parse a request
+  // that FastRequestParser accepts exactly as it does.
+  bool parser_at_message_start_{true};
+  FastRequestParser::Request fast_request_;
   bool reset_stream_called_{};
   Buffer::WatermarkBuffer output_buffer_;
   Buffer::RawSlice reserved_iovec_;
@@ -0,0 +1,190 @@
+#include "common/http/http1/fast_request_parser.h"
+
+#include <array>
+
+#include "absl/strings/match.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+namespace {
+
+constexpr absl::string_view HttpVersionSuffix = " HTTP/1.1";
+
+struct Method {
+  absl::string_view name_;
+  http_method method_;
+};
+
+// CONNECT is left to http_parser, which treats it as an upgrade.
+const Method Methods[] = {
+    {"GET", HTTP_GET},         {"HEAD", HTTP_HEAD},       {"POST", HTTP_POST},
+    {"PUT", HTTP_PUT},         {"DELETE", HTTP_DELETE},   {"OPTIONS", HTTP_OPTIONS},
+    {"PATCH", HTTP_PATCH},
+};
+
+// RFC 7230 tchar, which is also what http_parser accepts in a header field name.
+bool isTokenChar(unsigned char c) {
+  static const std::array<bool, 256> table = []() {
+    std::array<bool, 256> table{};
+    for (int c = '0'; c <= '9'; c++) {
+      table[c] = true;
+    }
+    for (int c = 'a'; c <= 'z'; c++) {
+      table[c] = true;
+      table[c - 'a' + 'A'] = true;
+    }
+    for (const char c : absl::string_view("!#$%&'*+-.^_`|~")) {
+      table[static_cast<unsigned char>(c)] = true;
+    }
+    return table;
+  }();
+  return table[c];
+}
+
+// Returns the CR of the CRLF that ends the line starting at begin. Returns nullptr if the line is
+// incomplete, ends with a bare LF or holds a byte other than HTAB that findControlCharacter() stops
+// at.
+const char* findLineEnd(const char* begin, const char* end) {
+  const char* p = FastRequestParser::findControlCharacter(begin, end);
+  while (p != end && *p == '\t') {
+    p = FastRequestParser::findControlCharacter(p + 1, end);
+  }
+  if (end - p < 2 || p[0] != '\r' || p[1] != '\n') {
+    return nullptr;
+  }
+  return p;
+}
+
+// http_parser interprets these headers, and would treat the request differently. A
+// "Connection: keep-alive" header changes nothing for HTTP/1.1 other than a parser flag.
+bool acceptHeader(absl::string_view field, absl::string_view value,
+                  FastRequestParser::Request& request) {
+  switch (field.size()) {
+  case 7:
+    return !absl::EqualsIgnoreCase(field, "upgrade");
+  case 10:
+    if (absl::EqualsIgnoreCase(field, "connection")) {
+      request.keep_alive_header_ = absl::EqualsIgnoreCase(value, "keep-alive");
+      return request.keep_alive_header_;
+    }
+    return true;
+  case 14:
+    return !absl::EqualsIgnoreCase(field, "content-length");
+  case 16:
+    return !absl::EqualsIgnoreCase(field, "proxy-connection");
+  case 17:
+    return !absl::EqualsIgnoreCase(field, "transfer-encoding");
+  default:
+    return true;
+  }
+}
+
+} // namespace
+
+const char* FastRequestParser::findControlCharacter(const char* begin, const char* end) {
+#if defined(__SSE2__)
+  const __m128i space = _mm_set1_epi8(0x20);
+  const __m128i del = _mm_set1_epi8(0x7f);
+  for (; end - begin >= 16; begin += 16) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+    // Bytes that are not ASCII are negative as signed chars, so one signed comparison finds them
+    // along with the control characters.
+    const int mask = _mm_movemask_epi8(
+        _mm_or_si128(_mm_cmplt_epi8(chunk, space), _mm_cmpeq_epi8(chunk, del)));
+    if (mask != 0) {
+      return begin + __builtin_ctz(mask);
+    }
+  }
+#endif
+  for (; begin != end; begin++) {
+    const unsigned char c = *begin;
+    if (c < 0x20 || c >= 0x7f) {
+      return begin;
+    }
+  }
+  return end;
+}
+
+bool FastRequestParser::parse(absl::string_view data, Request& request) {
+  const char* const begin = data.data();
+  const char* const end = begin + data.size();
+
+  // The request line: method SP origin-form SP "HTTP/1.1" CRLF.
+  const char* line_end = findLineEnd(begin, end);
+  if (line_end == nullptr) {
+    return false;
+  }
+  const absl::string_view line(begin, line_end - begin);
+  if (!absl::EndsWith(line, HttpVersionSuffix) || line.find('\t') != absl::string_view::npos) {
+    return false;
+  }
+  const size_t url_end = line.size() - HttpVersionSuffix.size();
+  const size_t method_end = line.find(' ');
+  if (method_end >= url_end) {
+    return false;
+  }
+  const absl::string_view method = line.substr(0, method_end);
+  const Method* found = nullptr;
+  for (const Method& candidate : Methods) {
+    if (candidate.name_ == method) {
+      found = &candidate;
+      break;
+    }
+  }
+  if (found == nullptr) {
+    return false;
+  }
+  request.method_ = found->method_;
+  request.url_ = line.substr(method_end + 1, url_end - method_end - 1);
+  if (request.url_.empty() || request.url_[0] != '/' ||
+      request.url_.find(' ') != absl::string_view::npos) {
+    return false;
+  }
+
+  request.headers_.clear();
+  request.keep_alive_header_ = false;
+  for (const char* p = line_end + 2;; p = line_end + 2) {
+    line_end = findLineEnd(p, end);
+    if (line_end == nullptr) {
+      return false;
+    }
+    if (line_end == p) {
+      request.size_ = line_end + 2 - begin;
+      return true;
+    }
+
+    const absl::string_view header_line(p, line_end - p);
+    const size_t colon = header_line.find(':');
+    if (colon == 0 || colon == absl::string_view::npos) {
+      return false;
+    }
+    const absl::string_view field = header_line.substr(0, colon);
+    for (const char c : field) {
+      // This also rejects obsolete line folding, which starts the line with whitespace.
+      if (!isTokenChar(c)) {
+        return false;
+      }
+    }
+    absl::string_view value = header_line.substr(colon + 1);
+    while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+      value.remove_prefix(1);
+    }
+    if (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+      return false;
+    }
+    if (!acceptHeader(field, value, request)) {
+      return false;
+    }
+    request.headers_.push_back({field, value});
+  }
+}
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
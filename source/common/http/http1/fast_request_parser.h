@@ -0,0 +1,58 @@
+#pragma once
+
+#include <http_parser.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+/**
+ * Scanner for the request heads that make up most HTTP/1.1 traffic: a complete, bodyless,
+ * keep-alive request that arrived in one piece. It finds line ends with SSE2 where available and
+ * returns whole header fields and values, so the codec can add each header in one step instead of
+ * through http_parser's byte-at-a-time callbacks.
+ *
+ * Only requests that http_parser would parse the same way are accepted. Bodies, Connection and
+ * Upgrade handling, CONNECT, obsolete line folding, bare LF, non-ASCII bytes and incomplete heads
+ * are all rejected, and the codec falls back to http_parser for them.
+ */
+class FastRequestParser {
+public:
+  struct Header {
+    absl::string_view field_;
+    absl::string_view value_;
+  };
+
+  struct Request {
+    http_method method_;
+    absl::string_view url_;
+    std::vector<Header> headers_;
+    // Whether the request has a "Connection: keep-alive" header.
+    bool keep_alive_header_;
+    // The size of the request head, including the empty line that ends it.
+    size_t size_;
+  };
+
+  /**
+   * @param data supplies received data that starts at the beginning of a request.
+   * @param request supplies the request to fill in. Its header vector is reused across calls.
+   * @return bool whether data starts with a request head the scanner handles. The request is only
+   *         meaningful if true is returned; it references data.
+   */
+  static bool parse(absl::string_view data, Request& request);
+
+  /**
+   * @return const char* the first byte in [begin, end) that is a control character (including
+   *         HTAB), DEL or not ASCII, or end if there is none.
+   */
+  static const char* findControlCharacter(const char* begin, const char* end);
+};
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
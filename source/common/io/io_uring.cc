@@ -0,0 +1,265 @@
+#include "common/io/io_uring.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+
+// The ring is only built against kernel headers that define the whole ABI used below, which is
+// that of Linux 5.7. IORING_FEAT_FAST_POLL is the most recent of the names used, so it implies
+// the others. Older headers get the stubs at the end of this file.
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(IORING_FEAT_FAST_POLL) && defined(__NR_io_uring_setup)
+#define ENVOY_IO_URING_ABI 1
+#endif
+#endif
+#endif
+
+namespace Envoy {
+namespace Io {
+
+#ifdef ENVOY_IO_URING_ABI
+
+namespace {
+
+int ioUringSetup(uint32_t entries, io_uring_params* params) {
+  return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int ring_fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags) {
+  return static_cast<int>(
+      ::syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int ioUringRegister(int ring_fd, uint32_t opcode, const void* arg, uint32_t nr_args) {
+  return static_cast<int>(::syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+}
+
+void* mapRing(int ring_fd, size_t size, uint64_t offset) {
+  void* ring =
+      ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, offset);
+  if (ring == MAP_FAILED) {
+    throw EnvoyException(fmt::format("unable to map io_uring: {}", strerror(errno)));
+  }
+  return ring;
+}
+
+template <class T> T* ringField(void* ring, uint32_t offset) {
+  return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+}
+
+} // namespace
+
+IoUring::IoUring(uint32_t entries) {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring_fd_ = ioUringSetup(entries, &params);
+  if (ring_fd_ < 0) {
+    throw EnvoyException(fmt::format("unable to create io_uring: {}", strerror(errno)));
+  }
+
+  // The destructor does not run for a constructor that throws, so unmap by hand on failure.
+  try {
+    const uint32_t required = IORING_FEAT_NODROP | IORING_FEAT_FAST_POLL;
+    if ((params.features & required) != required) {
+      throw EnvoyException("io_uring lacks IORING_FEAT_NODROP/IORING_FEAT_FAST_POLL");
+    }
+
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      sq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+      sq_ring_ = mapRing(ring_fd_, sq_ring_size_, IORING_OFF_SQ_RING);
+      cq_ring_ = sq_ring_;
+    } else {
+      sq_ring_ = mapRing(ring_fd_, sq_ring_size_, IORING_OFF_SQ_RING);
+      cq_ring_ = mapRing(ring_fd_, cq_ring_size_, IORING_OFF_CQ_RING);
+    }
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe*>(mapRing(ring_fd_, sqes_size_, IORING_OFF_SQES));
+  } catch (const EnvoyException&) {
+    release();
+    throw;
+  }
+
+  sq_head_ = ringField<uint32_t>(sq_ring_, params.sq_off.head);
+  sq_tail_ = ringField<uint32_t>(sq_ring_, params.sq_off.tail);
+  sq_mask_ = *ringField<uint32_t>(sq_ring_, params.sq_off.ring_mask);
+  sq_entries_ = *ringField<uint32_t>(sq_ring_, params.sq_off.ring_entries);
+  sq_array_ = ringField<uint32_t>(sq_ring_, params.sq_off.array);
+  cq_head_ = ringField<uint32_t>(cq_ring_, params.cq_off.head);
+  cq_tail_ = ringField<uint32_t>(cq_ring_, params.cq_off.tail);
+  cq_mask_ = *ringField<uint32_t>(cq_ring_, params.cq_off.ring_mask);
+  cqes_ = ringField<io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+}
+
+IoUring::~IoUring() { release(); }
+
+void IoUring::release() {
+  if (sqes_ != nullptr) {
+    ::munmap(sqes_, sqes_size_);
+    sqes_ = nullptr;
+  }
+  if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+    ::munmap(cq_ring_, cq_ring_size_);
+  }
+  cq_ring_ = nullptr;
+  if (sq_ring_ != nullptr) {
+    ::munmap(sq_ring_, sq_ring_size_);
+    sq_ring_ = nullptr;
+  }
+  if (ring_fd_ >= 0) {
+    ::close(ring_fd_);
+    ring_fd_ = -1;
+  }
+}
+
+bool IoUring::isSupported() {
+  try {
+    IoUring ring(1);
+    return true;
+  } catch (const EnvoyException&) {
+    return false;
+  }
+}
+
+void IoUring::registerEventfd(int event_fd) {
+  if (ioUringRegister(ring_fd_, IORING_REGISTER_EVENTFD, &event_fd, 1) < 0) {
+    throw EnvoyException(fmt::format("unable to register io_uring eventfd: {}", strerror(errno)));
+  }
+}
+
+io_uring_sqe* IoUring::nextSqe() {
+  // Only this thread moves the tail, but the kernel moves the head as it consumes entries.
+  const uint32_t tail = *sq_tail_;
+  if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+    return nullptr;
+  }
+  const uint32_t index = tail & sq_mask_;
+  io_uring_sqe* sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sq_array_[index] = index;
+  return sqe;
+}
+
+bool IoUring::prepareReadv(int fd, const iovec* iovecs, uint32_t num_iovecs, uint64_t user_data) {
+  io_uring_sqe* sqe = nextSqe();
+  if (sqe == nullptr) {
+    return false;
+  }
+  sqe->opcode = IORING_OP_READV;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(iovecs);
+  sqe->len = num_iovecs;
+  sqe->user_data = user_data;
+  __atomic_store_n(sq_tail_, *sq_tail_ + 1, __ATOMIC_RELEASE);
+  pending_submissions_++;
+  return true;
+}
+
+bool IoUring::prepareWritev(int fd, const iovec* iovecs, uint32_t num_iovecs, uint64_t user_data) {
+  io_uring_sqe* sqe = nextSqe();
+  if (sqe == nullptr) {
+    return false;
+  }
+  sqe->opcode = IORING_OP_WRITEV;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(iovecs);
+  sqe->len = num_iovecs;
+  sqe->user_data = user_data;
+  __atomic_store_n(sq_tail_, *sq_tail_ + 1, __ATOMIC_RELEASE);
+  pending_submissions_++;
+  return true;
+}
+
+bool IoUring::prepareCancel(uint64_t target_user_data, uint64_t user_data) {
+  io_uring_sqe* sqe = nextSqe();
+  if (sqe == nullptr) {
+    return false;
+  }
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->fd = -1;
+  sqe->addr = target_user_data;
+  sqe->user_data = user_data;
+  __atomic_store_n(sq_tail_, *sq_tail_ + 1, __ATOMIC_RELEASE);
+  pending_submissions_++;
+  return true;
+}
+
+Api::SysCallIntResult IoUring::submit() {
+  if (pending_submissions_ == 0) {
+    return {0, 0};
+  }
+  int rc;
+  do {
+    rc = ioUringEnter(ring_fd_, pending_submissions_, 0, 0);
+  } while (rc < 0 && errno == EINTR);
+  if (rc < 0) {
+    // EAGAIN and EBUSY mean the kernel is short of resources or completions must be reaped first;
+    // the entries stay queued and the caller retries once it has reaped.
+    RELEASE_ASSERT(errno == EAGAIN || errno == EBUSY,
+                   fmt::format("io_uring_enter failed: {}", strerror(errno)));
+    return {-1, errno};
+  }
+  pending_submissions_ -= rc;
+  return {rc, 0};
+}
+
+void IoUring::waitForCompletion() {
+  int rc;
+  do {
+    rc = ioUringEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS);
+  } while (rc < 0 && errno == EINTR);
+}
+
+uint32_t IoUring::forEveryCompletion(const CompletionCb& cb) {
+  uint32_t count = 0;
+  // Reload the head on every pass: a callback that reaps completions itself moves it.
+  for (uint32_t head = *cq_head_; head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+       head = *cq_head_) {
+    // Copy the entry and hand its slot back before running the callback, which may submit more
+    // operations that need room in the completion queue.
+    const io_uring_cqe cqe = cqes_[head & cq_mask_];
+    __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+    count++;
+    cb(cqe.user_data, cqe.res);
+  }
+  return count;
+}
+
+#else
+
+IoUring::IoUring(uint32_t) {
+  throw EnvoyException("io_uring is only available on Linux, built with 5.7+ kernel headers");
+}
+IoUring::~IoUring() {}
+void IoUring::release() {}
+bool IoUring::isSupported() { return false; }
+void IoUring::registerEventfd(int) { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+io_uring_sqe* IoUring::nextSqe() { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+bool IoUring::prepareReadv(int, const iovec*, uint32_t, uint64_t) {
+  NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+}
+bool IoUring::prepareWritev(int, const iovec*, uint32_t, uint64_t) {
+  NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+}
+bool IoUring::prepareCancel(uint64_t, uint64_t) { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+Api::SysCallIntResult IoUring::submit() { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+void IoUring::waitForCompletion() { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+uint32_t IoUring::forEveryCompletion(const CompletionCb&) { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
+
+#endif
+
+} // namespace Io
+} // namespace Envoy
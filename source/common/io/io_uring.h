@@ -0,0 +1,130 @@
+#pragma once
+
+#include <sys/uio.h>
+
+#include <cstdint>
+#include <functional>
+
+#include "envoy/api/os_sys_calls_common.h"
+
+#include "common/common/non_copyable.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace Envoy {
+namespace Io {
+
+/**
+ * Minimal wrapper around a Linux io_uring submission/completion queue pair, driven directly with
+ * the io_uring_setup(2)/io_uring_enter(2) system calls. Operations are queued with the prepare
+ * methods and handed to the kernel in a single system call by submit(). This class is not thread
+ * safe; it is meant to be owned by one dispatcher.
+ */
+class IoUring : NonCopyable {
+public:
+  /**
+   * Called for every reaped completion.
+   * @param user_data supplies the user data the operation was prepared with.
+   * @param result supplies the operation result: a byte count or a negated errno value.
+   */
+  using CompletionCb = std::function<void(uint64_t user_data, int32_t result)>;
+
+  /**
+   * @param entries supplies the minimum number of submission queue entries.
+   * Throws EnvoyException if the ring can not be created, or if the kernel lacks the features
+   * (IORING_FEAT_NODROP and IORING_FEAT_FAST_POLL, Linux 5.7+) needed to drive sockets without
+   * blocking io_uring worker threads.
+   */
+  explicit IoUring(uint32_t entries);
+  ~IoUring();
+
+  /**
+   * @return bool whether a usable io_uring can be created on this host.
+   */
+  static bool isSupported();
+
+  /**
+   * Have the kernel signal the given eventfd whenever a completion is posted.
+   * @param event_fd supplies the eventfd. Throws EnvoyException on failure.
+   */
+  void registerEventfd(int event_fd);
+
+  /**
+   * Queue a readv(2) of a socket. The iovecs and the memory they point to must stay valid until
+   * the operation completes.
+   * @return bool false if the submission queue is full, in which case submit() must be called
+   *         before retrying.
+   */
+  bool prepareReadv(int fd, const iovec* iovecs, uint32_t num_iovecs, uint64_t user_data);
+
+  /**
+   * Queue a writev(2) of a socket. The iovecs and the memory they point to must stay valid until
+   * the operation completes.
+   * @return bool false if the submission queue is full.
+   */
+  bool prepareWritev(int fd, const iovec* iovecs, uint32_t num_iovecs, uint64_t user_data);
+
+  /**
+   * Queue the cancellation of an earlier operation. The cancelled operation completes with
+   * -ECANCELED, unless it completed first.
+   * @param target_user_data supplies the user data of the operation to cancel.
+   * @return bool false if the submission queue is full.
+   */
+  bool prepareCancel(uint64_t target_user_data, uint64_t user_data);
+
+  /**
+   * Hand every queued operation to the kernel.
+   * @return Api::SysCallIntResult the number of operations submitted, or -1 with errno_ EBUSY or
+   *         EAGAIN if the kernel accepted none of them because completions must be reaped first or
+   *         it is short of resources. Unsubmitted operations stay queued for the next submit().
+   */
+  Api::SysCallIntResult submit();
+
+  /**
+   * Block until at least one completion is available.
+   */
+  void waitForCompletion();
+
+  /**
+   * Reap all available completions. Each completion is released back to the kernel before its
+   * callback runs, so callbacks may prepare and submit new operations.
+   * @param cb supplies the callback run for each completion.
+   * @return uint32_t the number of completions reaped.
+   */
+  uint32_t forEveryCompletion(const CompletionCb& cb);
+
+  /**
+   * @return uint32_t the number of queued operations not yet handed to the kernel.
+   */
+  uint32_t pendingSubmissions() const { return pending_submissions_; }
+
+private:
+  io_uring_sqe* nextSqe();
+  void release();
+
+  int ring_fd_{-1};
+  uint32_t pending_submissions_{};
+
+  // Submission queue.
+  void* sq_ring_{};
+  size_t sq_ring_size_{};
+  uint32_t* sq_head_{};
+  uint32_t* sq_tail_{};
+  uint32_t sq_mask_{};
+  uint32_t sq_entries_{};
+  uint32_t* sq_array_{};
+  io_uring_sqe* sqes_{};
+  size_t sqes_size_{};
+
+  // Completion queue. May share its mapping with the submission queue.
+  void* cq_ring_{};
+  size_t cq_ring_size_{};
+  uint32_t* cq_head_{};
+  uint32_t* cq_tail_{};
+  uint32_t cq_mask_{};
+  io_uring_cqe* cqes_{};
+};
+
+} // namespace Io
+} // namespace Envoy
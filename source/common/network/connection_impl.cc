@@ -62,8 +62,8 @@ ConnectionImpl::ConnectionImpl(Event::Dispatcher& dispatcher, ConnectionSocketPt
 
   // We never ask for both early close and read at the same time. If we are reading, we want to
   // consume all available data.
-  file_event_ = dispatcher_.createFileEvent(
-      ioHandle().fd(), [this](uint32_t events) -> void { onFileEvent(events); },
+  file_event_ = ioHandle().createFileEvent(
+      dispatcher_, [this](uint32_t events) -> void { onFileEvent(events); },
       Event::FileTriggerType::Edge, Event::FileReadyType::Read | Event::FileReadyType::Write);
 
   transport_socket_->setTransportSocketCallbacks(*this);
@@ -120,6 +120,9 @@ void ConnectionImpl::close(ConnectionCloseType type) {
         delayed_close_state_ = DelayedCloseState::CloseAfterFlushAndWait;
       }
     } else {
+      if (type != ConnectionCloseType::NoFlush) {
+        ioHandle().flushWritesOnClose();
+      }
       closeSocket(ConnectionEvent::LocalClose);
     }
   } else {
@@ -583,6 +586,7 @@ void ConnectionImpl::onWriteReady() {
       delayed_close_timer_->enableTimer(delayedCloseTimeout());
     } else {
       ASSERT(bothSidesHalfClosed() || delayed_close_state_ == DelayedCloseState::CloseAfterFlush);
+      ioHandle().flushWritesOnClose();
       closeSocket(ConnectionEvent::LocalClose);
     }
   } else {
@@ -603,6 +607,35 @@ void ConnectionImpl::onWriteReady() {
   }
 }
 
+IoHandle* ConnectionImpl::spliceableIoHandle() {
+  if (state() != State::Open || connecting_ || !transport_socket_->passthrough() ||
+      !ioHandle().allowsDirectFdIo() || filter_manager_.readFilterCount() > 1 ||
+      filter_manager_.writeFilterCount() > 0 || read_buffer_.length() > 0 ||
+      write_buffer_->length() > 0 || read_end_stream_ || write_end_stream_) {
+    return nullptr;
+  }
+  return &ioHandle();
+}
+
+void ConnectionImpl::addSplicedBytes(uint64_t bytes_read, uint64_t bytes_written) {
+  if (connection_stats_ && bytes_read > 0) {
+    connection_stats_->read_total_.add(bytes_read);
+  }
+  if (connection_stats_ && bytes_written > 0) {
+    connection_stats_->write_total_.add(bytes_written);
+  }
+  if (bytes_written > 0) {
+    for (BytesSentCb& cb : bytes_sent_callbacks_) {
+      cb(bytes_written);
+
+      // If a callback closes the socket, stop iterating.
+      if (!ioHandle().isOpen()) {
+        return;
+      }
+    }
+  }
+}
+
 void ConnectionImpl::setConnectionStats(const ConnectionStats& stats) {
   ASSERT(!connection_stats_,
          "Two network filters are attempting to set connection stats. This indicates an issue "
@@ -641,6 +674,11 @@ void ConnectionImpl::onDelayedCloseTimeout() {
   if (connection_stats_ != nullptr && connection_stats_->delayed_close_timeouts_ != nullptr) {
     connection_stats_->delayed_close_timeouts_->inc();
   }
+  if (write_buffer_->length() == 0) {
+    // The flush completed and the wait for the peer to close ran out, so finish writing whatever
+    // the handle still buffers.
+    ioHandle().flushWritesOnClose();
+  }
   closeSocket(ConnectionEvent::LocalClose);
 }
 
@@ -95,6 +95,8 @@ public:
   StreamInfo::StreamInfo& streamInfo() override { return stream_info_; }
   const StreamInfo::StreamInfo& streamInfo() const override { return stream_info_; }
   absl::string_view transportFailureReason() const override;
+  IoHandle* spliceableIoHandle() override;
+  void addSplicedBytes(uint64_t bytes_read, uint64_t bytes_written) override;
 
   // Network::FilterManagerConnection
   void rawWrite(Buffer::Instance& data, bool end_stream) override;
@@ -108,6 +108,8 @@ public:
   bool initializeReadFilters();
   void onRead();
   FilterStatus onWrite();
+  size_t readFilterCount() const { return upstream_filters_.size(); }
+  size_t writeFilterCount() const { return downstream_filters_.size(); }
 
 private:
   struct ActiveReadFilter : public ReadFilterCallbacks, LinkedObject<ActiveReadFilter> {
@@ -1,10 +1,12 @@
 #include "common/network/io_socket_handle_impl.h"
 
 #include <errno.h>
+#include <sys/socket.h>
 
 #include <iostream>
 
 #include "envoy/buffer/buffer.h"
+#include "envoy/event/dispatcher.h"
 
 #include "common/api/os_sys_calls_impl.h"
 #include "common/common/stack_array.h"
@@ -115,6 +117,18 @@ Api::IoCallUint64Result IoSocketHandleImpl::sendmsg(const Buffer::RawSlice* slic
   return sysCallResultToIoCallResult(result);
 }
 
+Api::SysCallIntResult IoSocketHandleImpl::shutdown(int how) {
+  const int rc = ::shutdown(fd_, how);
+  return {rc, errno};
+}
+
+Event::FileEventPtr IoSocketHandleImpl::createFileEvent(Event::Dispatcher& dispatcher,
+                                                        Event::FileReadyCb cb,
+                                                        Event::FileTriggerType trigger,
+                                                        uint32_t events) {
+  return dispatcher.createFileEvent(fd_, cb, trigger, events);
+}
+
 Api::IoCallUint64Result
 IoSocketHandleImpl::sysCallResultToIoCallResult(const Api::SysCallSizeResult& result) {
   if (result.rc_ >= 0) {
@@ -35,10 +35,21 @@ public:
   Api::IoCallUint64Result sendmsg(const Buffer::RawSlice* slices, uint64_t num_slice, int flags,
                                   const Address::Instance& address) override;
 
-private:
-  // Converts a SysCallSizeResult to IoCallUint64Result.
-  Api::IoCallUint64Result sysCallResultToIoCallResult(const Api::SysCallSizeResult& result);
+  Api::SysCallIntResult shutdown(int how) override;
 
+  Event::FileEventPtr createFileEvent(Event::Dispatcher& dispatcher, Event::FileReadyCb cb,
+                                      Event::FileTriggerType trigger, uint32_t events) override;
+  bool allowsDirectFdIo() const override { return true; }
+  void flushWritesOnClose() override {}
+
+  /**
+   * Converts the result of a socket system call to the result of an IoHandle call.
+   * @param result supplies the system call result.
+   * @return Api::IoCallUint64Result the equivalent result.
+   */
+  static Api::IoCallUint64Result sysCallResultToIoCallResult(const Api::SysCallSizeResult& result);
+
+protected:
   int fd_;
 };
 
@@ -0,0 +1,601 @@
+#include "common/network/io_uring_socket_handle_impl.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/common/exception.h"
+#include "envoy/event/dispatcher.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/macros.h"
+#include "common/event/dispatcher_impl.h"
+#include "common/network/io_socket_error_impl.h"
+
+#include "event2/watch.h"
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+namespace Envoy {
+namespace Network {
+
+class IoUringFileEvent;
+
+/**
+ * The part of an IoUringSocketHandleImpl that io_uring operations refer to. It outlives the handle
+ * while operations are in flight, and owns the fd once the handle is closed.
+ */
+class IoUringSocket {
+public:
+  // The operation an io_uring completion belongs to, kept in the low bits of its user data next to
+  // the IoUringSocket pointer.
+  enum class Op : uint64_t { Read = 0, Write = 1, Cancel = 2 };
+  static constexpr uint64_t OpMask = 3;
+
+  static constexpr uint64_t ReadBufferSize = 16384;
+  static constexpr uint64_t WriteBufferLimit = 65536;
+  static constexpr uint64_t MaxWriteIovecs = 16;
+
+  IoUringSocket(IoUringWorker& worker, int fd) : worker_(worker), fd_(fd) {
+    static_assert(alignof(IoUringSocket) > OpMask, "user data tag does not fit");
+  }
+
+  ~IoUringSocket() {
+    ASSERT(idle());
+    if (closed_) {
+      ::close(fd_);
+    }
+  }
+
+  bool engaged() const { return engaged_; }
+  bool idle() const { return ops_in_flight_ == 0; }
+  bool readable() const { return read_start_ != read_end_ || read_eof_ || read_error_ != 0; }
+  bool writable() const { return write_error_ != 0 || bufferedWriteBytes() < WriteBufferLimit; }
+  bool remoteClosed() const { return read_eof_; }
+  IoUringFileEvent* fileEvent() { return file_event_; }
+  void setFileEvent(IoUringFileEvent* file_event) { file_event_ = file_event; }
+
+  void engage();
+  Api::SysCallSizeResult readv(uint64_t max_length, Buffer::RawSlice* slices, uint64_t num_slice);
+  Api::SysCallSizeResult writev(const Buffer::RawSlice* slices, uint64_t num_slice);
+  Api::SysCallIntResult shutdown(int how);
+  void close();
+  void cancelWrites();
+  void onCompletion(Op op, int32_t result);
+
+private:
+  uint64_t userData(Op op) const {
+    return reinterpret_cast<uint64_t>(this) | static_cast<uint64_t>(op);
+  }
+  uint64_t bufferedWriteBytes() const {
+    return write_in_flight_.length() + write_pending_.length();
+  }
+  void submitRead();
+  void submitWrite();
+  void submitCancel(Op target);
+  void onReadCompletion(int32_t result);
+  void onWriteCompletion(int32_t result);
+  void notify(uint32_t events);
+
+  IoUringWorker& worker_;
+  const int fd_;
+  IoUringFileEvent* file_event_{};
+  uint32_t ops_in_flight_{};
+  bool engaged_{};
+  bool closed_{};
+
+  std::unique_ptr<char[]> read_buffer_;
+  iovec read_iovec_{};
+  uint64_t read_start_{};
+  uint64_t read_end_{};
+  int read_error_{};
+  bool read_in_flight_{};
+  bool read_eof_{};
+
+  // write_in_flight_ is referenced by write_iovecs_ while a write is in flight and is not touched
+  // until it completes; writev() appends to write_pending_ in the meantime.
+  Buffer::OwnedImpl write_in_flight_;
+  Buffer::OwnedImpl write_pending_;
+  iovec write_iovecs_[MaxWriteIovecs];
+  int write_error_{};
+  int shutdown_how_{-1};
+  bool write_in_flight_op_{};
+  bool write_blocked_{};
+  bool writes_cancelled_{};
+};
+
+constexpr uint64_t IoUringSocket::OpMask;
+constexpr uint64_t IoUringSocket::ReadBufferSize;
+constexpr uint64_t IoUringSocket::WriteBufferLimit;
+constexpr uint64_t IoUringSocket::MaxWriteIovecs;
+
+/**
+ * File event for an IoUringSocket. It wraps a libevent event on the fd until the socket moves to
+ * io_uring, and from then on reports the readiness of the socket's buffers.
+ */
+class IoUringFileEvent : public Event::FileEvent {
+public:
+  IoUringFileEvent(IoUringSocket& socket, Event::Dispatcher& dispatcher, int fd,
+                   Event::FileReadyCb cb, uint32_t events)
+      : socket_(&socket), cb_(cb), enabled_(events),
+        fd_event_(dispatcher.createFileEvent(fd, cb, Event::FileTriggerType::Edge, events)),
+        activation_timer_(dispatcher.createTimer([this]() -> void { onActivation(); })) {
+    socket_->setFileEvent(this);
+  }
+
+  ~IoUringFileEvent() override {
+    if (socket_ != nullptr) {
+      socket_->setFileEvent(nullptr);
+    }
+  }
+
+  // Event::FileEvent
+  void activate(uint32_t events) override {
+    if (socket_ == nullptr || !socket_->engaged()) {
+      fd_event_->activate(events);
+      return;
+    }
+    pending_activation_ |= events;
+    activation_timer_->enableTimer(std::chrono::milliseconds(0));
+  }
+
+  void setEnabled(uint32_t events) override {
+    enabled_ = events;
+    if (socket_ == nullptr || !socket_->engaged()) {
+      fd_event_->setEnabled(events);
+      return;
+    }
+    // Like an epoll re-arm, report whatever is already ready for the newly enabled events.
+    const uint32_t ready = readyEvents() & events;
+    if (ready != 0) {
+      activate(ready);
+    }
+  }
+
+  /**
+   * Stop watching the fd once the socket has moved to io_uring. Activations still queued in
+   * libevent are dropped along with the fd event, so report the enabled events once in their place.
+   */
+  void onEngaged() {
+    fd_event_->setEnabled(0);
+    const uint32_t events = enabled_ & (Event::FileReadyType::Read | Event::FileReadyType::Write);
+    if (events != 0) {
+      activate(events);
+    }
+  }
+
+  /**
+   * Report events of the socket. This may destroy the file event and the socket.
+   */
+  void onReady(uint32_t events) {
+    events &= enabled_;
+    if (events != 0) {
+      cb_(events);
+    }
+  }
+
+  void detach() { socket_ = nullptr; }
+
+private:
+  uint32_t readyEvents() const {
+    uint32_t events = 0;
+    if (socket_->readable()) {
+      events |= Event::FileReadyType::Read;
+    }
+    if (socket_->writable()) {
+      events |= Event::FileReadyType::Write;
+    }
+    if (socket_->remoteClosed()) {
+      events |= Event::FileReadyType::Closed;
+    }
+    return events;
+  }
+
+  void onActivation() {
+    const uint32_t events = pending_activation_;
+    pending_activation_ = 0;
+    if (events != 0) {
+      cb_(events);
+    }
+  }
+
+  IoUringSocket* socket_;
+  Event::FileReadyCb cb_;
+  uint32_t enabled_;
+  uint32_t pending_activation_{};
+  Event::FileEventPtr fd_event_;
+  Event::TimerPtr activation_timer_;
+};
+
+void IoUringSocket::engage() {
+  ASSERT(!engaged_ && file_event_ != nullptr);
+  engaged_ = true;
+  read_buffer_.reset(new char[ReadBufferSize]);
+  file_event_->onEngaged();
+  submitRead();
+}
+
+Api::SysCallSizeResult IoUringSocket::readv(uint64_t max_length, Buffer::RawSlice* slices,
+                                            uint64_t num_slice) {
+  if (read_start_ == read_end_) {
+    if (read_error_ != 0) {
+      return {-1, read_error_};
+    }
+    if (read_eof_) {
+      return {0, 0};
+    }
+    if (!read_in_flight_) {
+      submitRead();
+    }
+    return {-1, EAGAIN};
+  }
+
+  uint64_t bytes_read = 0;
+  for (uint64_t i = 0; i < num_slice && bytes_read < max_length && read_start_ < read_end_; i++) {
+    const uint64_t length =
+        std::min({static_cast<uint64_t>(slices[i].len_), max_length - bytes_read,
+                  read_end_ - read_start_});
+    memcpy(slices[i].mem_, read_buffer_.get() + read_start_, length);
+    read_start_ += length;
+    bytes_read += length;
+  }
+  if (read_start_ == read_end_ && !read_eof_ && read_error_ == 0) {
+    // Start the next read as soon as the current one is consumed, so that it is submitted with
+    // this loop iteration's batch.
+    submitRead();
+  }
+  return {static_cast<ssize_t>(bytes_read), 0};
+}
+
+Api::SysCallSizeResult IoUringSocket::writev(const Buffer::RawSlice* slices, uint64_t num_slice) {
+  if (write_error_ != 0) {
+    return {-1, write_error_};
+  }
+  const uint64_t space = WriteBufferLimit - std::min(bufferedWriteBytes(), WriteBufferLimit);
+  if (space == 0) {
+    write_blocked_ = true;
+    return {-1, EAGAIN};
+  }
+
+  Buffer::Instance& buffer = write_in_flight_op_ ? write_pending_ : write_in_flight_;
+  uint64_t bytes_written = 0;
+  for (uint64_t i = 0; i < num_slice && bytes_written < space; i++) {
+    const uint64_t length = std::min(static_cast<uint64_t>(slices[i].len_), space - bytes_written);
+    buffer.add(slices[i].mem_, length);
+    bytes_written += length;
+  }
+  if (!write_in_flight_op_ && write_in_flight_.length() > 0) {
+    submitWrite();
+  }
+  return {static_cast<ssize_t>(bytes_written), 0};
+}
+
+Api::SysCallIntResult IoUringSocket::shutdown(int how) {
+  if (bufferedWriteBytes() > 0 && how != SHUT_RD) {
+    // Shutting down now would cut off the buffered data; do it once the data is written.
+    shutdown_how_ = how;
+    return {0, 0};
+  }
+  const int rc = ::shutdown(fd_, how);
+  return {rc, errno};
+}
+
+void IoUringSocket::close() {
+  closed_ = true;
+  if (file_event_ != nullptr) {
+    file_event_->detach();
+    file_event_ = nullptr;
+  }
+  if (read_in_flight_) {
+    submitCancel(Op::Read);
+  }
+}
+
+void IoUringSocket::cancelWrites() {
+  if (write_in_flight_op_ && !writes_cancelled_) {
+    submitCancel(Op::Write);
+  }
+  writes_cancelled_ = true;
+  // Only the data of the write in flight is referenced by the kernel.
+  write_pending_.drain(write_pending_.length());
+}
+
+void IoUringSocket::submitRead() {
+  ASSERT(!read_in_flight_ && !closed_);
+  read_start_ = read_end_ = 0;
+  read_iovec_.iov_base = read_buffer_.get();
+  read_iovec_.iov_len = ReadBufferSize;
+  worker_.prepare([this](Io::IoUring& ring) -> bool {
+    return ring.prepareReadv(fd_, &read_iovec_, 1, userData(Op::Read));
+  });
+  read_in_flight_ = true;
+  ops_in_flight_++;
+}
+
+void IoUringSocket::submitWrite() {
+  ASSERT(!write_in_flight_op_);
+  Buffer::RawSlice slices[MaxWriteIovecs];
+  const uint64_t num_slices = std::min(write_in_flight_.getRawSlices(slices, MaxWriteIovecs),
+                                       static_cast<uint64_t>(MaxWriteIovecs));
+  uint32_t num_iovecs = 0;
+  for (uint64_t i = 0; i < num_slices; i++) {
+    if (slices[i].len_ != 0) {
+      write_iovecs_[num_iovecs].iov_base = slices[i].mem_;
+      write_iovecs_[num_iovecs].iov_len = slices[i].len_;
+      num_iovecs++;
+    }
+  }
+  ASSERT(num_iovecs > 0);
+  worker_.prepare([this, num_iovecs](Io::IoUring& ring) -> bool {
+    return ring.prepareWritev(fd_, write_iovecs_, num_iovecs, userData(Op::Write));
+  });
+  write_in_flight_op_ = true;
+  ops_in_flight_++;
+}
+
+void IoUringSocket::submitCancel(Op target) {
+  worker_.prepare([this, target](Io::IoUring& ring) -> bool {
+    return ring.prepareCancel(userData(target), userData(Op::Cancel));
+  });
+  ops_in_flight_++;
+}
+
+void IoUringSocket::onCompletion(Op op, int32_t result) {
+  ASSERT(ops_in_flight_ > 0);
+  ops_in_flight_--;
+  switch (op) {
+  case Op::Read:
+    onReadCompletion(result);
+    break;
+  case Op::Write:
+    onWriteCompletion(result);
+    break;
+  case Op::Cancel:
+    // The cancelled operation reports its own completion.
+    break;
+  }
+}
+
+void IoUringSocket::onReadCompletion(int32_t result) {
+  read_in_flight_ = false;
+  if (closed_) {
+    return;
+  }
+  if (result > 0) {
+    read_start_ = 0;
+    read_end_ = result;
+    notify(Event::FileReadyType::Read);
+  } else if (result == 0) {
+    read_eof_ = true;
+    notify(Event::FileReadyType::Read | Event::FileReadyType::Closed);
+  } else {
+    read_error_ = -result;
+    notify(Event::FileReadyType::Read);
+  }
+}
+
+void IoUringSocket::onWriteCompletion(int32_t result) {
+  write_in_flight_op_ = false;
+  if (result < 0 || writes_cancelled_) {
+    write_error_ = result < 0 ? -result : ECANCELED;
+    write_in_flight_.drain(write_in_flight_.length());
+    write_pending_.drain(write_pending_.length());
+    if (!closed_) {
+      notify(Event::FileReadyType::Write);
+    }
+    return;
+  }
+
+  write_in_flight_.drain(result);
+  write_in_flight_.move(write_pending_);
+  if (write_in_flight_.length() > 0) {
+    submitWrite();
+  } else if (shutdown_how_ != -1) {
+    ::shutdown(fd_, shutdown_how_);
+    shutdown_how_ = -1;
+  }
+  if (write_blocked_ && bufferedWriteBytes() < WriteBufferLimit && !closed_) {
+    write_blocked_ = false;
+    notify(Event::FileReadyType::Write);
+  }
+}
+
+void IoUringSocket::notify(uint32_t events) {
+  if (file_event_ != nullptr) {
+    file_event_->onReady(events);
+  }
+}
+
+constexpr uint32_t IoUringWorker::DefaultRingSize;
+constexpr std::chrono::milliseconds IoUringWorker::RetiredFlushTimeout;
+
+IoUringWorker::IoUringWorker(Event::DispatcherImpl& dispatcher, uint32_t ring_size)
+    : dispatcher_(dispatcher), ring_(ring_size) {
+#ifdef __linux__
+  event_fd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+#endif
+  RELEASE_ASSERT(event_fd_ >= 0, "unable to create io_uring eventfd");
+  try {
+    ring_.registerEventfd(event_fd_);
+  } catch (const EnvoyException&) {
+    ::close(event_fd_);
+    throw;
+  }
+  completion_event_ = dispatcher_.createFileEvent(
+      event_fd_, [this](uint32_t) -> void { onCompletions(); }, Event::FileTriggerType::Edge,
+      Event::FileReadyType::Read);
+  retire_timer_ = dispatcher_.createTimer([this]() -> void { onRetireTimer(); });
+  prepare_watch_ = evwatch_prepare_new(&dispatcher_.base(), onPrepare, this);
+}
+
+IoUringWorker::~IoUringWorker() {
+  // Operations still in flight write into memory owned by the retired sockets, so cancel them and
+  // wait for their completions before freeing it.
+  for (RetiredSocket& retired : retired_) {
+    retired.socket_->cancelWrites();
+  }
+  submit();
+  reapRetired();
+  while (!retired_.empty()) {
+    submit();
+    ring_.waitForCompletion();
+    onCompletions();
+  }
+  evwatch_free(prepare_watch_);
+  ::close(event_fd_);
+}
+
+void IoUringWorker::submit() {
+  while (flushOverflow() || ring_.pendingSubmissions() > 0) {
+    const Api::SysCallIntResult result = ring_.submit();
+    submit_calls_++;
+    if (result.rc_ < 0) {
+      // The kernel wants completions reaped first. onCompletions() submits again afterwards.
+      ENVOY_LOG(trace, "io_uring: submit deferred: {}", strerror(result.errno_));
+      return;
+    }
+    submitted_operations_ += result.rc_;
+    if (overflow_.empty()) {
+      return;
+    }
+  }
+}
+
+bool IoUringWorker::flushOverflow() {
+  bool flushed = false;
+  while (!overflow_.empty() && overflow_.front()(ring_)) {
+    overflow_.pop_front();
+    flushed = true;
+  }
+  return flushed;
+}
+
+void IoUringWorker::retire(std::unique_ptr<IoUringSocket>&& socket) {
+  retired_.push_back({std::move(socket), dispatcher_.timeSource().monotonicTime()});
+  if (!retire_timer_->enabled()) {
+    retire_timer_->enableTimer(RetiredFlushTimeout);
+  }
+}
+
+void IoUringWorker::onPrepare(evwatch*, const evwatch_prepare_cb_info*, void* arg) {
+  IoUringWorker* worker = static_cast<IoUringWorker*>(arg);
+  worker->reapRetired();
+  worker->submit();
+}
+
+void IoUringWorker::onCompletions() {
+  // Clear the eventfd before reaping so that a completion posted in between wakes the loop again.
+  uint64_t count;
+  const ssize_t rc = ::read(event_fd_, &count, sizeof(count));
+  UNREFERENCED_PARAMETER(rc);
+  ring_.forEveryCompletion([](uint64_t user_data, int32_t result) -> void {
+    IoUringSocket* socket = reinterpret_cast<IoUringSocket*>(user_data & ~IoUringSocket::OpMask);
+    socket->onCompletion(static_cast<IoUringSocket::Op>(user_data & IoUringSocket::OpMask),
+                         result);
+  });
+  // Reaping made room in the completion queue for submissions the kernel refused earlier.
+  submit();
+  reapRetired();
+}
+
+void IoUringWorker::onRetireTimer() {
+  const MonotonicTime now = dispatcher_.timeSource().monotonicTime();
+  for (RetiredSocket& retired : retired_) {
+    if (now - retired.retired_at_ >= RetiredFlushTimeout) {
+      ENVOY_LOG(debug, "io_uring: cancelling writes of a socket closed {}ms ago",
+                RetiredFlushTimeout.count());
+      retired.socket_->cancelWrites();
+    }
+  }
+  reapRetired();
+  if (!retired_.empty()) {
+    retire_timer_->enableTimer(RetiredFlushTimeout);
+  }
+}
+
+void IoUringWorker::reapRetired() {
+  retired_.remove_if([](const RetiredSocket& retired) { return retired.socket_->idle(); });
+}
+
+IoUringSocketHandleImpl::IoUringSocketHandleImpl(IoUringWorker& worker, int fd)
+    : IoSocketHandleImpl(fd), worker_(worker),
+      socket_(std::make_unique<IoUringSocket>(worker, fd)) {}
+
+IoUringSocketHandleImpl::~IoUringSocketHandleImpl() {
+  if (fd_ != -1) {
+    IoUringSocketHandleImpl::close();
+  }
+}
+
+bool IoUringSocketHandleImpl::usesIoUring() const {
+  return socket_ != nullptr && socket_->engaged();
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::close() {
+  ASSERT(fd_ != -1);
+  if (!socket_->engaged()) {
+    socket_.reset();
+    return IoSocketHandleImpl::close();
+  }
+  // The socket closes the fd once its outstanding operations complete or are cancelled, so that
+  // the fd number is not reused while the kernel may still refer to it. Buffered writes are only
+  // flushed first if the caller asked for it.
+  fd_ = -1;
+  if (!flush_writes_on_close_) {
+    socket_->cancelWrites();
+  }
+  socket_->close();
+  worker_.retire(std::move(socket_));
+  return Api::IoCallUint64Result(0, Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError));
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::readv(uint64_t max_length,
+                                                       Buffer::RawSlice* slices,
+                                                       uint64_t num_slice) {
+  if (!socket_->engaged()) {
+    if (socket_->fileEvent() == nullptr) {
+      return IoSocketHandleImpl::readv(max_length, slices, num_slice);
+    }
+    socket_->engage();
+  }
+  return sysCallResultToIoCallResult(socket_->readv(max_length, slices, num_slice));
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::writev(const Buffer::RawSlice* slices,
+                                                        uint64_t num_slice) {
+  if (!socket_->engaged()) {
+    if (socket_->fileEvent() == nullptr) {
+      return IoSocketHandleImpl::writev(slices, num_slice);
+    }
+    socket_->engage();
+  }
+  return sysCallResultToIoCallResult(socket_->writev(slices, num_slice));
+}
+
+Api::SysCallIntResult IoUringSocketHandleImpl::shutdown(int how) {
+  if (!socket_->engaged()) {
+    return IoSocketHandleImpl::shutdown(how);
+  }
+  return socket_->shutdown(how);
+}
+
+Event::FileEventPtr IoUringSocketHandleImpl::createFileEvent(Event::Dispatcher& dispatcher,
+                                                             Event::FileReadyCb cb,
+                                                             Event::FileTriggerType trigger,
+                                                             uint32_t events) {
+  // Only a single edge triggered consumer, such as ConnectionImpl, can be served from buffers.
+  if (trigger != Event::FileTriggerType::Edge || socket_->engaged() ||
+      socket_->fileEvent() != nullptr) {
+    return IoSocketHandleImpl::createFileEvent(dispatcher, cb, trigger, events);
+  }
+  return std::make_unique<IoUringFileEvent>(*socket_, dispatcher, fd_, cb, events);
+}
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+
+#include "envoy/common/time.h"
+#include "envoy/event/file_event.h"
+#include "envoy/event/timer.h"
+
+#include "common/common/assert.h"
+#include "common/common/logger.h"
+#include "common/io/io_uring.h"
+#include "common/network/io_socket_handle_impl.h"
+
+struct evwatch;
+struct evwatch_prepare_cb_info;
+
+namespace Envoy {
+namespace Event {
+class DispatcherImpl;
+} // namespace Event
+
+namespace Network {
+
+class IoUringSocket;
+
+/**
+ * Drives the io_uring of one dispatcher on behalf of IoUringSocketHandleImpl. The reads and writes
+ * that handles queue during a loop iteration are submitted with a single io_uring_enter() right
+ * before the dispatcher polls, and their completions are reaped in one pass when the ring's eventfd
+ * becomes readable.
+ */
+class IoUringWorker : Logger::Loggable<Logger::Id::connection> {
+public:
+  /**
+   * @param dispatcher supplies the dispatcher whose loop drives the ring.
+   * @param ring_size supplies the number of submission queue entries.
+   * Throws EnvoyException if io_uring is not usable on this host.
+   */
+  IoUringWorker(Event::DispatcherImpl& dispatcher, uint32_t ring_size = DefaultRingSize);
+  ~IoUringWorker();
+
+  static constexpr uint32_t DefaultRingSize = 1024;
+  // How long a socket closed with flushWritesOnClose() may keep flushing buffered writes before
+  // they are cancelled.
+  static constexpr std::chrono::milliseconds RetiredFlushTimeout{10000};
+
+  Event::DispatcherImpl& dispatcher() { return dispatcher_; }
+
+  /**
+   * Queue an operation. If the submission queue is full the queued batch is submitted early, and
+   * if the kernel can not take it yet the operation waits in an overflow list, in order, until
+   * completions are reaped.
+   * @param prepare_fn supplies a callable taking the Io::IoUring that prepares the operation and
+   *        returns false if the submission queue is full.
+   */
+  template <class PrepareFn> void prepare(PrepareFn prepare_fn) {
+    if (overflow_.empty() && prepare_fn(ring_)) {
+      return;
+    }
+    overflow_.emplace_back(std::move(prepare_fn));
+    submit();
+  }
+
+  /**
+   * Hand the queued operations to the kernel now instead of at the end of the loop iteration.
+   */
+  void submit();
+
+  /**
+   * Take ownership of the state of a closed handle. It is destroyed, and its fd closed, once its
+   * outstanding operations complete or are cancelled.
+   */
+  void retire(std::unique_ptr<IoUringSocket>&& socket);
+
+  /**
+   * @return uint64_t the number of io_uring_enter() calls made to submit operations.
+   */
+  uint64_t submitCalls() const { return submit_calls_; }
+
+  /**
+   * @return uint64_t the number of operations handed to the kernel.
+   */
+  uint64_t submittedOperations() const { return submitted_operations_; }
+
+  /**
+   * @return uint64_t the number of operations waiting for room in the submission queue.
+   */
+  uint64_t overflowedOperations() const { return overflow_.size(); }
+
+private:
+  struct RetiredSocket {
+    std::unique_ptr<IoUringSocket> socket_;
+    MonotonicTime retired_at_;
+  };
+
+  static void onPrepare(evwatch*, const evwatch_prepare_cb_info*, void* arg);
+  void onCompletions();
+  void onRetireTimer();
+  void reapRetired();
+  bool flushOverflow();
+
+  Event::DispatcherImpl& dispatcher_;
+  Io::IoUring ring_;
+  int event_fd_{-1};
+  Event::FileEventPtr completion_event_;
+  Event::TimerPtr retire_timer_;
+  evwatch* prepare_watch_{};
+  std::list<RetiredSocket> retired_;
+  std::list<std::function<bool(Io::IoUring&)>> overflow_;
+  uint64_t submit_calls_{};
+  uint64_t submitted_operations_{};
+};
+
+typedef std::unique_ptr<IoUringWorker> IoUringWorkerPtr;
+
+/**
+ * IoHandle for accepted sockets whose reads and writes go through an IoUringWorker rather than
+ * through readv(2)/writev(2). Until the first readv() or writev() made after an edge triggered file
+ * event was created with createFileEvent(), the handle behaves exactly like IoSocketHandleImpl, so
+ * listener filters and transport sockets that use the fd directly (TLS) are not affected. After
+ * that:
+ * - one read into a per-socket buffer is always in flight; readv() copies data out of that buffer
+ *   and fails with EAGAIN while it is empty;
+ * - writev() copies data into a per-socket buffer that the kernel writes out in the background,
+ *   and fails with EAGAIN once WriteBufferLimit bytes are buffered;
+ * - the file event fires Read when a read completes and Write when a full write buffer drains.
+ */
+class IoUringSocketHandleImpl : public IoSocketHandleImpl {
+public:
+  IoUringSocketHandleImpl(IoUringWorker& worker, int fd);
+  ~IoUringSocketHandleImpl() override;
+
+  // Network::IoHandle
+  Api::IoCallUint64Result close() override;
+  Api::IoCallUint64Result readv(uint64_t max_length, Buffer::RawSlice* slices,
+                                uint64_t num_slice) override;
+  Api::IoCallUint64Result writev(const Buffer::RawSlice* slices, uint64_t num_slice) override;
+  Api::SysCallIntResult shutdown(int how) override;
+  Event::FileEventPtr createFileEvent(Event::Dispatcher& dispatcher, Event::FileReadyCb cb,
+                                      Event::FileTriggerType trigger, uint32_t events) override;
+  bool allowsDirectFdIo() const override { return !usesIoUring(); }
+  void flushWritesOnClose() override { flush_writes_on_close_ = true; }
+
+  /**
+   * @return bool whether reads and writes have moved to io_uring.
+   */
+  bool usesIoUring() const;
+
+private:
+  IoUringWorker& worker_;
+  std::unique_ptr<IoUringSocket> socket_;
+  bool flush_writes_on_close_{};
+};
+
+} // namespace Network
+} // namespace Envoy
@@ -11,6 +11,7 @@
 #include "common/event/file_event_impl.h"
 #include "common/network/address_impl.h"
 #include "common/network/io_socket_handle_impl.h"
+#include "common/network/io_uring_socket_handle_impl.h"
 
 #include "event2/listener.h"
 
@@ -21,8 +22,12 @@ void ListenerImpl::listenCallback(evconnlistener*, evutil_socket_t fd, sockaddr*
                                   int remote_addr_len, void* arg) {
   ListenerImpl* listener = static_cast<ListenerImpl*>(arg);
 
-  // Create the IoSocketHandleImpl for the fd here.
-  IoHandlePtr io_handle = std::make_unique<IoSocketHandleImpl>(fd);
+  // Create the IoSocketHandleImpl for the fd here, or the io_uring variant if the dispatcher
+  // drives an io_uring.
+  IoUringWorker* io_uring_worker = listener->dispatcher_.ioUringWorker();
+  IoHandlePtr io_handle = io_uring_worker != nullptr
+                              ? std::make_unique<IoUringSocketHandleImpl>(*io_uring_worker, fd)
+                              : std::make_unique<IoSocketHandleImpl>(fd);
 
   // Get the local address from the new socket if the listener is listening on IP ANY
   // (e.g., 0.0.0.0 for IPv4) (local_address_ is nullptr in this case).
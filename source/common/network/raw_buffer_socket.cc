@@ -1,12 +1,48 @@
 #include "common/network/raw_buffer_socket.h"
 
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#ifdef __linux__
+#include <linux/errqueue.h>
+#endif
+
+#include "common/api/os_sys_calls_impl.h"
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
+#include "common/common/stack_array.h"
 #include "common/http/headers.h"
+#include "common/network/io_socket_handle_impl.h"
 
 namespace Envoy {
 namespace Network {
 
+namespace {
+
+// The most slices handed to one send, as in OwnedImpl::write().
+constexpr uint64_t MaxSendSlices = 16;
+
+} // namespace
+
+constexpr uint64_t ReadSizer::MinReadSize;
+constexpr uint64_t ReadSizer::InitialReadSize;
+constexpr uint64_t ReadSizer::MaxReadSize;
+
+void ReadSizer::onRead(uint64_t bytes_read) {
+  if (bytes_read >= read_size_) {
+    read_size_ = std::min(read_size_ * 2, MaxReadSize);
+    small_reads_ = 0;
+  } else if (bytes_read <= read_size_ / 2 && read_size_ > MinReadSize) {
+    // A single short read may just be the tail of a larger transfer, so wait for a second one.
+    if (++small_reads_ == 2) {
+      read_size_ /= 2;
+      small_reads_ = 0;
+    }
+  } else {
+    small_reads_ = 0;
+  }
+}
+
 void RawBufferSocket::setTransportSocketCallbacks(TransportSocketCallbacks& callbacks) {
   callbacks_ = &callbacks;
 }
@@ -14,10 +50,19 @@ void RawBufferSocket::setTransportSocketCallbacks(TransportSocketCallbacks& call
 IoResult RawBufferSocket::doRead(Buffer::Instance& buffer) {
   PostIoAction action = PostIoAction::KeepOpen;
   uint64_t bytes_read = 0;
+  uint64_t syscalls = 0;
   bool end_stream = false;
+  const uint32_t buffer_limit = callbacks_->connection().bufferLimit();
   do {
-    // 16K read is arbitrary. TODO(mattklein123) PERF: Tune the read size.
-    Api::IoCallUint64Result result = buffer.read(callbacks_->ioHandle(), 16384);
+    // Don't overshoot the connection's buffer limit by more than a default sized read, however
+    // large the reads have grown.
+    uint64_t read_size = read_sizer_.readSize();
+    if (buffer_limit > 0) {
+      const uint64_t room = buffer_limit > buffer.length() ? buffer_limit - buffer.length() : 0;
+      read_size = std::min(read_size, std::max(room, ReadSizer::InitialReadSize));
+    }
+    Api::IoCallUint64Result result = buffer.read(callbacks_->ioHandle(), read_size);
+    syscalls++;
 
     if (result.ok()) {
       ENVOY_CONN_LOG(trace, "read returns: {}", callbacks_->connection(), result.rc_);
@@ -26,6 +71,11 @@ IoResult RawBufferSocket::doRead(Buffer::Instance& buffer) {
         end_stream = true;
         break;
       }
+      // A read that the limit cut short and that came back full says nothing about how much the
+      // peer sends.
+      if (read_size == read_sizer_.readSize() || result.rc_ < read_size) {
+        read_sizer_.onRead(result.rc_);
+      }
       bytes_read += result.rc_;
       if (callbacks_->shouldDrainReadBuffer()) {
         callbacks_->setReadBufferReady();
@@ -42,25 +92,39 @@ IoResult RawBufferSocket::doRead(Buffer::Instance& buffer) {
     }
   } while (true);
 
+  if (stats_ != nullptr) {
+    // Add once per event rather than per syscall to keep atomic increments off the read loop.
+    stats_->read_syscalls_.add(syscalls);
+    stats_->read_bytes_.add(bytes_read);
+  }
   return {action, bytes_read, end_stream};
 }
 
 IoResult RawBufferSocket::doWrite(Buffer::Instance& buffer, bool end_stream) {
+  // Completions are reported as socket errors, which wake the connection up for writing.
+  if (zerocopy_sends_pending_ > 0) {
+    reapZerocopyCompletions();
+  }
+  drainCompletedSends(buffer);
+
   PostIoAction action;
   uint64_t bytes_written = 0;
-  ASSERT(!shutdown_ || buffer.length() == 0);
+  uint64_t syscalls = 0;
+  ASSERT(!shutdown_ || buffer.length() == pinned_bytes_);
   do {
-    if (buffer.length() == 0) {
+    const uint64_t unsent = buffer.length() - pinned_bytes_;
+    if (unsent == 0) {
       if (end_stream && !shutdown_) {
         // Ignore the result. This can only fail if the connection failed. In that case, the
         // error will be detected on the next read, and dealt with appropriately.
-        ::shutdown(callbacks_->ioHandle().fd(), SHUT_WR);
+        callbacks_->ioHandle().shutdown(SHUT_WR);
         shutdown_ = true;
       }
       action = PostIoAction::KeepOpen;
       break;
     }
-    Api::IoCallUint64Result result = buffer.write(callbacks_->ioHandle());
+    Api::IoCallUint64Result result = write(buffer, unsent);
+    syscalls++;
 
     if (result.ok()) {
       ENVOY_CONN_LOG(trace, "write returns: {}", callbacks_->connection(), result.rc_);
@@ -77,17 +141,176 @@ IoResult RawBufferSocket::doWrite(Buffer::Instance& buffer, bool end_stream) {
     }
   } while (true);
 
+  if (stats_ != nullptr) {
+    stats_->write_syscalls_.add(syscalls);
+    stats_->write_bytes_.add(bytes_written);
+  }
   return {action, bytes_written, false};
 }
 
+Api::IoCallUint64Result RawBufferSocket::write(Buffer::Instance& buffer, uint64_t unsent) {
+  if (zerocopy_threshold_ > 0 && unsent >= zerocopy_threshold_ && zerocopyEnabled()) {
+    Api::IoCallUint64Result result = sendUnpinned(buffer, MSG_ZEROCOPY);
+    if (!result.ok() && result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again) {
+      return result;
+    }
+    if (result.ok()) {
+      // The kernel numbers successful zero copy sends on a socket consecutively from 0.
+      pinned_sends_.push_back({result.rc_, next_zerocopy_id_++, false});
+      pinned_bytes_ += result.rc_;
+      zerocopy_sends_pending_++;
+      return result;
+    }
+    // Most likely ENOBUFS, when the pinned memory exceeds the socket's option memory limit. Copy
+    // instead, which fails the same way if the error is about the connection.
+  }
+
+  if (pinned_sends_.empty()) {
+    return buffer.write(callbacks_->ioHandle());
+  }
+  Api::IoCallUint64Result result = sendUnpinned(buffer, 0);
+  if (result.ok()) {
+    if (pinned_sends_.back().completed_) {
+      pinned_sends_.back().bytes_ += result.rc_;
+    } else {
+      pinned_sends_.push_back({result.rc_, 0, true});
+    }
+    pinned_bytes_ += result.rc_;
+  }
+  return result;
+}
+
+Api::IoCallUint64Result RawBufferSocket::sendUnpinned(Buffer::Instance& buffer, int flags) {
+  const uint64_t num_slices = buffer.getRawSlices(nullptr, 0);
+  STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
+  buffer.getRawSlices(slices.begin(), num_slices);
+
+  iovec iov[MaxSendSlices];
+  uint64_t num_iov = 0;
+  uint64_t skip = pinned_bytes_;
+  for (uint64_t i = 0; i < num_slices && num_iov < MaxSendSlices; i++) {
+    if (skip >= slices[i].len_) {
+      skip -= slices[i].len_;
+      continue;
+    }
+    iov[num_iov].iov_base = static_cast<uint8_t*>(slices[i].mem_) + skip;
+    iov[num_iov].iov_len = slices[i].len_ - skip;
+    skip = 0;
+    num_iov++;
+  }
+
+  msghdr message{};
+  message.msg_iov = iov;
+  message.msg_iovlen = num_iov;
+  return IoSocketHandleImpl::sysCallResultToIoCallResult(
+      Api::OsSysCallsSingleton::get().sendmsg(callbacks_->ioHandle().fd(), &message, flags));
+}
+
+bool RawBufferSocket::zerocopyEnabled() {
+  // Sending from the fd directly bypasses the IoHandle, which is only allowed while it does plain
+  // socket I/O. A handle may switch to another mode, e.g. io_uring, after the first write, so this
+  // is checked on every write.
+  IoHandle& io_handle = callbacks_->ioHandle();
+  if (!io_handle.allowsDirectFdIo()) {
+    return false;
+  }
+  if (zerocopy_state_ == ZerocopyState::Unknown) {
+    zerocopy_state_ = ZerocopyState::Unavailable;
+#if defined(__linux__) && defined(SO_ZEROCOPY)
+    // Fails on sockets other than TCP and on kernels older than 4.14.
+    const int enable = 1;
+    if (Api::OsSysCallsSingleton::get()
+            .setsockopt(io_handle.fd(), SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable))
+            .rc_ == 0) {
+      zerocopy_state_ = ZerocopyState::Enabled;
+    }
+#endif
+    ENVOY_CONN_LOG(debug, "zero copy sends {}", callbacks_->connection(),
+                   zerocopy_state_ == ZerocopyState::Enabled ? "enabled" : "unavailable");
+  }
+  return zerocopy_state_ == ZerocopyState::Enabled;
+}
+
+void RawBufferSocket::reapZerocopyCompletions() {
+#ifdef __linux__
+  auto& os_syscalls = Api::OsSysCallsSingleton::get();
+  while (zerocopy_sends_pending_ > 0) {
+    // The kernel coalesces consecutive completions into one message with a range of ids.
+    alignas(cmsghdr) char control[128];
+    msghdr message{};
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    if (os_syscalls.recvmsg(callbacks_->ioHandle().fd(), &message, MSG_ERRQUEUE).rc_ < 0) {
+      // Usually EAGAIN, when the remaining sends have not been acknowledged yet.
+      return;
+    }
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&message, cmsg)) {
+      if (!(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) &&
+          !(cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)) {
+        continue;
+      }
+      sock_extended_err err;
+      memcpy(&err, CMSG_DATA(cmsg), sizeof(err));
+      if (err.ee_errno == 0 && err.ee_origin == SO_EE_ORIGIN_ZEROCOPY) {
+        onZerocopyCompleted(err.ee_info, err.ee_data,
+                            (err.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0);
+      }
+    }
+  }
+#endif
+}
+
+void RawBufferSocket::onZerocopyCompleted(uint32_t lo, uint32_t hi, bool copied) {
+  for (PinnedSend& send : pinned_sends_) {
+    // Ids wrap around, so compare offsets into the range rather than the ids themselves.
+    if (send.completed_ || send.zerocopy_id_ - lo > hi - lo) {
+      continue;
+    }
+    send.completed_ = true;
+    zerocopy_sends_pending_--;
+    if (stats_ != nullptr) {
+      // The kernel copies when the device cannot send from user memory, e.g. on loopback.
+      (copied ? stats_->write_zerocopy_copied_bytes_ : stats_->write_zerocopy_bytes_)
+          .add(send.bytes_);
+    }
+  }
+}
+
+void RawBufferSocket::drainCompletedSends(Buffer::Instance& buffer) {
+  while (!pinned_sends_.empty() && pinned_sends_.front().completed_) {
+    buffer.drain(pinned_sends_.front().bytes_);
+    pinned_bytes_ -= pinned_sends_.front().bytes_;
+    pinned_sends_.pop_front();
+  }
+}
+
+void RawBufferSocket::closeSocket(Network::ConnectionEvent) {
+  if (zerocopy_sends_pending_ > 0) {
+    reapZerocopyCompletions();
+  }
+  if (zerocopy_sends_pending_ > 0) {
+    // The kernel may still retransmit from the write buffer, whose memory is about to be freed and
+    // reused. Reset the connection on close so that nothing else is sent in its place.
+    const linger reset{1, 0};
+    Api::OsSysCallsSingleton::get().setsockopt(callbacks_->ioHandle().fd(), SOL_SOCKET, SO_LINGER,
+                                               &reset, sizeof(reset));
+  }
+}
+
 std::string RawBufferSocket::protocol() const { return EMPTY_STRING; }
 absl::string_view RawBufferSocket::failureReason() const { return EMPTY_STRING; }
 
 void RawBufferSocket::onConnected() { callbacks_->raiseEvent(ConnectionEvent::Connected); }
 
+RawBufferSocketFactory::RawBufferSocketFactory(Stats::Scope& scope, uint32_t zerocopy_threshold)
+    : stats_(new RawBufferSocketStats{
+          ALL_RAW_BUFFER_SOCKET_STATS(POOL_COUNTER_PREFIX(scope, "raw_buffer."))}),
+      zerocopy_threshold_(zerocopy_threshold) {}
+
 TransportSocketPtr
 RawBufferSocketFactory::createTransportSocket(TransportSocketOptionsSharedPtr) const {
-  return std::make_unique<RawBufferSocket>();
+  return std::make_unique<RawBufferSocket>(stats_.get(), zerocopy_threshold_);
 }
 
 bool RawBufferSocketFactory::implementsSecureTransport() const { return false; }
@@ -1,37 +1,155 @@
 #pragma once
 
+#include <deque>
+
 #include "envoy/buffer/buffer.h"
 #include "envoy/network/connection.h"
 #include "envoy/network/transport_socket.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
 
 #include "common/common/logger.h"
 
 namespace Envoy {
 namespace Network {
 
+/**
+ * All raw buffer socket stats. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_RAW_BUFFER_SOCKET_STATS(COUNTER)                                                       \
+  COUNTER(read_bytes)                                                                              \
+  COUNTER(read_syscalls)                                                                           \
+  COUNTER(write_bytes)                                                                             \
+  COUNTER(write_syscalls)                                                                          \
+  COUNTER(write_zerocopy_bytes)                                                                    \
+  COUNTER(write_zerocopy_copied_bytes)
+// clang-format on
+
+/**
+ * Struct definition for all raw buffer socket stats. @see stats_macros.h
+ */
+struct RawBufferSocketStats {
+  ALL_RAW_BUFFER_SOCKET_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * Picks the size of the next read on a connection from how full its recent reads were. A read
+ * that fills the whole request doubles the next one, so bulk transfers need fewer syscalls. Two
+ * reads in a row that would have fit in half the size halve it, so connections carrying small
+ * messages reserve less buffer space.
+ */
+class ReadSizer {
+public:
+  static constexpr uint64_t MinReadSize = 4096;
+  static constexpr uint64_t InitialReadSize = 16384;
+  static constexpr uint64_t MaxReadSize = 262144;
+
+  /**
+   * @return uint64_t the number of bytes to request in the next read.
+   */
+  uint64_t readSize() const { return read_size_; }
+
+  /**
+   * Record the result of a successful read.
+   * @param bytes_read supplies the number of bytes returned by a read of readSize() bytes.
+   */
+  void onRead(uint64_t bytes_read);
+
+private:
+  uint64_t read_size_{InitialReadSize};
+  uint32_t small_reads_{};
+};
+
 class RawBufferSocket : public TransportSocket, protected Logger::Loggable<Logger::Id::connection> {
 public:
+  RawBufferSocket() = default;
+
+  /**
+   * @param stats supplies the stats to update, or nullptr.
+   * @param zerocopy_threshold supplies the smallest write that is sent with MSG_ZEROCOPY, or 0 to
+   *        always copy.
+   */
+  explicit RawBufferSocket(RawBufferSocketStats* stats, uint32_t zerocopy_threshold = 0)
+      : stats_(stats), zerocopy_threshold_(zerocopy_threshold) {}
+
   // Network::TransportSocket
   void setTransportSocketCallbacks(TransportSocketCallbacks& callbacks) override;
   std::string protocol() const override;
   absl::string_view failureReason() const override;
   bool canFlushClose() override { return true; }
-  void closeSocket(Network::ConnectionEvent) override {}
+  void closeSocket(Network::ConnectionEvent) override;
   void onConnected() override;
   IoResult doRead(Buffer::Instance& buffer) override;
   IoResult doWrite(Buffer::Instance& buffer, bool end_stream) override;
   const Ssl::ConnectionInfo* ssl() const override { return nullptr; }
+  bool passthrough() const override { return true; }
+
+  /**
+   * @return uint64_t the number of bytes the next read will request.
+   */
+  uint64_t readSize() const { return read_sizer_.readSize(); }
+
+  /**
+   * @return uint64_t the number of bytes at the front of the write buffer that were sent with
+   *         MSG_ZEROCOPY, or sent after such bytes, and wait for the kernel to release them.
+   */
+  uint64_t pinnedBytes() const { return pinned_bytes_; }
 
 private:
+  // Bytes handed to the kernel that are still at the front of the write buffer. A send with
+  // MSG_ZEROCOPY completes when the kernel reports it on the error queue, a copying send as soon
+  // as it returns. Sends are drained from the buffer in order, so a copying send that follows a
+  // zero copy one waits for it.
+  struct PinnedSend {
+    uint64_t bytes_;
+    uint32_t zerocopy_id_;
+    bool completed_;
+  };
+
+  enum class ZerocopyState { Unknown, Enabled, Unavailable };
+
+  // Returns whether the next write may use MSG_ZEROCOPY, enabling SO_ZEROCOPY on first use.
+  bool zerocopyEnabled();
+  Api::IoCallUint64Result write(Buffer::Instance& buffer, uint64_t unsent);
+  // Sends bytes that follow the pinned ones with sendmsg(2).
+  Api::IoCallUint64Result sendUnpinned(Buffer::Instance& buffer, int flags);
+  // Reads zero copy completions from the error queue and drains completed sends from the buffer.
+  void reapZerocopyCompletions();
+  void onZerocopyCompleted(uint32_t lo, uint32_t hi, bool copied);
+  void drainCompletedSends(Buffer::Instance& buffer);
+
   TransportSocketCallbacks* callbacks_{};
+  RawBufferSocketStats* const stats_{};
+  ReadSizer read_sizer_;
   bool shutdown_{};
+  const uint32_t zerocopy_threshold_{};
+  ZerocopyState zerocopy_state_{ZerocopyState::Unknown};
+  std::deque<PinnedSend> pinned_sends_;
+  uint64_t pinned_bytes_{};
+  uint32_t zerocopy_sends_pending_{};
+  uint32_t next_zerocopy_id_{};
 };
 
 class RawBufferSocketFactory : public TransportSocketFactory {
 public:
+  RawBufferSocketFactory() = default;
+
+  /**
+   * @param scope supplies the scope that the sockets' stats are written to under "raw_buffer.".
+   * @param zerocopy_threshold supplies the smallest write that the sockets send with MSG_ZEROCOPY,
+   *        or 0 to always copy.
+   */
+  explicit RawBufferSocketFactory(Stats::Scope& scope, uint32_t zerocopy_threshold = 0);
+
   // Network::TransportSocketFactory
   TransportSocketPtr createTransportSocket(TransportSocketOptionsSharedPtr options) const override;
   bool implementsSecureTransport() const override;
+
+private:
+  // Shared by all sockets created by this factory, and so must outlive them.
+  std::unique_ptr<RawBufferSocketStats> stats_;
+  const uint32_t zerocopy_threshold_{};
 };
 
 } // namespace Network
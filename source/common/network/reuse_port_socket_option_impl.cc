@@ -0,0 +1,61 @@
+#include "common/network/reuse_port_socket_option_impl.h"
+
+#ifdef __linux__
+#include <linux/filter.h>
+#endif
+
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+
+namespace Envoy {
+namespace Network {
+
+bool ReusePortCpuSteeringSocketOptionImpl::setOption(
+    Socket& socket, envoy::api::v2::core::SocketOption::SocketState state) const {
+  // The reuse port group only exists once the socket is bound.
+  if (state != envoy::api::v2::core::SocketOption::STATE_BOUND) {
+    return true;
+  }
+
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+  ASSERT(group_size_ > 0);
+  sock_filter code[] = {
+      // A = the CPU that is processing the connection.
+      {BPF_LD | BPF_W | BPF_ABS, 0, 0, static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU)},
+      // A = A % group_size_.
+      {BPF_ALU | BPF_MOD | BPF_K, 0, 0, group_size_},
+      // Return A as the index of the socket in the reuse port group.
+      {BPF_RET | BPF_A, 0, 0, 0},
+  };
+  sock_fprog program{sizeof(code) / sizeof(code[0]), code};
+  const Api::SysCallIntResult result = SocketOptionImpl::setSocketOption(
+      socket, ENVOY_SOCKET_SO_ATTACH_REUSEPORT_CBPF,
+      absl::string_view(reinterpret_cast<const char*>(&program), sizeof(program)));
+  if (result.rc_ != 0) {
+    ENVOY_LOG(warn, "Attaching reuse port CPU steering program failed: {}",
+              strerror(result.errno_));
+    return false;
+  }
+  return true;
+#else
+  UNREFERENCED_PARAMETER(socket);
+  ENVOY_LOG(warn, "Reuse port CPU steering is not supported on this platform");
+  return false;
+#endif
+}
+
+absl::optional<Socket::Option::Details> ReusePortCpuSteeringSocketOptionImpl::getOptionDetails(
+    const Socket&, envoy::api::v2::core::SocketOption::SocketState state) const {
+  const SocketOptionName name = ENVOY_SOCKET_SO_ATTACH_REUSEPORT_CBPF;
+  if (state != envoy::api::v2::core::SocketOption::STATE_BOUND || !name.has_value()) {
+    return absl::nullopt;
+  }
+
+  Socket::Option::Details info;
+  info.name_ = name;
+  info.value_ = std::string(reinterpret_cast<const char*>(&group_size_), sizeof(group_size_));
+  return absl::optional<Option::Details>(std::move(info));
+}
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <sys/socket.h>
+
+#include "envoy/network/listen_socket.h"
+
+#include "common/common/logger.h"
+#include "common/network/socket_option_impl.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * Attaches a classic BPF program to the SO_REUSEPORT group of a listen socket. For every new
+ * connection the program selects the socket at index (CPU that received the connection) modulo
+ * the group size, instead of the kernel's hash of the connection 4-tuple. Listeners create one
+ * socket per worker in worker order, so the index is the worker index.
+ */
+class ReusePortCpuSteeringSocketOptionImpl : public Socket::Option,
+                                             Logger::Loggable<Logger::Id::connection> {
+public:
+  /**
+   * @param group_size supplies the number of sockets in the reuse port group.
+   */
+  ReusePortCpuSteeringSocketOptionImpl(uint32_t group_size) : group_size_(group_size) {}
+
+  // Socket::Option
+  bool setOption(Socket& socket,
+                 envoy::api::v2::core::SocketOption::SocketState state) const override;
+  void hashKey(std::vector<uint8_t>&) const override {}
+  absl::optional<Details>
+  getOptionDetails(const Socket& socket,
+                   envoy::api::v2::core::SocketOption::SocketState state) const override;
+
+private:
+  const uint32_t group_size_;
+};
+
+} // namespace Network
+} // namespace Envoy
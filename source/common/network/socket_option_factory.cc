@@ -1,6 +1,7 @@
 #include "common/network/socket_option_factory.h"
 
 #include "common/network/addr_family_aware_socket_option_impl.h"
+#include "common/network/reuse_port_socket_option_impl.h"
 #include "common/network/socket_option_impl.h"
 
 namespace Envoy {
@@ -94,5 +95,19 @@ SocketOptionFactory::buildTcpFastOpenOptions(uint32_t queue_length) {
   return options;
 }
 
+std::unique_ptr<Socket::Options> SocketOptionFactory::buildReusePortOptions() {
+  std::unique_ptr<Socket::Options> options = std::make_unique<Socket::Options>();
+  options->push_back(std::make_shared<Network::SocketOptionImpl>(
+      envoy::api::v2::core::SocketOption::STATE_PREBIND, ENVOY_SOCKET_SO_REUSEPORT, 1));
+  return options;
+}
+
+std::unique_ptr<Socket::Options>
+SocketOptionFactory::buildReusePortCpuSteeringOptions(uint32_t group_size) {
+  std::unique_ptr<Socket::Options> options = std::make_unique<Socket::Options>();
+  options->push_back(std::make_shared<Network::ReusePortCpuSteeringSocketOptionImpl>(group_size));
+  return options;
+}
+
 } // namespace Network
 } // namespace Envoy
@@ -82,6 +82,20 @@ namespace Network {
 #define ENVOY_SOCKET_TCP_FASTOPEN Network::SocketOptionName()
 #endif
 
+#ifdef SO_REUSEPORT
+#define ENVOY_SOCKET_SO_REUSEPORT                                                                  \
+  Network::SocketOptionName(std::make_pair(SOL_SOCKET, SO_REUSEPORT))
+#else
+#define ENVOY_SOCKET_SO_REUSEPORT Network::SocketOptionName()
+#endif
+
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+#define ENVOY_SOCKET_SO_ATTACH_REUSEPORT_CBPF                                                      \
+  Network::SocketOptionName(std::make_pair(SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF))
+#else
+#define ENVOY_SOCKET_SO_ATTACH_REUSEPORT_CBPF Network::SocketOptionName()
+#endif
+
 class SocketOptionImpl : public Socket::Option, Logger::Loggable<Logger::Id::connection> {
 public:
   SocketOptionImpl(envoy::api::v2::core::SocketOption::SocketState in_state,
@@ -2,6 +2,8 @@
 
 #include <sys/un.h>
 
+#include <array>
+
 #include "envoy/buffer/buffer.h"
 #include "envoy/common/exception.h"
 
@@ -9,9 +11,11 @@
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
 #include "common/common/fmt.h"
+#include "common/common/macros.h"
 #include "common/common/stack_array.h"
 #include "common/event/dispatcher_impl.h"
 #include "common/network/address_impl.h"
+#include "common/network/io_socket_error_impl.h"
 
 #include "event2/listener.h"
 
@@ -22,9 +26,66 @@
 namespace Envoy {
 namespace Network {
 
+constexpr uint32_t UdpListenerImpl::MaxDatagramsPerSyscall;
+constexpr uint64_t UdpListenerImpl::MaxRxDatagramSize;
+
+#if defined(__linux__)
+// Receive state for recvmmsg(), allocated once per listener. Datagrams land in a shared pool and
+// are copied out into buffers of their own size, so a small datagram does not pin a whole
+// MaxRxDatagramSize slice.
+struct UdpListenerImpl::RecvBatch {
+  RecvBatch() : pool_(new uint8_t[MaxDatagramsPerSyscall * MaxRxDatagramSize]) {
+    for (uint32_t i = 0; i < MaxDatagramsPerSyscall; i++) {
+      iovecs_[i].iov_base = pool_.get() + i * MaxRxDatagramSize;
+      iovecs_[i].iov_len = MaxRxDatagramSize;
+      msgs_[i].msg_hdr.msg_name = &addrs_[i];
+      msgs_[i].msg_hdr.msg_iov = &iovecs_[i];
+      msgs_[i].msg_hdr.msg_iovlen = 1;
+      msgs_[i].msg_hdr.msg_control = nullptr;
+      msgs_[i].msg_hdr.msg_controllen = 0;
+    }
+  }
+
+  // Reset the fields that the kernel overwrites on every call.
+  void prepare() {
+    for (mmsghdr& msg : msgs_) {
+      msg.msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+      msg.msg_hdr.msg_flags = 0;
+      msg.msg_len = 0;
+    }
+  }
+
+  std::unique_ptr<uint8_t[]> pool_;
+  std::array<iovec, MaxDatagramsPerSyscall> iovecs_;
+  std::array<sockaddr_storage, MaxDatagramsPerSyscall> addrs_;
+  std::array<mmsghdr, MaxDatagramsPerSyscall> msgs_;
+};
+#else
+struct UdpListenerImpl::RecvBatch {};
+#endif
+
+namespace {
+
+Api::IoCallUint64Result sysCallErrorToIoCallResult(int sys_errno) {
+  // EAGAIN is frequent enough that its memory allocation should be avoided.
+  IoSocketError* error = sys_errno == EAGAIN ? IoSocketError::getIoSocketEagainInstance()
+                                             : new IoSocketError(sys_errno);
+  return Api::IoCallUint64Result(/*rc=*/0, Api::IoErrorPtr(error, IoSocketError::deleteIoError));
+}
+
+} // namespace
+
 UdpListenerImpl::UdpListenerImpl(Event::DispatcherImpl& dispatcher, Socket& socket,
-                                 UdpListenerCallbacks& cb)
+                                 UdpListenerCallbacks& cb, bool batched_receive)
     : BaseListenerImpl(dispatcher, socket), cb_(cb) {
+#if defined(__linux__)
+  if (batched_receive) {
+    recv_batch_ = std::make_unique<RecvBatch>();
+  }
+#else
+  UNREFERENCED_PARAMETER(batched_receive);
+#endif
+
   file_event_ = dispatcher_.createFileEvent(
       socket.ioHandle().fd(), [this](uint32_t events) -> void { onSocketEvent(events); },
       Event::FileTriggerType::Edge, Event::FileReadyType::Read | Event::FileReadyType::Write);
@@ -51,7 +112,7 @@ void UdpListenerImpl::enable() {
 
 UdpListenerImpl::ReceiveResult UdpListenerImpl::doRecvFrom(sockaddr_storage& peer_addr,
                                                            socklen_t& addr_len) {
-  constexpr uint64_t const read_length = 16384;
+  constexpr uint64_t const read_length = MaxRxDatagramSize;
 
   Buffer::InstancePtr buffer = std::make_unique<Buffer::OwnedImpl>();
 
@@ -94,6 +155,10 @@ void UdpListenerImpl::onSocketEvent(short flags) {
 
 void UdpListenerImpl::handleReadCallback() {
   ENVOY_UDP_LOG(trace, "handleReadCallback");
+  if (recv_batch_ != nullptr && handleBatchedRead()) {
+    return;
+  }
+
   sockaddr_storage addr;
   socklen_t addr_len = 0;
 
@@ -113,38 +178,84 @@ void UdpListenerImpl::handleReadCallback() {
       return;
     }
 
-    Address::InstanceConstSharedPtr local_address = socket_.localAddress();
+    deliverDatagram(addr, addr_len, std::move(recv_result.buffer_));
+  } while (true);
+}
 
-    RELEASE_ASSERT(
-        addr_len > 0,
-        fmt::format(
-            "Unable to get remote address for fd: {}, local address: {}. address length is 0 ",
-            socket_.ioHandle().fd(), local_address->asString()));
+bool UdpListenerImpl::handleBatchedRead() {
+#if defined(__linux__)
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  do {
+    recv_batch_->prepare();
+    const Api::SysCallIntResult result = os_sys_calls.recvmmsg(
+        socket_.ioHandle().fd(), recv_batch_->msgs_.data(), MaxDatagramsPerSyscall, 0);
+    if (result.rc_ < 0) {
+      if (result.errno_ == ENOSYS) {
+        ENVOY_UDP_LOG(debug, "recvmmsg is not supported, falling back to recvfrom");
+        recv_batch_.reset();
+        return false;
+      }
+      if (result.errno_ != EAGAIN) {
+        ENVOY_UDP_LOG(error, "recvmmsg result {}", result.errno_);
+        cb_.onReceiveError(UdpListenerCallbacks::ErrorCode::SyscallError, result.errno_);
+      }
+      return true;
+    }
 
-    Address::InstanceConstSharedPtr peer_address;
+    ENVOY_UDP_LOG(trace, "recvmmsg datagrams {}", result.rc_);
+    for (int i = 0; i < result.rc_; i++) {
+      const mmsghdr& msg = recv_batch_->msgs_[i];
+      if (msg.msg_len == 0) {
+        continue;
+      }
+      deliverDatagram(recv_batch_->addrs_[i], msg.msg_hdr.msg_namelen,
+                      std::make_unique<Buffer::OwnedImpl>(recv_batch_->iovecs_[i].iov_base,
+                                                          msg.msg_len));
+    }
 
-    try {
-      peer_address = Address::addressFromSockAddr(
-          addr, addr_len, local_address->ip()->version() == Address::IpVersion::v6);
-    } catch (const EnvoyException&) {
-      // Intentional no-op. The assert should fail below
+    // A short batch means the socket was drained. Edge triggered events fire again for the next
+    // datagram, so skip the call that would only return EAGAIN.
+    if (static_cast<uint32_t>(result.rc_) < MaxDatagramsPerSyscall) {
+      return true;
     }
+  } while (true);
+#else
+  return false;
+#endif
+}
 
-    RELEASE_ASSERT((peer_address != nullptr),
-                   fmt::format("Unable to get remote address for fd: {}, local address: {} ",
-                               socket_.ioHandle().fd(), local_address->asString()));
+void UdpListenerImpl::deliverDatagram(const sockaddr_storage& addr, socklen_t addr_len,
+                                      Buffer::InstancePtr&& buffer) {
+  Address::InstanceConstSharedPtr local_address = socket_.localAddress();
 
-    // Unix domain sockets are not supported
-    RELEASE_ASSERT(peer_address->type() == Address::Type::Ip,
-                   fmt::format("Unsupported peer address: {} local address: {}, receive size: "
-                               "{}, address length: {}",
-                               peer_address->asString(), local_address->asString(),
-                               recv_result.result_.rc_, addr_len));
+  RELEASE_ASSERT(
+      addr_len > 0,
+      fmt::format(
+          "Unable to get remote address for fd: {}, local address: {}. address length is 0 ",
+          socket_.ioHandle().fd(), local_address->asString()));
 
-    UdpRecvData recvData{local_address, peer_address, std::move(recv_result.buffer_)};
-    cb_.onData(recvData);
+  Address::InstanceConstSharedPtr peer_address;
 
-  } while (true);
+  try {
+    peer_address = Address::addressFromSockAddr(
+        addr, addr_len, local_address->ip()->version() == Address::IpVersion::v6);
+  } catch (const EnvoyException&) {
+    // Intentional no-op. The assert should fail below
+  }
+
+  RELEASE_ASSERT((peer_address != nullptr),
+                 fmt::format("Unable to get remote address for fd: {}, local address: {} ",
+                             socket_.ioHandle().fd(), local_address->asString()));
+
+  // Unix domain sockets are not supported
+  RELEASE_ASSERT(peer_address->type() == Address::Type::Ip,
+                 fmt::format("Unsupported peer address: {} local address: {}, receive size: "
+                             "{}, address length: {}",
+                             peer_address->asString(), local_address->asString(),
+                             buffer->length(), addr_len));
+
+  UdpRecvData recvData{local_address, peer_address, std::move(buffer)};
+  cb_.onData(recvData);
 }
 
 void UdpListenerImpl::handleWriteCallback() {
@@ -182,5 +293,103 @@ Api::IoCallUint64Result UdpListenerImpl::send(const UdpSendData& send_data) {
   return send_result;
 }
 
+Api::IoCallUint64Result UdpListenerImpl::sendBatch(const std::vector<UdpSendData>& data) {
+  ENVOY_UDP_LOG(trace, "sendBatch of {} datagrams", data.size());
+  uint64_t sent = 0;
+  while (sent < data.size()) {
+    if (!sendmmsg_supported_) {
+      Api::IoCallUint64Result send_result = send(data[sent]);
+      if (!send_result.ok()) {
+        if (sent == 0) {
+          return send_result;
+        }
+        break;
+      }
+      sent++;
+      continue;
+    }
+
+    const uint32_t batch_size =
+        static_cast<uint32_t>(std::min<uint64_t>(data.size() - sent, MaxDatagramsPerSyscall));
+    const Api::SysCallIntResult result = sendmmsgBatch(data, sent, batch_size);
+    if (result.rc_ < 0) {
+      if (result.errno_ == ENOSYS) {
+        ENVOY_UDP_LOG(debug, "sendmmsg is not supported, falling back to sendmsg");
+        sendmmsg_supported_ = false;
+        continue;
+      }
+      ENVOY_UDP_LOG(debug, "sendmmsg failed with error {}", result.errno_);
+      if (sent == 0) {
+        return sysCallErrorToIoCallResult(result.errno_);
+      }
+      break;
+    }
+
+    ENVOY_UDP_LOG(trace, "sendmmsg sent {} datagrams", result.rc_);
+    sent += result.rc_;
+    if (static_cast<uint32_t>(result.rc_) < batch_size) {
+      break;
+    }
+  }
+
+  return Api::IoCallUint64Result(sent, Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError));
+}
+
+Api::SysCallIntResult UdpListenerImpl::sendmmsgBatch(const std::vector<UdpSendData>& data,
+                                                     uint64_t first, uint32_t batch_size) {
+#if defined(__linux__)
+  uint64_t num_slices = 0;
+  for (uint32_t i = 0; i < batch_size; i++) {
+    num_slices += data[first + i].buffer_.getRawSlices(nullptr, 0);
+  }
+  STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
+  STACK_ARRAY(iovecs, iovec, num_slices);
+  std::array<mmsghdr, MaxDatagramsPerSyscall> msgs;
+
+  uint64_t next_slice = 0;
+  uint64_t next_iovec = 0;
+  for (uint32_t i = 0; i < batch_size; i++) {
+    const UdpSendData& datagram = data[first + i];
+    const uint64_t datagram_slices =
+        datagram.buffer_.getRawSlices(slices.begin() + next_slice, num_slices - next_slice);
+    msghdr& hdr = msgs[i].msg_hdr;
+    hdr.msg_iov = iovecs.begin() + next_iovec;
+    hdr.msg_iovlen = 0;
+    for (uint64_t j = next_slice; j < next_slice + datagram_slices; j++) {
+      if (slices[j].mem_ != nullptr && slices[j].len_ != 0) {
+        iovecs[next_iovec].iov_base = slices[j].mem_;
+        iovecs[next_iovec].iov_len = slices[j].len_;
+        next_iovec++;
+        hdr.msg_iovlen++;
+      }
+    }
+    next_slice += datagram_slices;
+
+    const auto* address = dynamic_cast<const Address::InstanceBase*>(datagram.send_address_.get());
+    ASSERT(address != nullptr);
+    hdr.msg_name = const_cast<sockaddr*>(address->sockAddr());
+    hdr.msg_namelen = address->sockAddrLen();
+    hdr.msg_control = nullptr;
+    hdr.msg_controllen = 0;
+    hdr.msg_flags = 0;
+    msgs[i].msg_len = 0;
+  }
+
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  const Api::SysCallIntResult result =
+      os_sys_calls.sendmmsg(socket_.ioHandle().fd(), msgs.data(), batch_size, 0);
+  for (int i = 0; i < result.rc_; i++) {
+    // Datagrams are sent whole, so this drains each sent buffer completely.
+    data[first + i].buffer_.drain(msgs[i].msg_len);
+  }
+  return result;
+#else
+  UNREFERENCED_PARAMETER(data);
+  UNREFERENCED_PARAMETER(first);
+  UNREFERENCED_PARAMETER(batch_size);
+  return {-1, ENOSYS};
+#endif
+}
+
 } // namespace Network
 } // namespace Envoy
@@ -18,7 +18,17 @@ class UdpListenerImpl : public BaseListenerImpl,
                         public virtual UdpListener,
                         protected Logger::Loggable<Logger::Id::udp> {
 public:
-  UdpListenerImpl(Event::DispatcherImpl& dispatcher, Socket& socket, UdpListenerCallbacks& cb);
+  // The most datagrams received or sent by a single recvmmsg() or sendmmsg() call.
+  static constexpr uint32_t MaxDatagramsPerSyscall = 16;
+  // Datagrams longer than this are truncated on receive.
+  static constexpr uint64_t MaxRxDatagramSize = 16384;
+
+  /**
+   * @param batched_receive if true, datagrams are received in batches of up to
+   * MaxDatagramsPerSyscall with recvmmsg() where available, instead of one recvfrom() each.
+   */
+  UdpListenerImpl(Event::DispatcherImpl& dispatcher, Socket& socket, UdpListenerCallbacks& cb,
+                  bool batched_receive = false);
 
   ~UdpListenerImpl();
 
@@ -30,6 +40,7 @@ public:
   Event::Dispatcher& dispatcher() override;
   const Address::InstanceConstSharedPtr& localAddress() const override;
   Api::IoCallUint64Result send(const UdpSendData& data) override;
+  Api::IoCallUint64Result sendBatch(const std::vector<UdpSendData>& data) override;
 
   struct ReceiveResult {
     Api::SysCallIntResult result_;
@@ -46,8 +57,22 @@ protected:
   UdpListenerCallbacks& cb_;
 
 private:
+  struct RecvBatch;
+
   void onSocketEvent(short flags);
+  // Receives with recvmmsg() until the socket is drained. Returns false if recvmmsg() is not
+  // supported, in which case the caller falls back to recvfrom().
+  bool handleBatchedRead();
+  void deliverDatagram(const sockaddr_storage& addr, socklen_t addr_len,
+                       Buffer::InstancePtr&& buffer);
+  // Sends data[first, first + batch_size) with one sendmmsg() call.
+  Api::SysCallIntResult sendmmsgBatch(const std::vector<UdpSendData>& data, uint64_t first,
+                                      uint32_t batch_size);
+
   Event::FileEventPtr file_event_;
+  // Preallocated recvmmsg() state, or nullptr when receiving one datagram at a time.
+  std::unique_ptr<RecvBatch> recv_batch_;
+  bool sendmmsg_supported_{true};
 };
 
 } // namespace Network
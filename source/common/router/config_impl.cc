@@ -151,7 +151,7 @@ CorsPolicyImpl::CorsPolicyImpl(const envoy::api::v2::route::CorsPolicy& config,
     allow_origin_.push_back(origin);
   }
   for (const auto& regex : config.allow_origin_regex()) {
-    allow_origin_regex_.push_back(RegexUtil::parseRegex(regex));
+    allow_origin_regex_.push_back(Regex::Utility::parseStdRegexAsCompiledMatcher(regex));
   }
   allow_methods_ = config.allow_methods();
   allow_headers_ = config.allow_headers();
@@ -886,8 +886,16 @@ RouteConstSharedPtr PathRouteEntryImpl::matches(const Http::HeaderMap& headers,
 RegexRouteEntryImpl::RegexRouteEntryImpl(const VirtualHostImpl& vhost,
                                          const envoy::api::v2::route::Route& route,
                                          Server::Configuration::FactoryContext& factory_context)
-    : RouteEntryImplBase(vhost, route, factory_context),
-      regex_(RegexUtil::parseRegex(route.match().regex())), regex_str_(route.match().regex()) {}
+    : RouteEntryImplBase(vhost, route, factory_context) {
+  if (route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kRegex) {
+    regex_ = Regex::Utility::parseStdRegexAsCompiledMatcher(route.match().regex());
+    regex_str_ = route.match().regex();
+  } else {
+    ASSERT(route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kSafeRegex);
+    regex_ = Regex::Utility::parseRegex(route.match().safe_regex());
+    regex_str_ = route.match().safe_regex().regex();
+  }
+}
 
 void RegexRouteEntryImpl::rewritePathHeader(Http::HeaderMap& headers,
                                             bool insert_envoy_original_path) const {
@@ -898,7 +906,7 @@ void RegexRouteEntryImpl::rewritePathHeader(Http::HeaderMap& headers,
   // route cache. We should consider if ASSERT-ing is the desired behavior in this case.
 
   const absl::string_view path_view = path.getStringView();
-  ASSERT(std::regex_match(path_view.begin(), path_view.begin() + path_string_length, regex_));
+  ASSERT(regex_->match(path_view.substr(0, path_string_length)));
   const std::string matched_path(path_view.begin(), path_view.begin() + path_string_length);
 
   finalizePathHeader(headers, matched_path, insert_envoy_original_path);
@@ -909,9 +917,7 @@ RouteConstSharedPtr RegexRouteEntryImpl::matches(const Http::HeaderMap& headers,
   if (RouteEntryImplBase::matchRoute(headers, random_value)) {
     const Http::HeaderString& path = headers.Path()->value();
     const absl::string_view query_string = Http::Utility::findQueryStringStart(path);
-    if (std::regex_match(path.getStringView().begin(),
-                         path.getStringView().begin() + (path.size() - query_string.length()),
-                         regex_)) {
+    if (regex_->match(path.getStringView().substr(0, path.size() - query_string.length()))) {
       return clusterEntry(headers, random_value);
     }
   }
@@ -957,19 +963,26 @@ VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtu
   }
 
   for (const auto& route : virtual_host.routes()) {
+    const uint32_t position = routes_.size();
+    const bool case_sensitive =
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(route.match(), case_sensitive, true);
     const bool has_prefix =
         route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kPrefix;
     const bool has_path =
         route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kPath;
     const bool has_regex =
-        route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kRegex;
+        route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kRegex ||
+        route.match().path_specifier_case() == envoy::api::v2::route::RouteMatch::kSafeRegex;
     if (has_prefix) {
       routes_.emplace_back(new PrefixRouteEntryImpl(*this, route, factory_context));
+      route_index_.addPrefix(route.match().prefix(), case_sensitive, position);
     } else if (has_path) {
       routes_.emplace_back(new PathRouteEntryImpl(*this, route, factory_context));
+      route_index_.addPath(route.match().path(), case_sensitive, position);
     } else {
       ASSERT(has_regex);
       routes_.emplace_back(new RegexRouteEntryImpl(*this, route, factory_context));
+      route_index_.addUnindexed(position);
     }
 
     if (validate_clusters) {
@@ -983,6 +996,8 @@ VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtu
     }
   }
 
+  route_index_.compile();
+
   for (const auto& virtual_cluster : virtual_host.virtual_clusters()) {
     virtual_clusters_.push_back(VirtualClusterEntry(virtual_cluster, stat_name_pool_));
   }
@@ -994,7 +1009,7 @@ VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtu
 
 VirtualHostImpl::VirtualClusterEntry::VirtualClusterEntry(
     const envoy::api::v2::route::VirtualCluster& virtual_cluster, Stats::StatNamePool& pool)
-    : pattern_(RegexUtil::parseRegex(virtual_cluster.pattern())),
+    : pattern_(Regex::Utility::parseStdRegexAsCompiledMatcher(virtual_cluster.pattern())),
       stat_name_(pool.add(virtual_cluster.name())) {
   if (virtual_cluster.method() != envoy::api::v2::core::RequestMethod::METHOD_UNSPECIFIED) {
     method_ = envoy::api::v2::core::RequestMethod_Name(virtual_cluster.method());
@@ -1007,28 +1022,6 @@ const RouteSpecificFilterConfig* VirtualHostImpl::perFilterConfig(const std::str
   return per_filter_configs_.get(name);
 }
 
-const VirtualHostImpl* RouteMatcher::findWildcardVirtualHost(
-    const std::string& host, const RouteMatcher::WildcardVirtualHosts& wildcard_virtual_hosts,
-    RouteMatcher::SubstringFunction substring_function) const {
-  // We do a longest wildcard match against the host that's passed in
-  // (e.g. foo-bar.baz.com should match *-bar.baz.com before matching *.baz.com for suffix
-  // wildcards). This is done by scanning the length => wildcards map looking for every wildcard
-  // whose size is < length.
-  for (const auto& iter : wildcard_virtual_hosts) {
-    const uint32_t wildcard_length = iter.first;
-    const auto& wildcard_map = iter.second;
-    // >= because *.foo.com shouldn't match .foo.com.
-    if (wildcard_length >= host.size()) {
-      continue;
-    }
-    const auto& match = wildcard_map.find(substring_function(host, wildcard_length));
-    if (match != wildcard_map.end()) {
-      return match->second.get();
-    }
-  }
-  return nullptr;
-}
-
 RouteMatcher::RouteMatcher(const envoy::api::v2::RouteConfiguration& route_config,
                            const ConfigImpl& global_route_config,
                            Server::Configuration::FactoryContext& factory_context,
@@ -1045,13 +1038,11 @@ RouteMatcher::RouteMatcher(const envoy::api::v2::RouteConfiguration& route_confi
         }
         default_virtual_host_ = virtual_host;
       } else if (!domain.empty() && '*' == domain[0]) {
-        duplicate_found = !wildcard_virtual_host_suffixes_[domain.size() - 1]
-                               .emplace(domain.substr(1), virtual_host)
-                               .second;
+        duplicate_found =
+            !wildcard_virtual_host_suffixes_.add(absl::string_view(domain).substr(1), virtual_host);
       } else if (!domain.empty() && '*' == domain[domain.size() - 1]) {
-        duplicate_found = !wildcard_virtual_host_prefixes_[domain.size() - 1]
-                               .emplace(domain.substr(0, domain.size() - 1), virtual_host)
-                               .second;
+        duplicate_found = !wildcard_virtual_host_prefixes_.add(
+            absl::string_view(domain).substr(0, domain.size() - 1), virtual_host);
       } else {
         duplicate_found = !virtual_hosts_.emplace(domain, virtual_host).second;
       }
@@ -1061,6 +1052,8 @@ RouteMatcher::RouteMatcher(const envoy::api::v2::RouteConfiguration& route_confi
       }
     }
   }
+  wildcard_virtual_host_suffixes_.compile();
+  wildcard_virtual_host_prefixes_.compile();
 }
 
 RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const Http::HeaderMap& headers,
@@ -1080,9 +1073,17 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const Http::HeaderMap&
     return SSL_REDIRECT_ROUTE;
   }
 
-  // Check for a route that matches the request.
-  for (const RouteEntryImplBaseConstSharedPtr& route : routes_) {
-    RouteConstSharedPtr route_entry = route->matches(headers, random_value);
+  if (routes_.empty()) {
+    return nullptr;
+  }
+
+  // Check for a route that matches the request. The index narrows the search down to the routes
+  // whose path specifier may match; they are returned in route table order so that the first
+  // route that fully matches wins, as if every route had been checked in turn.
+  PathMatchIndex::Candidates candidates;
+  route_index_.findCandidates(headers.Path()->value().getStringView(), candidates);
+  for (const uint32_t position : candidates) {
+    RouteConstSharedPtr route_entry = routes_[position]->matches(headers, random_value);
     if (nullptr != route_entry) {
       return route_entry;
     }
@@ -1107,19 +1108,15 @@ const VirtualHostImpl* RouteMatcher::findVirtualHost(const Http::HeaderMap& head
     return iter->second.get();
   }
   if (!wildcard_virtual_host_suffixes_.empty()) {
-    const VirtualHostImpl* vhost = findWildcardVirtualHost(
-        host, wildcard_virtual_host_suffixes_,
-        [](const std::string& h, int l) -> std::string { return h.substr(h.size() - l); });
+    const VirtualHostSharedPtr* vhost = wildcard_virtual_host_suffixes_.findLongestMatch(host);
     if (vhost != nullptr) {
-      return vhost;
+      return vhost->get();
     }
   }
   if (!wildcard_virtual_host_prefixes_.empty()) {
-    const VirtualHostImpl* vhost = findWildcardVirtualHost(
-        host, wildcard_virtual_host_prefixes_,
-        [](const std::string& h, int l) -> std::string { return h.substr(0, l); });
+    const VirtualHostSharedPtr* vhost = wildcard_virtual_host_prefixes_.findLongestMatch(host);
     if (vhost != nullptr) {
-      return vhost;
+      return vhost->get();
     }
   }
   return default_virtual_host_.get();
@@ -1146,7 +1143,7 @@ VirtualHostImpl::virtualClusterFromEntries(const Http::HeaderMap& headers) const
         !entry.method_ || headers.Method()->value().getStringView() == entry.method_.value();
 
     absl::string_view path_view = headers.Path()->value().getStringView();
-    if (method_matches && std::regex_match(path_view.begin(), path_view.end(), entry.pattern_)) {
+    if (method_matches && entry.pattern_->match(path_view)) {
       return &entry;
     }
   }
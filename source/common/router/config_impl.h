@@ -17,12 +17,15 @@
 #include "envoy/server/filter_config.h"
 #include "envoy/upstream/cluster_manager.h"
 
+#include "common/common/regex.h"
 #include "common/config/metadata.h"
 #include "common/http/header_utility.h"
 #include "common/router/config_utility.h"
+#include "common/router/domain_trie.h"
 #include "common/router/header_formatter.h"
 #include "common/router/header_parser.h"
 #include "common/router/metadatamatchcriteria_impl.h"
+#include "common/router/path_match_index.h"
 #include "common/router/router_ratelimit.h"
 #include "common/stats/symbol_table_impl.h"
 
@@ -105,7 +108,9 @@ public:
 
   // Router::CorsPolicy
   const std::list<std::string>& allowOrigins() const override { return allow_origin_; };
-  const std::list<std::regex>& allowOriginRegexes() const override { return allow_origin_regex_; }
+  const std::list<Regex::CompiledMatcherPtr>& allowOriginRegexes() const override {
+    return allow_origin_regex_;
+  }
   const std::string& allowMethods() const override { return allow_methods_; };
   const std::string& allowHeaders() const override { return allow_headers_; };
   const std::string& exposeHeaders() const override { return expose_headers_; };
@@ -132,7 +137,7 @@ private:
   const envoy::api::v2::route::CorsPolicy config_;
   Runtime::Loader& loader_;
   std::list<std::string> allow_origin_;
-  std::list<std::regex> allow_origin_regex_;
+  std::list<Regex::CompiledMatcherPtr> allow_origin_regex_;
   std::string allow_methods_;
   std::string allow_headers_;
   std::string expose_headers_;
@@ -182,7 +187,7 @@ private:
     // Router::VirtualCluster
     Stats::StatName statName() const override { return stat_name_; }
 
-    const std::regex pattern_;
+    const Regex::CompiledMatcherSharedPtr pattern_;
     absl::optional<std::string> method_;
     const Stats::StatName stat_name_;
   };
@@ -203,6 +208,8 @@ private:
   Stats::StatNamePool stat_name_pool_;
   const Stats::StatName stat_name_;
   std::vector<RouteEntryImplBaseConstSharedPtr> routes_;
+  // Index of routes_ by path specifier, so that only routes whose path may match are evaluated.
+  PathMatchIndex route_index_;
   std::vector<VirtualClusterEntry> virtual_clusters_;
   SslRequirements ssl_requirements_;
   const RateLimitPolicyImpl rate_limit_policy_;
@@ -757,8 +764,8 @@ public:
   void rewritePathHeader(Http::HeaderMap& headers, bool insert_envoy_original_path) const override;
 
 private:
-  const std::regex regex_;
-  const std::string regex_str_;
+  Regex::CompiledMatcherPtr regex_;
+  std::string regex_str_;
 };
 
 /**
@@ -776,26 +783,14 @@ public:
 private:
   const VirtualHostImpl* findVirtualHost(const Http::HeaderMap& headers) const;
 
-  typedef std::map<int64_t, std::unordered_map<std::string, VirtualHostSharedPtr>,
-                   std::greater<int64_t>>
-      WildcardVirtualHosts;
-  typedef std::function<std::string(const std::string&, int)> SubstringFunction;
-  const VirtualHostImpl* findWildcardVirtualHost(const std::string& host,
-                                                 const WildcardVirtualHosts& wildcard_virtual_hosts,
-                                                 SubstringFunction substring_function) const;
-
   std::unordered_map<std::string, VirtualHostSharedPtr> virtual_hosts_;
-  // std::greater as a minor optimization to iterate from more to less specific
-  //
-  // A note on using an unordered_map versus a vector of (string, VirtualHostSharedPtr) pairs:
-  //
-  // Based on local benchmarks, each vector entry costs around 20ns for recall and (string)
-  // comparison with a fixed cost of about 25ns. For unordered_map, the empty map costs about 65ns
-  // and climbs to about 110ns once there are any entries.
-  //
-  // The break-even is 4 entries.
-  WildcardVirtualHosts wildcard_virtual_host_suffixes_;
-  WildcardVirtualHosts wildcard_virtual_host_prefixes_;
+  // Wildcard domains are compiled into tries at load time so that the longest matching wildcard
+  // is found in a single pass over the host. Suffix wildcards ("*.foo.com") are walked from the
+  // end of the host, prefix wildcards ("foo.*") from its start.
+  DomainTrie<VirtualHostSharedPtr> wildcard_virtual_host_suffixes_{
+      DomainTrie<VirtualHostSharedPtr>::Direction::Reverse};
+  DomainTrie<VirtualHostSharedPtr> wildcard_virtual_host_prefixes_{
+      DomainTrie<VirtualHostSharedPtr>::Direction::Forward};
 
   VirtualHostSharedPtr default_virtual_host_;
 };
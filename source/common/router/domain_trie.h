@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "common/common/assert.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * A compiled byte trie used to find the longest wildcard domain matching a host. Keys are added
+ * with add() while the route configuration is being loaded and are then flattened by compile()
+ * into contiguous node and edge arrays. A lookup visits each byte of the host at most once and
+ * does not allocate.
+ *
+ * A Reverse trie walks keys from their last byte and so implements suffix wildcards
+ * ("*.foo.com" is stored as ".foo.com"). A Forward trie walks keys from their first byte and
+ * implements prefix wildcards ("foo.*" is stored as "foo.").
+ */
+template <class Value> class DomainTrie {
+public:
+  enum class Direction { Forward, Reverse };
+
+  explicit DomainTrie(Direction direction) : direction_(direction) { build_nodes_.emplace_back(); }
+
+  /**
+   * Adds a key to the trie. Must be called before compile().
+   * @param key supplies the non-empty wildcard key, without the '*'.
+   * @param value supplies the value associated with the key.
+   * @return false if a value already exists for the given key.
+   */
+  bool add(absl::string_view key, Value value) {
+    ASSERT(!compiled_);
+    ASSERT(!key.empty());
+    uint32_t current = 0;
+    for (size_t i = 0; i < key.size(); i++) {
+      const uint8_t c = byteAt(key, i);
+      uint32_t next = 0;
+      for (const auto& child : build_nodes_[current].children_) {
+        if (child.first == c) {
+          next = child.second;
+          break;
+        }
+      }
+      if (next == 0) {
+        next = build_nodes_.size();
+        build_nodes_[current].children_.emplace_back(c, next);
+        build_nodes_.emplace_back();
+      }
+      current = next;
+    }
+    if (build_nodes_[current].value_index_ != NoValue) {
+      return false;
+    }
+    build_nodes_[current].value_index_ = values_.size();
+    values_.emplace_back(std::move(value));
+    return true;
+  }
+
+  /**
+   * Flattens the trie into its lookup representation. No keys may be added afterwards.
+   */
+  void compile() {
+    ASSERT(!compiled_);
+    nodes_.reserve(build_nodes_.size());
+    edge_labels_.reserve(build_nodes_.size() - 1);
+    edge_children_.reserve(build_nodes_.size() - 1);
+    for (auto& build_node : build_nodes_) {
+      std::sort(build_node.children_.begin(), build_node.children_.end());
+      nodes_.push_back({static_cast<uint32_t>(edge_labels_.size()),
+                        static_cast<uint32_t>(build_node.children_.size()),
+                        build_node.value_index_});
+      for (const auto& child : build_node.children_) {
+        edge_labels_.push_back(child.first);
+        edge_children_.push_back(child.second);
+      }
+    }
+    build_nodes_.clear();
+    build_nodes_.shrink_to_fit();
+    compiled_ = true;
+  }
+
+  /**
+   * @return true if no keys have been added.
+   */
+  bool empty() const { return values_.empty(); }
+
+  /**
+   * Finds the value of the longest key that matches the given host and is strictly shorter than
+   * it, so that "*.foo.com" does not match ".foo.com".
+   * @param host supplies the lower cased host to match.
+   * @return the matching value or nullptr if there is no match.
+   */
+  const Value* findLongestMatch(absl::string_view host) const {
+    ASSERT(compiled_);
+    const Value* result = nullptr;
+    uint32_t current = 0;
+    for (size_t i = 0; i < host.size(); i++) {
+      const Node& node = nodes_[current];
+      if (node.value_index_ != NoValue) {
+        result = &values_[node.value_index_];
+      }
+      const uint8_t* first = edge_labels_.data() + node.first_edge_;
+      const uint8_t* last = first + node.edge_count_;
+      const uint8_t c = byteAt(host, i);
+      const uint8_t* edge = std::lower_bound(first, last, c);
+      if (edge == last || *edge != c) {
+        return result;
+      }
+      current = edge_children_[edge - edge_labels_.data()];
+    }
+    // A node reached after consuming the whole host is an exact match, which wildcards exclude.
+    return result;
+  }
+
+private:
+  static constexpr int32_t NoValue = -1;
+
+  struct BuildNode {
+    std::vector<std::pair<uint8_t, uint32_t>> children_;
+    int32_t value_index_{NoValue};
+  };
+
+  struct Node {
+    uint32_t first_edge_;
+    uint32_t edge_count_;
+    int32_t value_index_;
+  };
+
+  uint8_t byteAt(absl::string_view key, size_t i) const {
+    return direction_ == Direction::Forward ? key[i] : key[key.size() - 1 - i];
+  }
+
+  const Direction direction_;
+  bool compiled_{};
+  std::vector<BuildNode> build_nodes_;
+  std::vector<Node> nodes_;
+  // Edge labels are kept apart from the child indices so that the per-node search only touches
+  // the label bytes.
+  std::vector<uint8_t> edge_labels_;
+  std::vector<uint32_t> edge_children_;
+  std::vector<Value> values_;
+};
+
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,130 @@
+#include "common/router/path_match_index.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+
+#include "absl/strings/ascii.h"
+
+namespace Envoy {
+namespace Router {
+
+PathMatchIndex::PathMatchIndex() = default;
+
+void PathMatchIndex::addPrefix(absl::string_view prefix, bool case_sensitive, uint32_t position) {
+  ASSERT(!compiled_);
+  if (case_sensitive) {
+    case_sensitive_.add(prefix, true, position);
+  } else {
+    case_insensitive_.add(absl::AsciiStrToLower(prefix), true, position);
+  }
+}
+
+void PathMatchIndex::addPath(absl::string_view path, bool case_sensitive, uint32_t position) {
+  ASSERT(!compiled_);
+  if (case_sensitive) {
+    case_sensitive_.add(path, false, position);
+  } else {
+    case_insensitive_.add(absl::AsciiStrToLower(path), false, position);
+  }
+}
+
+void PathMatchIndex::addUnindexed(uint32_t position) {
+  ASSERT(!compiled_);
+  unindexed_.push_back(position);
+}
+
+void PathMatchIndex::compile() {
+  ASSERT(!compiled_);
+  case_sensitive_.compile();
+  case_insensitive_.compile();
+  compiled_ = true;
+}
+
+void PathMatchIndex::findCandidates(absl::string_view path, Candidates& candidates) const {
+  ASSERT(compiled_);
+  // Exact path routes are compared against the path without its query string.
+  const size_t path_length = std::min(path.find('?'), path.size());
+  case_sensitive_.find(path, path_length, false, candidates);
+  case_insensitive_.find(path, path_length, true, candidates);
+  candidates.insert(candidates.end(), unindexed_.begin(), unindexed_.end());
+  std::sort(candidates.begin(), candidates.end());
+}
+
+PathMatchIndex::Trie::Trie() { build_nodes_.emplace_back(); }
+
+void PathMatchIndex::Trie::add(absl::string_view key, bool prefix, uint32_t position) {
+  uint32_t current = 0;
+  for (const uint8_t c : key) {
+    uint32_t next = 0;
+    for (const auto& child : build_nodes_[current].children_) {
+      if (child.first == c) {
+        next = child.second;
+        break;
+      }
+    }
+    if (next == 0) {
+      next = build_nodes_.size();
+      build_nodes_[current].children_.emplace_back(c, next);
+      build_nodes_.emplace_back();
+    }
+    current = next;
+  }
+  if (prefix) {
+    build_nodes_[current].prefixes_.push_back(position);
+  } else {
+    build_nodes_[current].paths_.push_back(position);
+  }
+}
+
+void PathMatchIndex::Trie::compile() {
+  nodes_.reserve(build_nodes_.size());
+  for (auto& build_node : build_nodes_) {
+    std::sort(build_node.children_.begin(), build_node.children_.end());
+    nodes_.push_back({static_cast<uint32_t>(edge_labels_.size()),
+                      static_cast<uint32_t>(build_node.children_.size()),
+                      static_cast<uint32_t>(prefixes_.size()),
+                      static_cast<uint32_t>(build_node.prefixes_.size()),
+                      static_cast<uint32_t>(paths_.size()),
+                      static_cast<uint32_t>(build_node.paths_.size())});
+    for (const auto& child : build_node.children_) {
+      edge_labels_.push_back(child.first);
+      edge_children_.push_back(child.second);
+    }
+    prefixes_.insert(prefixes_.end(), build_node.prefixes_.begin(), build_node.prefixes_.end());
+    paths_.insert(paths_.end(), build_node.paths_.begin(), build_node.paths_.end());
+  }
+  build_nodes_.clear();
+  build_nodes_.shrink_to_fit();
+}
+
+void PathMatchIndex::Trie::find(absl::string_view path, size_t path_length, bool lower_case,
+                                Candidates& candidates) const {
+  uint32_t current = 0;
+  size_t depth = 0;
+  while (true) {
+    const Node& node = nodes_[current];
+    candidates.insert(candidates.end(), prefixes_.begin() + node.first_prefix_,
+                      prefixes_.begin() + node.first_prefix_ + node.prefix_count_);
+    if (depth == path_length) {
+      candidates.insert(candidates.end(), paths_.begin() + node.first_path_,
+                        paths_.begin() + node.first_path_ + node.path_count_);
+    }
+    if (depth == path.size() || node.edge_count_ == 0) {
+      return;
+    }
+
+    const uint8_t c = lower_case ? absl::ascii_tolower(path[depth]) : path[depth];
+    const uint8_t* first = edge_labels_.data() + node.first_edge_;
+    const uint8_t* last = first + node.edge_count_;
+    const uint8_t* edge = std::lower_bound(first, last, c);
+    if (edge == last || *edge != c) {
+      return;
+    }
+    current = edge_children_[edge - edge_labels_.data()];
+    depth++;
+  }
+}
+
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * An index over the path specifiers of the routes in a virtual host. Each route is identified by
+ * its position in the route table. Prefix and exact path routes are stored in byte tries (one for
+ * case sensitive and one for case insensitive routes), so that a single walk over the request
+ * path finds every prefix and exact path route whose path specifier matches. Routes that cannot
+ * be indexed (e.g. regex routes) are always returned as candidates.
+ *
+ * The index only narrows down the routes to evaluate: each candidate still has to be fully matched
+ * against the request, including its runtime, header and query parameter matchers.
+ */
+class PathMatchIndex {
+public:
+  using Candidates = absl::InlinedVector<uint32_t, 16>;
+
+  PathMatchIndex();
+
+  /**
+   * Adds a prefix route. Must be called before compile().
+   */
+  void addPrefix(absl::string_view prefix, bool case_sensitive, uint32_t position);
+
+  /**
+   * Adds an exact path route. Must be called before compile().
+   */
+  void addPath(absl::string_view path, bool case_sensitive, uint32_t position);
+
+  /**
+   * Adds a route that is a candidate for every request path. Must be called before compile().
+   */
+  void addUnindexed(uint32_t position);
+
+  /**
+   * Flattens the index into its lookup representation. No routes may be added afterwards.
+   */
+  void compile();
+
+  /**
+   * Finds the routes whose path specifier may match the given request path.
+   * @param path supplies the request path, including the query string if any.
+   * @param candidates supplies the container the positions of the candidate routes are written
+   *        to, in ascending order.
+   */
+  void findCandidates(absl::string_view path, Candidates& candidates) const;
+
+private:
+  class Trie {
+  public:
+    Trie();
+
+    void add(absl::string_view key, bool prefix, uint32_t position);
+    void compile();
+    void find(absl::string_view path, size_t path_length, bool lower_case,
+              Candidates& candidates) const;
+
+  private:
+    struct BuildNode {
+      std::vector<std::pair<uint8_t, uint32_t>> children_;
+      std::vector<uint32_t> prefixes_;
+      std::vector<uint32_t> paths_;
+    };
+
+    struct Node {
+      uint32_t first_edge_;
+      uint32_t edge_count_;
+      uint32_t first_prefix_;
+      uint32_t prefix_count_;
+      uint32_t first_path_;
+      uint32_t path_count_;
+    };
+
+    std::vector<BuildNode> build_nodes_;
+    std::vector<Node> nodes_;
+    std::vector<uint8_t> edge_labels_;
+    std::vector<uint32_t> edge_children_;
+    std::vector<uint32_t> prefixes_;
+    std::vector<uint32_t> paths_;
+  };
+
+  bool compiled_{};
+  Trie case_sensitive_;
+  Trie case_insensitive_;
+  std::vector<uint32_t> unindexed_;
+};
+
+} // namespace Router
+} // namespace Envoy
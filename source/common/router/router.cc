@@ -614,6 +614,7 @@ void Filter::onResponseTimeout() {
       if (!upstream_request->outlier_detection_timeout_recorded_) {
         updateOutlierDetection(timeout_response_code_, *upstream_request);
       }
+      putUpstreamResponseTime(*upstream_request);
       upstream_request->resetStream();
 
       chargeUpstreamAbort(timeout_response_code_, false, *upstream_request);
@@ -667,6 +668,7 @@ void Filter::onPerTryTimeout(UpstreamRequest& upstream_request) {
   upstream_request.resetStream();
 
   updateOutlierDetection(timeout_response_code_, upstream_request);
+  putUpstreamResponseTime(upstream_request);
 
   if (maybeRetryReset(Http::StreamResetReason::LocalReset, upstream_request)) {
     return;
@@ -680,6 +682,28 @@ void Filter::onPerTryTimeout(UpstreamRequest& upstream_request) {
                          StreamInfo::ResponseCodeDetails::get().UpstreamPerTryTimeout);
 }
 
+void Filter::putUpstreamResponseTime(UpstreamRequest& upstream_request) {
+  // The load balancer steers by the time the upstream took to respond, which leaves out the time
+  // spent waiting for the downstream to send the request. Requests that time out or are reset
+  // report the time until then, as the upstream took at least that long. Only the peak EWMA load
+  // balancer uses them, so the others are spared the cluster lookup.
+  if (cluster_->lbType() != Upstream::LoadBalancerType::PeakEwma ||
+      !upstream_request.upstream_host_ ||
+      !upstream_request.upstream_timing_.first_upstream_tx_byte_sent_) {
+    return;
+  }
+  // The thread local cluster may not be kept across event loop iterations, as a cluster update
+  // replaces it.
+  Upstream::ThreadLocalCluster* cluster = config_.cm_.get(cluster_->name());
+  if (cluster == nullptr) {
+    return;
+  }
+  const auto response_time = std::chrono::duration_cast<std::chrono::microseconds>(
+      callbacks_->dispatcher().timeSource().monotonicTime() -
+      upstream_request.upstream_timing_.first_upstream_tx_byte_sent_.value());
+  cluster->loadBalancer().putResponseTime(*upstream_request.upstream_host_, response_time);
+}
+
 void Filter::updateOutlierDetection(Http::Code code, UpstreamRequest& upstream_request) {
   if (upstream_request.upstream_host_) {
     upstream_request.upstream_host_->outlierDetector().putHttpResponseCode(enumToInt(code));
@@ -772,6 +796,7 @@ void Filter::onUpstreamReset(Http::StreamResetReason reset_reason,
                    Http::Utility::resetReasonToString(reset_reason));
 
   updateOutlierDetection(Http::Code::ServiceUnavailable, upstream_request);
+  putUpstreamResponseTime(upstream_request);
 
   if (maybeRetryReset(reset_reason, upstream_request)) {
     return;
@@ -1049,6 +1074,8 @@ void Filter::onUpstreamComplete(UpstreamRequest& upstream_request) {
   }
   callbacks_->streamInfo().setUpstreamTiming(final_upstream_request_->upstream_timing_);
 
+  putUpstreamResponseTime(upstream_request);
+
   if (config_.emit_dynamic_stats_ && !callbacks_->streamInfo().healthCheck() &&
       DateUtil::timePointValid(downstream_request_complete_time_)) {
     Event::Dispatcher& dispatcher = callbacks_->dispatcher();
@@ -226,6 +226,7 @@ public:
     }
     return nullptr;
   }
+  bool metadataMatchCriteriaPerRequest() const override { return metadata_match_ != nullptr; }
   const Network::Connection* downstreamConnection() const override {
     return callbacks_->connection();
   }
@@ -467,6 +468,8 @@ private:
   void sendNoHealthyUpstreamResponse();
   bool setupRetry();
   bool setupRedirect(const Http::HeaderMap& headers, UpstreamRequest& upstream_request);
+  // Report the time the upstream took so far to the load balancer of the cluster, if it uses it.
+  void putUpstreamResponseTime(UpstreamRequest& upstream_request);
   void updateOutlierDetection(Http::Code code, UpstreamRequest& upstream_request);
   void doRetry();
   // Called immediately after a non-5xx header is received from upstream, performs stats accounting
@@ -123,11 +123,22 @@ void SymbolTableImpl::addTokensToEncoding(const absl::string_view name, Encoding
   symbols.reserve(tokens.size());
 
   // Now take the lock and populate the Symbol objects, which involves bumping
-  // ref-counts in this.
+  // ref-counts in this. Tokens that are already interned only need the lock
+  // shared; the exclusive lock is taken for the remaining tokens, if any.
   {
-    Thread::LockGuard lock(lock_);
+    absl::ReaderMutexLock lock(&lock_);
     for (auto& token : tokens) {
-      symbols.push_back(toSymbol(token));
+      Symbol symbol;
+      if (!findAndRefSymbol(token, symbol)) {
+        break;
+      }
+      symbols.push_back(symbol);
+    }
+  }
+  if (symbols.size() < tokens.size()) {
+    absl::MutexLock lock(&lock_);
+    for (size_t i = symbols.size(); i < tokens.size(); ++i) {
+      symbols.push_back(toSymbol(tokens[i]));
     }
   }
 
@@ -138,7 +149,7 @@ void SymbolTableImpl::addTokensToEncoding(const absl::string_view name, Encoding
 }
 
 uint64_t SymbolTableImpl::numSymbols() const {
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   ASSERT(encode_map_.size() == decode_map_.size());
   return encode_map_.size();
 }
@@ -157,7 +168,7 @@ std::string SymbolTableImpl::decodeSymbolVec(const SymbolVec& symbols) const {
   name_tokens.reserve(symbols.size());
   {
     // Hold the lock only while decoding symbols.
-    Thread::LockGuard lock(lock_);
+    absl::ReaderMutexLock lock(&lock_);
     for (Symbol symbol : symbols) {
       name_tokens.push_back(fromSymbol(symbol));
     }
@@ -169,7 +180,7 @@ void SymbolTableImpl::incRefCount(const StatName& stat_name) {
   // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name.data(), stat_name.dataSize());
 
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   for (Symbol symbol : symbols) {
     auto decode_search = decode_map_.find(symbol);
     ASSERT(decode_search != decode_map_.end());
@@ -177,7 +188,7 @@ void SymbolTableImpl::incRefCount(const StatName& stat_name) {
     auto encode_search = encode_map_.find(decode_search->second->toStringView());
     ASSERT(encode_search != encode_map_.end());
 
-    ++encode_search->second.ref_count_;
+    encode_search->second.ref_count_.fetch_add(1, std::memory_order_relaxed);
   }
 }
 
@@ -185,27 +196,58 @@ void SymbolTableImpl::free(const StatName& stat_name) {
   // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name.data(), stat_name.dataSize());
 
-  Thread::LockGuard lock(lock_);
-  for (Symbol symbol : symbols) {
-    auto decode_search = decode_map_.find(symbol);
-    ASSERT(decode_search != decode_map_.end());
+  // Decrement the ref-counts with the lock held shared, collecting the symbols
+  // that are no longer referenced.
+  SymbolVec unreferenced;
+  {
+    absl::ReaderMutexLock lock(&lock_);
+    for (Symbol symbol : symbols) {
+      auto decode_search = decode_map_.find(symbol);
+      ASSERT(decode_search != decode_map_.end());
+
+      auto encode_search = encode_map_.find(decode_search->second->toStringView());
+      ASSERT(encode_search != encode_map_.end());
+
+      if (encode_search->second.ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        unreferenced.push_back(symbol);
+      }
+    }
+  }
+  if (unreferenced.empty()) {
+    return;
+  }
 
+  // If that was the last remaining client usage of a symbol, erase the current
+  // mappings and add the now-unused symbol to the reuse pool. Another thread
+  // may have looked the symbol up again, or already erased it (and possibly
+  // reused it for another string) before we got the exclusive lock, so a symbol
+  // is only erased if it is still unreferenced.
+  absl::MutexLock lock(&lock_);
+  for (Symbol symbol : unreferenced) {
+    auto decode_search = decode_map_.find(symbol);
+    if (decode_search == decode_map_.end()) {
+      continue;
+    }
     auto encode_search = encode_map_.find(decode_search->second->toStringView());
     ASSERT(encode_search != encode_map_.end());
-
-    // If that was the last remaining client usage of the symbol, erase the
-    // current mappings and add the now-unused symbol to the reuse pool.
-    //
-    // The "if (--EXPR.ref_count_)" pattern speeds up BM_CreateRace by 20% in
-    // symbol_table_speed_test.cc, relative to breaking out the decrement into a
-    // separate step, likely due to the non-trivial dereferences in EXPR.
-    if (--encode_search->second.ref_count_ == 0) {
-      decode_map_.erase(decode_search);
+    if (encode_search->second.ref_count_.load(std::memory_order_acquire) == 0) {
       encode_map_.erase(encode_search);
+      decode_map_.erase(decode_search);
       pool_.push(symbol);
     }
   }
 }
+
+bool SymbolTableImpl::findAndRefSymbol(absl::string_view sv, Symbol& symbol) {
+  auto encode_find = encode_map_.find(sv);
+  if (encode_find == encode_map_.end()) {
+    return false;
+  }
+  symbol = encode_find->second.symbol_;
+  encode_find->second.ref_count_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
 Symbol SymbolTableImpl::toSymbol(absl::string_view sv) {
   Symbol result;
   auto encode_find = encode_map_.find(sv);
@@ -227,13 +269,13 @@ Symbol SymbolTableImpl::toSymbol(absl::string_view sv) {
     // If the insertion didn't take place, return the actual value at that location and up the
     // refcount at that location
     result = encode_find->second.symbol_;
-    ++(encode_find->second.ref_count_);
+    encode_find->second.ref_count_.fetch_add(1, std::memory_order_relaxed);
   }
   return result;
 }
 
 absl::string_view SymbolTableImpl::fromSymbol(const Symbol symbol) const
-    EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    SHARED_LOCKS_REQUIRED(lock_) {
   auto search = decode_map_.find(symbol);
   RELEASE_ASSERT(search != decode_map_.end(), "no such symbol");
   return search->second->toStringView();
@@ -260,7 +302,7 @@ bool SymbolTableImpl::lessThan(const StatName& a, const StatName& b) const {
 
   // Calling fromSymbol requires holding the lock, as it needs read-access to
   // the maps that are written when adding new symbols.
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   for (uint64_t i = 0, n = std::min(av.size(), bv.size()); i < n; ++i) {
     if (av[i] != bv[i]) {
       bool ret = fromSymbol(av[i]) < fromSymbol(bv[i]);
@@ -272,7 +314,7 @@ bool SymbolTableImpl::lessThan(const StatName& a, const StatName& b) const {
 
 #ifndef ENVOY_CONFIG_COVERAGE
 void SymbolTableImpl::debugPrint() const {
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   std::vector<Symbol> symbols;
   for (const auto& p : decode_map_) {
     symbols.push_back(p.first);
@@ -281,7 +323,8 @@ void SymbolTableImpl::debugPrint() const {
   for (Symbol symbol : symbols) {
     const InlineString& token = *decode_map_.find(symbol)->second;
     const SharedSymbol& shared_symbol = encode_map_.find(token.toStringView())->second;
-    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token.toStringView(), shared_symbol.ref_count_);
+    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token.toStringView(),
+                   shared_symbol.ref_count_.load());
   }
 }
 #endif
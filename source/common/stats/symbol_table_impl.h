@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <memory>
 #include <stack>
@@ -22,6 +23,7 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Stats {
@@ -165,13 +167,20 @@ private:
 
   struct SharedSymbol {
     SharedSymbol(Symbol symbol) : symbol_(symbol), ref_count_(1) {}
+    // The map only moves symbols while rehashing, which requires the exclusive lock.
+    SharedSymbol(SharedSymbol&& src)
+        : symbol_(src.symbol_), ref_count_(src.ref_count_.load(std::memory_order_relaxed)) {}
 
     Symbol symbol_;
-    uint32_t ref_count_;
+    // Updated atomically under a shared lock when the symbol already exists. A symbol is only
+    // erased under the exclusive lock, once its count is observed to be zero.
+    std::atomic<uint32_t> ref_count_;
   };
 
-  // This must be held during both encode() and free().
-  mutable Thread::MutexBasicLockable lock_;
+  // Lookups of existing symbols, including their ref-count changes, hold this shared; adding and
+  // erasing symbols holds it exclusively. Stats are mostly created with already-interned tokens,
+  // so concurrent encodes and frees from workers do not serialize.
+  mutable absl::Mutex lock_;
 
   /**
    * Decodes a vector of symbols back into its period-delimited stat name. If
@@ -198,7 +207,16 @@ private:
    * @param symbol the individual symbol to be decoded.
    * @return absl::string_view the decoded string.
    */
-  absl::string_view fromSymbol(Symbol symbol) const EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  absl::string_view fromSymbol(Symbol symbol) const SHARED_LOCKS_REQUIRED(lock_);
+
+  /**
+   * Looks up an existing symbol and takes a reference to it.
+   *
+   * @param sv the individual string to be looked up.
+   * @param symbol receives the symbol, if it exists.
+   * @return bool whether the string was already interned.
+   */
+  bool findAndRefSymbol(absl::string_view sv, Symbol& symbol) SHARED_LOCKS_REQUIRED(lock_);
 
   /**
    * Stages a new symbol for use. To be called after a successful insertion.
@@ -215,7 +233,7 @@ private:
   void addTokensToEncoding(absl::string_view name, Encoding& encoding);
 
   Symbol monotonicCounter() {
-    Thread::LockGuard lock(lock_);
+    absl::MutexLock lock(&lock_);
     return monotonic_counter_;
   }
 
@@ -0,0 +1,174 @@
+#include "common/tcp_proxy/splice_forwarder.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace TcpProxy {
+
+namespace {
+
+// Rounds of reading and writing one direction does per event before it yields to other
+// connections. Each round moves up to a pipe's worth of bytes.
+constexpr uint32_t MaxRoundsPerEvent = 16;
+
+} // namespace
+
+SpliceForwarder::Direction::~Direction() {
+  for (int fd : pipe_) {
+    if (fd != -1) {
+      ::close(fd);
+    }
+  }
+}
+
+#ifdef __linux__
+
+bool SpliceForwarder::isSupported() { return true; }
+
+std::unique_ptr<SpliceForwarder> SpliceForwarder::create(Event::Dispatcher& dispatcher,
+                                                         Network::IoHandle& downstream,
+                                                         Network::IoHandle& upstream,
+                                                         Callbacks& callbacks) {
+  std::unique_ptr<SpliceForwarder> forwarder(new SpliceForwarder(downstream, upstream, callbacks));
+  if (!forwarder->createPipe(forwarder->downstream_to_upstream_) ||
+      !forwarder->createPipe(forwarder->upstream_to_downstream_)) {
+    return nullptr;
+  }
+
+  SpliceForwarder* raw = forwarder.get();
+  forwarder->downstream_event_ = dispatcher.createFileEvent(
+      downstream.fd(), [raw](uint32_t) { raw->onFileEvent(); },
+      Event::FileTriggerType::Edge, Event::FileReadyType::Read | Event::FileReadyType::Write);
+  forwarder->upstream_event_ = dispatcher.createFileEvent(
+      upstream.fd(), [raw](uint32_t) { raw->onFileEvent(); },
+      Event::FileTriggerType::Edge, Event::FileReadyType::Read | Event::FileReadyType::Write);
+  // Bytes may have arrived before the events were created.
+  forwarder->downstream_event_->activate(Event::FileReadyType::Read);
+  forwarder->upstream_event_->activate(Event::FileReadyType::Read);
+  return forwarder;
+}
+
+bool SpliceForwarder::createPipe(Direction& direction) {
+  if (::pipe2(direction.pipe_, O_NONBLOCK | O_CLOEXEC) != 0) {
+    ENVOY_LOG(debug, "splice: pipe2 failed: {}", strerror(errno));
+    return false;
+  }
+  const int pipe_size = ::fcntl(direction.pipe_[0], F_GETPIPE_SZ);
+  if (pipe_size <= 0) {
+    return false;
+  }
+  direction.pipe_size_ = pipe_size;
+  return true;
+}
+
+bool SpliceForwarder::pump(Direction& direction) {
+  const unsigned int flags = SPLICE_F_MOVE | SPLICE_F_NONBLOCK;
+  for (uint32_t round = 0; round < MaxRoundsPerEvent; round++) {
+    bool progress = false;
+
+    // The pipe counts buffers rather than bytes, so it may refuse bytes before pipe_size_ is
+    // reached. That reads as EAGAIN, which is fine: the pipe gets drained below, and the read is
+    // retried in the next round or on the next writable event of the other socket.
+    if (!direction.end_stream_read_ && direction.in_pipe_ < direction.pipe_size_) {
+      const ssize_t rc = ::splice(direction.from_->fd(), nullptr, direction.pipe_[1], nullptr,
+                                  direction.pipe_size_ - direction.in_pipe_, flags);
+      if (rc > 0) {
+        direction.in_pipe_ += rc;
+        progress = true;
+        callbacks_.onSpliceRead(direction.from_side_, rc);
+      } else if (rc == 0) {
+        direction.end_stream_read_ = true;
+      } else if (errno != EAGAIN) {
+        ENVOY_LOG(debug, "splice: read failed: {}", strerror(errno));
+        return false;
+      }
+    }
+
+    if (direction.in_pipe_ > 0) {
+      const ssize_t rc = ::splice(direction.pipe_[0], nullptr, direction.to_->fd(), nullptr,
+                                  direction.in_pipe_, flags);
+      if (rc > 0) {
+        ASSERT(static_cast<uint64_t>(rc) <= direction.in_pipe_);
+        direction.in_pipe_ -= rc;
+        progress = true;
+        callbacks_.onSpliceWritten(direction.to_side_, rc);
+      } else if (rc < 0 && errno != EAGAIN) {
+        ENVOY_LOG(debug, "splice: write failed: {}", strerror(errno));
+        return false;
+      }
+    }
+
+    if (direction.end_stream_read_ && direction.in_pipe_ == 0 && !direction.shutdown_) {
+      direction.shutdown_ = true;
+      if (direction.to_->shutdown(SHUT_WR).rc_ != 0) {
+        return false;
+      }
+    }
+
+    if (!progress) {
+      return true;
+    }
+  }
+
+  // There is more to move; continue on the next event loop iteration.
+  Event::FileEvent& from_event =
+      direction.from_side_ == Side::Downstream ? *downstream_event_ : *upstream_event_;
+  from_event.activate(Event::FileReadyType::Read);
+  return true;
+}
+
+#else
+
+bool SpliceForwarder::isSupported() { return false; }
+
+std::unique_ptr<SpliceForwarder> SpliceForwarder::create(Event::Dispatcher&, Network::IoHandle&,
+                                                         Network::IoHandle&, Callbacks&) {
+  return nullptr;
+}
+
+bool SpliceForwarder::createPipe(Direction&) { NOT_REACHED_GCOVR_EXCL_LINE; }
+bool SpliceForwarder::pump(Direction&) { NOT_REACHED_GCOVR_EXCL_LINE; }
+
+#endif
+
+SpliceForwarder::SpliceForwarder(Network::IoHandle& downstream, Network::IoHandle& upstream,
+                                 Callbacks& callbacks)
+    : callbacks_(callbacks) {
+  downstream_to_upstream_.from_ = &downstream;
+  downstream_to_upstream_.to_ = &upstream;
+  downstream_to_upstream_.from_side_ = Side::Downstream;
+  downstream_to_upstream_.to_side_ = Side::Upstream;
+  upstream_to_downstream_.from_ = &upstream;
+  upstream_to_downstream_.to_ = &downstream;
+  upstream_to_downstream_.from_side_ = Side::Upstream;
+  upstream_to_downstream_.to_side_ = Side::Downstream;
+}
+
+SpliceForwarder::~SpliceForwarder() = default;
+
+void SpliceForwarder::onFileEvent() {
+  // Either socket becoming readable or writable can unblock either direction, and errors are
+  // reported as both, so try both directions on every event.
+  if (!pump(downstream_to_upstream_) || !pump(upstream_to_downstream_)) {
+    done(true);
+    return;
+  }
+  if (downstream_to_upstream_.shutdown_ && upstream_to_downstream_.shutdown_) {
+    done(false);
+  }
+}
+
+void SpliceForwarder::done(bool error) {
+  downstream_event_.reset();
+  upstream_event_.reset();
+  callbacks_.onSpliceDone(error);
+}
+
+} // namespace TcpProxy
+} // namespace Envoy
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/file_event.h"
+#include "envoy/network/io_handle.h"
+
+#include "common/common/logger.h"
+
+namespace Envoy {
+namespace TcpProxy {
+
+/**
+ * Moves bytes between a downstream and an upstream socket with splice(2), through one pipe per
+ * direction, so that they never get copied to user space. When a socket reaches end of stream the
+ * other one is shut down for writes once the pipe has drained, which keeps half-closed
+ * connections working. Only available on Linux.
+ */
+class SpliceForwarder : Logger::Loggable<Logger::Id::filter> {
+public:
+  enum class Side { Downstream, Upstream };
+
+  class Callbacks {
+  public:
+    virtual ~Callbacks() = default;
+
+    /**
+     * Called when bytes were read from a socket into its pipe.
+     * @param side supplies the socket that was read.
+     * @param bytes supplies the number of bytes read.
+     */
+    virtual void onSpliceRead(Side side, uint64_t bytes) PURE;
+
+    /**
+     * Called when bytes were written to a socket from the pipe of the other one.
+     * @param side supplies the socket that was written.
+     * @param bytes supplies the number of bytes written.
+     */
+    virtual void onSpliceWritten(Side side, uint64_t bytes) PURE;
+
+    /**
+     * Called once both directions have reached end of stream and drained, or a system call failed.
+     * The forwarder has stopped watching the sockets by then and may be destroyed after the call
+     * returns.
+     * @param error supplies whether a system call failed.
+     */
+    virtual void onSpliceDone(bool error) PURE;
+  };
+
+  /**
+   * @return bool whether splice(2) can be used on this platform.
+   */
+  static bool isSupported();
+
+  /**
+   * Start forwarding. The sockets must be non-blocking, and the connections owning them must not
+   * read or write them for as long as the forwarder exists.
+   * @param dispatcher supplies the dispatcher the sockets are watched on.
+   * @param downstream supplies the downstream socket.
+   * @param upstream supplies the upstream socket.
+   * @param callbacks supplies the callbacks, which must not destroy the forwarder other than from
+   *        onSpliceDone().
+   * @return std::unique_ptr<SpliceForwarder> the forwarder, or nullptr if the pipes could not be
+   *         created.
+   */
+  static std::unique_ptr<SpliceForwarder> create(Event::Dispatcher& dispatcher,
+                                                 Network::IoHandle& downstream,
+                                                 Network::IoHandle& upstream,
+                                                 Callbacks& callbacks);
+
+  ~SpliceForwarder();
+
+private:
+  // The bytes flowing from one socket to the other.
+  struct Direction {
+    ~Direction();
+
+    Network::IoHandle* from_{};
+    Network::IoHandle* to_{};
+    Side from_side_;
+    Side to_side_;
+    int pipe_[2]{-1, -1};
+    uint64_t pipe_size_{};
+    uint64_t in_pipe_{};
+    bool end_stream_read_{};
+    bool shutdown_{};
+  };
+
+  SpliceForwarder(Network::IoHandle& downstream, Network::IoHandle& upstream,
+                  Callbacks& callbacks);
+
+  bool createPipe(Direction& direction);
+  void onFileEvent();
+  // Moves what can be moved without blocking. Returns false if a system call failed.
+  bool pump(Direction& direction);
+  void done(bool error);
+
+  Callbacks& callbacks_;
+  Direction downstream_to_upstream_;
+  Direction upstream_to_downstream_;
+  Event::FileEventPtr downstream_event_;
+  Event::FileEventPtr upstream_event_;
+};
+
+typedef std::unique_ptr<SpliceForwarder> SpliceForwarderPtr;
+
+} // namespace TcpProxy
+} // namespace Envoy
@@ -66,6 +66,7 @@ Config::SharedConfig::SharedConfig(
 Config::Config(const envoy::config::filter::network::tcp_proxy::v2::TcpProxy& config,
                Server::Configuration::FactoryContext& context)
     : max_connect_attempts_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_connect_attempts, 1)),
+      splice_(config.splice()),
       upstream_drain_manager_slot_(context.threadLocal().allocateSlot()),
       shared_config_(std::make_shared<SharedConfig>(config, context)),
       random_generator_(context.random()) {
@@ -442,9 +443,64 @@ void Filter::onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr&& conn_data,
   // Simulate the event that onPoolReady represents.
   upstream_callbacks_->onEvent(Network::ConnectionEvent::Connected);
 
+  maybeStartSplice();
   read_callbacks_->continueReading();
 }
 
+void Filter::maybeStartSplice() {
+  if (!config_->splice() || !SpliceForwarder::isSupported()) {
+    return;
+  }
+
+  Network::Connection& downstream = read_callbacks_->connection();
+  Network::Connection& upstream = upstream_conn_data_->connection();
+  Network::IoHandle* downstream_io_handle = downstream.spliceableIoHandle();
+  Network::IoHandle* upstream_io_handle = upstream.spliceableIoHandle();
+  if (downstream_io_handle == nullptr || upstream_io_handle == nullptr) {
+    ENVOY_CONN_LOG(debug, "bytes must pass through the connections, not splicing", downstream);
+    return;
+  }
+
+  splice_forwarder_ = SpliceForwarder::create(downstream.dispatcher(), *downstream_io_handle,
+                                              *upstream_io_handle, *this);
+  if (splice_forwarder_ == nullptr) {
+    return;
+  }
+  ENVOY_CONN_LOG(debug, "splicing", downstream);
+  config_->stats().downstream_cx_splice_total_.inc();
+  // The forwarder reads the sockets from now on.
+  downstream.readDisable(true);
+  upstream.readDisable(true);
+}
+
+void Filter::onSpliceRead(SpliceForwarder::Side side, uint64_t bytes) {
+  if (side == SpliceForwarder::Side::Downstream) {
+    getStreamInfo().addBytesReceived(bytes);
+    read_callbacks_->connection().addSplicedBytes(bytes, 0);
+  } else {
+    getStreamInfo().addBytesSent(bytes);
+    upstream_conn_data_->connection().addSplicedBytes(bytes, 0);
+  }
+  resetIdleTimer();
+}
+
+void Filter::onSpliceWritten(SpliceForwarder::Side side, uint64_t bytes) {
+  // This runs the bytes sent callbacks, which reset the idle timer.
+  if (side == SpliceForwarder::Side::Downstream) {
+    read_callbacks_->connection().addSplicedBytes(0, bytes);
+  } else {
+    upstream_conn_data_->connection().addSplicedBytes(0, bytes);
+  }
+}
+
+void Filter::onSpliceDone(bool error) {
+  ENVOY_CONN_LOG(debug, "splicing {}", read_callbacks_->connection(),
+                 error ? "failed" : "complete");
+  // Both directions have been shut down, or can not make progress, so there is nothing left to
+  // flush. This also closes the upstream connection.
+  read_callbacks_->connection().close(Network::ConnectionCloseType::NoFlush);
+}
+
 void Filter::onConnectTimeout() {
   ENVOY_CONN_LOG(debug, "connect timeout", read_callbacks_->connection());
   read_callbacks_->upstreamHost()->outlierDetector().putResult(Upstream::Outlier::Result::TIMEOUT);
@@ -465,6 +521,12 @@ Network::FilterStatus Filter::onData(Buffer::Instance& data, bool end_stream) {
 }
 
 void Filter::onDownstreamEvent(Network::ConnectionEvent event) {
+  if (event == Network::ConnectionEvent::RemoteClose ||
+      event == Network::ConnectionEvent::LocalClose) {
+    // Stop watching the sockets before they are closed.
+    splice_forwarder_.reset();
+  }
+
   if (upstream_conn_data_) {
     if (event == Network::ConnectionEvent::RemoteClose) {
       upstream_conn_data_->connection().close(Network::ConnectionCloseType::FlushWrite);
@@ -513,6 +575,7 @@ void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
 
   if (event == Network::ConnectionEvent::RemoteClose ||
       event == Network::ConnectionEvent::LocalClose) {
+    splice_forwarder_.reset();
     upstream_conn_data_.reset();
     disableIdleTimer();
 
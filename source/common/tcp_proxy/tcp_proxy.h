@@ -26,6 +26,7 @@
 #include "common/network/filter_impl.h"
 #include "common/network/utility.h"
 #include "common/stream_info/stream_info_impl.h"
+#include "common/tcp_proxy/splice_forwarder.h"
 #include "common/upstream/load_balancer_impl.h"
 
 namespace Envoy {
@@ -37,6 +38,7 @@ namespace TcpProxy {
 #define ALL_TCP_PROXY_STATS(COUNTER, GAUGE)                                                        \
   COUNTER(downstream_cx_no_route)                                                                  \
   COUNTER(downstream_cx_rx_bytes_total)                                                            \
+  COUNTER(downstream_cx_splice_total)                                                              \
   COUNTER(downstream_cx_total)                                                                     \
   COUNTER(downstream_cx_tx_bytes_total)                                                            \
   COUNTER(downstream_flow_control_paused_reading_total)                                            \
@@ -105,6 +107,7 @@ public:
   const TcpProxyStats& stats() { return shared_config_->stats(); }
   const std::vector<AccessLog::InstanceSharedPtr>& accessLogs() { return access_logs_; }
   uint32_t maxConnectAttempts() const { return max_connect_attempts_; }
+  bool splice() const { return splice_; }
   const absl::optional<std::chrono::milliseconds>& idleTimeout() {
     return shared_config_->idleTimeout();
   }
@@ -145,6 +148,7 @@ private:
   uint64_t total_cluster_weight_;
   std::vector<AccessLog::InstanceSharedPtr> access_logs_;
   const uint32_t max_connect_attempts_;
+  const bool splice_;
   ThreadLocal::SlotPtr upstream_drain_manager_slot_;
   SharedConfigSharedPtr shared_config_;
   std::unique_ptr<const Router::MetadataMatchCriteria> cluster_metadata_match_criteria_;
@@ -174,6 +178,7 @@ private:
 class Filter : public Network::ReadFilter,
                public Upstream::LoadBalancerContextBase,
                Tcp::ConnectionPool::Callbacks,
+               SpliceForwarder::Callbacks,
                protected Logger::Loggable<Logger::Id::filter> {
 public:
   Filter(ConfigSharedPtr config, Upstream::ClusterManager& cluster_manager,
@@ -200,6 +205,11 @@ public:
     return &read_callbacks_->connection();
   }
 
+  // TcpProxy::SpliceForwarder::Callbacks
+  void onSpliceRead(SpliceForwarder::Side side, uint64_t bytes) override;
+  void onSpliceWritten(SpliceForwarder::Side side, uint64_t bytes) override;
+  void onSpliceDone(bool error) override;
+
   // These two functions allow enabling/disabling reads on the upstream and downstream connections.
   // They are called by the Downstream/Upstream Watermark callbacks to limit buffering.
   void readDisableUpstream(bool disable);
@@ -271,6 +281,8 @@ protected:
   void onIdleTimeout();
   void resetIdleTimer();
   void disableIdleTimer();
+  // Moves the bytes of both connections with splice(2) if they allow it.
+  void maybeStartSplice();
 
   const ConfigSharedPtr config_;
   Upstream::ClusterManager& cluster_manager_;
@@ -282,6 +294,7 @@ protected:
   std::shared_ptr<UpstreamCallbacks> upstream_callbacks_; // shared_ptr required for passing as a
                                                           // read filter.
   StreamInfo::StreamInfoImpl stream_info_;
+  SpliceForwarderPtr splice_forwarder_;
   uint32_t connect_attempts_{};
   bool connecting_{};
 };
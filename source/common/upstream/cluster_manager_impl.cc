@@ -49,6 +49,14 @@ void addOptionsIfNotNull(Network::Socket::OptionsSharedPtr& options,
   }
 }
 
+// Whether membership updates of the cluster are merged along with health/weight/metadata changes.
+// See `Cluster.CommonLbConfig.merge_membership_updates`.
+bool mergesMembershipUpdates(const Cluster& cluster) {
+  const auto& lb_config = cluster.info()->lbConfig();
+  return lb_config.merge_membership_updates() &&
+         PROTOBUF_GET_MS_OR_DEFAULT(lb_config, update_merge_window, 1000) > 0;
+}
+
 } // namespace
 
 void ClusterManagerInitHelper::addCluster(Cluster& cluster) {
@@ -185,7 +193,7 @@ ClusterManagerImpl::ClusterManagerImpl(
     AccessLog::AccessLogManager& log_manager, Event::Dispatcher& main_thread_dispatcher,
     Server::Admin& admin, Api::Api& api, Http::Context& http_context)
     : factory_(factory), runtime_(runtime), stats_(stats), tls_(tls.allocateSlot()),
-      random_(random), bind_config_(bootstrap.cluster_manager().upstream_bind_config()),
+      random_(random), api_(api), bind_config_(bootstrap.cluster_manager().upstream_bind_config()),
       local_info_(local_info), cm_stats_(generateStats(stats)),
       init_helper_([this](Cluster& cluster) { onClusterInit(cluster); }),
       config_tracker_entry_(
@@ -308,66 +316,74 @@ void ClusterManagerImpl::onClusterInit(Cluster& cluster) {
   }
 
   // Now setup for cross-thread updates.
+  const bool merge_membership_updates = mergesMembershipUpdates(cluster);
   cluster.prioritySet().addMemberUpdateCb(
-      [&cluster, this](const HostVector&, const HostVector& hosts_removed) -> void {
-        // TODO(snowp): Should this be subject to merge windows?
-
+      [&cluster, this, merge_membership_updates](const HostVector&,
+                                                 const HostVector& hosts_removed) -> void {
         // Whenever hosts are removed from the cluster, we make each TLS cluster drain it's
-        // connection pools for the removed hosts.
-        if (!hosts_removed.empty()) {
+        // connection pools for the removed hosts. When membership updates are merged this happens
+        // when the merged update is delivered instead, see deliverUpdates().
+        if (!hosts_removed.empty() && !merge_membership_updates) {
           postThreadLocalHostRemoval(cluster, hosts_removed);
         }
       });
 
-  cluster.prioritySet().addPriorityUpdateCb([&cluster, this](uint32_t priority,
-                                                             const HostVector& hosts_added,
-                                                             const HostVector& hosts_removed) {
+  cluster.prioritySet().addPriorityUpdateCb([&cluster, this, merge_membership_updates](
+                                                uint32_t priority, const HostVector& hosts_added,
+                                                const HostVector& hosts_removed) {
     // This fires when a cluster is about to have an updated member set. We need to send this
     // out to all of the thread local configurations.
 
     // Should we save this update and merge it with other updates?
     //
-    // Note that we can only _safely_ merge updates that have no added/removed hosts. That is,
-    // only those updates that signal a change in host healthcheck state, weight or metadata.
+    // By default we only merge updates that have no added/removed hosts. That is, only those
+    // updates that signal a change in host healthcheck state, weight or metadata.
     //
-    // We've discussed merging updates related to hosts being added/removed, but it's really
-    // tricky to merge those given that downstream consumers of these updates expect to see the
-    // full list of updates, not a condensed one. This is because they use the broadcasted
-    // HostSharedPtrs within internal maps to track hosts. If we fail to broadcast the entire list
-    // of removals, these maps will leak those HostSharedPtrs.
+    // Downstream consumers of these updates use the broadcasted HostSharedPtrs within internal
+    // maps to track hosts, so merging adds/removes requires tracking the net change of every
+    // host while the update is pending; if we fail to broadcast a removal, these maps will leak
+    // those HostSharedPtrs. This is done when `merge_membership_updates` is set.
     //
     // See https://github.com/envoyproxy/envoy/pull/3941 for more context.
     bool scheduled = false;
     const auto merge_timeout =
         PROTOBUF_GET_MS_OR_DEFAULT(cluster.info()->lbConfig(), update_merge_window, 1000);
-    // Remember: we only merge updates with no adds/removes — just hc/weight/metadata changes.
-    const bool is_mergeable = !hosts_added.size() && !hosts_removed.size();
+    // Remember: unless membership updates are merged, we only merge updates with no
+    // adds/removes — just hc/weight/metadata changes.
+    const bool is_mergeable =
+        merge_membership_updates || (!hosts_added.size() && !hosts_removed.size());
 
     if (merge_timeout > 0) {
       // If this is not mergeable, we should cancel any scheduled updates since
       // we'll deliver it immediately.
-      scheduled = scheduleUpdate(cluster, priority, is_mergeable, merge_timeout);
+      scheduled = scheduleUpdate(cluster, priority, is_mergeable, merge_timeout, hosts_added,
+                                 hosts_removed);
     }
 
     // If an update was not scheduled for later, deliver it immediately.
     if (!scheduled) {
       cm_stats_.cluster_updated_.inc();
-      postThreadLocalClusterUpdate(cluster, priority, hosts_added, hosts_removed);
+      deliverUpdates(cluster, {{priority, hosts_added, hosts_removed}});
     }
   });
 
   // Finally, if the cluster has any hosts, post updates cross-thread so the per-thread load
-  // balancers are ready.
+  // balancers are ready. All priorities are posted as a single batch.
+  ThreadLocalClusterUpdates updates;
   for (auto& host_set : cluster.prioritySet().hostSetsPerPriority()) {
     if (host_set->hosts().empty()) {
       continue;
     }
-    postThreadLocalClusterUpdate(cluster, host_set->priority(), host_set->hosts(), HostVector{});
+    updates.push_back({host_set->priority(), host_set->hosts(), HostVector{}});
+  }
+  if (!updates.empty()) {
+    deliverUpdates(cluster, std::move(updates));
   }
 }
 
 bool ClusterManagerImpl::scheduleUpdate(const Cluster& cluster, uint32_t priority, bool mergeable,
-                                        const uint64_t timeout) {
+                                        const uint64_t timeout, const HostVector& hosts_added,
+                                        const HostVector& hosts_removed) {
   // Find pending updates for this cluster.
   auto& updates_by_prio = updates_map_[cluster.info()->name()];
   if (!updates_by_prio) {
@@ -406,16 +422,33 @@ bool ClusterManagerImpl::scheduleUpdate(const Cluster& cluster, uint32_t priorit
     }
 
     updates->last_updated_ = time_source_.monotonicTime();
+
+    // Membership changes that are still pending must not be lost: deliver them along with this
+    // update, as their net change.
+    if (updates->hasHosts()) {
+      updates->mergeHosts(hosts_added, hosts_removed);
+      cm_stats_.cluster_updated_.inc();
+      deliverUpdates(cluster, {{priority,
+                                {updates->hosts_added_.begin(), updates->hosts_added_.end()},
+                                {updates->hosts_removed_.begin(), updates->hosts_removed_.end()}}});
+      updates->hosts_added_.clear();
+      updates->hosts_removed_.clear();
+      return true;
+    }
     return false;
   }
 
   // If there's no timer, create one.
   if (updates->timer_ == nullptr) {
-    updates->timer_ = dispatcher_.createTimer([this, &cluster, priority, &updates]() -> void {
-      applyUpdates(cluster, priority, *updates);
-    });
+    updates->timer_ =
+        dispatcher_.createTimer([this, &cluster]() -> void { applyUpdates(cluster); });
   }
 
+  if (updates->timer_enabled_) {
+    cm_stats_.update_merged_.inc();
+  }
+  updates->mergeHosts(hosts_added, hosts_removed);
+
   // Ensure there's a timer set to deliver these updates.
   if (!updates->timer_enabled_) {
     updates->enableTimer(timeout);
@@ -424,21 +457,55 @@ bool ClusterManagerImpl::scheduleUpdate(const Cluster& cluster, uint32_t priorit
   return true;
 }
 
-void ClusterManagerImpl::applyUpdates(const Cluster& cluster, uint32_t priority,
-                                      PendingUpdates& updates) {
-  // Deliver pending updates.
+void ClusterManagerImpl::applyUpdates(const Cluster& cluster) {
+  // Deliver pending updates. All priorities of the cluster with a pending update are delivered
+  // together, so that workers process a single batch rather than one post per priority.
+  //
+  // Unless membership updates are merged, the pending updates are _only_ for updates related to
+  // HC/weight/metadata changes and added/removed are empty: all adds/removals were already
+  // immediately broadcasted.
+  auto updates_by_prio = updates_map_.find(cluster.info()->name());
+  ASSERT(updates_by_prio != updates_map_.end());
+
+  ThreadLocalClusterUpdates batch;
+  for (auto& priority_and_updates : *updates_by_prio->second) {
+    PendingUpdates& updates = *priority_and_updates.second;
+    if (!updates.timer_enabled_) {
+      continue;
+    }
+    batch.push_back({priority_and_updates.first,
+                     {updates.hosts_added_.begin(), updates.hosts_added_.end()},
+                     {updates.hosts_removed_.begin(), updates.hosts_removed_.end()}});
+    updates.hosts_added_.clear();
+    updates.hosts_removed_.clear();
+    updates.disableTimer();
+    updates.last_updated_ = time_source_.monotonicTime();
+    cm_stats_.cluster_updated_via_merge_.inc();
+  }
 
-  // Remember that these merged updates are _only_ for updates related to
-  // HC/weight/metadata changes. That's why added/removed are empty. All
-  // adds/removals were already immediately broadcasted.
-  static const HostVector hosts_added;
-  static const HostVector hosts_removed;
+  if (!batch.empty()) {
+    deliverUpdates(cluster, std::move(batch));
+  }
+}
 
-  postThreadLocalClusterUpdate(cluster, priority, hosts_added, hosts_removed);
+void ClusterManagerImpl::deliverUpdates(const Cluster& cluster,
+                                        ThreadLocalClusterUpdates&& updates) {
+  cm_stats_.update_delivered_.inc();
+
+  // With merged membership updates the removed hosts were not drained when they were removed,
+  // see onClusterInit(). Collect them before the updates are handed off.
+  HostVector hosts_removed;
+  if (mergesMembershipUpdates(cluster)) {
+    for (const ThreadLocalClusterUpdate& update : updates) {
+      hosts_removed.insert(hosts_removed.end(), update.hosts_removed_.begin(),
+                           update.hosts_removed_.end());
+    }
+  }
 
-  cm_stats_.cluster_updated_via_merge_.inc();
-  updates.timer_enabled_ = false;
-  updates.last_updated_ = time_source_.monotonicTime();
+  postThreadLocalClusterUpdate(cluster, std::move(updates));
+  if (!hosts_removed.empty()) {
+    postThreadLocalHostRemoval(cluster, hosts_removed);
+  }
 }
 
 bool ClusterManagerImpl::addOrUpdateCluster(const envoy::api::v2::Cluster& cluster,
@@ -635,12 +702,13 @@ void ClusterManagerImpl::loadCluster(const envoy::api::v2::Cluster& cluster,
     cluster_entry_it->second->thread_aware_lb_ = std::make_unique<RingHashLoadBalancer>(
         cluster_reference.prioritySet(), cluster_reference.info()->stats(),
         cluster_reference.info()->statsScope(), runtime_, random_,
-        cluster_reference.info()->lbRingHashConfig(), cluster_reference.info()->lbConfig());
+        cluster_reference.info()->lbRingHashConfig(), cluster_reference.info()->lbConfig(),
+        &lbTableBuilder());
   } else if (cluster_reference.info()->lbType() == LoadBalancerType::Maglev) {
     cluster_entry_it->second->thread_aware_lb_ = std::make_unique<MaglevLoadBalancer>(
         cluster_reference.prioritySet(), cluster_reference.info()->stats(),
         cluster_reference.info()->statsScope(), runtime_, random_,
-        cluster_reference.info()->lbConfig());
+        cluster_reference.info()->lbConfig(), MaglevTable::DefaultTableSize, &lbTableBuilder());
   } else if (cluster_reference.info()->lbType() == LoadBalancerType::ClusterProvided) {
     cluster_entry_it->second->thread_aware_lb_ = std::move(new_cluster_pair.second);
   }
@@ -648,6 +716,13 @@ void ClusterManagerImpl::loadCluster(const envoy::api::v2::Cluster& cluster,
   updateGauges();
 }
 
+LoadBalancerTableBuilder& ClusterManagerImpl::lbTableBuilder() {
+  if (lb_table_builder_ == nullptr) {
+    lb_table_builder_ = std::make_unique<LoadBalancerTableBuilder>(api_.threadFactory());
+  }
+  return *lb_table_builder_;
+}
+
 void ClusterManagerImpl::updateGauges() {
   cm_stats_.active_clusters_.set(active_clusters_.size());
   cm_stats_.warming_clusters_.set(warming_clusters_.size());
@@ -699,19 +774,22 @@ void ClusterManagerImpl::postThreadLocalHostRemoval(const Cluster& cluster,
   });
 }
 
-void ClusterManagerImpl::postThreadLocalClusterUpdate(const Cluster& cluster, uint32_t priority,
-                                                      const HostVector& hosts_added,
-                                                      const HostVector& hosts_removed) {
-  const auto& host_set = cluster.prioritySet().hostSetsPerPriority()[priority];
-
-  tls_->runOnAllThreads([this, name = cluster.info()->name(), priority,
-                         update_params = HostSetImpl::updateHostsParams(*host_set),
-                         locality_weights = host_set->localityWeights(), hosts_added, hosts_removed,
-                         overprovisioning_factor = host_set->overprovisioningFactor()]() {
-    ThreadLocalClusterManagerImpl::updateClusterMembership(
-        name, priority, update_params, locality_weights, hosts_added, hosts_removed, *tls_,
-        overprovisioning_factor);
-  });
+void ClusterManagerImpl::postThreadLocalClusterUpdate(const Cluster& cluster,
+                                                      ThreadLocalClusterUpdates&& updates) {
+  // Snapshot the current state of each updated host set, so the workers see the latest state
+  // regardless of how many updates were merged into this batch.
+  std::vector<ThreadLocalClusterManagerImpl::PriorityUpdate> priority_updates;
+  priority_updates.reserve(updates.size());
+  for (ThreadLocalClusterUpdate& update : updates) {
+    const auto& host_set = cluster.prioritySet().hostSetsPerPriority()[update.priority_];
+    priority_updates.push_back({std::move(update), HostSetImpl::updateHostsParams(*host_set),
+                                host_set->localityWeights(), host_set->overprovisioningFactor()});
+  }
+
+  tls_->runOnAllThreads(
+      [this, name = cluster.info()->name(), priority_updates = std::move(priority_updates)]() {
+        ThreadLocalClusterManagerImpl::updateClusterMembership(name, priority_updates, *tls_);
+      });
 }
 
 void ClusterManagerImpl::postThreadLocalHealthFailure(const HostSharedPtr& host) {
@@ -968,19 +1046,22 @@ void ClusterManagerImpl::ThreadLocalClusterManagerImpl::removeHosts(const std::s
 }
 
 void ClusterManagerImpl::ThreadLocalClusterManagerImpl::updateClusterMembership(
-    const std::string& name, uint32_t priority, PrioritySet::UpdateHostsParams update_hosts_params,
-    LocalityWeightsConstSharedPtr locality_weights, const HostVector& hosts_added,
-    const HostVector& hosts_removed, ThreadLocal::Slot& tls, uint64_t overprovisioning_factor) {
+    const std::string& name, const std::vector<PriorityUpdate>& updates, ThreadLocal::Slot& tls) {
 
   ThreadLocalClusterManagerImpl& config = tls.getTyped<ThreadLocalClusterManagerImpl>();
 
   ASSERT(config.thread_local_clusters_.find(name) != config.thread_local_clusters_.end());
   const auto& cluster_entry = config.thread_local_clusters_[name];
-  ENVOY_LOG(debug, "membership update for TLS cluster {} added {} removed {}", name,
-            hosts_added.size(), hosts_removed.size());
-  cluster_entry->priority_set_.updateHosts(priority, std::move(update_hosts_params),
-                                           std::move(locality_weights), hosts_added, hosts_removed,
-                                           overprovisioning_factor);
+  for (const PriorityUpdate& update : updates) {
+    ENVOY_LOG(debug, "membership update for TLS cluster {} priority {} added {} removed {}", name,
+              update.update_.priority_, update.update_.hosts_added_.size(),
+              update.update_.hosts_removed_.size());
+    // The parameters are copied since the same batch is applied on every worker.
+    cluster_entry->priority_set_.updateHosts(
+        update.update_.priority_, PrioritySet::UpdateHostsParams(update.update_hosts_params_),
+        update.locality_weights_, update.update_.hosts_added_, update.update_.hosts_removed_,
+        update.overprovisioning_factor_);
+  }
 
   // If an LB is thread aware, create a new worker local LB on membership changes.
   if (cluster_entry->lb_factory_ != nullptr) {
@@ -1094,6 +1175,14 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::ClusterEntry(
                                                      parent.parent_.random_, cluster->lbConfig());
       break;
     }
+    case LoadBalancerType::PeakEwma: {
+      ASSERT(lb_factory_ == nullptr);
+      lb_ = std::make_unique<PeakEwmaLoadBalancer>(
+          priority_set_, parent_.local_priority_set_, cluster->stats(), parent.parent_.runtime_,
+          parent.parent_.random_, cluster->lbConfig(),
+          parent.thread_local_dispatcher_.timeSource());
+      break;
+    }
     case LoadBalancerType::ClusterProvided:
     case LoadBalancerType::RingHash:
     case LoadBalancerType::Maglev: {
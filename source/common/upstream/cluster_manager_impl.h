@@ -7,6 +7,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "envoy/api/api.h"
@@ -23,6 +24,7 @@
 #include "common/common/cleanup.h"
 #include "common/config/grpc_mux_impl.h"
 #include "common/http/async_client_impl.h"
+#include "common/upstream/lb_table_builder.h"
 #include "common/upstream/load_stats_reporter.h"
 #include "common/upstream/priority_conn_pool_map.h"
 #include "common/upstream/upstream_impl.h"
@@ -148,7 +150,9 @@ private:
   COUNTER(cluster_removed)                                                                         \
   COUNTER(cluster_updated)                                                                         \
   COUNTER(cluster_updated_via_merge)                                                               \
+  COUNTER(update_delivered)                                                                        \
   COUNTER(update_merge_cancelled)                                                                  \
+  COUNTER(update_merged)                                                                           \
   COUNTER(update_out_of_merge_window)                                                              \
   GAUGE(active_clusters, NeverImport)                                                              \
   GAUGE(warming_clusters, NeverImport)
@@ -228,10 +232,24 @@ public:
   std::size_t warmingClusterCount() const override { return warming_clusters_.size(); }
 
 protected:
+  /**
+   * A membership update of one priority of a cluster. The rest of the host set state is taken
+   * when the update is posted, so that the latest state always wins.
+   */
+  struct ThreadLocalClusterUpdate {
+    uint32_t priority_;
+    HostVector hosts_added_;
+    HostVector hosts_removed_;
+  };
+  using ThreadLocalClusterUpdates = std::vector<ThreadLocalClusterUpdate>;
+
   virtual void postThreadLocalHostRemoval(const Cluster& cluster, const HostVector& hosts_removed);
-  virtual void postThreadLocalClusterUpdate(const Cluster& cluster, uint32_t priority,
-                                            const HostVector& hosts_added,
-                                            const HostVector& hosts_removed);
+  /**
+   * Posts a batch of updates of a cluster to the worker threads as a single cross-thread call.
+   */
+  virtual void postThreadLocalClusterUpdate(const Cluster& cluster,
+                                            ThreadLocalClusterUpdates&& updates);
+  LoadBalancerTableBuilder& lbTableBuilder();
 
 private:
   /**
@@ -327,12 +345,17 @@ private:
     void removeTcpConn(const HostConstSharedPtr& host, Network::ClientConnection& connection);
     static void removeHosts(const std::string& name, const HostVector& hosts_removed,
                             ThreadLocal::Slot& tls);
-    static void updateClusterMembership(const std::string& name, uint32_t priority,
-                                        PrioritySet::UpdateHostsParams update_hosts_params,
-                                        LocalityWeightsConstSharedPtr locality_weights,
-                                        const HostVector& hosts_added,
-                                        const HostVector& hosts_removed, ThreadLocal::Slot& tls,
-                                        uint64_t overprovisioning_factor);
+    // A ThreadLocalClusterUpdate along with the state of the host set when it was posted.
+    struct PriorityUpdate {
+      ThreadLocalClusterUpdate update_;
+      PrioritySet::UpdateHostsParams update_hosts_params_;
+      LocalityWeightsConstSharedPtr locality_weights_;
+      uint32_t overprovisioning_factor_;
+    };
+
+    static void updateClusterMembership(const std::string& name,
+                                        const std::vector<PriorityUpdate>& updates,
+                                        ThreadLocal::Slot& tls);
     static void onHostHealthFailure(const HostSharedPtr& host, ThreadLocal::Slot& tls);
 
     ConnPoolsContainer* getHttpConnPoolsContainer(const HostConstSharedPtr& host,
@@ -393,6 +416,22 @@ private:
 
   struct PendingUpdates {
     ~PendingUpdates() { disableTimer(); }
+    // Merges a membership change into the pending update. Hosts are tracked by identity so that
+    // only the net change is delivered: a host added and removed again while the update is pending
+    // is never seen by the workers.
+    void mergeHosts(const HostVector& hosts_added, const HostVector& hosts_removed) {
+      for (const HostSharedPtr& host : hosts_removed) {
+        if (hosts_added_.erase(host) == 0) {
+          hosts_removed_.insert(host);
+        }
+      }
+      for (const HostSharedPtr& host : hosts_added) {
+        if (hosts_removed_.erase(host) == 0) {
+          hosts_added_.insert(host);
+        }
+      }
+    }
+    bool hasHosts() const { return !hosts_added_.empty() || !hosts_removed_.empty(); }
     void enableTimer(const uint64_t timeout) {
       ASSERT(!timer_enabled_);
       if (timer_ != nullptr) {
@@ -419,15 +458,19 @@ private:
     // `Cluster.CommonLbConfig.update_merge_window`, the first update will trigger immediately
     // (the expected behavior).
     MonotonicTime last_updated_;
+    std::unordered_set<HostSharedPtr> hosts_added_;
+    std::unordered_set<HostSharedPtr> hosts_removed_;
   };
   using PendingUpdatesPtr = std::unique_ptr<PendingUpdates>;
   using PendingUpdatesByPriorityMap = std::unordered_map<uint32_t, PendingUpdatesPtr>;
   using PendingUpdatesByPriorityMapPtr = std::unique_ptr<PendingUpdatesByPriorityMap>;
   using ClusterUpdatesMap = std::unordered_map<std::string, PendingUpdatesByPriorityMapPtr>;
 
-  void applyUpdates(const Cluster& cluster, uint32_t priority, PendingUpdates& updates);
+  void applyUpdates(const Cluster& cluster);
   bool scheduleUpdate(const Cluster& cluster, uint32_t priority, bool mergeable,
-                      const uint64_t timeout);
+                      const uint64_t timeout, const HostVector& hosts_added,
+                      const HostVector& hosts_removed);
+  void deliverUpdates(const Cluster& cluster, ThreadLocalClusterUpdates&& updates);
   void createOrUpdateThreadLocalCluster(ClusterData& cluster);
   ProtobufTypes::MessagePtr dumpClusterConfigs();
   static ClusterManagerStats generateStats(Stats::Scope& scope);
@@ -442,6 +485,10 @@ private:
   Stats::Store& stats_;
   ThreadLocal::SlotPtr tls_;
   Runtime::RandomGenerator& random_;
+  Api::Api& api_;
+  // Builds the tables of the thread aware load balancers when hosts change. Created with the first
+  // of them, and declared ahead of the clusters so that it outlives their load balancers.
+  LoadBalancerTableBuilderPtr lb_table_builder_;
 
 protected:
   ClusterMap active_clusters_;
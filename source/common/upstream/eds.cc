@@ -247,9 +247,14 @@ bool EdsClusterImpl::updateHostsPerLocality(
               "EDS hosts or locality weights changed for cluster: {} current hosts {} priority {}",
               info_->name(), host_set.hosts().size(), host_set.priority());
 
-    priority_state_manager.updateClusterPrioritySet(priority, std::move(current_hosts_copy),
-                                                    hosts_added, hosts_removed, absl::nullopt,
-                                                    overprovisioning_factor);
+    // If only the health, weight or metadata of existing hosts changed, the hosts remain in the
+    // same locality buckets; reuse them rather than grouping every host of the priority again.
+    // Since nothing was removed, an unchanged size means that no host was added either.
+    const bool membership_changed = !hosts_added.empty() || !hosts_removed.empty() ||
+                                    current_hosts_copy->size() != host_set.hosts().size();
+    priority_state_manager.updateClusterPrioritySet(
+        priority, std::move(current_hosts_copy), hosts_added, hosts_removed, absl::nullopt,
+        overprovisioning_factor, membership_changed ? nullptr : host_set.hostsPerLocalityPtr());
     return true;
   }
   return false;
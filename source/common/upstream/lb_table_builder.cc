@@ -0,0 +1,83 @@
+#include "common/upstream/lb_table_builder.h"
+
+#include "common/common/assert.h"
+#include "common/common/lock_guard.h"
+
+namespace Envoy {
+namespace Upstream {
+
+LoadBalancerTableBuilder::LoadBalancerTableBuilder(Thread::ThreadFactory& thread_factory)
+    : thread_(thread_factory.createThread([this]() -> void { threadRoutine(); })) {}
+
+LoadBalancerTableBuilder::~LoadBalancerTableBuilder() {
+  {
+    Thread::LockGuard lock(lock_);
+    shutdown_ = true;
+    work_event_.notifyOne();
+  }
+  thread_->join();
+}
+
+void LoadBalancerTableBuilder::schedule(const void* owner, std::function<void()> build) {
+  Thread::LockGuard lock(lock_);
+  auto it = waiting_.find(owner);
+  if (it != waiting_.end()) {
+    ENVOY_LOG(debug, "replacing a waiting load balancer table build");
+    it->second = std::move(build);
+    return;
+  }
+  waiting_.emplace(owner, std::move(build));
+  queue_.push_back(owner);
+  work_event_.notifyOne();
+}
+
+void LoadBalancerTableBuilder::cancel(const void* owner) {
+  Thread::LockGuard lock(lock_);
+  if (waiting_.erase(owner) > 0) {
+    queue_.remove(owner);
+  }
+  while (running_ == owner) {
+    // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
+    done_event_.wait(lock_);
+  }
+}
+
+void LoadBalancerTableBuilder::waitForIdle() {
+  Thread::LockGuard lock(lock_);
+  while (running_ != nullptr || !queue_.empty()) {
+    done_event_.wait(lock_);
+  }
+}
+
+void LoadBalancerTableBuilder::threadRoutine() {
+  while (true) {
+    std::function<void()> build;
+    {
+      Thread::LockGuard lock(lock_);
+      while (queue_.empty() && !shutdown_) {
+        work_event_.wait(lock_);
+      }
+      if (shutdown_) {
+        return;
+      }
+      running_ = queue_.front();
+      queue_.pop_front();
+      auto it = waiting_.find(running_);
+      ASSERT(it != waiting_.end());
+      build = std::move(it->second);
+      waiting_.erase(it);
+    }
+
+    // Builds take a while, and the owner may schedule the next one meanwhile. The build, and
+    // whatever it holds, is destroyed before the owner can see that it finished.
+    build();
+    build = nullptr;
+
+    Thread::LockGuard lock(lock_);
+    running_ = nullptr;
+    done_event_.notifyAll();
+  }
+}
+
+} // namespace Upstream
+} // namespace Envoy
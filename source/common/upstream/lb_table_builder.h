@@ -0,0 +1,71 @@
+#pragma once
+
+#include <functional>
+#include <list>
+#include <unordered_map>
+
+#include "envoy/thread/thread.h"
+
+#include "common/common/logger.h"
+#include "common/common/non_copyable.h"
+#include "common/common/thread.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * A background thread that builds the lookup tables of thread aware load balancers (ring hash
+ * rings and Maglev tables), so that host set updates on the main thread don't wait for them.
+ *
+ * Builds are scheduled per owner, and an owner has at most one build waiting: a build scheduled
+ * while an earlier one is still waiting replaces it, as only the table for the latest host set is
+ * of any use. Builds of different owners run in the order they were first scheduled.
+ */
+class LoadBalancerTableBuilder : NonCopyable, Logger::Loggable<Logger::Id::upstream> {
+public:
+  explicit LoadBalancerTableBuilder(Thread::ThreadFactory& thread_factory);
+
+  /**
+   * Waiting builds are dropped, and the thread is joined.
+   */
+  ~LoadBalancerTableBuilder();
+
+  /**
+   * Run a build on the builder thread.
+   * @param owner supplies the owner of the build, which replaces any of its builds still waiting.
+   * @param build supplies the build to run.
+   */
+  void schedule(const void* owner, std::function<void()> build);
+
+  /**
+   * Drop the waiting build of an owner, and wait for its running build, if any, to finish. Owners
+   * must call this before going away.
+   * @param owner supplies the owner.
+   */
+  void cancel(const void* owner);
+
+  /**
+   * Wait until no build is running or waiting.
+   */
+  void waitForIdle();
+
+private:
+  void threadRoutine();
+
+  Thread::MutexBasicLockable lock_;
+  // Signaled when a build is scheduled, or on shutdown.
+  Thread::CondVar work_event_;
+  // Signaled when a build finishes.
+  Thread::CondVar done_event_;
+  // The owners with a build waiting, in the order they run, and their builds.
+  std::list<const void*> queue_ GUARDED_BY(lock_);
+  std::unordered_map<const void*, std::function<void()>> waiting_ GUARDED_BY(lock_);
+  const void* running_ GUARDED_BY(lock_){};
+  bool shutdown_ GUARDED_BY(lock_){};
+  Thread::ThreadPtr thread_;
+};
+
+typedef std::unique_ptr<LoadBalancerTableBuilder> LoadBalancerTableBuilderPtr;
+
+} // namespace Upstream
+} // namespace Envoy
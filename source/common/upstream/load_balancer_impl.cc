@@ -1,5 +1,6 @@
 #include "common/upstream/load_balancer_impl.h"
 
+#include <cmath>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -627,10 +628,20 @@ void EdfLoadBalancerBase::refresh(uint32_t priority) {
     refreshHostSource(source);
 
     // Populate scheduler with host list.
-    // TODO(mattklein123): We must build the EDF schedule even if all of the hosts are currently
-    // weighted 1. This is because currently we don't refresh host sets if only weights change.
-    // We should probably change this to refresh at all times. See the comment in
-    // BaseDynamicClusterImpl::updateDynamicHostList about this.
+    // We must build the schedule even if all of the hosts are currently weighted 1. This is
+    // because the runtime pivot in chooseHostOnce() is on the maximum host weight of the whole
+    // cluster, not of this host source.
+    if (hostWeightsAreStatic()) {
+      // Host weights only change along with a host set update, which refreshes the schedule, so
+      // the schedule can be built once here.
+      for (const auto& host : hosts) {
+        scheduler.wrr_.add(host->weight(), host);
+      }
+      // Start at the seed offset, like the unweighted RR index.
+      scheduler.wrr_.seek(seed_);
+      return;
+    }
+
     for (const auto& host : hosts) {
       // We use a fixed weight here. While the weight may change without
       // notification, this will only be stale until this host is next picked,
@@ -650,7 +661,7 @@ void EdfLoadBalancerBase::refresh(uint32_t priority) {
     }
   };
 
-  // Populate EdfSchedulers for each valid HostsSource value for the host set at this priority.
+  // Populate schedulers for each valid HostsSource value for the host set at this priority.
   const auto& host_set = priority_set_.hostSetsPerPriority()[priority];
   add_hosts_source(HostsSource(priority, HostsSource::SourceType::AllHosts), host_set->hosts());
   add_hosts_source(HostsSource(priority, HostsSource::SourceType::HealthyHosts),
@@ -681,12 +692,14 @@ HostConstSharedPtr EdfLoadBalancerBase::chooseHostOnce(LoadBalancerContext* cont
 
   // As has been commented in both EdfLoadBalancerBase::refresh and
   // BaseDynamicClusterImpl::updateDynamicHostList, we must do a runtime pivot here to determine
-  // whether to use EDF or do unweighted (fast) selection.
-  // TODO(mattklein123): As commented elsewhere, this is wasteful, and we should just refresh the
-  // host set if any weights change. Additionally, it has the property that if all weights are
-  // the same but not 1 (like 42), we will use the EDF schedule not the unweighted pick. This is
-  // not optimal. If this is fixed, remove the note in the arch overview docs for the LR LB.
+  // whether to use a weighted schedule or do unweighted (fast) selection.
+  // TODO(mattklein123): This has the property that if all weights are the same but not 1 (like
+  // 42), we will use the weighted schedule not the unweighted pick. This is not optimal. If this
+  // is fixed, remove the note in the arch overview docs for the LR LB.
   if (stats_.max_host_weight_.value() != 1) {
+    if (hostWeightsAreStatic()) {
+      return scheduler.wrr_.pick();
+    }
     auto host = scheduler.edf_.pick();
     if (host != nullptr) {
       scheduler.edf_.add(hostWeight(*host), host);
@@ -733,5 +746,100 @@ HostConstSharedPtr RandomLoadBalancer::chooseHostOnce(LoadBalancerContext* conte
   return hosts_to_use[random_.random() % hosts_to_use.size()];
 }
 
+constexpr std::chrono::milliseconds PeakEwmaLoadBalancer::DefaultDecayTime;
+constexpr double PeakEwmaLoadBalancer::Penalty;
+
+PeakEwmaLoadBalancer::PeakEwmaLoadBalancer(
+    const PrioritySet& priority_set, const PrioritySet* local_priority_set, ClusterStats& stats,
+    Runtime::Loader& runtime, Runtime::RandomGenerator& random,
+    const envoy::api::v2::Cluster::CommonLbConfig& common_config, TimeSource& time_source,
+    std::chrono::milliseconds decay_time)
+    : ZoneAwareLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random,
+                                common_config),
+      time_source_(time_source),
+      decay_time_us_(std::chrono::duration_cast<std::chrono::microseconds>(decay_time).count()) {
+  ASSERT(decay_time.count() > 0);
+  for (const auto& host_set : priority_set.hostSetsPerPriority()) {
+    addHosts(host_set->hosts());
+  }
+  priority_set.addPriorityUpdateCb(
+      [this](uint32_t, const HostVector& hosts_added, const HostVector& hosts_removed) -> void {
+        for (const auto& host : hosts_removed) {
+          ewmas_.erase(host.get());
+        }
+        addHosts(hosts_added);
+      });
+}
+
+void PeakEwmaLoadBalancer::addHosts(const HostVector& hosts) {
+  const MonotonicTime now = time_source_.monotonicTime();
+  for (const auto& host : hosts) {
+    ewmas_.emplace(host.get(), PeakEwma{0, now});
+  }
+}
+
+double PeakEwmaLoadBalancer::decayed(const PeakEwma& ewma, MonotonicTime now) const {
+  const double elapsed_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(now - ewma.updated_).count();
+  return elapsed_us > 0 ? ewma.response_time_us_ * std::exp(-elapsed_us / decay_time_us_)
+                        : ewma.response_time_us_;
+}
+
+void PeakEwmaLoadBalancer::putResponseTime(const HostDescription& host,
+                                           std::chrono::microseconds response_time) {
+  auto it = ewmas_.find(&host);
+  if (it == ewmas_.end()) {
+    // The host was removed while the request was outstanding.
+    return;
+  }
+
+  PeakEwma& ewma = it->second;
+  const MonotonicTime now = time_source_.monotonicTime();
+  const double elapsed_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(now - ewma.updated_).count();
+  const double response_time_us = response_time.count();
+  if (response_time_us > ewma.response_time_us_) {
+    // The peak: slower responses replace the average outright.
+    ewma.response_time_us_ = response_time_us;
+  } else {
+    // The more time passed since the last response, the less the average counts.
+    const double w = elapsed_us > 0 ? std::exp(-elapsed_us / decay_time_us_) : 1.0;
+    ewma.response_time_us_ = ewma.response_time_us_ * w + response_time_us * (1.0 - w);
+  }
+  ewma.updated_ = now;
+}
+
+double PeakEwmaLoadBalancer::cost(const Host& host, MonotonicTime now) const {
+  const uint64_t active = host.stats().rq_active_.value();
+  auto it = ewmas_.find(&host);
+  const double response_time_us = it != ewmas_.end() ? decayed(it->second, now) : 0;
+  if (response_time_us == 0 && active != 0) {
+    return Penalty + active;
+  }
+  return response_time_us * (active + 1) / host.weight();
+}
+
+HostConstSharedPtr PeakEwmaLoadBalancer::chooseHostOnce(LoadBalancerContext* context) {
+  const HostVector& hosts_to_use = hostSourceToHosts(hostSourceToUse(context));
+  if (hosts_to_use.empty()) {
+    return nullptr;
+  }
+  if (hosts_to_use.size() == 1) {
+    return hosts_to_use[0];
+  }
+
+  // Pick two distinct hosts.
+  const uint64_t first = random_.random() % hosts_to_use.size();
+  uint64_t second = random_.random() % (hosts_to_use.size() - 1);
+  if (second >= first) {
+    second++;
+  }
+
+  const MonotonicTime now = time_source_.monotonicTime();
+  const HostSharedPtr& first_host = hosts_to_use[first];
+  const HostSharedPtr& second_host = hosts_to_use[second];
+  return cost(*second_host, now) < cost(*first_host, now) ? second_host : first_host;
+}
+
 } // namespace Upstream
 } // namespace Envoy
@@ -1,17 +1,21 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <queue>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 #include "envoy/api/v2/cds.pb.h"
+#include "envoy/common/time.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/upstream/load_balancer.h"
 #include "envoy/upstream/upstream.h"
 
 #include "common/protobuf/utility.h"
 #include "common/upstream/edf_scheduler.h"
+#include "common/upstream/wrr_scheduler.h"
 
 namespace Envoy {
 namespace Upstream {
@@ -36,6 +40,7 @@ public:
                  const DegradedLoad& degraded_per_priority_load);
 
   HostConstSharedPtr chooseHost(LoadBalancerContext* context) override;
+  void putResponseTime(const HostDescription&, std::chrono::microseconds) override {}
 
 protected:
   /**
@@ -137,6 +142,8 @@ public:
 
   const Router::MetadataMatchCriteria* metadataMatchCriteria() override { return nullptr; }
 
+  bool metadataMatchCriteriaPerRequest() const override { return false; }
+
   const Http::HeaderMap* downstreamHeaders() const override { return nullptr; }
 
   const HealthyAndDegradedLoad&
@@ -348,6 +355,8 @@ protected:
   struct Scheduler {
     // EdfScheduler for weighted LB.
     EdfScheduler<const Host> edf_;
+    // WrrScheduler for weighted LB when hostWeightsAreStatic().
+    WrrScheduler<const Host> wrr_;
   };
 
   void initialize();
@@ -365,14 +374,21 @@ private:
   virtual double hostWeight(const Host& host) PURE;
   virtual HostConstSharedPtr unweightedHostPick(const HostVector& hosts_to_use,
                                                 const HostsSource& source) PURE;
+  /**
+   * @return bool whether hostWeight() only depends on the host weights, which only change along
+   *         with a host set update. If so, weighted picks use a WrrScheduler built on refresh with
+   *         O(1) picks, rather than an EdfScheduler that reinserts each pick with its current
+   *         weight.
+   */
+  virtual bool hostWeightsAreStatic() const { return false; }
 
   // Scheduler for each valid HostsSource.
   std::unordered_map<HostsSource, Scheduler, HostsSourceHash> scheduler_;
 };
 
 /**
- * A round robin load balancer. When in weighted mode, EDF scheduling is used. When in not
- * weighted mode, simple RR index selection is used.
+ * A round robin load balancer. When in weighted mode, an interleaved weighted round robin schedule
+ * is used. When in not weighted mode, simple RR index selection is used.
  */
 class RoundRobinLoadBalancer : public EdfLoadBalancerBase {
 public:
@@ -401,6 +417,7 @@ private:
     ASSERT(rr_indexes_.find(source) != rr_indexes_.end());
     return hosts_to_use[rr_indexes_[source]++ % hosts_to_use.size()];
   }
+  bool hostWeightsAreStatic() const override { return true; }
 
   std::unordered_map<HostsSource, uint64_t, HostsSourceHash> rr_indexes_;
 };
@@ -474,6 +491,58 @@ public:
   HostConstSharedPtr chooseHostOnce(LoadBalancerContext* context) override;
 };
 
+/**
+ * Peak EWMA load balancer. Each host has an exponentially weighted moving average of its response
+ * times, which jumps up to any response time above it so that a host that slows down is avoided
+ * right away, and decays towards zero while the host isn't responding so that it is tried again.
+ * Of two random hosts, the one with the lower average response time times outstanding requests
+ * (scaled by the host weight) is picked.
+ */
+class PeakEwmaLoadBalancer : public ZoneAwareLoadBalancerBase {
+public:
+  /**
+   * @param decay_time supplies the time constant of the moving average.
+   */
+  PeakEwmaLoadBalancer(const PrioritySet& priority_set, const PrioritySet* local_priority_set,
+                       ClusterStats& stats, Runtime::Loader& runtime,
+                       Runtime::RandomGenerator& random,
+                       const envoy::api::v2::Cluster::CommonLbConfig& common_config,
+                       TimeSource& time_source,
+                       std::chrono::milliseconds decay_time = DefaultDecayTime);
+
+  // Upstream::LoadBalancer
+  void putResponseTime(const HostDescription& host,
+                       std::chrono::microseconds response_time) override;
+
+  // Upstream::LoadBalancerBase
+  HostConstSharedPtr chooseHostOnce(LoadBalancerContext* context) override;
+
+  // Matches the decay time of Finagle's peak EWMA balancer.
+  static constexpr std::chrono::milliseconds DefaultDecayTime{10000};
+
+  // The cost of a host that has requests outstanding but no response time yet, so that new hosts
+  // get requests one at a time until the first of them completes.
+  static constexpr double Penalty = 1e9;
+
+private:
+  struct PeakEwma {
+    // The moving average in microseconds, as of updated_.
+    double response_time_us_{};
+    MonotonicTime updated_;
+  };
+
+  void addHosts(const HostVector& hosts);
+  // Decay a moving average to now.
+  double decayed(const PeakEwma& ewma, MonotonicTime now) const;
+  double cost(const Host& host, MonotonicTime now) const;
+
+  TimeSource& time_source_;
+  const double decay_time_us_;
+  // Keyed by host, as hosts don't carry load balancer state. This is a per worker load balancer,
+  // so it is only ever touched from one thread.
+  std::unordered_map<const HostDescription*, PeakEwma> ewmas_;
+};
+
 /**
  * Implementation of LoadBalancerSubsetInfo.
  */
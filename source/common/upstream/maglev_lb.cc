@@ -1,12 +1,15 @@
 #include "common/upstream/maglev_lb.h"
 
+#include <unordered_map>
+
 namespace Envoy {
 namespace Upstream {
 
 MaglevTable::MaglevTable(const NormalizedHostWeightVector& normalized_host_weights,
                          double max_normalized_weight, uint64_t table_size,
-                         MaglevLoadBalancerStats& stats)
-    : table_size_(table_size), stats_(stats) {
+                         MaglevLoadBalancerStats& stats, const MaglevTable* previous)
+    : table_size_(table_size), max_normalized_weight_(max_normalized_weight),
+      normalized_host_weights_(normalized_host_weights), stats_(stats) {
   // TODO(mattklein123): The Maglev table must have a size that is a prime number for the algorithm
   // to work. Currently, the table size is not user configurable. In the future, if the table size
   // is made user configurable, we will need proper error checking that the user cannot configure a
@@ -19,15 +22,31 @@ MaglevTable::MaglevTable(const NormalizedHostWeightVector& normalized_host_weigh
     return;
   }
 
+  // The permutations of the hosts that were there for the previous table don't change.
+  std::unordered_map<const Host*, Permutation> previous_permutations;
+  if (previous != nullptr && previous->table_size_ == table_size_) {
+    for (uint64_t i = 0; i < previous->permutations_.size(); i++) {
+      previous_permutations.emplace(previous->normalized_host_weights_[i].first.get(),
+                                    previous->permutations_[i]);
+    }
+  }
+
   // Implementation of pseudocode listing 1 in the paper (see header file for more info).
   std::vector<TableBuildEntry> table_build_entries;
   table_build_entries.reserve(normalized_host_weights.size());
+  permutations_.reserve(normalized_host_weights.size());
   for (const auto& host_weight : normalized_host_weights) {
     const auto& host = host_weight.first;
-    const std::string& address = host->address()->asString();
-    table_build_entries.emplace_back(host, HashUtil::xxHash64(address) % table_size_,
-                                     (HashUtil::xxHash64(address, 1) % (table_size_ - 1)) + 1,
-                                     host_weight.second);
+    auto it = previous_permutations.find(host.get());
+    if (it != previous_permutations.end()) {
+      permutations_.push_back(it->second);
+    } else {
+      const std::string& address = host->address()->asString();
+      permutations_.push_back({HashUtil::xxHash64(address) % table_size_,
+                               (HashUtil::xxHash64(address, 1) % (table_size_ - 1)) + 1});
+    }
+    table_build_entries.emplace_back(host, permutations_.back().offset_,
+                                     permutations_.back().skip_, host_weight.second);
   }
 
   table_.resize(table_size_);
@@ -74,6 +93,21 @@ MaglevTable::MaglevTable(const NormalizedHostWeightVector& normalized_host_weigh
   }
 }
 
+bool MaglevTable::builtFor(const NormalizedHostWeightVector& normalized_host_weights,
+                           double max_normalized_weight) const {
+  if (max_normalized_weight != max_normalized_weight_ ||
+      normalized_host_weights.size() != normalized_host_weights_.size()) {
+    return false;
+  }
+  for (uint64_t i = 0; i < normalized_host_weights.size(); i++) {
+    if (normalized_host_weights[i].first != normalized_host_weights_[i].first ||
+        normalized_host_weights[i].second != normalized_host_weights_[i].second) {
+      return false;
+    }
+  }
+  return true;
+}
+
 HostConstSharedPtr MaglevTable::chooseHost(uint64_t hash) const {
   if (table_.empty()) {
     return nullptr;
@@ -90,11 +124,29 @@ MaglevLoadBalancer::MaglevLoadBalancer(const PrioritySet& priority_set, ClusterS
                                        Stats::Scope& scope, Runtime::Loader& runtime,
                                        Runtime::RandomGenerator& random,
                                        const envoy::api::v2::Cluster::CommonLbConfig& common_config,
-                                       uint64_t table_size)
-    : ThreadAwareLoadBalancerBase(priority_set, stats, runtime, random, common_config),
+                                       uint64_t table_size,
+                                       LoadBalancerTableBuilder* table_builder)
+    : ThreadAwareLoadBalancerBase(priority_set, stats, runtime, random, common_config,
+                                  table_builder),
       scope_(scope.createScope("maglev_lb.")), stats_(generateStats(*scope_)),
       table_size_(table_size) {}
 
+MaglevLoadBalancer::~MaglevLoadBalancer() { cancelTableBuilds(); }
+
+ThreadAwareLoadBalancerBase::HashingLoadBalancerSharedPtr
+MaglevLoadBalancer::createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
+                                       double, double max_normalized_weight,
+                                       const HashingLoadBalancerSharedPtr& previous_lb) {
+  // Every table built here is a MaglevTable.
+  const MaglevTable* previous = static_cast<const MaglevTable*>(previous_lb.get());
+  if (previous != nullptr && previous->builtFor(normalized_host_weights, max_normalized_weight)) {
+    // E.g. only the metadata of the hosts changed.
+    return previous_lb;
+  }
+  return std::make_shared<MaglevTable>(normalized_host_weights, max_normalized_weight, table_size_,
+                                       stats_, previous);
+}
+
 MaglevLoadBalancerStats MaglevLoadBalancer::generateStats(Stats::Scope& scope) {
   return {ALL_MAGLEV_LOAD_BALANCER_STATS(POOL_GAUGE(scope))};
 }
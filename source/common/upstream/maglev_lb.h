@@ -32,8 +32,20 @@ struct MaglevLoadBalancerStats {
 class MaglevTable : public ThreadAwareLoadBalancerBase::HashingLoadBalancer,
                     Logger::Loggable<Logger::Id::upstream> {
 public:
+  /**
+   * @param previous supplies the table built for the previous host set, if any. The permutations
+   *        of the hosts that are still there are taken from it rather than hashed again.
+   */
   MaglevTable(const NormalizedHostWeightVector& normalized_host_weights,
-              double max_normalized_weight, uint64_t table_size, MaglevLoadBalancerStats& stats);
+              double max_normalized_weight, uint64_t table_size, MaglevLoadBalancerStats& stats,
+              const MaglevTable* previous = nullptr);
+
+  /**
+   * @return bool whether this table was built for exactly these hosts and weights, in which case
+   *         building it again would give the same table.
+   */
+  bool builtFor(const NormalizedHostWeightVector& normalized_host_weights,
+                double max_normalized_weight) const;
 
   // ThreadAwareLoadBalancerBase::HashingLoadBalancer
   HostConstSharedPtr chooseHost(uint64_t hash) const override;
@@ -57,7 +69,18 @@ private:
 
   uint64_t permutation(const TableBuildEntry& entry);
 
+  // The permutation of a host, i.e. the order it takes table slots in.
+  struct Permutation {
+    uint64_t offset_;
+    uint64_t skip_;
+  };
+
   const uint64_t table_size_;
+  const double max_normalized_weight_;
+  // The hosts and weights the table was built for, and the permutations of the hosts, in the same
+  // order.
+  NormalizedHostWeightVector normalized_host_weights_;
+  std::vector<Permutation> permutations_;
   std::vector<HostConstSharedPtr> table_;
   MaglevLoadBalancerStats& stats_;
 };
@@ -70,7 +93,9 @@ public:
   MaglevLoadBalancer(const PrioritySet& priority_set, ClusterStats& stats, Stats::Scope& scope,
                      Runtime::Loader& runtime, Runtime::RandomGenerator& random,
                      const envoy::api::v2::Cluster::CommonLbConfig& common_config,
-                     uint64_t table_size = MaglevTable::DefaultTableSize);
+                     uint64_t table_size = MaglevTable::DefaultTableSize,
+                     LoadBalancerTableBuilder* table_builder = nullptr);
+  ~MaglevLoadBalancer();
 
   const MaglevLoadBalancerStats& stats() const { return stats_; }
 
@@ -78,10 +103,8 @@ private:
   // ThreadAwareLoadBalancerBase
   HashingLoadBalancerSharedPtr
   createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
-                     double /* min_normalized_weight */, double max_normalized_weight) override {
-    return std::make_shared<MaglevTable>(normalized_host_weights, max_normalized_weight,
-                                         table_size_, stats_);
-  }
+                     double /* min_normalized_weight */, double max_normalized_weight,
+                     const HashingLoadBalancerSharedPtr& previous_lb) override;
 
   static MaglevLoadBalancerStats generateStats(Stats::Scope& scope);
 
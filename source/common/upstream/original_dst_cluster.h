@@ -53,6 +53,7 @@ public:
 
     // Upstream::LoadBalancer
     HostConstSharedPtr chooseHost(LoadBalancerContext* context) override;
+    void putResponseTime(const HostDescription&, std::chrono::microseconds) override {}
 
   private:
     /**
@@ -17,8 +17,10 @@ RingHashLoadBalancer::RingHashLoadBalancer(
     const PrioritySet& priority_set, ClusterStats& stats, Stats::Scope& scope,
     Runtime::Loader& runtime, Runtime::RandomGenerator& random,
     const absl::optional<envoy::api::v2::Cluster::RingHashLbConfig>& config,
-    const envoy::api::v2::Cluster::CommonLbConfig& common_config)
-    : ThreadAwareLoadBalancerBase(priority_set, stats, runtime, random, common_config),
+    const envoy::api::v2::Cluster::CommonLbConfig& common_config,
+    LoadBalancerTableBuilder* table_builder)
+    : ThreadAwareLoadBalancerBase(priority_set, stats, runtime, random, common_config,
+                                  table_builder),
       scope_(scope.createScope("ring_hash_lb.")), stats_(generateStats(*scope_)),
       min_ring_size_(config ? PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.value(), minimum_ring_size,
                                                               DefaultMinRingSize)
@@ -36,45 +38,59 @@ RingHashLoadBalancer::RingHashLoadBalancer(
   }
 }
 
+RingHashLoadBalancer::~RingHashLoadBalancer() { cancelTableBuilds(); }
+
 RingHashLoadBalancerStats RingHashLoadBalancer::generateStats(Stats::Scope& scope) {
   return {ALL_RING_HASH_LOAD_BALANCER_STATS(POOL_GAUGE(scope))};
 }
 
-HostConstSharedPtr RingHashLoadBalancer::Ring::chooseHost(uint64_t h) const {
-  if (ring_.empty()) {
-    return nullptr;
+namespace {
+
+struct RingEntry {
+  uint64_t hash_;
+  uint32_t host_index_;
+};
+
+// Lay out sorted entries [i, ...) as the subtree of the Eytzinger tree rooted at k, by walking it
+// in order. Returns the index of the first entry not used.
+uint64_t layoutEytzinger(const std::vector<RingEntry>& sorted, uint64_t i, uint64_t k,
+                         std::vector<uint64_t>& hashes, std::vector<uint32_t>& host_indices) {
+  if (k < hashes.size()) {
+    i = layoutEytzinger(sorted, i, 2 * k, hashes, host_indices);
+    hashes[k] = sorted[i].hash_;
+    host_indices[k] = sorted[i].host_index_;
+    i = layoutEytzinger(sorted, i + 1, 2 * k + 1, hashes, host_indices);
   }
+  return i;
+}
 
-  // Ported from https://github.com/RJ/ketama/blob/master/libketama/ketama.c (ketama_get_server)
-  // I've generally kept the variable names to make the code easier to compare.
-  // NOTE: The algorithm depends on using signed integers for lowp, midp, and highp. Do not
-  //       change them!
-  int64_t lowp = 0;
-  int64_t highp = ring_.size();
-  while (true) {
-    int64_t midp = (lowp + highp) / 2;
-
-    if (midp == static_cast<int64_t>(ring_.size())) {
-      return ring_[0].host_;
-    }
-
-    uint64_t midval = ring_[midp].hash_;
-    uint64_t midval1 = midp == 0 ? 0 : ring_[midp - 1].hash_;
-
-    if (h <= midval && h > midval1) {
-      return ring_[midp].host_;
-    }
+} // namespace
 
-    if (midval < h) {
-      lowp = midp + 1;
-    } else {
-      highp = midp - 1;
-    }
+HostConstSharedPtr RingHashLoadBalancer::Ring::chooseHost(uint64_t h) const {
+  if (hosts_.empty()) {
+    return nullptr;
+  }
 
-    if (lowp > highp) {
-      return ring_[0].host_;
-    }
+  // Find the entry with the lowest hash that is at least h. Each step goes left when the node's
+  // hash is at least h and right otherwise, computing the next index rather than branching on the
+  // comparison, which the CPU could not predict. The loop runs a fixed number of times for a given
+  // ring size.
+  const uint64_t* hashes = hashes_.data();
+  const uint64_t size = hashes_.size();
+  uint64_t k = 1;
+  while (k < size) {
+    // The 16 descendants of k four levels down are adjacent, in two cache lines. Start loading
+    // them now so that they are there when the walk gets to them. A prefetch doesn't fault, so
+    // there is no need to check whether they are past the end of the tree.
+    __builtin_prefetch(reinterpret_cast<const void*>(reinterpret_cast<uintptr_t>(hashes) +
+                                                     16 * k * sizeof(uint64_t)));
+    k = 2 * k + (hashes[k] < h);
   }
+  // The entry found is where the walk last went left. Undo the right turns after it, and that
+  // left turn. If the walk never went left, every hash is lower than h, and k is now 0: wrap
+  // around to the lowest hash.
+  k >>= __builtin_ctzll(~k) + 1;
+  return hosts_[k == 0 ? first_host_index_ : host_indices_[k]];
 }
 
 using HashFunction = envoy::api::v2::Cluster_RingHashLbConfig_HashFunction;
@@ -101,7 +117,9 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
 
   // Reserve memory for the entire ring up front.
   const uint64_t ring_size = std::ceil(scale);
-  ring_.reserve(ring_size);
+  std::vector<RingEntry> ring;
+  ring.reserve(ring_size);
+  hosts_.reserve(normalized_host_weights.size());
 
   // Populate the hash ring by walking through the (host, weight) pairs in normalized_host_weights,
   // and generating (scale * weight) hashes for each host. Since these aren't necessarily whole
@@ -127,6 +145,8 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
   uint64_t max_hashes_per_host = 0;
   for (const auto& entry : normalized_host_weights) {
     const auto& host = entry.first;
+    const uint32_t host_index = hosts_.size();
+    hosts_.push_back(host);
     const std::string& address_string = host->address()->asString();
     uint64_t offset_start = address_string.size();
 
@@ -158,7 +178,7 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
               : HashUtil::xxHash64(hash_key);
 
       ENVOY_LOG(trace, "ring hash: hash_key={} hash={}", hash_key.data(), hash);
-      ring_.push_back({hash, host});
+      ring.push_back({hash, host_index});
       ++i;
       ++current_hashes;
     }
@@ -166,16 +186,22 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
     max_hashes_per_host = std::max(i, max_hashes_per_host);
   }
 
-  std::sort(ring_.begin(), ring_.end(), [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
+  std::sort(ring.begin(), ring.end(), [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
     return lhs.hash_ < rhs.hash_;
   });
   if (ENVOY_LOG_CHECK_LEVEL(trace)) {
-    for (const auto& entry : ring_) {
-      ENVOY_LOG(trace, "ring hash: host={} hash={}", entry.host_->address()->asString(),
-                entry.hash_);
+    for (const auto& entry : ring) {
+      ENVOY_LOG(trace, "ring hash: host={} hash={}",
+                hosts_[entry.host_index_]->address()->asString(), entry.hash_);
     }
   }
 
+  // Lay the sorted ring out for chooseHost(). Index 0 is unused.
+  hashes_.resize(ring.size() + 1);
+  host_indices_.resize(ring.size() + 1);
+  layoutEytzinger(ring, 0, 1, hashes_, host_indices_);
+  first_host_index_ = ring[0].host_index_;
+
   stats_.size_.set(ring_size);
   stats_.min_hashes_per_host_.set(min_hashes_per_host);
   stats_.max_hashes_per_host_.set(max_hashes_per_host);
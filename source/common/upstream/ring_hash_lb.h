@@ -42,18 +42,15 @@ public:
   RingHashLoadBalancer(const PrioritySet& priority_set, ClusterStats& stats, Stats::Scope& scope,
                        Runtime::Loader& runtime, Runtime::RandomGenerator& random,
                        const absl::optional<envoy::api::v2::Cluster::RingHashLbConfig>& config,
-                       const envoy::api::v2::Cluster::CommonLbConfig& common_config);
+                       const envoy::api::v2::Cluster::CommonLbConfig& common_config,
+                       LoadBalancerTableBuilder* table_builder = nullptr);
+  ~RingHashLoadBalancer();
 
   const RingHashLoadBalancerStats& stats() const { return stats_; }
 
 private:
   using HashFunction = envoy::api::v2::Cluster_RingHashLbConfig_HashFunction;
 
-  struct RingEntry {
-    uint64_t hash_;
-    HostConstSharedPtr host_;
-  };
-
   struct Ring : public HashingLoadBalancer {
     Ring(const NormalizedHostWeightVector& normalized_host_weights, double min_normalized_weight,
          uint64_t min_ring_size, uint64_t max_ring_size, HashFunction hash_function,
@@ -62,7 +59,17 @@ private:
     // ThreadAwareLoadBalancerBase::HashingLoadBalancer
     HostConstSharedPtr chooseHost(uint64_t hash) const override;
 
-    std::vector<RingEntry> ring_;
+    // The ring is kept as an implicit binary search tree in Eytzinger (breadth first) order:
+    // hashes_[1] is the root, and the children of hashes_[k] are hashes_[2k] and hashes_[2k+1].
+    // hashes_[0] is unused. A lookup walks down from the root, so the first levels stay in cache
+    // and the nodes further down can be prefetched ahead of the comparisons that need them. The
+    // hashes are kept apart from the hosts, so that a lookup only touches one hash per level.
+    std::vector<uint64_t> hashes_;
+    // For each entry of hashes_, the index of its host in hosts_.
+    std::vector<uint32_t> host_indices_;
+    std::vector<HostConstSharedPtr> hosts_;
+    // The host of the entry with the lowest hash, which hashes past the last entry wrap around to.
+    uint32_t first_host_index_{};
 
     RingHashLoadBalancerStats& stats_;
   };
@@ -71,7 +78,8 @@ private:
   // ThreadAwareLoadBalancerBase
   HashingLoadBalancerSharedPtr
   createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
-                     double min_normalized_weight, double /* max_normalized_weight */) override {
+                     double min_normalized_weight, double /* max_normalized_weight */,
+                     const HashingLoadBalancerSharedPtr& /* previous_lb */) override {
     return std::make_shared<Ring>(normalized_host_weights, min_normalized_weight, min_ring_size_,
                                   max_ring_size_, hash_function_, stats_);
   }
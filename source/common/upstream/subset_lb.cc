@@ -17,6 +17,8 @@
 namespace Envoy {
 namespace Upstream {
 
+constexpr size_t SubsetLoadBalancer::MaxCachedSubsets;
+
 SubsetLoadBalancer::SubsetLoadBalancer(
     LoadBalancerType lb_type, PrioritySet& priority_set, const PrioritySet* local_priority_set,
     ClusterStats& stats, Stats::Scope& scope, Runtime::Loader& runtime,
@@ -69,6 +71,8 @@ SubsetLoadBalancer::SubsetLoadBalancer(
   // Configure future updates.
   original_priority_set_callback_handle_ = priority_set.addPriorityUpdateCb(
       [this](uint32_t priority, const HostVector& hosts_added, const HostVector& hosts_removed) {
+        subset_cache_.clear();
+
         if (!hosts_added.size() && !hosts_removed.size()) {
           // It's possible that metadata changed, without hosts being added nor removed.
           // If so we need to add any new subsets, remove unused ones, and regroup hosts into
@@ -154,7 +158,7 @@ HostConstSharedPtr SubsetLoadBalancer::tryChooseHostFromContext(LoadBalancerCont
   }
 
   // Route has metadata match criteria defined, see if we have a matching subset.
-  LbSubsetEntryPtr entry = findSubset(match_criteria->metadataMatchCriteria());
+  LbSubsetEntryPtr entry = findSubset(*match_criteria, context->metadataMatchCriteriaPerRequest());
   if (entry == nullptr || !entry->active()) {
     // No matching subset or subset not active: use fallback policy.
     return nullptr;
@@ -165,6 +169,36 @@ HostConstSharedPtr SubsetLoadBalancer::tryChooseHostFromContext(LoadBalancerCont
   return entry->priority_subset_->lb_->chooseHost(context);
 }
 
+// Finds the LbSubsetEntryPtr matching the criteria, if any, trying the subset cache first unless
+// the criteria were created for this request, as they would only ever be looked up once.
+SubsetLoadBalancer::LbSubsetEntryPtr
+SubsetLoadBalancer::findSubset(const Router::MetadataMatchCriteria& match_criteria,
+                               bool per_request) {
+  const auto& criteria = match_criteria.metadataMatchCriteria();
+  if (per_request) {
+    return findSubset(criteria);
+  }
+  auto it = subset_cache_.find(&match_criteria);
+  // The criteria may have been freed and others allocated at the same address, so check that the
+  // entry is for these criteria. The criteria of the entry are still alive, so comparing their
+  // addresses is enough.
+  if (it != subset_cache_.end() && it->second.criteria_ == criteria) {
+    return it->second.entry_;
+  }
+
+  LbSubsetEntryPtr entry = findSubset(criteria);
+  if (it != subset_cache_.end()) {
+    it->second = {criteria, entry};
+    return entry;
+  }
+
+  if (subset_cache_.size() >= MaxCachedSubsets) {
+    subset_cache_.clear();
+  }
+  subset_cache_.emplace(&match_criteria, CachedSubset{criteria, entry});
+  return entry;
+}
+
 // Iterates over the given metadata match criteria (which must be lexically sorted by key) and find
 // a matching LbSubsetEntryPtr, if any.
 SubsetLoadBalancer::LbSubsetEntryPtr SubsetLoadBalancer::findSubset(
@@ -502,8 +536,10 @@ SubsetLoadBalancer::PrioritySubsetImpl::PrioritySubsetImpl(const SubsetLoadBalan
 
   case LoadBalancerType::OriginalDst:
   case LoadBalancerType::ClusterProvided:
+  case LoadBalancerType::PeakEwma:
     // LoadBalancerType::OriginalDst is blocked in the factory. LoadBalancerType::ClusterProvided
     // is impossible because the subset LB returns a null load balancer from its factory.
+    // LoadBalancerType::PeakEwma is rejected with subsets in the cluster config.
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
 
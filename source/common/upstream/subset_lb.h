@@ -33,6 +33,8 @@ public:
 
   // Upstream::LoadBalancer
   HostConstSharedPtr chooseHost(LoadBalancerContext* context) override;
+  // The load balancers of the subsets don't steer by latency.
+  void putResponseTime(const HostDescription&, std::chrono::microseconds) override {}
 
 private:
   typedef std::function<bool(const Host&)> HostPredicate;
@@ -147,6 +149,8 @@ private:
 
   bool hostMatches(const SubsetMetadata& kvs, const Host& host);
 
+  LbSubsetEntryPtr findSubset(const Router::MetadataMatchCriteria& match_criteria,
+                              bool per_request);
   LbSubsetEntryPtr
   findSubset(const std::vector<Router::MetadataMatchCriterionConstSharedPtr>& matches);
 
@@ -180,10 +184,24 @@ private:
   // Forms a trie-like structure. Requires lexically sorted Host and Route metadata.
   LbSubsetMap subsets_;
 
+  // The result of a subset lookup, which may be nullptr. The criteria looked up are kept, so that
+  // their addresses can't be reused while the result is cached.
+  struct CachedSubset {
+    std::vector<Router::MetadataMatchCriterionConstSharedPtr> criteria_;
+    LbSubsetEntryPtr entry_;
+  };
+
+  // Subset lookups by the match criteria object, which is usually the route's. Criteria created per
+  // request are not cached. The cache is cleared when the hosts change, as subsets may have been
+  // created, and when it is full.
+  std::unordered_map<const Router::MetadataMatchCriteria*, CachedSubset> subset_cache_;
+  static constexpr size_t MaxCachedSubsets = 1024;
+
   const bool locality_weight_aware_;
   const bool scale_locality_weight_;
 
   friend class SubsetLoadBalancerDescribeMetadataTester;
+  friend class SubsetLoadBalancerCacheTester;
 };
 
 } // namespace Upstream
@@ -73,20 +73,28 @@ void normalizeWeights(const HostSet& host_set, bool in_panic,
 } // namespace
 
 void ThreadAwareLoadBalancerBase::initialize() {
-  // TODO(mattklein123): In the future, once initialized and the initial LB is built, it would be
-  // better to use a background thread for computing LB updates. This has the substantial benefit
-  // that if the LB computation thread falls behind, host set updates can be trivially collapsed.
-  // I will look into doing this in a follow up. Doing everything using a background thread heavily
-  // complicated initialization as the load balancer would need its own initialized callback. I
-  // think the synchronous/asynchronous split is probably the best option.
+  // The initial tables are built in place, as the load balancer would otherwise need its own
+  // initialized callback. Later updates are built on the table builder thread, if there is one.
+  // That thread can fall behind, in which case host set updates are collapsed into a single build.
   priority_set_.addPriorityUpdateCb(
-      [this](uint32_t, const HostVector&, const HostVector&) -> void { refresh(); });
+      [this](uint32_t, const HostVector& hosts_added, const HostVector& hosts_removed) -> void {
+        refresh(hosts_added, hosts_removed);
+      });
 
-  refresh();
+  refresh({}, {});
+  initialized_ = true;
 }
 
-void ThreadAwareLoadBalancerBase::refresh() {
-  auto per_priority_state_vector = std::make_shared<std::vector<PerPriorityStatePtr>>(
+void ThreadAwareLoadBalancerBase::cancelTableBuilds() {
+  if (table_builder_ != nullptr) {
+    table_builder_->cancel(this);
+  }
+}
+
+void ThreadAwareLoadBalancerBase::refresh(const HostVector& hosts_added,
+                                          const HostVector& hosts_removed) {
+  // Gather everything the build needs from the priority set here, on the main thread.
+  std::vector<PerPriorityBuildInput> per_priority_input(
       priority_set_.hostSetsPerPriority().size());
   auto healthy_per_priority_load =
       std::make_shared<HealthyLoad>(per_priority_load_.healthy_priority_load_);
@@ -95,20 +103,90 @@ void ThreadAwareLoadBalancerBase::refresh() {
 
   for (const auto& host_set : priority_set_.hostSetsPerPriority()) {
     const uint32_t priority = host_set->priority();
-    (*per_priority_state_vector)[priority] = std::make_unique<PerPriorityState>();
-    const auto& per_priority_state = (*per_priority_state_vector)[priority];
+    PerPriorityBuildInput& input = per_priority_input[priority];
     // Copy panic flag from LoadBalancerBase. It is calculated when there is a change
     // in hosts set or hosts' health.
-    per_priority_state->global_panic_ = per_priority_panic_[priority];
+    input.global_panic_ = per_priority_panic_[priority];
 
     // Normalize host and locality weights such that the sum of all normalized weights is 1.
-    NormalizedHostWeightVector normalized_host_weights;
-    double min_normalized_weight = 1.0;
-    double max_normalized_weight = 0.0;
-    normalizeWeights(*host_set, per_priority_state->global_panic_, normalized_host_weights,
-                     min_normalized_weight, max_normalized_weight);
+    normalizeWeights(*host_set, input.global_panic_, input.normalized_host_weights_,
+                     input.min_normalized_weight_, input.max_normalized_weight_);
+  }
+
+  const uint64_t sequence = ++refresh_sequence_;
+  if (table_builder_ == nullptr || !initialized_) {
+    build(per_priority_input, healthy_per_priority_load, degraded_per_priority_load, sequence);
+    return;
+  }
+
+  // Until the build finishes, the workers keep using the current tables. A build that is still
+  // waiting when the hosts change again is replaced by the build for the new hosts.
+  updateRemovedHosts(hosts_added, hosts_removed, per_priority_input, sequence);
+  auto shared_input = std::make_shared<std::vector<PerPriorityBuildInput>>(
+      std::move(per_priority_input));
+  table_builder_->schedule(this, [this, shared_input, healthy_per_priority_load,
+                                  degraded_per_priority_load, sequence]() -> void {
+    build(*shared_input, healthy_per_priority_load, degraded_per_priority_load, sequence);
+  });
+}
+
+void ThreadAwareLoadBalancerBase::updateRemovedHosts(
+    const HostVector& hosts_added, const HostVector& hosts_removed,
+    const std::vector<PerPriorityBuildInput>& per_priority_input, uint64_t sequence) {
+  absl::WriterMutexLock lock(&factory_->mutex_);
+  if (factory_->removed_hosts_ == nullptr && hosts_removed.empty()) {
+    return;
+  }
+
+  auto removed_hosts = std::make_shared<RemovedHosts>();
+  if (factory_->removed_hosts_ != nullptr) {
+    removed_hosts->hosts_ = factory_->removed_hosts_->hosts_;
+  }
+  for (const auto& host : hosts_added) {
+    removed_hosts->hosts_.erase(host);
+  }
+  for (const auto& host : hosts_removed) {
+    removed_hosts->hosts_[host] = sequence;
+  }
+  if (removed_hosts->hosts_.empty()) {
+    factory_->removed_hosts_ = nullptr;
+  } else {
+    for (const PerPriorityBuildInput& input : per_priority_input) {
+      removed_hosts->remaining_per_priority_.emplace_back();
+      for (const auto& host_weight : input.normalized_host_weights_) {
+        removed_hosts->remaining_per_priority_.back().push_back(host_weight.first);
+      }
+    }
+    factory_->removed_hosts_ = std::move(removed_hosts);
+  }
+  factory_->generation_++;
+}
+
+void ThreadAwareLoadBalancerBase::build(
+    const std::vector<PerPriorityBuildInput>& per_priority_input,
+    const std::shared_ptr<HealthyLoad>& healthy_per_priority_load,
+    const std::shared_ptr<DegradedLoad>& degraded_per_priority_load, uint64_t sequence) {
+  std::shared_ptr<std::vector<PerPriorityStatePtr>> previous_per_priority_state;
+  {
+    absl::ReaderMutexLock lock(&factory_->mutex_);
+    previous_per_priority_state = factory_->per_priority_state_;
+  }
+
+  auto per_priority_state_vector =
+      std::make_shared<std::vector<PerPriorityStatePtr>>(per_priority_input.size());
+  for (size_t priority = 0; priority < per_priority_input.size(); priority++) {
+    const PerPriorityBuildInput& input = per_priority_input[priority];
+    (*per_priority_state_vector)[priority] = std::make_unique<PerPriorityState>();
+    const auto& per_priority_state = (*per_priority_state_vector)[priority];
+    per_priority_state->global_panic_ = input.global_panic_;
+
+    const HashingLoadBalancerSharedPtr previous_lb =
+        previous_per_priority_state != nullptr && priority < previous_per_priority_state->size()
+            ? (*previous_per_priority_state)[priority]->current_lb_
+            : nullptr;
     per_priority_state->current_lb_ =
-        createLoadBalancer(normalized_host_weights, min_normalized_weight, max_normalized_weight);
+        createLoadBalancer(input.normalized_host_weights_, input.min_normalized_weight_,
+                           input.max_normalized_weight_, previous_lb);
   }
 
   {
@@ -116,11 +194,33 @@ void ThreadAwareLoadBalancerBase::refresh() {
     factory_->healthy_per_priority_load_ = healthy_per_priority_load;
     factory_->degraded_per_priority_load_ = degraded_per_priority_load;
     factory_->per_priority_state_ = per_priority_state_vector;
+    // The new tables no longer have the hosts removed up to this refresh. Builds finish in the
+    // order they were scheduled, so hosts removed by later refreshes must still be skipped.
+    if (factory_->removed_hosts_ != nullptr) {
+      auto removed_hosts = std::make_shared<RemovedHosts>();
+      for (const auto& removed_host : factory_->removed_hosts_->hosts_) {
+        if (removed_host.second > sequence) {
+          removed_hosts->hosts_.insert(removed_host);
+        }
+      }
+      if (removed_hosts->hosts_.empty()) {
+        factory_->removed_hosts_ = nullptr;
+      } else {
+        removed_hosts->remaining_per_priority_ = factory_->removed_hosts_->remaining_per_priority_;
+        factory_->removed_hosts_ = std::move(removed_hosts);
+      }
+    }
+    factory_->generation_++;
   }
 }
 
 HostConstSharedPtr
 ThreadAwareLoadBalancerBase::LoadBalancerImpl::chooseHost(LoadBalancerContext* context) {
+  // Pick up the tables that finished building since this load balancer was created.
+  if (generation_ != factory_->generation_.load(std::memory_order_acquire)) {
+    factory_->takeState(*this);
+  }
+
   // Make sure we correctly return nullptr for any early chooseHost() calls.
   if (per_priority_state_ == nullptr) {
     return nullptr;
@@ -142,20 +242,35 @@ ThreadAwareLoadBalancerBase::LoadBalancerImpl::chooseHost(LoadBalancerContext* c
   if (per_priority_state->global_panic_) {
     stats_.lb_healthy_panic_.inc();
   }
-  return per_priority_state->current_lb_->chooseHost(h);
+  HostConstSharedPtr host = per_priority_state->current_lb_->chooseHost(h);
+  if (removed_hosts_ == nullptr || host == nullptr || removed_hosts_->hosts_.count(host) == 0) {
+    return host;
+  }
+
+  // The tables still have a host that was removed while their replacement is being built. Pick one
+  // of the remaining hosts instead, by the same hash so that the pick stays put until then.
+  const auto& remaining_per_priority = removed_hosts_->remaining_per_priority_;
+  if (priority >= remaining_per_priority.size() || remaining_per_priority[priority].empty()) {
+    return nullptr;
+  }
+  return remaining_per_priority[priority][h % remaining_per_priority[priority].size()];
 }
 
 LoadBalancerPtr ThreadAwareLoadBalancerBase::LoadBalancerFactoryImpl::create() {
-  auto lb = std::make_unique<LoadBalancerImpl>(stats_, random_);
+  auto lb = std::make_unique<LoadBalancerImpl>(shared_from_this());
+  takeState(*lb);
+  return lb;
+}
 
+void ThreadAwareLoadBalancerBase::LoadBalancerFactoryImpl::takeState(LoadBalancerImpl& lb) {
   // We must protect current_lb_ via a RW lock since it is accessed and written to by multiple
   // threads. All complex processing has already been precalculated however.
   absl::ReaderMutexLock lock(&mutex_);
-  lb->healthy_per_priority_load_ = healthy_per_priority_load_;
-  lb->degraded_per_priority_load_ = degraded_per_priority_load_;
-  lb->per_priority_state_ = per_priority_state_;
-
-  return lb;
+  lb.generation_ = generation_.load(std::memory_order_relaxed);
+  lb.healthy_per_priority_load_ = healthy_per_priority_load_;
+  lb.degraded_per_priority_load_ = degraded_per_priority_load_;
+  lb.per_priority_state_ = per_priority_state_;
+  lb.removed_hosts_ = removed_hosts_;
 }
 
 } // namespace Upstream
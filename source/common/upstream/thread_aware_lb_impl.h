@@ -1,5 +1,10 @@
 #pragma once
 
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+#include "common/upstream/lb_table_builder.h"
 #include "common/upstream/load_balancer_impl.h"
 
 #include "absl/synchronization/mutex.h"
@@ -36,11 +41,23 @@ public:
   }
 
 protected:
+  /**
+   * @param table_builder supplies the thread to build tables on when the hosts change after
+   *        initialize(), or nullptr to build them in place.
+   */
   ThreadAwareLoadBalancerBase(const PrioritySet& priority_set, ClusterStats& stats,
                               Runtime::Loader& runtime, Runtime::RandomGenerator& random,
-                              const envoy::api::v2::Cluster::CommonLbConfig& common_config)
+                              const envoy::api::v2::Cluster::CommonLbConfig& common_config,
+                              LoadBalancerTableBuilder* table_builder = nullptr)
       : LoadBalancerBase(priority_set, stats, runtime, random, common_config),
-        factory_(new LoadBalancerFactoryImpl(stats, random)) {}
+        factory_(new LoadBalancerFactoryImpl(stats, random)), table_builder_(table_builder) {}
+
+  /**
+   * Stop building tables, waiting for a build that is running to finish. Builds call
+   * createLoadBalancer(), so when tables are built in the background, the destructor of the most
+   * derived class must call this before its members go away.
+   */
+  void cancelTableBuilds();
 
 private:
   struct PerPriorityState {
@@ -49,42 +66,93 @@ private:
   };
   typedef std::unique_ptr<PerPriorityState> PerPriorityStatePtr;
 
+  // The input of a table build for one priority, gathered on the main thread.
+  struct PerPriorityBuildInput {
+    NormalizedHostWeightVector normalized_host_weights_;
+    double min_normalized_weight_{1.0};
+    double max_normalized_weight_{0.0};
+    bool global_panic_{};
+  };
+
+  // The hosts removed while the tables without them are being built, and the hosts the latest
+  // refresh left in each priority, which picks of removed hosts fall back to.
+  struct RemovedHosts {
+    // Maps each removed host to the refresh that removed it.
+    std::unordered_map<HostConstSharedPtr, uint64_t> hosts_;
+    std::vector<std::vector<HostConstSharedPtr>> remaining_per_priority_;
+  };
+
+  struct LoadBalancerFactoryImpl;
+
   struct LoadBalancerImpl : public LoadBalancer {
-    LoadBalancerImpl(ClusterStats& stats, Runtime::RandomGenerator& random)
-        : stats_(stats), random_(random) {}
+    LoadBalancerImpl(const std::shared_ptr<LoadBalancerFactoryImpl>& factory)
+        : factory_(factory), stats_(factory->stats_), random_(factory->random_) {}
 
     // Upstream::LoadBalancer
     HostConstSharedPtr chooseHost(LoadBalancerContext* context) override;
+    void putResponseTime(const HostDescription&, std::chrono::microseconds) override {}
 
+    const std::shared_ptr<LoadBalancerFactoryImpl> factory_;
     ClusterStats& stats_;
     Runtime::RandomGenerator& random_;
+    // The factory generation the state below was taken at.
+    uint64_t generation_{};
     std::shared_ptr<std::vector<PerPriorityStatePtr>> per_priority_state_;
     std::shared_ptr<HealthyLoad> healthy_per_priority_load_;
     std::shared_ptr<DegradedLoad> degraded_per_priority_load_;
+    std::shared_ptr<const RemovedHosts> removed_hosts_;
   };
 
-  struct LoadBalancerFactoryImpl : public LoadBalancerFactory {
+  struct LoadBalancerFactoryImpl : public LoadBalancerFactory,
+                                   public std::enable_shared_from_this<LoadBalancerFactoryImpl> {
     LoadBalancerFactoryImpl(ClusterStats& stats, Runtime::RandomGenerator& random)
         : stats_(stats), random_(random) {}
 
     // Upstream::LoadBalancerFactory
     LoadBalancerPtr create() override;
 
+    // Copy the current state into a load balancer.
+    void takeState(LoadBalancerImpl& lb);
+
     ClusterStats& stats_;
     Runtime::RandomGenerator& random_;
+    // Bumped whenever the state below changes, so that the load balancers already created can pick
+    // up tables that were built in the background after they were.
+    std::atomic<uint64_t> generation_{};
     absl::Mutex mutex_;
     std::shared_ptr<std::vector<PerPriorityStatePtr>> per_priority_state_ GUARDED_BY(mutex_);
     // This is split out of PerPriorityState so LoadBalancerBase::ChoosePriority can be reused.
     std::shared_ptr<HealthyLoad> healthy_per_priority_load_ GUARDED_BY(mutex_);
     std::shared_ptr<DegradedLoad> degraded_per_priority_load_ GUARDED_BY(mutex_);
+    // The workers drain the connection pools of removed hosts right away, but keep picking from
+    // the current tables until the build without those hosts finishes. Picks of these hosts are
+    // redirected in the meantime, as they would create pools that are never drained. nullptr when
+    // there are none.
+    std::shared_ptr<const RemovedHosts> removed_hosts_ GUARDED_BY(mutex_);
   };
 
+  /**
+   * Build the table of a priority. This runs on the table builder thread, if there is one, and may
+   * not touch the priority set.
+   * @param previous_lb supplies the table the priority had before, if any, which may be reused.
+   */
   virtual HashingLoadBalancerSharedPtr
   createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
-                     double min_normalized_weight, double max_normalized_weight) PURE;
-  void refresh();
+                     double min_normalized_weight, double max_normalized_weight,
+                     const HashingLoadBalancerSharedPtr& previous_lb) PURE;
+  void refresh(const HostVector& hosts_added, const HostVector& hosts_removed);
+  void updateRemovedHosts(const HostVector& hosts_added, const HostVector& hosts_removed,
+                          const std::vector<PerPriorityBuildInput>& per_priority_input,
+                          uint64_t sequence);
+  void build(const std::vector<PerPriorityBuildInput>& per_priority_input,
+             const std::shared_ptr<HealthyLoad>& healthy_per_priority_load,
+             const std::shared_ptr<DegradedLoad>& degraded_per_priority_load, uint64_t sequence);
 
   std::shared_ptr<LoadBalancerFactoryImpl> factory_;
+  LoadBalancerTableBuilder* const table_builder_;
+  bool initialized_{};
+  // Numbers the refreshes, so that a build only forgets the hosts removed up to its own refresh.
+  uint64_t refresh_sequence_{};
 };
 
 } // namespace Upstream
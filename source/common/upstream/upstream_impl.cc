@@ -1,5 +1,6 @@
 #include "common/upstream/upstream_impl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <limits>
@@ -601,6 +602,13 @@ ClusterInfoImpl::ClusterInfoImpl(const envoy::api::v2::Cluster& config,
   case envoy::api::v2::Cluster::CLUSTER_PROVIDED:
     lb_type_ = LoadBalancerType::ClusterProvided;
     break;
+  case envoy::api::v2::Cluster::PEAK_EWMA:
+    if (config.has_lb_subset_config() && config.lb_subset_config().subset_selectors_size() != 0) {
+      throw EnvoyException(
+          fmt::format("cluster: LB type 'peak_ewma' may not be used with lb_subset_config"));
+    }
+    lb_type_ = LoadBalancerType::PeakEwma;
+    break;
   default:
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
@@ -991,7 +999,8 @@ void PriorityStateManager::updateClusterPrioritySet(
     const uint32_t priority, HostVectorSharedPtr&& current_hosts,
     const absl::optional<HostVector>& hosts_added, const absl::optional<HostVector>& hosts_removed,
     const absl::optional<Upstream::Host::HealthFlag> health_checker_flag,
-    absl::optional<uint32_t> overprovisioning_factor) {
+    absl::optional<uint32_t> overprovisioning_factor,
+    HostsPerLocalityConstSharedPtr current_hosts_per_locality) {
   // If local locality is not defined then skip populating per locality hosts.
   const auto& local_locality = local_info_node_.locality();
   ENVOY_LOG(trace, "Local locality: {}", local_locality.DebugString());
@@ -1011,6 +1020,23 @@ void PriorityStateManager::updateClusterPrioritySet(
     locality_weights = std::make_shared<LocalityWeights>();
   }
 
+  if (current_hosts_per_locality != nullptr) {
+    // The membership of the priority did not change, so neither did its locality buckets (the
+    // locality of a host is immutable). Only the locality weights need to be refreshed, in the
+    // order of the existing buckets.
+    ASSERT(!health_checker_flag.has_value());
+    if (locality_weighted_lb) {
+      for (const HostVector& locality_hosts : current_hosts_per_locality->get()) {
+        locality_weights->emplace_back(
+            locality_hosts.empty() ? 0 : locality_weights_map[locality_hosts[0]->locality()]);
+      }
+    }
+    updatePrioritySet(priority, std::move(hosts), std::move(current_hosts_per_locality),
+                      std::move(locality_weights), hosts_added, hosts_removed,
+                      overprovisioning_factor);
+    return;
+  }
+
   // We use std::map to guarantee a stable ordering for zone aware routing.
   std::map<envoy::api::v2::core::Locality, HostVector, LocalityLess> hosts_per_locality;
 
@@ -1032,7 +1058,7 @@ void PriorityStateManager::updateClusterPrioritySet(
   // As per HostsPerLocality::get(), the per_locality vector must have the local locality hosts
   // first if non_empty_local_locality.
   if (non_empty_local_locality) {
-    per_locality.emplace_back(hosts_per_locality[local_locality]);
+    per_locality.emplace_back(std::move(hosts_per_locality[local_locality]));
     if (locality_weighted_lb) {
       locality_weights->emplace_back(locality_weights_map[local_locality]);
     }
@@ -1042,7 +1068,7 @@ void PriorityStateManager::updateClusterPrioritySet(
   // lexicographic order. This provides a stable ordering for zone aware routing.
   for (auto& entry : hosts_per_locality) {
     if (!non_empty_local_locality || !LocalityEqualTo()(local_locality, entry.first)) {
-      per_locality.emplace_back(entry.second);
+      per_locality.emplace_back(std::move(entry.second));
       if (locality_weighted_lb) {
         locality_weights->emplace_back(locality_weights_map[entry.first]);
       }
@@ -1052,15 +1078,26 @@ void PriorityStateManager::updateClusterPrioritySet(
   auto per_locality_shared =
       std::make_shared<HostsPerLocalityImpl>(std::move(per_locality), non_empty_local_locality);
 
+  updatePrioritySet(priority, std::move(hosts), std::move(per_locality_shared),
+                    std::move(locality_weights), hosts_added, hosts_removed,
+                    overprovisioning_factor);
+}
+
+void PriorityStateManager::updatePrioritySet(const uint32_t priority, HostVectorSharedPtr&& hosts,
+                                             HostsPerLocalityConstSharedPtr&& hosts_per_locality,
+                                             LocalityWeightsConstSharedPtr&& locality_weights,
+                                             const absl::optional<HostVector>& hosts_added,
+                                             const absl::optional<HostVector>& hosts_removed,
+                                             absl::optional<uint32_t> overprovisioning_factor) {
   // If a batch update callback was provided, use that. Otherwise directly update
   // the PrioritySet.
   if (update_cb_ != nullptr) {
-    update_cb_->updateHosts(priority, HostSetImpl::partitionHosts(hosts, per_locality_shared),
+    update_cb_->updateHosts(priority, HostSetImpl::partitionHosts(hosts, hosts_per_locality),
                             std::move(locality_weights), hosts_added.value_or(*hosts),
                             hosts_removed.value_or<HostVector>({}), overprovisioning_factor);
   } else {
     parent_.prioritySet().updateHosts(
-        priority, HostSetImpl::partitionHosts(hosts, per_locality_shared),
+        priority, HostSetImpl::partitionHosts(hosts, hosts_per_locality),
         std::move(locality_weights), hosts_added.value_or(*hosts),
         hosts_removed.value_or<HostVector>({}), overprovisioning_factor);
   }
@@ -1081,7 +1118,7 @@ bool BaseDynamicClusterImpl::updateDynamicHostList(const HostVector& new_hosts,
   // endpoint has materially changed (e.g. if previously failing active health
   // checks, we just note it's now failing EDS health status but don't rebuild).
   //
-  // Likewise, if metadata for an endpoint changed we rebuild the hosts vectors.
+  // Likewise, if metadata or the weight of an endpoint changed we rebuild the hosts vectors.
   //
   // TODO(htuch): We can be smarter about this potentially, and not force a full
   // host set update on health status change. The way this would work is to
@@ -1091,8 +1128,9 @@ bool BaseDynamicClusterImpl::updateDynamicHostList(const HostVector& new_hosts,
   bool hosts_changed = false;
 
   // Go through and see if the list we have is different from what we just got. If it is, we make a
-  // new host list and raise a change notification. This uses an N^2 search given that this does not
-  // happen very often and the list sizes should be small (see
+  // new host list and raise a change notification. New hosts are matched with existing ones through
+  // the address-keyed all_hosts index, and the hosts of the current priority are partitioned in a
+  // single pass, so this is linear in the number of hosts (see
   // https://github.com/envoyproxy/envoy/issues/2874). We also check for duplicates here. It's
   // possible for DNS to return the same address multiple times, and a bad EDS implementation could
   // do the same thing.
@@ -1102,12 +1140,13 @@ bool BaseDynamicClusterImpl::updateDynamicHostList(const HostVector& new_hosts,
       current_priority_hosts.size());
   HostVector final_hosts;
   for (const HostSharedPtr& host : new_hosts) {
-    if (updated_hosts.count(host->address()->asString())) {
+    const std::string& address = host->address()->asString();
+    if (updated_hosts.count(address)) {
       continue;
     }
 
     // To match a new host with an existing host means comparing their addresses.
-    auto existing_host = all_hosts.find(host->address()->asString());
+    auto existing_host = all_hosts.find(address);
     const bool existing_host_found = existing_host != all_hosts.end();
 
     // Clear any pending deletion flag on an existing host in case it came back while it was
@@ -1163,9 +1202,15 @@ bool BaseDynamicClusterImpl::updateDynamicHostList(const HostVector& new_hosts,
         hosts_added_to_current_priority.emplace_back(existing_host->second);
       }
 
-      existing_host->second->weight(host->weight());
+      // Did the weight change? If so, we need to rebuild so that load balancers that precompute a
+      // weighted schedule on host set updates pick up the new weight.
+      if (host->weight() != existing_host->second->weight()) {
+        existing_host->second->weight(host->weight());
+        hosts_changed = true;
+      }
+
       final_hosts.push_back(existing_host->second);
-      updated_hosts[existing_host->second->address()->asString()] = existing_host->second;
+      updated_hosts[address] = existing_host->second;
     } else {
       if (host->weight() > max_host_weight) {
         max_host_weight = host->weight();
@@ -1182,7 +1227,7 @@ bool BaseDynamicClusterImpl::updateDynamicHostList(const HostVector& new_hosts,
         }
       }
 
-      updated_hosts[host->address()->asString()] = host;
+      updated_hosts[address] = host;
       final_hosts.push_back(host);
       hosts_added_to_current_priority.push_back(host);
     }
@@ -1190,16 +1235,13 @@ bool BaseDynamicClusterImpl::updateDynamicHostList(const HostVector& new_hosts,
 
   // Remove hosts from current_priority_hosts that were matched to an existing host in the previous
   // loop.
-  for (auto itr = current_priority_hosts.begin(); itr != current_priority_hosts.end();) {
-    auto existing_itr = existing_hosts_for_current_priority.find((*itr)->address()->asString());
-
-    if (existing_itr != existing_hosts_for_current_priority.end()) {
-      existing_hosts_for_current_priority.erase(existing_itr);
-      itr = current_priority_hosts.erase(itr);
-    } else {
-      itr++;
-    }
-  }
+  current_priority_hosts.erase(
+      std::remove_if(current_priority_hosts.begin(), current_priority_hosts.end(),
+                     [&existing_hosts_for_current_priority](const HostSharedPtr& host) {
+                       return existing_hosts_for_current_priority.erase(
+                                  host->address()->asString()) > 0;
+                     }),
+      current_priority_hosts.end());
 
   // If we saw existing hosts during this iteration from a different priority, then we've moved
   // a host from another priority into this one, so we should mark the priority as having changed.
@@ -1217,21 +1259,23 @@ bool BaseDynamicClusterImpl::updateDynamicHostList(const HostVector& new_hosts,
   const bool dont_remove_healthy_hosts =
       health_checker_ != nullptr && !info()->drainConnectionsOnHostRemoval();
   if (!current_priority_hosts.empty() && dont_remove_healthy_hosts) {
-    for (auto i = current_priority_hosts.begin(); i != current_priority_hosts.end();) {
-      if (!((*i)->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC) ||
-            (*i)->healthFlagGet(Host::HealthFlag::FAILED_EDS_HEALTH))) {
-        if ((*i)->weight() > max_host_weight) {
-          max_host_weight = (*i)->weight();
-        }
-
-        final_hosts.push_back(*i);
-        updated_hosts[(*i)->address()->asString()] = *i;
-        (*i)->healthFlagSet(Host::HealthFlag::PENDING_DYNAMIC_REMOVAL);
-        i = current_priority_hosts.erase(i);
-      } else {
-        i++;
-      }
-    }
+    current_priority_hosts.erase(
+        std::remove_if(current_priority_hosts.begin(), current_priority_hosts.end(),
+                       [&](const HostSharedPtr& host) {
+                         if (host->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC) ||
+                             host->healthFlagGet(Host::HealthFlag::FAILED_EDS_HEALTH)) {
+                           return false;
+                         }
+                         if (host->weight() > max_host_weight) {
+                           max_host_weight = host->weight();
+                         }
+
+                         final_hosts.push_back(host);
+                         updated_hosts[host->address()->asString()] = host;
+                         host->healthFlagSet(Host::HealthFlag::PENDING_DYNAMIC_REMOVAL);
+                         return true;
+                       }),
+        current_priority_hosts.end());
   }
 
   // At this point we've accounted for all the new hosts as well the hosts that previously
@@ -1239,9 +1283,9 @@ bool BaseDynamicClusterImpl::updateDynamicHostList(const HostVector& new_hosts,
 
   // TODO(mattklein123): This stat is used by both the RR and LR load balancer to decide at
   // runtime whether to use either the weighted or unweighted mode. If we extend weights to
-  // static clusters or DNS SRV clusters we need to make sure this gets set. Better, we should
-  // avoid pivoting on this entirely and probably just force a host set refresh if any weights
-  // change.
+  // static clusters or DNS SRV clusters we need to make sure this gets set. Better, now that a
+  // weight change forces a host set refresh, we should avoid pivoting on this entirely and have
+  // the load balancers look at the weights of the hosts on refresh.
   info_->stats().max_host_weight_.set(max_host_weight);
 
   // Whatever remains in current_priority_hosts should be removed.
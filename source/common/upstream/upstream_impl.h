@@ -767,12 +767,16 @@ public:
       const HostSharedPtr& host,
       const envoy::api::v2::endpoint::LocalityLbEndpoints& locality_lb_endpoint);
 
+  // Updates the hosts of a priority, grouping them by locality. If the caller knows that the
+  // membership of the priority did not change, it can pass the current hosts_per_locality of the
+  // priority so that the hosts are not grouped again.
   void
   updateClusterPrioritySet(const uint32_t priority, HostVectorSharedPtr&& current_hosts,
                            const absl::optional<HostVector>& hosts_added,
                            const absl::optional<HostVector>& hosts_removed,
                            const absl::optional<Upstream::Host::HealthFlag> health_checker_flag,
-                           absl::optional<uint32_t> overprovisioning_factor = absl::nullopt);
+                           absl::optional<uint32_t> overprovisioning_factor = absl::nullopt,
+                           HostsPerLocalityConstSharedPtr current_hosts_per_locality = nullptr);
 
   // Returns the size of the current cluster priority state.
   size_t size() const { return priority_state_.size(); }
@@ -781,6 +785,13 @@ public:
   PriorityState& priorityState() { return priority_state_; }
 
 private:
+  void updatePrioritySet(const uint32_t priority, HostVectorSharedPtr&& hosts,
+                         HostsPerLocalityConstSharedPtr&& hosts_per_locality,
+                         LocalityWeightsConstSharedPtr&& locality_weights,
+                         const absl::optional<HostVector>& hosts_added,
+                         const absl::optional<HostVector>& hosts_removed,
+                         absl::optional<uint32_t> overprovisioning_factor);
+
   ClusterImplBase& parent_;
   PriorityState priority_state_;
   const envoy::api::v2::core::Node& local_info_node_;
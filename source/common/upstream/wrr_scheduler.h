@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Upstream {
+
+// Interleaved weighted round robin (IWRR) scheduler used for weighted round robin over integer
+// weights that do not change between picks. The schedule is made of max weight rounds. Round r
+// visits, in insertion order among equal weights, every entry whose weight is greater than r, so
+// an entry of weight w is picked w times per schedule and the picks of heavy entries are spread
+// across the schedule rather than bunched together. The schedule is built lazily on the first pick
+// after entries have been added, in O(n log n) time, after which picks are O(1) and do not
+// allocate.
+template <class C> class WrrScheduler {
+public:
+  /**
+   * Pick the next entry of the schedule.
+   * @return std::shared_ptr<C> to the next entry if the schedule is not empty, nullptr otherwise.
+   *         Unlike EdfScheduler::pick(), the entry stays in the schedule.
+   */
+  std::shared_ptr<C> pick() {
+    if (entries_.empty()) {
+      return nullptr;
+    }
+    build();
+    if (index_ == round_sizes_[round_]) {
+      index_ = 0;
+      round_ = round_ + 1 == round_sizes_.size() ? 0 : round_ + 1;
+    }
+    return entries_[index_++].entry_;
+  }
+
+  /**
+   * Add an entry to the schedule with a given weight. This invalidates the position of the
+   * schedule, which restarts at the first pick unless seek() is called.
+   * @param weight integer weight of the entry, which must be at least 1.
+   * @param entry shared pointer to entry. A strong reference is retained, since the schedule is
+   *        expected to be rebuilt whenever its entries change.
+   */
+  void add(uint32_t weight, std::shared_ptr<C> entry) {
+    ASSERT(weight > 0);
+    entries_.push_back({weight, std::move(entry)});
+    total_weight_ += weight;
+    dirty_ = true;
+  }
+
+  /**
+   * Move the position of the schedule, so that the next pick is the one that would have been made
+   * after offset picks from the start of the schedule. This is O(max weight).
+   * @param offset number of picks to skip, modulo the total weight of the entries.
+   */
+  void seek(uint64_t offset) {
+    if (entries_.empty()) {
+      return;
+    }
+    build();
+    offset %= total_weight_;
+    round_ = 0;
+    while (offset >= round_sizes_[round_]) {
+      offset -= round_sizes_[round_++];
+    }
+    index_ = offset;
+  }
+
+  /**
+   * @return bool whether or not the schedule has any entries.
+   */
+  bool empty() const { return entries_.empty(); }
+
+private:
+  struct WrrEntry {
+    uint32_t weight_;
+    std::shared_ptr<C> entry_;
+  };
+
+  void build() {
+    if (!dirty_) {
+      return;
+    }
+    dirty_ = false;
+
+    // Heaviest entries first, so that each round is a prefix of entries_. The sort is stable to
+    // keep insertion order within a weight.
+    std::stable_sort(entries_.begin(), entries_.end(), [](const WrrEntry& a, const WrrEntry& b) {
+      return a.weight_ > b.weight_;
+    });
+
+    // round_sizes_[r] is the number of entries with weight greater than r. Count the entries of
+    // each weight and then accumulate from the heaviest weight down.
+    round_sizes_.assign(entries_.front().weight_, 0);
+    for (const WrrEntry& entry : entries_) {
+      ++round_sizes_[entry.weight_ - 1];
+    }
+    for (size_t round = round_sizes_.size() - 1; round > 0; --round) {
+      round_sizes_[round - 1] += round_sizes_[round];
+    }
+
+    round_ = 0;
+    index_ = 0;
+  }
+
+  std::vector<WrrEntry> entries_;
+  // Number of entries visited by each round of the schedule.
+  std::vector<uint32_t> round_sizes_;
+  // The next pick is entries_[index_] in round round_, unless the round is over.
+  uint32_t round_{};
+  uint32_t index_{};
+  uint64_t total_weight_{};
+  bool dirty_{};
+};
+
+} // namespace Upstream
+} // namespace Envoy
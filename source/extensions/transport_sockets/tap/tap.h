@@ -27,6 +27,7 @@ public:
   Network::IoResult doWrite(Buffer::Instance& buffer, bool end_stream) override;
   void onConnected() override;
   const Ssl::ConnectionInfo* ssl() const override;
+  bool passthrough() const override { return false; }
 
 private:
   SocketTapConfigSharedPtr config_;
@@ -123,7 +123,8 @@ ContextConfigImpl::ContextConfigImpl(
       min_protocol_version_(tlsVersionFromProto(config.tls_params().tls_minimum_protocol_version(),
                                                 default_min_protocol_version)),
       max_protocol_version_(tlsVersionFromProto(config.tls_params().tls_maximum_protocol_version(),
-                                                default_max_protocol_version)) {
+                                                default_max_protocol_version)),
+      kernel_tls_enabled_(config.enable_kernel_tls()) {
   if (default_cvc_ && certificate_validation_context_provider_ != nullptr) {
     // We need to validate combined certificate validation context.
     // The default certificate validation context and dynamic certificate validation
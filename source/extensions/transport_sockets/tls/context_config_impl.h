@@ -43,6 +43,7 @@ public:
   }
   unsigned minProtocolVersion() const override { return min_protocol_version_; };
   unsigned maxProtocolVersion() const override { return max_protocol_version_; };
+  bool kernelTlsEnabled() const override { return kernel_tls_enabled_; }
 
   bool isReady() const override {
     const bool tls_is_ready =
@@ -92,6 +93,7 @@ private:
   Common::CallbackHandle* cvc_validation_callback_handle_{};
   const unsigned min_protocol_version_;
   const unsigned max_protocol_version_;
+  const bool kernel_tls_enabled_;
 };
 
 class ClientContextConfigImpl : public ContextConfigImpl, public Envoy::Ssl::ClientContextConfig {
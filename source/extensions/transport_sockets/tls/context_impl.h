@@ -34,7 +34,9 @@ namespace Tls {
   COUNTER(fail_verify_no_cert)                                                                     \
   COUNTER(fail_verify_error)                                                                       \
   COUNTER(fail_verify_san)                                                                         \
-  COUNTER(fail_verify_cert_hash)
+  COUNTER(fail_verify_cert_hash)                                                                   \
+  COUNTER(kernel_tls_offloaded)                                                                    \
+  COUNTER(kernel_tls_unsupported)
 // clang-format on
 
 /**
@@ -73,6 +75,11 @@ public:
 
   SslStats& stats() { return stats_; }
 
+  /**
+   * @return bool whether connections should try to hand their keys to kernel TLS.
+   */
+  bool kernelTlsEnabled() const { return kernel_tls_enabled_; }
+
   // Ssl::Context
   size_t daysUntilFirstCertExpires() const override;
   Envoy::Ssl::CertificateDetailsPtr getCaCertInformation() const override;
@@ -159,6 +166,7 @@ protected:
   std::string cert_chain_file_path_;
   TimeSource& time_source_;
   const unsigned tls_max_version_;
+  const bool kernel_tls_enabled_;
 };
 
 typedef std::shared_ptr<ContextImpl> ContextImplSharedPtr;
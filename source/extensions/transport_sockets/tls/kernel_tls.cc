@@ -0,0 +1,181 @@
+#include "extensions/transport_sockets/tls/kernel_tls.h"
+
+#include <string.h>
+#include <sys/socket.h>
+
+#include <vector>
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+
+#include "openssl/mem.h"
+
+#ifdef __linux__
+#include <linux/tls.h>
+#include <netinet/tcp.h>
+#endif
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace KernelTls {
+
+#ifdef __linux__
+
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+
+namespace {
+
+// TLS 1.2 AES-GCM uses no MAC keys and a 4 byte implicit nonce (the "salt").
+constexpr size_t GcmSaltLength = 4;
+
+template <class CryptoInfo>
+bool setCryptoInfo(int fd, int direction, uint16_t cipher_type, const uint8_t* key,
+                   const uint8_t* salt, uint64_t sequence) {
+  CryptoInfo info;
+  memset(&info, 0, sizeof(info));
+  info.info.version = TLS_1_2_VERSION;
+  info.info.cipher_type = cipher_type;
+  static_assert(sizeof(info.rec_seq) == sizeof(uint64_t), "unexpected record sequence size");
+  static_assert(sizeof(info.iv) == sizeof(uint64_t), "unexpected explicit nonce size");
+  static_assert(sizeof(info.salt) == GcmSaltLength, "unexpected salt size");
+  memcpy(info.key, key, sizeof(info.key));
+  memcpy(info.salt, salt, sizeof(info.salt));
+  for (size_t i = 0; i < sizeof(info.rec_seq); i++) {
+    info.rec_seq[i] = static_cast<uint8_t>(sequence >> (8 * (sizeof(info.rec_seq) - 1 - i)));
+  }
+  // BoringSSL uses the record sequence number as the explicit nonce, as does the kernel.
+  memcpy(info.iv, info.rec_seq, sizeof(info.iv));
+
+  const int rc =
+      Api::OsSysCallsSingleton::get().setsockopt(fd, SOL_TLS, direction, &info, sizeof(info)).rc_;
+  OPENSSL_cleanse(&info, sizeof(info));
+  return rc == 0;
+}
+
+bool setKeys(int fd, int direction, size_t key_length, const uint8_t* key, const uint8_t* salt,
+             uint64_t sequence) {
+  if (key_length == TLS_CIPHER_AES_GCM_128_KEY_SIZE) {
+    return setCryptoInfo<tls12_crypto_info_aes_gcm_128>(fd, direction, TLS_CIPHER_AES_GCM_128, key,
+                                                        salt, sequence);
+  }
+  ASSERT(key_length == TLS_CIPHER_AES_GCM_256_KEY_SIZE);
+  return setCryptoInfo<tls12_crypto_info_aes_gcm_256>(fd, direction, TLS_CIPHER_AES_GCM_256, key,
+                                                      salt, sequence);
+}
+
+} // namespace
+
+OffloadResult offload(SSL* ssl, int fd) {
+  if (SSL_version(ssl) != TLS1_2_VERSION || SSL_in_false_start(ssl)) {
+    return OffloadResult::Unsupported;
+  }
+  // Records BoringSSL already read from the socket would be lost to the kernel.
+  if (SSL_pending(ssl) != 0 || SSL_has_pending(ssl)) {
+    return OffloadResult::Unsupported;
+  }
+
+  const SSL_CIPHER* cipher = SSL_get_current_cipher(ssl);
+  if (cipher == nullptr) {
+    return OffloadResult::Unsupported;
+  }
+  size_t key_length;
+  switch (SSL_CIPHER_get_cipher_nid(cipher)) {
+  case NID_aes_128_gcm:
+    key_length = TLS_CIPHER_AES_GCM_128_KEY_SIZE;
+    break;
+  case NID_aes_256_gcm:
+    key_length = TLS_CIPHER_AES_GCM_256_KEY_SIZE;
+    break;
+  default:
+    return OffloadResult::Unsupported;
+  }
+
+  // The key block is client_write_key, server_write_key, client_write_IV, server_write_IV.
+  std::vector<uint8_t> key_block(SSL_get_key_block_len(ssl));
+  if (key_block.size() != 2 * (key_length + GcmSaltLength) ||
+      !SSL_generate_key_block(ssl, key_block.data(), key_block.size())) {
+    return OffloadResult::Unsupported;
+  }
+  const uint8_t* client_key = key_block.data();
+  const uint8_t* server_key = client_key + key_length;
+  const uint8_t* client_salt = server_key + key_length;
+  const uint8_t* server_salt = client_salt + GcmSaltLength;
+  const bool is_server = SSL_is_server(ssl);
+
+  OffloadResult result = OffloadResult::Offloaded;
+  if (Api::OsSysCallsSingleton::get().setsockopt(fd, SOL_TCP, TCP_ULP, "tls", 3).rc_ != 0) {
+    result = OffloadResult::Unavailable;
+  } else if (!setKeys(fd, TLS_RX, key_length, is_server ? client_key : server_key,
+                      is_server ? client_salt : server_salt, SSL_get_read_sequence(ssl))) {
+    // The socket behaves like a plain TCP socket until keys are installed.
+    result = OffloadResult::Unavailable;
+  } else if (!setKeys(fd, TLS_TX, key_length, is_server ? server_key : client_key,
+                      is_server ? server_salt : client_salt, SSL_get_write_sequence(ssl))) {
+    result = OffloadResult::Failed;
+  }
+  OPENSSL_cleanse(key_block.data(), key_block.size());
+  return result;
+}
+
+Api::SysCallSizeResult recv(int fd, const iovec* iov, int num_iov, uint8_t& record_type) {
+  char control[CMSG_SPACE(sizeof(uint8_t))];
+  msghdr message;
+  memset(&message, 0, sizeof(message));
+  message.msg_iov = const_cast<iovec*>(iov);
+  message.msg_iovlen = num_iov;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+
+  const ssize_t rc = ::recvmsg(fd, &message, 0);
+  if (rc < 0) {
+    return {rc, errno};
+  }
+  record_type = RecordTypeApplicationData;
+  for (cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr;
+       cmsg = CMSG_NXTHDR(&message, cmsg)) {
+    if (cmsg->cmsg_level == SOL_TLS && cmsg->cmsg_type == TLS_GET_RECORD_TYPE) {
+      record_type = *CMSG_DATA(cmsg);
+    }
+  }
+  return {rc, 0};
+}
+
+Api::SysCallSizeResult sendCloseNotify(int fd) {
+  // Alert level warning (1), description close_notify (0).
+  uint8_t alert[2] = {1, 0};
+  iovec iov{alert, sizeof(alert)};
+  char control[CMSG_SPACE(sizeof(uint8_t))];
+  msghdr message;
+  memset(&message, 0, sizeof(message));
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+  cmsg->cmsg_level = SOL_TLS;
+  cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(uint8_t));
+  *CMSG_DATA(cmsg) = RecordTypeAlert;
+  return Api::OsSysCallsSingleton::get().sendmsg(fd, &message, 0);
+}
+
+#else
+
+OffloadResult offload(SSL*, int) { return OffloadResult::Unavailable; }
+Api::SysCallSizeResult recv(int, const iovec*, int, uint8_t&) { NOT_REACHED_GCOVR_EXCL_LINE; }
+Api::SysCallSizeResult sendCloseNotify(int) { NOT_REACHED_GCOVR_EXCL_LINE; }
+
+#endif
+
+} // namespace KernelTls
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <sys/uio.h>
+
+#include <cstdint>
+
+#include "envoy/api/os_sys_calls_common.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace KernelTls {
+
+/**
+ * TLS record content types, see RFC 5246 section 6.2.1.
+ */
+constexpr uint8_t RecordTypeAlert = 21;
+constexpr uint8_t RecordTypeApplicationData = 23;
+
+enum class OffloadResult {
+  // The kernel now encrypts writes and decrypts reads of the socket.
+  Offloaded,
+  // The negotiated protocol version or cipher can not be offloaded, or BoringSSL still holds
+  // unprocessed data. The connection keeps using BoringSSL.
+  Unsupported,
+  // The kernel lacks TLS support. The connection keeps using BoringSSL.
+  Unavailable,
+  // Reads were offloaded but writes could not be; the connection can not continue.
+  Failed,
+};
+
+/**
+ * Hand the symmetric keys and sequence numbers negotiated by a completed handshake to the kernel
+ * TLS ULP (Linux 4.17+), so that plaintext can be written to and read from the socket directly.
+ * Only TLS 1.2 with AES-GCM is supported.
+ * @param ssl supplies the connection, which must have completed its handshake.
+ * @param fd supplies the TCP socket the connection runs on.
+ * @return OffloadResult the outcome. Unless it is Offloaded, the socket is left as it was.
+ */
+OffloadResult offload(SSL* ssl, int fd);
+
+/**
+ * Read from an offloaded socket. Reading stops at record type boundaries, so the data returned by
+ * one call belongs to records of a single type.
+ * @param fd supplies the socket.
+ * @param iov supplies the buffers to read into.
+ * @param num_iov supplies the number of buffers.
+ * @param record_type is set to the content type of the records read.
+ * @return Api::SysCallSizeResult the number of bytes read, 0 on EOF.
+ */
+Api::SysCallSizeResult recv(int fd, const iovec* iov, int num_iov, uint8_t& record_type);
+
+/**
+ * Send a close_notify alert on an offloaded socket.
+ * @param fd supplies the socket.
+ * @return Api::SysCallSizeResult the result of sendmsg(2).
+ */
+Api::SysCallSizeResult sendCloseNotify(int fd);
+
+} // namespace KernelTls
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
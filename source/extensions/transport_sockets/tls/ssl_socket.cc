@@ -2,11 +2,13 @@
 
 #include "envoy/stats/scope.h"
 
+#include "common/api/os_sys_calls_impl.h"
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
 #include "common/common/hex.h"
 #include "common/http/headers.h"
 
+#include "extensions/transport_sockets/tls/kernel_tls.h"
 #include "extensions/transport_sockets/tls/utility.h"
 
 #include "absl/strings/str_replace.h"
@@ -39,6 +41,7 @@ public:
   }
   void onConnected() override {}
   const Ssl::ConnectionInfo* ssl() const override { return nullptr; }
+  bool passthrough() const override { return false; }
 };
 } // namespace
 
@@ -97,6 +100,9 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
       return {action, 0, false};
     }
   }
+  if (kernel_tls_) {
+    return doKernelTlsRead(read_buffer);
+  }
 
   bool keep_reading = true;
   bool end_stream = false;
@@ -157,6 +163,9 @@ PostIoAction SslSocket::doHandshake() {
     ENVOY_CONN_LOG(debug, "handshake complete", callbacks_->connection());
     handshake_complete_ = true;
     ctx_->logHandshake(ssl_.get());
+    if (ctx_->kernelTlsEnabled() && !offloadToKernel()) {
+      return PostIoAction::Close;
+    }
     callbacks_->raiseEvent(Network::ConnectionEvent::Connected);
 
     // It's possible that we closed during the handshake callback.
@@ -177,6 +186,127 @@ PostIoAction SslSocket::doHandshake() {
   }
 }
 
+bool SslSocket::offloadToKernel() {
+  switch (KernelTls::offload(ssl_.get(), callbacks_->ioHandle().fd())) {
+  case KernelTls::OffloadResult::Offloaded:
+    ENVOY_CONN_LOG(debug, "handed TLS keys to the kernel", callbacks_->connection());
+    kernel_tls_ = true;
+    ctx_->stats().kernel_tls_offloaded_.inc();
+    return true;
+  case KernelTls::OffloadResult::Unsupported:
+  case KernelTls::OffloadResult::Unavailable:
+    ctx_->stats().kernel_tls_unsupported_.inc();
+    return true;
+  case KernelTls::OffloadResult::Failed:
+    failure_reason_ = "TLS error: unable to hand write keys to the kernel";
+    ENVOY_CONN_LOG(debug, "{}", callbacks_->connection(), failure_reason_);
+    ctx_->stats().connection_error_.inc();
+    return false;
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+// Kernel TLS reads and writes go straight to the fd, as BoringSSL's socket BIO does, so that the
+// close_notify alert written by shutdownSsl() is ordered after all data.
+Network::IoResult SslSocket::doKernelTlsRead(Buffer::Instance& read_buffer) {
+  const int fd = callbacks_->ioHandle().fd();
+  PostIoAction action = PostIoAction::KeepOpen;
+  bool end_stream = false;
+  uint64_t bytes_read = 0;
+  while (true) {
+    Buffer::RawSlice slices[2];
+    const uint64_t num_slices = read_buffer.reserve(16384, slices, 2);
+    iovec iov[2];
+    for (uint64_t i = 0; i < num_slices; i++) {
+      iov[i].iov_base = slices[i].mem_;
+      iov[i].iov_len = slices[i].len_;
+    }
+    uint8_t record_type;
+    const Api::SysCallSizeResult result = KernelTls::recv(fd, iov, num_slices, record_type);
+    ENVOY_CONN_LOG(trace, "kernel tls read returns: {}", callbacks_->connection(), result.rc_);
+    if (result.rc_ < 0) {
+      if (result.errno_ != EAGAIN) {
+        action = PostIoAction::Close;
+      }
+      break;
+    }
+    if (result.rc_ == 0) {
+      // Like SSL_read(), treat a TCP close without close_notify as an error.
+      action = PostIoAction::Close;
+      break;
+    }
+    if (record_type == KernelTls::RecordTypeAlert) {
+      // An alert has a level and a description, close_notify being 0.
+      const uint8_t* alert = static_cast<const uint8_t*>(slices[0].mem_);
+      if (result.rc_ >= 2 && slices[0].len_ >= 2 && alert[1] == 0) {
+        end_stream = true;
+      } else {
+        failure_reason_ = "TLS error: received fatal alert";
+        action = PostIoAction::Close;
+      }
+      break;
+    }
+    if (record_type != KernelTls::RecordTypeApplicationData) {
+      // Post-handshake messages would need BoringSSL, and renegotiation is not supported anyway.
+      failure_reason_ = "TLS error: unexpected record type";
+      action = PostIoAction::Close;
+      break;
+    }
+
+    uint64_t remaining = result.rc_;
+    uint64_t slices_to_commit = 0;
+    for (uint64_t i = 0; i < num_slices && remaining > 0; i++) {
+      slices[i].len_ = std::min(slices[i].len_, static_cast<size_t>(remaining));
+      remaining -= slices[i].len_;
+      slices_to_commit++;
+    }
+    read_buffer.commit(slices, slices_to_commit);
+    bytes_read += result.rc_;
+    if (callbacks_->shouldDrainReadBuffer()) {
+      callbacks_->setReadBufferReady();
+      break;
+    }
+  }
+
+  if (action == PostIoAction::Close && !failure_reason_.empty()) {
+    ENVOY_CONN_LOG(debug, "{}", callbacks_->connection(), failure_reason_);
+    ctx_->stats().connection_error_.inc();
+  }
+  return {action, bytes_read, end_stream};
+}
+
+Network::IoResult SslSocket::doKernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream) {
+  const int fd = callbacks_->ioHandle().fd();
+  uint64_t total_bytes_written = 0;
+  while (write_buffer.length() > 0) {
+    constexpr uint64_t MaxSlices = 16;
+    Buffer::RawSlice slices[MaxSlices];
+    const uint64_t num_slices = std::min(write_buffer.getRawSlices(slices, MaxSlices), MaxSlices);
+    iovec iov[MaxSlices];
+    for (uint64_t i = 0; i < num_slices; i++) {
+      iov[i].iov_base = slices[i].mem_;
+      iov[i].iov_len = slices[i].len_;
+    }
+    const Api::SysCallSizeResult result =
+        Api::OsSysCallsSingleton::get().writev(fd, iov, num_slices);
+    ENVOY_CONN_LOG(trace, "kernel tls write returns: {}", callbacks_->connection(), result.rc_);
+    if (result.rc_ < 0) {
+      if (result.errno_ == EAGAIN) {
+        break;
+      }
+      return {PostIoAction::Close, total_bytes_written, false};
+    }
+    total_bytes_written += result.rc_;
+    write_buffer.drain(result.rc_);
+  }
+
+  if (write_buffer.length() == 0 && end_stream) {
+    shutdownSsl();
+  }
+
+  return {PostIoAction::KeepOpen, total_bytes_written, false};
+}
+
 void SslSocket::drainErrorQueue() {
   bool saw_error = false;
   bool saw_counted_error = false;
@@ -212,6 +342,9 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
       return {action, 0, false};
     }
   }
+  if (kernel_tls_) {
+    return doKernelTlsWrite(write_buffer, end_stream);
+  }
 
   uint64_t bytes_to_write;
   if (bytes_to_retry_) {
@@ -266,6 +399,14 @@ void SslSocket::onConnected() { ASSERT(!handshake_complete_); }
 void SslSocket::shutdownSsl() {
   ASSERT(handshake_complete_);
   if (!shutdown_sent_ && callbacks_->connection().state() != Network::Connection::State::Closed) {
+    if (kernel_tls_) {
+      // ssl_ no longer knows the record sequence numbers, so the kernel has to send the alert.
+      const Api::SysCallSizeResult result =
+          KernelTls::sendCloseNotify(callbacks_->ioHandle().fd());
+      ENVOY_CONN_LOG(debug, "kernel TLS shutdown: rc={}", callbacks_->connection(), result.rc_);
+      shutdown_sent_ = true;
+      return;
+    }
     int rc = SSL_shutdown(ssl_.get());
     ENVOY_CONN_LOG(debug, "SSL shutdown: rc={}", callbacks_->connection(), rc);
     drainErrorQueue();
@@ -76,6 +76,7 @@ public:
   Network::IoResult doWrite(Buffer::Instance& write_buffer, bool end_stream) override;
   void onConnected() override;
   const Ssl::ConnectionInfo* ssl() const override { return this; }
+  bool passthrough() const override { return false; }
 
   SSL* rawSslForTest() const { return ssl_.get(); }
 
@@ -87,6 +88,9 @@ private:
   ReadResult sslReadIntoSlice(Buffer::RawSlice& slice);
 
   Network::PostIoAction doHandshake();
+  bool offloadToKernel();
+  Network::IoResult doKernelTlsRead(Buffer::Instance& read_buffer);
+  Network::IoResult doKernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream);
   void drainErrorQueue();
   void shutdownSsl();
 
@@ -95,6 +99,8 @@ private:
   bssl::UniquePtr<SSL> ssl_;
   bool handshake_complete_{};
   bool shutdown_sent_{};
+  // Whether records are encrypted and decrypted by the kernel rather than by ssl_.
+  bool kernel_tls_{};
   uint64_t bytes_to_retry_{};
   std::string failure_reason_;
   mutable std::string cached_sha_256_peer_certificate_digest_;
@@ -138,13 +138,19 @@ public:
     // validation mock.
     return nullptr;
   }
+  Network::SocketSharedPtr createWorkerListenSocket(Network::Address::InstanceConstSharedPtr,
+                                                    Network::Address::SocketType,
+                                                    const Network::Socket::OptionsSharedPtr&,
+                                                    uint32_t) override {
+    return nullptr;
+  }
   DrainManagerPtr createDrainManager(envoy::api::v2::Listener::DrainType) override {
     return nullptr;
   }
   uint64_t nextListenerTag() override { return 0; }
 
   // Server::WorkerFactory
-  WorkerPtr createWorker(OverloadManager&) override {
+  WorkerPtr createWorker(uint32_t, OverloadManager&) override {
     // Returned workers are not currently used so we can return nothing here safely vs. a
     // validation mock.
     return nullptr;
@@ -6,6 +6,7 @@
 #include "envoy/stats/scope.h"
 #include "envoy/stats/timespan.h"
 
+#include "common/common/fmt.h"
 #include "common/network/connection_impl.h"
 #include "common/network/utility.h"
 
@@ -14,8 +15,19 @@
 namespace Envoy {
 namespace Server {
 
-ConnectionHandlerImpl::ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher)
-    : logger_(logger), dispatcher_(dispatcher), disable_listeners_(false) {}
+ConnectionHandlerImpl::ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher,
+                                             absl::optional<uint32_t> worker_index)
+    : logger_(logger), dispatcher_(dispatcher), worker_index_(worker_index),
+      disable_listeners_(false) {}
+
+Network::Socket* ConnectionHandlerImpl::workerSocket(Network::ListenerConfig& config) {
+  return worker_index_.has_value() ? config.workerSocket(worker_index_.value()) : nullptr;
+}
+
+Network::Socket& ConnectionHandlerImpl::listenSocket(Network::ListenerConfig& config) {
+  Network::Socket* socket = workerSocket(config);
+  return socket != nullptr ? *socket : config.socket();
+}
 
 void ConnectionHandlerImpl::addListener(Network::ListenerConfig& config) {
   ActiveListenerBasePtr listener;
@@ -89,6 +101,7 @@ ConnectionHandlerImpl::ActiveListenerBase::ActiveListenerBase(ConnectionHandlerI
                                                               Network::ListenerConfig& config)
     : parent_(parent), listener_(std::move(listener)),
       stats_(generateStats(config.listenerScope())),
+      per_worker_stats_(parent.generatePerWorkerStats(config)),
       listener_filters_timeout_(config.listenerFiltersTimeout()),
       listener_tag_(config.listenerTag()), config_(config) {}
 
@@ -96,7 +109,7 @@ ConnectionHandlerImpl::ActiveTcpListener::ActiveTcpListener(ConnectionHandlerImp
                                                             Network::ListenerConfig& config)
     : ActiveTcpListener(
           parent,
-          parent.dispatcher_.createListener(config.socket(), *this, config.bindToPort(),
+          parent.dispatcher_.createListener(parent.listenSocket(config), *this, config.bindToPort(),
                                             config.handOffRestoredDestinationConnections()),
           config) {}
 
@@ -299,10 +312,17 @@ ConnectionHandlerImpl::ActiveConnection::ActiveConnection(ActiveTcpListener& lis
   connection_->addConnectionCallbacks(*this);
   listener_.stats_.downstream_cx_total_.inc();
   listener_.stats_.downstream_cx_active_.inc();
+  if (listener_.per_worker_stats_ != nullptr) {
+    listener_.per_worker_stats_->downstream_cx_total_.inc();
+    listener_.per_worker_stats_->downstream_cx_active_.inc();
+  }
 }
 
 ConnectionHandlerImpl::ActiveConnection::~ActiveConnection() {
   listener_.stats_.downstream_cx_active_.dec();
+  if (listener_.per_worker_stats_ != nullptr) {
+    listener_.per_worker_stats_->downstream_cx_active_.dec();
+  }
   listener_.stats_.downstream_cx_destroy_.inc();
   conn_length_->complete();
 }
@@ -311,10 +331,26 @@ ListenerStats ConnectionHandlerImpl::generateStats(Stats::Scope& scope) {
   return {ALL_LISTENER_STATS(POOL_COUNTER(scope), POOL_GAUGE(scope), POOL_HISTOGRAM(scope))};
 }
 
+std::unique_ptr<PerWorkerListenerStats>
+ConnectionHandlerImpl::generatePerWorkerStats(Network::ListenerConfig& config) {
+  // Only workers accepting on their own SO_REUSEPORT socket get their own stats, which show how
+  // the kernel spreads connections across those sockets. Otherwise every listener would add a set
+  // of stats per worker.
+  if (workerSocket(config) == nullptr) {
+    return nullptr;
+  }
+  Stats::Scope& scope = config.listenerScope();
+  const std::string prefix = fmt::format("worker_{}.", worker_index_.value());
+  return std::make_unique<PerWorkerListenerStats>(PerWorkerListenerStats{
+      ALL_PER_WORKER_LISTENER_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                    POOL_GAUGE_PREFIX(scope, prefix))});
+}
+
 ConnectionHandlerImpl::ActiveUdpListener::ActiveUdpListener(ConnectionHandlerImpl& parent,
                                                             Network::ListenerConfig& config)
-    : ActiveUdpListener(parent, parent.dispatcher_.createUdpListener(config.socket(), *this),
-                        config) {}
+    : ActiveUdpListener(
+          parent, parent.dispatcher_.createUdpListener(parent.listenSocket(config), *this),
+          config) {}
 
 ConnectionHandlerImpl::ActiveUdpListener::ActiveUdpListener(ConnectionHandlerImpl& parent,
                                                             Network::ListenerPtr&& listener,
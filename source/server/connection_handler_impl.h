@@ -19,6 +19,7 @@
 #include "common/common/linked_object.h"
 #include "common/common/non_copyable.h"
 
+#include "absl/types/optional.h"
 #include "spdlog/spdlog.h"
 
 namespace Envoy {
@@ -40,13 +41,31 @@ struct ListenerStats {
   ALL_LISTENER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT)
 };
 
+#define ALL_PER_WORKER_LISTENER_STATS(COUNTER, GAUGE)                                              \
+  COUNTER(downstream_cx_total)                                                                     \
+  GAUGE(downstream_cx_active, Accumulate)
+
+/**
+ * Wrapper struct for the listener stats of a single worker accepting on its own listen socket.
+ * @see stats_macros.h
+ */
+struct PerWorkerListenerStats {
+  ALL_PER_WORKER_LISTENER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
 /**
  * Server side connection handler. This is used both by workers as well as the
  * main thread for non-threaded listeners.
  */
 class ConnectionHandlerImpl : public Network::ConnectionHandler, NonCopyable {
 public:
-  ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher);
+  /**
+   * @param worker_index supplies the index of the worker that owns the handler, or nullopt for the
+   *        main thread. Workers accept on their own listen socket of listeners that give every
+   *        worker its own SO_REUSEPORT socket.
+   */
+  ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher,
+                        absl::optional<uint32_t> worker_index = absl::nullopt);
 
   // Network::ConnectionHandler
   uint64_t numConnections() override { return num_connections_; }
@@ -71,6 +90,17 @@ private:
 
   ActiveListenerBase* findActiveListenerByAddress(const Network::Address::Instance& address);
 
+  /**
+   * @return Network::Socket* the listen socket of this worker for the given listener, or nullptr if
+   *         the handler accepts on the socket the listener shares between workers.
+   */
+  Network::Socket* workerSocket(Network::ListenerConfig& config);
+
+  /**
+   * @return Network::Socket& the socket this handler accepts on for the given listener.
+   */
+  Network::Socket& listenSocket(Network::ListenerConfig& config);
+
   struct ActiveConnection;
   typedef std::unique_ptr<ActiveConnection> ActiveConnectionPtr;
   struct ActiveSocket;
@@ -88,6 +118,8 @@ private:
     ConnectionHandlerImpl& parent_;
     Network::ListenerPtr listener_;
     ListenerStats stats_;
+    // Only set when the worker accepts on its own listen socket.
+    std::unique_ptr<PerWorkerListenerStats> per_worker_stats_;
     const std::chrono::milliseconds listener_filters_timeout_;
     const uint64_t listener_tag_;
     Network::ListenerConfig& config_;
@@ -220,9 +252,11 @@ private:
   };
 
   static ListenerStats generateStats(Stats::Scope& scope);
+  std::unique_ptr<PerWorkerListenerStats> generatePerWorkerStats(Network::ListenerConfig& config);
 
   spdlog::logger& logger_;
   Event::Dispatcher& dispatcher_;
+  const absl::optional<uint32_t> worker_index_;
   std::list<std::pair<Network::Address::InstanceConstSharedPtr, ActiveListenerBasePtr>> listeners_;
   std::atomic<uint64_t> num_connections_{};
   bool disable_listeners_;
@@ -94,10 +94,18 @@ HotRestartingParent::Internal::getListenSocketsForChild(const HotRestartMessage:
   wrapped_reply.mutable_reply()->mutable_pass_listen_socket()->set_fd(-1);
   Network::Address::InstanceConstSharedPtr addr =
       Network::Utility::resolveUrl(request.pass_listen_socket().address());
+  const uint32_t worker_index = request.pass_listen_socket().worker_index();
   for (const auto& listener : server_->listenerManager().listeners()) {
     if (*listener.get().socket().localAddress() == *addr) {
-      wrapped_reply.mutable_reply()->mutable_pass_listen_socket()->set_fd(
-          listener.get().socket().ioHandle().fd());
+      // Listeners with a single shared socket only pass it as the socket of worker 0.
+      Network::Socket* socket = listener.get().workerSocket(worker_index);
+      if (socket == nullptr && worker_index == 0) {
+        socket = &listener.get().socket();
+      }
+      if (socket != nullptr) {
+        wrapped_reply.mutable_reply()->mutable_pass_listen_socket()->set_fd(
+            socket->ioHandle().fd());
+      }
       break;
     }
   }
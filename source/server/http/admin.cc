@@ -3,7 +3,6 @@
 #include <algorithm>
 #include <cstdint>
 #include <fstream>
-#include <regex>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -16,6 +15,7 @@
 #include "envoy/admin/v2alpha/memory.pb.h"
 #include "envoy/admin/v2alpha/mutex_stats.pb.h"
 #include "envoy/admin/v2alpha/server_info.pb.h"
+#include "envoy/admin/v2alpha/slow_callbacks.pb.h"
 #include "envoy/filesystem/filesystem.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/server/hot_restart.h"
@@ -36,6 +36,7 @@
 #include "common/common/mutex_tracer_impl.h"
 #include "common/common/utility.h"
 #include "common/common/version.h"
+#include "common/event/callback_tracker.h"
 #include "common/html/utility.h"
 #include "common/http/codes.h"
 #include "common/http/conn_manager_utility.h"
@@ -52,6 +53,8 @@
 
 #include "extensions/access_loggers/file/file_access_log_impl.h"
 
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_replace.h"
 #include "absl/strings/string_view.h"
@@ -137,7 +140,30 @@ const char AdminHtmlEnd[] = R"(
 </body>
 )";
 
-const std::regex PromRegex("[^a-zA-Z0-9_]");
+// Reports an invalid /stats query in the output format the client asked for.
+Http::Code statsBadRequest(const Http::Utility::QueryParams& params, absl::string_view message,
+                           Http::HeaderMap& response_headers, Buffer::Instance& response) {
+  const auto format = params.find("format");
+  if (format != params.end() && format->second == "json") {
+    response_headers.insertContentType().value().setReference(
+        Http::Headers::get().ContentTypeValues.Json);
+    rapidjson::Document document;
+    document.SetObject();
+    rapidjson::Value error;
+    error.SetString(message.data(), message.size(), document.GetAllocator());
+    document.AddMember("error", error, document.GetAllocator());
+    rapidjson::StringBuffer strbuf;
+    rapidjson::Writer<StringBuffer> writer(strbuf);
+    document.Accept(writer);
+    response.add(strbuf.GetString());
+  } else if (format != params.end() && format->second == "prometheus") {
+    // Lines starting with '#' are comments in the Prometheus text exposition format.
+    response.add(fmt::format("# {}\n", message));
+  } else {
+    response.add(fmt::format("{}\n", message));
+  }
+  return Http::Code::BadRequest;
+}
 
 void populateFallbackResponseHeaders(Http::Code code, Http::HeaderMap& header_map) {
   header_map.insertStatus().value(std::to_string(enumToInt(code)));
@@ -498,6 +524,34 @@ Http::Code AdminImpl::handlerContention(absl::string_view, Http::HeaderMap& resp
   return Http::Code::OK;
 }
 
+Http::Code AdminImpl::handlerSlowCallbacks(absl::string_view, Http::HeaderMap& response_headers,
+                                           Buffer::Instance& response, AdminStream&) {
+  envoy::admin::v2alpha::SlowCallbacks slow_callbacks;
+  Event::CallbackTracker::forEach([&slow_callbacks](const Event::CallbackTracker& tracker) {
+    auto& dispatcher = *slow_callbacks.add_dispatchers();
+    dispatcher.set_name(tracker.name());
+    for (const auto& callback : tracker.slowCallbacks()) {
+      auto& slow_callback = *dispatcher.add_callbacks();
+      TimestampUtil::systemClockToTimestamp(callback.start_time_,
+                                            *slow_callback.mutable_start_time());
+      *slow_callback.mutable_duration() =
+          Protobuf::util::TimeUtil::MicrosecondsToDuration(callback.duration_.count());
+      slow_callback.set_kind(callback.kind_);
+      slow_callback.set_source(Event::CallbackTracker::sourceName(*callback.source_));
+    }
+  });
+
+  if (slow_callbacks.dispatchers().empty()) {
+    response.add("Slow callbacks are not tracked. To track them, set enable_dispatcher_stats in "
+                 "the bootstrap config.");
+    return Http::Code::OK;
+  }
+  response_headers.insertContentType().value().setReference(
+      Http::Headers::get().ContentTypeValues.Json);
+  response.add(MessageUtil::getJsonStringFromMessage(slow_callbacks, true, true));
+  return Http::Code::OK;
+}
+
 Http::Code AdminImpl::handlerCpuProfiler(absl::string_view url, Http::HeaderMap&,
                                          Buffer::Instance& response, AdminStream&) {
   Http::Utility::QueryParams query_params = Http::Utility::parseQueryString(url);
@@ -696,62 +750,159 @@ Http::Code AdminImpl::handlerStats(absl::string_view url, Http::HeaderMap& respo
 
   const bool used_only = params.find("usedonly") != params.end();
   const bool has_format = !(params.find("format") == params.end());
-  const absl::optional<std::regex> regex =
-      (params.find("filter") != params.end())
-          ? absl::optional<std::regex>{std::regex(params.at("filter"))}
-          : absl::nullopt;
-
-  std::map<std::string, uint64_t> all_stats;
-  for (const Stats::CounterSharedPtr& counter : server_.stats().counters()) {
-    if (shouldShowMetric(counter, used_only, regex)) {
-      all_stats.emplace(counter->name(), counter->value());
+  std::unique_ptr<re2::RE2> regex;
+  if (params.find("filter") != params.end()) {
+    regex = std::make_unique<re2::RE2>(params.at("filter"), re2::RE2::Quiet);
+    if (!regex->ok()) {
+      return statsBadRequest(params, fmt::format("invalid filter regex: {}", regex->error()),
+                             response_headers, response);
     }
   }
-
-  for (const Stats::GaugeSharedPtr& gauge : server_.stats().gauges()) {
-    if (shouldShowMetric(gauge, used_only, regex)) {
-      ASSERT(gauge->importMode() != Stats::Gauge::ImportMode::Uninitialized);
-      all_stats.emplace(gauge->name(), gauge->value());
+  const std::string prefix =
+      params.find("prefix") != params.end() ? params.at("prefix") : EMPTY_STRING;
+  const std::string after =
+      params.find("after") != params.end() ? params.at("after") : EMPTY_STRING;
+  absl::optional<uint64_t> page_size;
+  if (params.find("page_size") != params.end()) {
+    uint64_t value;
+    if (!StringUtil::atoull(params.at("page_size").c_str(), value) || value == 0) {
+      return statsBadRequest(params, "usage: /stats?page_size=<positive integer>",
+                             response_headers, response);
     }
+    page_size = value;
+  }
+
+  if (has_format && params.at("format") == "prometheus") {
+    return handlerPrometheusStats(url, response_headers, response, admin_stream);
   }
 
+  const StatsPage page =
+      selectStats(server_.stats().counters(), server_.stats().gauges(),
+                  server_.stats().histograms(), used_only, regex.get(), prefix, page_size, after);
+
   if (has_format) {
     const std::string format_value = params.at("format");
     if (format_value == "json") {
       response_headers.insertContentType().value().setReference(
           Http::Headers::get().ContentTypeValues.Json);
-      response.add(
-          AdminImpl::statsAsJson(all_stats, server_.stats().histograms(), used_only, regex));
-    } else if (format_value == "prometheus") {
-      return handlerPrometheusStats(url, response_headers, response, admin_stream);
+      // The page has already been filtered.
+      response.add(AdminImpl::statsAsJson(page.stats_, page.histograms_, used_only));
     } else {
       response.add("usage: /stats?format=json  or /stats?format=prometheus \n");
       response.add("\n");
       rc = Http::Code::NotFound;
     }
   } else { // Display plain stats if format query param is not there.
-    for (auto stat : all_stats) {
-      response.add(fmt::format("{}: {}\n", stat.first, stat.second));
-    }
     // TODO(ramaraochavali): See the comment in ThreadLocalStoreImpl::histograms() for why we use a
     // multimap here. This makes sure that duplicate histograms get output. When shared storage is
     // implemented this can be switched back to a normal map.
     std::multimap<std::string, std::string> all_histograms;
-    for (const Stats::ParentHistogramSharedPtr& histogram : server_.stats().histograms()) {
-      if (shouldShowMetric(histogram, used_only, regex)) {
-        all_histograms.emplace(histogram->name(), histogram->quantileSummary());
-      }
+    for (const Stats::ParentHistogramSharedPtr& histogram : page.histograms_) {
+      all_histograms.emplace(histogram->name(), histogram->quantileSummary());
     }
-    for (auto histogram : all_histograms) {
-      response.add(fmt::format("{}: {}\n", histogram.first, histogram.second));
+    // Histograms follow the other stats, except in a page, which is printed in name order so that
+    // its last line names the cursor for the next page.
+    auto stat = page.stats_.begin();
+    auto histogram = all_histograms.begin();
+    while (stat != page.stats_.end() || histogram != all_histograms.end()) {
+      if (stat != page.stats_.end() &&
+          (!page_size.has_value() || histogram == all_histograms.end() ||
+           stat->first < histogram->first)) {
+        response.add(fmt::format("{}: {}\n", stat->first, stat->second));
+        ++stat;
+      } else {
+        response.add(fmt::format("{}: {}\n", histogram->first, histogram->second));
+        ++histogram;
+      }
     }
   }
   return rc;
 }
 
-Http::Code AdminImpl::handlerPrometheusStats(absl::string_view path_and_query, Http::HeaderMap&,
+AdminImpl::StatsPage AdminImpl::selectStats(
+    const std::vector<Stats::CounterSharedPtr>& counters,
+    const std::vector<Stats::GaugeSharedPtr>& gauges,
+    const std::vector<Stats::ParentHistogramSharedPtr>& histograms, bool used_only,
+    const re2::RE2* regex, absl::string_view prefix, absl::optional<uint64_t> page_size,
+    absl::string_view after) {
+  struct Candidate {
+    std::string name_;
+    uint64_t value_;
+    Stats::ParentHistogramSharedPtr histogram_;
+  };
+  struct NameLess {
+    bool operator()(const Candidate& lhs, const Candidate& rhs) const {
+      return lhs.name_ < rhs.name_;
+    }
+  };
+
+  // With a page size, keep a max-heap of the page_size smallest names seen so far. Each metric
+  // costs O(log page_size) and the page is the only thing that is ever sorted.
+  std::vector<Candidate> heap;
+  StatsPage page;
+  auto add = [&](std::string&& name, uint64_t value, Stats::ParentHistogramSharedPtr histogram) {
+    if (!after.empty() && name <= after) {
+      return;
+    }
+    if (!page_size.has_value()) {
+      if (histogram != nullptr) {
+        page.histograms_.push_back(std::move(histogram));
+      } else {
+        page.stats_.emplace(std::move(name), value);
+      }
+      return;
+    }
+    if (heap.size() == page_size.value()) {
+      if (!(name < heap.front().name_)) {
+        return;
+      }
+      std::pop_heap(heap.begin(), heap.end(), NameLess());
+      heap.pop_back();
+    }
+    heap.push_back({std::move(name), value, std::move(histogram)});
+    std::push_heap(heap.begin(), heap.end(), NameLess());
+  };
+
+  for (const Stats::CounterSharedPtr& counter : counters) {
+    if (shouldShowMetric(counter, used_only, regex, prefix)) {
+      add(counter->name(), counter->value(), nullptr);
+    }
+  }
+  for (const Stats::GaugeSharedPtr& gauge : gauges) {
+    if (shouldShowMetric(gauge, used_only, regex, prefix)) {
+      ASSERT(gauge->importMode() != Stats::Gauge::ImportMode::Uninitialized);
+      add(gauge->name(), gauge->value(), nullptr);
+    }
+  }
+  for (const Stats::ParentHistogramSharedPtr& histogram : histograms) {
+    if (shouldShowMetric(histogram, used_only, regex, prefix)) {
+      add(histogram->name(), 0, histogram);
+    }
+  }
+
+  std::sort_heap(heap.begin(), heap.end(), NameLess());
+  for (Candidate& candidate : heap) {
+    if (candidate.histogram_ != nullptr) {
+      page.histograms_.push_back(std::move(candidate.histogram_));
+    } else {
+      page.stats_.emplace(std::move(candidate.name_), candidate.value_);
+    }
+  }
+  return page;
+}
+
+Http::Code AdminImpl::handlerPrometheusStats(absl::string_view path_and_query,
+                                             Http::HeaderMap& response_headers,
                                              Buffer::Instance& response, AdminStream&) {
   const Http::Utility::QueryParams params = Http::Utility::parseQueryString(path_and_query);
+  // Prometheus scrapes the whole exposition at once, so the prefix filter and paging are not
+  // supported here.
+  if (params.find("prefix") != params.end() || params.find("page_size") != params.end() ||
+      params.find("after") != params.end()) {
+    return statsBadRequest(params,
+                           "prefix, page_size and after are not supported in prometheus format",
+                           response_headers, response);
+  }
   const bool used_only = params.find("usedonly") != params.end();
   PrometheusStatsFormatter::statsAsPrometheus(server_.stats().counters(), server_.stats().gauges(),
                                               server_.stats().histograms(), response, used_only);
@@ -761,20 +912,46 @@ Http::Code AdminImpl::handlerPrometheusStats(absl::string_view path_and_query, H
 std::string PrometheusStatsFormatter::sanitizeName(const std::string& name) {
   // The name must match the regex [a-zA-Z_][a-zA-Z0-9_]* as required by
   // prometheus. Refer to https://prometheus.io/docs/concepts/data_model/.
-  std::string stats_name = std::regex_replace(name, PromRegex, "_");
-  if (stats_name[0] >= '0' && stats_name[0] <= '9') {
-    return fmt::format("_{}", stats_name);
-  } else {
-    return stats_name;
+  std::string stats_name;
+  stats_name.reserve(name.size() + 1);
+  if (!name.empty() && absl::ascii_isdigit(name[0])) {
+    stats_name.push_back('_');
+  }
+  for (const char c : name) {
+    stats_name.push_back(absl::ascii_isalnum(c) || c == '_' ? c : '_');
   }
+  return stats_name;
 }
 
 std::string PrometheusStatsFormatter::formattedTags(const std::vector<Stats::Tag>& tags) {
-  std::vector<std::string> buf;
+  SanitizedNameCache tag_names;
+  return formattedTags(tags, tag_names);
+}
+
+std::string PrometheusStatsFormatter::formattedTags(const std::vector<Stats::Tag>& tags,
+                                                    SanitizedNameCache& tag_names) {
+  std::string formatted;
   for (const Stats::Tag& tag : tags) {
-    buf.push_back(fmt::format("{}=\"{}\"", sanitizeName(tag.name_), tag.value_));
+    auto it = tag_names.find(tag.name_);
+    if (it == tag_names.end()) {
+      it = tag_names.emplace(tag.name_, sanitizeName(tag.name_)).first;
+    }
+    if (!formatted.empty()) {
+      formatted.push_back(',');
+    }
+    absl::StrAppend(&formatted, it->second, "=\"", tag.value_, "\"");
+  }
+  return formatted;
+}
+
+const std::string&
+PrometheusStatsFormatter::cachedMetricName(const std::string& extracted_name,
+                                           SanitizedNameCache& metric_names) {
+  auto it = metric_names.find(extracted_name);
+  if (it == metric_names.end()) {
+    it = metric_names.emplace(extracted_name, metricName(extracted_name)).first;
   }
-  return StringUtil::join(buf, ",");
+  return it->second;
 }
 
 std::string PrometheusStatsFormatter::metricName(const std::string& extractedName) {
@@ -790,13 +967,15 @@ uint64_t PrometheusStatsFormatter::statsAsPrometheus(
     const std::vector<Stats::ParentHistogramSharedPtr>& histograms, Buffer::Instance& response,
     const bool used_only) {
   std::unordered_set<std::string> metric_type_tracker;
+  SanitizedNameCache metric_names;
+  SanitizedNameCache tag_names;
   for (const auto& counter : counters) {
     if (!shouldShowMetric(counter, used_only)) {
       continue;
     }
 
-    const std::string tags = formattedTags(counter->tags());
-    const std::string metric_name = metricName(counter->tagExtractedName());
+    const std::string tags = formattedTags(counter->tags(), tag_names);
+    const std::string& metric_name = cachedMetricName(counter->tagExtractedName(), metric_names);
     if (metric_type_tracker.find(metric_name) == metric_type_tracker.end()) {
       metric_type_tracker.insert(metric_name);
       response.add(fmt::format("# TYPE {0} counter\n", metric_name));
@@ -809,8 +988,8 @@ uint64_t PrometheusStatsFormatter::statsAsPrometheus(
       continue;
     }
 
-    const std::string tags = formattedTags(gauge->tags());
-    const std::string metric_name = metricName(gauge->tagExtractedName());
+    const std::string tags = formattedTags(gauge->tags(), tag_names);
+    const std::string& metric_name = cachedMetricName(gauge->tagExtractedName(), metric_names);
     if (metric_type_tracker.find(metric_name) == metric_type_tracker.end()) {
       metric_type_tracker.insert(metric_name);
       response.add(fmt::format("# TYPE {0} gauge\n", metric_name));
@@ -823,10 +1002,10 @@ uint64_t PrometheusStatsFormatter::statsAsPrometheus(
       continue;
     }
 
-    const std::string tags = formattedTags(histogram->tags());
+    const std::string tags = formattedTags(histogram->tags(), tag_names);
     const std::string hist_tags = histogram->tags().empty() ? EMPTY_STRING : (tags + ",");
 
-    const std::string metric_name = metricName(histogram->tagExtractedName());
+    const std::string& metric_name = cachedMetricName(histogram->tagExtractedName(), metric_names);
     if (metric_type_tracker.find(metric_name) == metric_type_tracker.end()) {
       metric_type_tracker.insert(metric_name);
       response.add(fmt::format("# TYPE {0} histogram\n", metric_name));
@@ -859,7 +1038,7 @@ uint64_t PrometheusStatsFormatter::statsAsPrometheus(
 std::string
 AdminImpl::statsAsJson(const std::map<std::string, uint64_t>& all_stats,
                        const std::vector<Stats::ParentHistogramSharedPtr>& all_histograms,
-                       const bool used_only, const absl::optional<std::regex> regex,
+                       const bool used_only, const re2::RE2* regex,
                        const bool pretty_print) {
   rapidjson::Document document;
   document.SetObject();
@@ -1197,6 +1376,8 @@ AdminImpl::AdminImpl(const std::string& profile_path, Server::Instance& server)
            MAKE_ADMIN_HANDLER(handlerServerInfo), false, false},
           {"/ready", "print server state, return 200 if LIVE, otherwise return 503",
            MAKE_ADMIN_HANDLER(handlerReady), false, false},
+          {"/slow_callbacks", "print the recent slow event loop callbacks of each dispatcher",
+           MAKE_ADMIN_HANDLER(handlerSlowCallbacks), false, false},
           {"/stats", "print server stats", MAKE_ADMIN_HANDLER(handlerStats), false, false},
           {"/stats/prometheus", "print server stats in prometheus format",
            MAKE_ADMIN_HANDLER(handlerPrometheusStats), false, false},
@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include <list>
+#include <map>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -31,7 +32,10 @@
 
 #include "server/http/config_tracker_impl.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/match.h"
 #include "absl/strings/string_view.h"
+#include "re2/re2.h"
 
 namespace Envoy {
 namespace Server {
@@ -184,15 +188,44 @@ private:
   void writeClustersAsJson(Buffer::Instance& response);
   void writeClustersAsText(Buffer::Instance& response);
 
+  /**
+   * Metrics selected for a /stats response. Counter and gauge values are captured at selection
+   * time; histograms are rendered from the histogram itself.
+   */
+  struct StatsPage {
+    std::map<std::string, uint64_t> stats_;
+    std::vector<Stats::ParentHistogramSharedPtr> histograms_;
+  };
+
   static bool shouldShowMetric(const std::shared_ptr<Stats::Metric>& metric, const bool used_only,
-                               const absl::optional<std::regex>& regex) {
-    return ((!used_only || metric->used()) &&
-            (!regex.has_value() || std::regex_search(metric->name(), regex.value())));
+                               const re2::RE2* regex, absl::string_view prefix = "") {
+    if (used_only && !metric->used()) {
+      return false;
+    }
+    if (regex == nullptr && prefix.empty()) {
+      return true;
+    }
+    const std::string name = metric->name();
+    return absl::StartsWith(name, prefix) &&
+           (regex == nullptr || re2::RE2::PartialMatch(name, *regex));
   }
+  /**
+   * Select the counters, gauges and histograms to show for a /stats request.
+   * @param used_only supplies whether to skip metrics that were never updated.
+   * @param regex supplies an optional filter, which must match part of the metric name.
+   * @param prefix supplies a prefix that selected metric names must start with.
+   * @param page_size if set, supplies the maximum number of metrics to select. Only the page_size
+   *        smallest names are retained while iterating, so a page does not sort the entire store.
+   * @param after supplies a cursor. Only metrics whose names sort after it are selected.
+   */
+  static StatsPage selectStats(const std::vector<Stats::CounterSharedPtr>& counters,
+                               const std::vector<Stats::GaugeSharedPtr>& gauges,
+                               const std::vector<Stats::ParentHistogramSharedPtr>& histograms,
+                               bool used_only, const re2::RE2* regex, absl::string_view prefix,
+                               absl::optional<uint64_t> page_size, absl::string_view after);
   static std::string statsAsJson(const std::map<std::string, uint64_t>& all_stats,
                                  const std::vector<Stats::ParentHistogramSharedPtr>& all_histograms,
-                                 bool used_only,
-                                 const absl::optional<std::regex> regex = absl::nullopt,
+                                 bool used_only, const re2::RE2* regex = nullptr,
                                  bool pretty_print = false);
   static std::string
   runtimeAsJson(const std::vector<std::pair<std::string, Runtime::Snapshot::Entry>>& entries);
@@ -245,6 +278,9 @@ private:
                                   AdminStream&);
   Http::Code handlerServerInfo(absl::string_view path_and_query, Http::HeaderMap& response_headers,
                                Buffer::Instance& response, AdminStream&);
+  Http::Code handlerSlowCallbacks(absl::string_view path_and_query,
+                                  Http::HeaderMap& response_headers, Buffer::Instance& response,
+                                  AdminStream&);
   Http::Code handlerReady(absl::string_view path_and_query, Http::HeaderMap& response_headers,
                           Buffer::Instance& response, AdminStream&);
   Http::Code handlerStats(absl::string_view path_and_query, Http::HeaderMap& response_headers,
@@ -270,6 +306,7 @@ private:
     Network::FilterChainFactory& filterChainFactory() override { return parent_; }
     Network::Socket& socket() override { return parent_.mutable_socket(); }
     const Network::Socket& socket() const override { return parent_.mutable_socket(); }
+    Network::Socket* workerSocket(uint32_t) override { return nullptr; }
     bool bindToPort() override { return true; }
     bool handOffRestoredDestinationConnections() const override { return false; }
     uint32_t perConnectionBufferLimitBytes() const override { return 0; }
@@ -398,11 +435,20 @@ public:
   static std::string metricName(const std::string& extractedName);
 
 private:
+  // Maps a raw metric or tag name to its sanitized form. Many stats share a tag extracted name
+  // (e.g. one per cluster), so each distinct name is only sanitized once per scrape.
+  using SanitizedNameCache = absl::flat_hash_map<std::string, std::string>;
+
   /**
    * Take a string and sanitize it according to Prometheus conventions.
    */
   static std::string sanitizeName(const std::string& name);
 
+  static std::string formattedTags(const std::vector<Stats::Tag>& tags,
+                                   SanitizedNameCache& tag_names);
+  static const std::string& cachedMetricName(const std::string& extracted_name,
+                                             SanitizedNameCache& metric_names);
+
   /*
    * Determine whether a metric has never been emitted and choose to
    * not show it if we only wanted used metrics.
@@ -134,7 +134,7 @@ Network::SocketSharedPtr ProdListenerComponentFactory::createListenSocket(
   ASSERT(socket_type == Network::Address::SocketType::Stream ||
          socket_type == Network::Address::SocketType::Datagram);
 
-  // For each listener config we share a single socket among all threaded listeners.
+  // Unless the listener uses reuse_port, we share a single socket among all threaded listeners.
   // First we try to get the socket from our parent if applicable.
   if (address->type() == Network::Address::Type::Pipe) {
     if (socket_type != Network::Address::SocketType::Stream) {
@@ -145,7 +145,7 @@ Network::SocketSharedPtr ProdListenerComponentFactory::createListenSocket(
           fmt::format("socket type {} not supported for pipes", toString(socket_type)));
     }
     const std::string addr = fmt::format("unix://{}", address->asString());
-    const int fd = server_.hotRestart().duplicateParentListenSocket(addr);
+    const int fd = server_.hotRestart().duplicateParentListenSocket(addr, 0);
     Network::IoHandlePtr io_handle = std::make_unique<Network::IoSocketHandleImpl>(fd);
     if (io_handle->isOpen()) {
       ENVOY_LOG(debug, "obtained socket for address {} from parent", addr);
@@ -154,11 +154,27 @@ Network::SocketSharedPtr ProdListenerComponentFactory::createListenSocket(
     return std::make_shared<Network::UdsListenSocket>(address);
   }
 
+  return createIpListenSocket(address, socket_type, options, bind_to_port, 0);
+}
+
+Network::SocketSharedPtr ProdListenerComponentFactory::createWorkerListenSocket(
+    Network::Address::InstanceConstSharedPtr address, Network::Address::SocketType socket_type,
+    const Network::Socket::OptionsSharedPtr& options, uint32_t worker_index) {
+  ASSERT(address->type() == Network::Address::Type::Ip);
+  ASSERT(worker_index > 0);
+  // Each worker's socket is passed on separately during hot restart so that the reuse port group,
+  // and the connections queued on its sockets, survive the restart.
+  return createIpListenSocket(address, socket_type, options, true, worker_index);
+}
+
+Network::SocketSharedPtr ProdListenerComponentFactory::createIpListenSocket(
+    Network::Address::InstanceConstSharedPtr address, Network::Address::SocketType socket_type,
+    const Network::Socket::OptionsSharedPtr& options, bool bind_to_port, uint32_t worker_index) {
   const std::string scheme = (socket_type == Network::Address::SocketType::Stream)
                                  ? Network::Utility::TCP_SCHEME
                                  : Network::Utility::UDP_SCHEME;
   const std::string addr = absl::StrCat(scheme, address->asString());
-  const int fd = server_.hotRestart().duplicateParentListenSocket(addr);
+  const int fd = server_.hotRestart().duplicateParentListenSocket(addr, worker_index);
   if (fd != -1) {
     ENVOY_LOG(debug, "obtained socket for address {} from parent", addr);
     Network::IoHandlePtr io_handle = std::make_unique<Network::IoSocketHandleImpl>(fd);
@@ -189,6 +205,7 @@ ListenerImpl::ListenerImpl(const envoy::api::v2::Listener& config, const std::st
       listener_scope_(
           parent_.server_.stats().createScope(fmt::format("listener.{}.", address_->asString()))),
       bind_to_port_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.deprecated_v1(), bind_to_port, true)),
+      reuse_port_(config.reuse_port() && bind_to_port_),
       hand_off_restored_destination_connections_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, use_original_dst, false)),
       per_connection_buffer_limit_bytes_(
@@ -212,6 +229,18 @@ ListenerImpl::ListenerImpl(const envoy::api::v2::Listener& config, const std::st
     addListenSocketOptions(
         Network::SocketOptionFactory::buildLiteralOptions(config.socket_options()));
   }
+  if (reuse_port_) {
+    if (address_->type() != Network::Address::Type::Ip) {
+      throw EnvoyException(fmt::format(
+          "error adding listener '{}': reuse_port is only supported for IP addresses",
+          address_->asString()));
+    }
+    addListenSocketOptions(Network::SocketOptionFactory::buildReusePortOptions());
+    if (config.reuse_port_cpu_steering()) {
+      addListenSocketOptions(Network::SocketOptionFactory::buildReusePortCpuSteeringOptions(
+          std::max<uint32_t>(parent_.numWorkers(), 1)));
+    }
+  }
 
   if (!config.listener_filters().empty()) {
     switch (socket_type_) {
@@ -852,13 +881,17 @@ Init::Manager& ListenerImpl::initManager() {
   }
 }
 
-void ListenerImpl::setSocket(const Network::SocketSharedPtr& socket) {
-  ASSERT(!socket_);
-  socket_ = socket;
-  // Server config validation sets nullptr sockets.
-  if (socket_ && listen_socket_options_) {
+void ListenerImpl::setSockets(const std::vector<Network::SocketSharedPtr>& sockets) {
+  ASSERT(sockets_.empty());
+  ASSERT(!sockets.empty());
+  sockets_ = sockets;
+  for (const Network::SocketSharedPtr& socket : sockets_) {
+    // Server config validation sets nullptr sockets.
+    if (!socket || !listen_socket_options_) {
+      continue;
+    }
     // 'pre_bind = false' as bind() is never done after this.
-    bool ok = Network::Socket::applyOptions(listen_socket_options_, *socket_,
+    bool ok = Network::Socket::applyOptions(listen_socket_options_, *socket,
                                             envoy::api::v2::core::SocketOption::STATE_BOUND);
     const std::string message =
         fmt::format("{}: Setting socket options {}", name_, ok ? "succeeded" : "failed");
@@ -869,9 +902,9 @@ void ListenerImpl::setSocket(const Network::SocketSharedPtr& socket) {
       ENVOY_LOG(debug, "{}", message);
     }
 
-    // Add the options to the socket_ so that STATE_LISTENING options can be
+    // Add the options to the socket so that STATE_LISTENING options can be
     // set in the worker after listen()/evconnlistener_new() is called.
-    socket_->addOptions(listen_socket_options_);
+    socket->addOptions(listen_socket_options_);
   }
 }
 
@@ -885,7 +918,7 @@ ListenerManagerImpl::ListenerManagerImpl(Instance& server,
           "listeners", [this] { return dumpListenerConfigs(); })),
       enable_dispatcher_stats_(enable_dispatcher_stats) {
   for (uint32_t i = 0; i < server.options().concurrency(); i++) {
-    workers_.emplace_back(worker_factory.createWorker(server.overloadManager()));
+    workers_.emplace_back(worker_factory.createWorker(i, server.overloadManager()));
   }
 }
 
@@ -973,17 +1006,29 @@ bool ListenerManagerImpl::addOrUpdateListener(const envoy::api::v2::Listener& co
     throw EnvoyException(message);
   }
 
+  // Listeners with the same name share their sockets, and the kernel only lets sockets that all
+  // set SO_REUSEPORT share an address, so reuse_port can't be changed by an update.
+  if ((existing_warming_listener != warming_listeners_.end() &&
+       (*existing_warming_listener)->reusePort() != new_listener->reusePort()) ||
+      (existing_active_listener != active_listeners_.end() &&
+       (*existing_active_listener)->reusePort() != new_listener->reusePort())) {
+    const std::string message =
+        fmt::format("error updating listener: '{}' can not change reuse_port", name);
+    ENVOY_LOG(warn, "{}", message);
+    throw EnvoyException(message);
+  }
+
   bool added = false;
   if (existing_warming_listener != warming_listeners_.end()) {
     // In this case we can just replace inline.
     ASSERT(workers_started_);
     new_listener->debugLog("update warming listener");
-    new_listener->setSocket((*existing_warming_listener)->getSocket());
+    new_listener->setSockets((*existing_warming_listener)->getSockets());
     *existing_warming_listener = std::move(new_listener);
   } else if (existing_active_listener != active_listeners_.end()) {
     // In this case we have no warming listener, so what we do depends on whether workers
     // have been started or not. Either way we get the socket from the existing listener.
-    new_listener->setSocket((*existing_active_listener)->getSocket());
+    new_listener->setSockets((*existing_active_listener)->getSockets());
     if (workers_started_) {
       new_listener->debugLog("add warming listener");
       warming_listeners_.emplace_back(std::move(new_listener));
@@ -1012,22 +1057,15 @@ bool ListenerManagerImpl::addOrUpdateListener(const envoy::api::v2::Listener& co
     // to see if there is a listener that has a socket bound to the address we are configured for.
     // This is an edge case, but may happen if a listener is removed and then added back with a same
     // or different name and intended to listen on the same address. This should work and not fail.
-    Network::SocketSharedPtr draining_listener_socket;
     auto existing_draining_listener = std::find_if(
         draining_listeners_.cbegin(), draining_listeners_.cend(),
         [&new_listener](const DrainingListener& listener) {
-          return *new_listener->address() == *listener.listener_->socket().localAddress();
+          return *new_listener->address() == *listener.listener_->socket().localAddress() &&
+                 new_listener->reusePort() == listener.listener_->reusePort();
         });
-    if (existing_draining_listener != draining_listeners_.cend()) {
-      draining_listener_socket = existing_draining_listener->listener_->getSocket();
-    }
-
-    new_listener->setSocket(draining_listener_socket
-                                ? draining_listener_socket
-                                : factory_.createListenSocket(new_listener->address(),
-                                                              new_listener->socketType(),
-                                                              new_listener->listenSocketOptions(),
-                                                              new_listener->bindToPort()));
+    new_listener->setSockets(existing_draining_listener != draining_listeners_.cend()
+                                 ? existing_draining_listener->listener_->getSockets()
+                                 : createListenSockets(*new_listener));
     if (workers_started_) {
       new_listener->debugLog("add warming listener");
       warming_listeners_.emplace_back(std::move(new_listener));
@@ -1050,6 +1088,25 @@ bool ListenerManagerImpl::addOrUpdateListener(const envoy::api::v2::Listener& co
   return true;
 }
 
+std::vector<Network::SocketSharedPtr>
+ListenerManagerImpl::createListenSockets(ListenerImpl& listener) {
+  std::vector<Network::SocketSharedPtr> sockets;
+  sockets.push_back(factory_.createListenSocket(listener.address(), listener.socketType(),
+                                                listener.listenSocketOptions(),
+                                                listener.bindToPort()));
+  if (listener.reusePort()) {
+    // Bind the other workers' sockets to the address the first socket is bound to, which differs
+    // from the configured one when binding to port 0.
+    const Network::Address::InstanceConstSharedPtr address =
+        sockets[0] != nullptr ? sockets[0]->localAddress() : listener.address();
+    for (uint32_t i = 1; i < numWorkers(); i++) {
+      sockets.push_back(factory_.createWorkerListenSocket(address, listener.socketType(),
+                                                          listener.listenSocketOptions(), i));
+    }
+  }
+  return sockets;
+}
+
 bool ListenerManagerImpl::hasListenerWithAddress(const ListenerList& list,
                                                  const Network::Address::Instance& address) {
   for (const auto& listener : list) {
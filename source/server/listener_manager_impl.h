@@ -77,10 +77,20 @@ public:
                                               Network::Address::SocketType socket_type,
                                               const Network::Socket::OptionsSharedPtr& options,
                                               bool bind_to_port) override;
+  Network::SocketSharedPtr
+  createWorkerListenSocket(Network::Address::InstanceConstSharedPtr address,
+                           Network::Address::SocketType socket_type,
+                           const Network::Socket::OptionsSharedPtr& options,
+                           uint32_t worker_index) override;
   DrainManagerPtr createDrainManager(envoy::api::v2::Listener::DrainType drain_type) override;
   uint64_t nextListenerTag() override { return next_listener_tag_++; }
 
 private:
+  Network::SocketSharedPtr createIpListenSocket(Network::Address::InstanceConstSharedPtr address,
+                                                Network::Address::SocketType socket_type,
+                                                const Network::Socket::OptionsSharedPtr& options,
+                                                bool bind_to_port, uint32_t worker_index);
+
   Instance& server_;
   uint64_t next_listener_tag_{1};
 };
@@ -132,6 +142,7 @@ public:
   void stopListeners() override;
   void stopWorkers() override;
   Http::Context& httpContext() { return server_.httpContext(); }
+  uint32_t numWorkers() const { return workers_.size(); }
 
   Instance& server_;
   ListenerComponentFactory& factory_;
@@ -165,6 +176,7 @@ private:
    * @param listener supplies the listener to drain.
    */
   void drainListener(ListenerImplPtr&& listener);
+  std::vector<Network::SocketSharedPtr> createListenSockets(ListenerImpl& listener);
 
   /**
    * Get a listener by name. This routine is used because listeners have inherent order in static
@@ -242,11 +254,16 @@ public:
   Network::Address::InstanceConstSharedPtr address() const { return address_; }
   Network::Address::SocketType socketType() const { return socket_type_; }
   const envoy::api::v2::Listener& config() { return config_; }
-  const Network::SocketSharedPtr& getSocket() const { return socket_; }
+  const std::vector<Network::SocketSharedPtr>& getSockets() const { return sockets_; }
+  bool reusePort() const { return reuse_port_; }
   void debugLog(const std::string& message);
   void initialize();
   DrainManager& localDrainManager() const { return *local_drain_manager_; }
-  void setSocket(const Network::SocketSharedPtr& socket);
+  /**
+   * Set the listen sockets. All workers accept on the first socket unless the listener uses
+   * reuse_port, in which case worker i accepts on sockets[i].
+   */
+  void setSockets(const std::vector<Network::SocketSharedPtr>& sockets);
   void setSocketAndOptions(const Network::SocketSharedPtr& socket);
   const Network::Socket::OptionsSharedPtr& listenSocketOptions() { return listen_socket_options_; }
   const std::string& versionInfo() { return version_info_; }
@@ -254,8 +271,11 @@ public:
   // Network::ListenerConfig
   Network::FilterChainManager& filterChainManager() override { return *this; }
   Network::FilterChainFactory& filterChainFactory() override { return *this; }
-  Network::Socket& socket() override { return *socket_; }
-  const Network::Socket& socket() const override { return *socket_; }
+  Network::Socket& socket() override { return *sockets_[0]; }
+  const Network::Socket& socket() const override { return *sockets_[0]; }
+  Network::Socket* workerSocket(uint32_t worker_index) override {
+    return reuse_port_ && worker_index < sockets_.size() ? sockets_[worker_index].get() : nullptr;
+  }
   bool bindToPort() override { return bind_to_port_; }
   bool handOffRestoredDestinationConnections() const override {
     return hand_off_restored_destination_connections_;
@@ -437,10 +457,12 @@ private:
   ListenerManagerImpl& parent_;
   Network::Address::InstanceConstSharedPtr address_;
   Network::Address::SocketType socket_type_;
-  Network::SocketSharedPtr socket_;
+  std::vector<Network::SocketSharedPtr> sockets_;
   Stats::ScopePtr global_scope_;   // Stats with global named scope, but needed for LDS cleanup.
   Stats::ScopePtr listener_scope_; // Stats with listener named scope.
   const bool bind_to_port_;
+  // Whether every worker accepts on its own SO_REUSEPORT socket.
+  const bool reuse_port_;
   const bool hand_off_restored_destination_connections_;
   const uint32_t per_connection_buffer_limit_bytes_;
   const uint64_t listener_tag_;
@@ -101,6 +101,12 @@ OptionsImpl::OptionsImpl(int argc, const char* const* argv,
       "", "enable-mutex-tracing", "Enable mutex contention tracing functionality", cmd, false);
   TCLAP::SwitchArg cpuset_threads(
       "", "cpuset-threads", "Get the default # of worker threads from cpuset size", cmd, false);
+  TCLAP::SwitchArg enable_io_uring("", "enable-io-uring",
+                                   "Use io_uring for the I/O of accepted connections", cmd, false);
+  TCLAP::ValueArg<uint32_t> timer_wheel_resolution_msec(
+      "", "timer-wheel-resolution-msec",
+      "Keep worker timers in a timing wheel with this resolution in msec, 0 to disable", false, 0,
+      "uint32_t", cmd);
 
   TCLAP::ValueArg<bool> use_libevent_buffer("", "use-libevent-buffers",
                                             "Use the original libevent buffer implementation",
@@ -130,6 +136,8 @@ OptionsImpl::OptionsImpl(int argc, const char* const* argv,
 
   libevent_buffer_enabled_ = use_libevent_buffer.getValue();
   cpuset_threads_ = cpuset_threads.getValue();
+  io_uring_enabled_ = enable_io_uring.getValue();
+  timer_wheel_resolution_ = std::chrono::milliseconds(timer_wheel_resolution_msec.getValue());
 
   log_level_ = default_log_level;
   for (size_t i = 0; i < ARRAY_SIZE(spdlog::level::level_string_views); i++) {
@@ -286,6 +294,7 @@ OptionsImpl::OptionsImpl(const std::string& service_cluster, const std::string&
       service_cluster_(service_cluster), service_node_(service_node), service_zone_(service_zone),
       file_flush_interval_msec_(10000), drain_time_(600), parent_shutdown_time_(900),
       mode_(Server::Mode::Serve), hot_restart_disabled_(false), signal_handling_enabled_(true),
-      mutex_tracing_enabled_(false), cpuset_threads_(false), libevent_buffer_enabled_(false) {}
+      mutex_tracing_enabled_(false), cpuset_threads_(false), libevent_buffer_enabled_(false),
+      io_uring_enabled_(false), timer_wheel_resolution_(0) {}
 
 } // namespace Envoy
@@ -106,6 +106,10 @@ public:
   virtual Server::CommandLineOptionsPtr toCommandLineOptions() const override;
   void parseComponentLogLevels(const std::string& component_log_levels);
   bool cpusetThreadsEnabled() const override { return cpuset_threads_; }
+  bool ioUringEnabled() const override { return io_uring_enabled_; }
+  std::chrono::milliseconds timerWheelResolution() const override {
+    return timer_wheel_resolution_;
+  }
   uint32_t count() const;
 
 private:
@@ -136,6 +140,8 @@ private:
   bool mutex_tracing_enabled_;
   bool cpuset_threads_;
   bool libevent_buffer_enabled_;
+  bool io_uring_enabled_;
+  std::chrono::milliseconds timer_wheel_resolution_;
   uint32_t count_;
 };
 
@@ -27,6 +27,8 @@
 #include "common/common/version.h"
 #include "common/config/resources.h"
 #include "common/config/utility.h"
+#include "common/event/dispatcher_impl.h"
+#include "common/event/real_time_system.h"
 #include "common/http/codes.h"
 #include "common/local_info/local_info_impl.h"
 #include "common/memory/stats.h"
@@ -58,7 +60,8 @@ InstanceImpl::InstanceImpl(const Options& options, Event::TimeSystem& time_syste
     : secret_manager_(std::make_unique<Secret::SecretManagerImpl>()), shutdown_(false),
       options_(options), time_source_(time_system), restarter_(restarter),
       start_time_(time(nullptr)), original_start_time_(start_time_), stats_store_(store),
-      thread_local_(tls), api_(new Api::Impl(thread_factory, store, time_system, file_system)),
+      thread_local_(tls), api_(new Api::Impl(thread_factory, store, time_system, file_system,
+                                             options.ioUringEnabled())),
       dispatcher_(api_->allocateDispatcher()),
       singleton_manager_(new Singleton::ManagerImpl(api_->threadFactory().currentThreadId())),
       handler_(new ConnectionHandlerImpl(ENVOY_LOGGER(), *dispatcher_)),
@@ -251,6 +254,18 @@ void InstanceImpl::initialize(const Options& options,
   ENVOY_LOG(info, "buffer implementation: {}",
             Buffer::OwnedImpl().usesOldImpl() ? "old (libevent)" : "new");
 
+  // The I/O path of accepted connections is selected when the Api allocates dispatchers, which
+  // fall back to libevent readiness if io_uring can not be set up.
+  ENVOY_LOG(info, "connection I/O: {}", options.ioUringEnabled() ? "io_uring" : "libevent");
+
+  // Workers are created after this, so their dispatchers pick up the timing wheel. The main
+  // thread, which has few timers, keeps the libevent timer heap.
+  Event::RealTimeSystem::useTimerWheel(options.timerWheelResolution());
+  if (options.timerWheelResolution().count() > 0) {
+    ENVOY_LOG(info, "worker timers: timing wheel with {}ms resolution",
+              options.timerWheelResolution().count());
+  }
+
   // Handle configuration that needs to take place prior to the main configuration load.
   InstanceUtil::loadBootstrapConfig(bootstrap_, options, messageValidationVisitor(), *api_);
   bootstrap_config_update_time_ = time_source_.systemTime();
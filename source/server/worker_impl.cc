@@ -13,12 +13,12 @@
 namespace Envoy {
 namespace Server {
 
-WorkerPtr ProdWorkerFactory::createWorker(OverloadManager& overload_manager) {
+WorkerPtr ProdWorkerFactory::createWorker(uint32_t index, OverloadManager& overload_manager) {
   Event::DispatcherPtr dispatcher(api_.allocateDispatcher());
-  return WorkerPtr{new WorkerImpl(
-      tls_, hooks_, std::move(dispatcher),
-      Network::ConnectionHandlerPtr{new ConnectionHandlerImpl(ENVOY_LOGGER(), *dispatcher)},
-      overload_manager, api_)};
+  Network::ConnectionHandlerPtr handler{
+      new ConnectionHandlerImpl(ENVOY_LOGGER(), *dispatcher, index)};
+  return WorkerPtr{new WorkerImpl(tls_, hooks_, std::move(dispatcher), std::move(handler),
+                                  overload_manager, api_)};
 }
 
 WorkerImpl::WorkerImpl(ThreadLocal::Instance& tls, ListenerHooks& hooks,
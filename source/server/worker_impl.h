@@ -23,7 +23,7 @@ public:
       : tls_(tls), api_(api), hooks_(hooks) {}
 
   // Server::WorkerFactory
-  WorkerPtr createWorker(OverloadManager& overload_manager) override;
+  WorkerPtr createWorker(uint32_t index, OverloadManager& overload_manager) override;
 
 private:
   ThreadLocal::Instance& tls_;
@@ -520,6 +520,36 @@ TEST_P(OwnedImplTest, ReserveZeroCommit) {
   EXPECT_EQ("bbbbb", buf.toString().substr(0, 5));
 }
 
+// The content of a shared slice stays in place after being drained, while the buffer keeps
+// appending to the slice but no longer writes in front of its content.
+TEST_P(OwnedImplTest, ShareSlice) {
+  Buffer::OwnedImpl buffer;
+  verifyImplementation(buffer);
+  buffer.add("hello world");
+  Buffer::RawSlice slice;
+  ASSERT_EQ(1, buffer.getRawSlices(&slice, 1));
+  const char* content = static_cast<const char*>(slice.mem_);
+
+  std::shared_ptr<const Slice> shared = buffer.shareSlice(content + 6);
+  if (GetParam() == BufferImplementation::Old) {
+    EXPECT_EQ(nullptr, shared);
+    return;
+  }
+  ASSERT_NE(nullptr, shared);
+  EXPECT_EQ(shared, buffer.shareSlice(content));
+  EXPECT_EQ("hello world", absl::string_view(reinterpret_cast<const char*>(shared->data()),
+                                             shared->dataSize()));
+
+  buffer.drain(6);
+  buffer.prepend("goodbye ");
+  buffer.add("!");
+  EXPECT_EQ("goodbye world!", buffer.toString());
+  buffer.drain(buffer.length());
+  buffer.add("again");
+  EXPECT_EQ("again", buffer.toString());
+  EXPECT_EQ("hello world", absl::string_view(content, 11));
+}
+
 TEST(OverflowDetectingUInt64, Arithmetic) {
   Logger::StderrSinkDelegate stderr_sink(Logger::Registry::getSink()); // For coverage build.
   OverflowDetectingUInt64 length;
@@ -0,0 +1,62 @@
+// Drives RawBufferSocket reads through a socketpair to compare syscalls per byte for different
+// message sizes, with read sizes adapting to the traffic as they do on a live connection.
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
+#include "common/network/io_socket_handle_impl.h"
+#include "common/network/raw_buffer_socket.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/mocks/network/mocks.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+
+static void RawBufferSocketRead(benchmark::State& state) {
+  int fds[2];
+  RELEASE_ASSERT(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0, "");
+  RELEASE_ASSERT(::fcntl(fds[0], F_SETFL, O_NONBLOCK) == 0, "");
+  Network::IoSocketHandleImpl io_handle(fds[0]);
+  testing::NiceMock<Network::MockTransportSocketCallbacks> callbacks;
+  ON_CALL(callbacks, ioHandle()).WillByDefault(testing::ReturnRef(io_handle));
+
+  Stats::IsolatedStoreImpl store;
+  Network::RawBufferSocketFactory factory(store);
+  Network::TransportSocketPtr socket = factory.createTransportSocket(nullptr);
+  socket->setTransportSocketCallbacks(callbacks);
+
+  // Stay below the default socketpair buffer size so that the blocking write never waits for
+  // the reader.
+  const std::string data(state.range(0), 'a');
+  Buffer::OwnedImpl buffer;
+  for (auto _ : state) {
+    const ssize_t rc = ::write(fds[1], data.data(), data.size());
+    RELEASE_ASSERT(rc == static_cast<ssize_t>(data.size()), "");
+    socket->doRead(buffer);
+    buffer.drain(buffer.length());
+  }
+  ::close(fds[1]);
+
+  const double bytes = store.counter("raw_buffer.read_bytes").value();
+  const double syscalls = store.counter("raw_buffer.read_syscalls").value();
+  state.counters["syscalls_per_mb"] = bytes > 0 ? syscalls * 1024 * 1024 / bytes : 0;
+  state.SetBytesProcessed(bytes);
+}
+BENCHMARK(RawBufferSocketRead)->Arg(128)->Arg(4096)->Arg(16384)->Arg(65536);
+
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,84 @@
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <string>
+
+#include "common/common/arena.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+struct Tracked {
+  Tracked(int& destroyed, std::string value) : destroyed_(destroyed), value_(std::move(value)) {}
+  ~Tracked() { destroyed_++; }
+
+  int& destroyed_;
+  std::string value_;
+};
+
+TEST(ArenaTest, AllocationsAreAligned) {
+  Arena arena;
+  for (size_t alignment : {1, 2, 4, 8, 16, 64}) {
+    arena.allocate(1, 1);
+    void* memory = arena.allocate(3, alignment);
+    EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(memory) % alignment);
+  }
+}
+
+TEST(ArenaTest, GrowsIntoHeapBlocks) {
+  Arena arena;
+  EXPECT_EQ(0U, arena.heapBlocks());
+  arena.allocate(16, 8);
+  EXPECT_EQ(1U, arena.heapBlocks());
+
+  // An allocation larger than the next block size gets a block of its own.
+  char* large = static_cast<char*>(arena.allocate(64 * 1024, 8));
+  memset(large, 'a', 64 * 1024);
+  EXPECT_EQ(2U, arena.heapBlocks());
+  EXPECT_EQ(16U + 64 * 1024, arena.bytesAllocated());
+}
+
+TEST(ArenaTest, InlineArenaUsesInlineBlockFirst) {
+  InlineArena<256> arena;
+  for (int i = 0; i < 16; i++) {
+    arena.allocate(16, 8);
+  }
+  EXPECT_EQ(0U, arena.heapBlocks());
+  arena.allocate(16, 8);
+  EXPECT_EQ(1U, arena.heapBlocks());
+}
+
+TEST(ArenaTest, CreateRunsDestructor) {
+  int destroyed = 0;
+  {
+    Arena arena;
+    ArenaPtr<Tracked> object = arena.create<Tracked>(destroyed, std::string(100, 'a'));
+    EXPECT_EQ(std::string(100, 'a'), object->value_);
+    object.reset();
+    EXPECT_EQ(1, destroyed);
+  }
+  EXPECT_EQ(1, destroyed);
+}
+
+TEST(ArenaTest, ListWithArenaAllocator) {
+  int destroyed = 0;
+  InlineArena<512> arena;
+  {
+    std::list<ArenaPtr<Tracked>, ArenaAllocator<ArenaPtr<Tracked>>> list{
+        ArenaAllocator<ArenaPtr<Tracked>>(arena)};
+    for (int i = 0; i < 100; i++) {
+      list.emplace_back(arena.create<Tracked>(destroyed, std::to_string(i)));
+    }
+    list.pop_front();
+    EXPECT_EQ(1, destroyed);
+    EXPECT_EQ("1", list.front()->value_);
+    EXPECT_EQ("99", list.back()->value_);
+  }
+  EXPECT_EQ(100, destroyed);
+  EXPECT_LT(0U, arena.heapBlocks());
+}
+
+} // namespace
+} // namespace Envoy
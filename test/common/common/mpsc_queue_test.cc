@@ -0,0 +1,81 @@
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "common/common/mpsc_queue.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+struct TestNode : public MpscQueue::Node {
+  TestNode(uint32_t producer, uint32_t value) : producer_(producer), value_(value) {}
+
+  const uint32_t producer_;
+  const uint32_t value_;
+};
+
+TEST(MpscQueueTest, Fifo) {
+  MpscQueue queue;
+  EXPECT_EQ(nullptr, queue.pop());
+
+  std::vector<std::unique_ptr<TestNode>> nodes;
+  for (uint32_t i = 0; i < 3; i++) {
+    nodes.push_back(std::make_unique<TestNode>(0, i));
+    queue.push(*nodes.back());
+  }
+  EXPECT_EQ(nodes[0].get(), queue.pop());
+  EXPECT_EQ(nodes[1].get(), queue.pop());
+
+  // Nodes can be pushed again once popped, including while others are queued.
+  queue.push(*nodes[0]);
+  EXPECT_EQ(nodes[2].get(), queue.pop());
+  EXPECT_EQ(nodes[0].get(), queue.pop());
+  EXPECT_EQ(nullptr, queue.pop());
+
+  queue.push(*nodes[1]);
+  EXPECT_EQ(nodes[1].get(), queue.pop());
+  EXPECT_EQ(nullptr, queue.pop());
+}
+
+// Every node pushed by concurrent producers is popped exactly once, in the order each producer
+// pushed them.
+TEST(MpscQueueTest, ConcurrentProducers) {
+  const uint32_t num_producers = 4;
+  const uint32_t nodes_per_producer = 100000;
+  MpscQueue queue;
+  std::atomic<uint32_t> done{0};
+
+  std::vector<Thread::ThreadPtr> producers;
+  for (uint32_t p = 0; p < num_producers; p++) {
+    producers.push_back(Thread::threadFactoryForTest().createThread([&queue, &done, p]() {
+      for (uint32_t i = 0; i < nodes_per_producer; i++) {
+        queue.push(*new TestNode(p, i));
+      }
+      done++;
+    }));
+  }
+
+  std::vector<uint32_t> next(num_producers);
+  uint32_t popped = 0;
+  while (popped < num_producers * nodes_per_producer) {
+    std::unique_ptr<TestNode> node(static_cast<TestNode*>(queue.pop()));
+    if (node == nullptr) {
+      // Either empty, or a push is in progress.
+      continue;
+    }
+    EXPECT_EQ(next[node->producer_]++, node->value_);
+    popped++;
+  }
+  for (auto& producer : producers) {
+    producer->join();
+  }
+  EXPECT_EQ(num_producers, done);
+  EXPECT_EQ(nullptr, queue.pop());
+}
+
+} // namespace
+} // namespace Envoy
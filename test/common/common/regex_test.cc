@@ -0,0 +1,60 @@
+#include "envoy/common/exception.h"
+
+#include "common/common/regex.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Regex {
+namespace {
+
+envoy::type::matcher::RegexMatcher googleReMatcher(const std::string& regex) {
+  envoy::type::matcher::RegexMatcher matcher;
+  matcher.mutable_google_re2();
+  matcher.set_regex(regex);
+  return matcher;
+}
+
+TEST(Utility, ParseStdRegex) {
+  EXPECT_THROW_WITH_REGEX(Utility::parseStdRegexAsCompiledMatcher("(+invalid)"), EnvoyException,
+                          "Invalid regex '\\(\\+invalid\\)': .+");
+
+  CompiledMatcherPtr matcher = Utility::parseStdRegexAsCompiledMatcher("/asdf/.*");
+  EXPECT_TRUE(matcher->match("/asdf/1"));
+  EXPECT_FALSE(matcher->match("/ASDF/1"));
+  EXPECT_FALSE(matcher->match("/foo/asdf/1"));
+}
+
+TEST(Utility, ParseRegex) {
+  EXPECT_THROW_WITH_REGEX(Utility::parseRegex(googleReMatcher("(+invalid)")), EnvoyException,
+                          "Invalid regex '\\(\\+invalid\\)': .+");
+
+  CompiledMatcherPtr matcher = Utility::parseRegex(googleReMatcher("/asdf/.*"));
+  EXPECT_TRUE(matcher->match("/asdf/1"));
+  EXPECT_FALSE(matcher->match("/ASDF/1"));
+  // Matching is implicitly anchored at both ends.
+  EXPECT_FALSE(matcher->match("/foo/asdf/1"));
+  EXPECT_FALSE(Utility::parseRegex(googleReMatcher("/asdf"))->match("/asdf/1"));
+}
+
+TEST(Utility, ParseRegexProgramSize) {
+  // Too large for the default program size budget.
+  const std::string regex = "/asdf/.*/asdf/.*/asdf/.*/asdf/.*/asdf/.*/asdf/.*/asdf/.*/asdf/.*";
+  EXPECT_THROW_WITH_REGEX(Utility::parseRegex(googleReMatcher(regex)), EnvoyException,
+                          "RE2 program size of [0-9]+ > max program size of 100");
+
+  envoy::type::matcher::RegexMatcher matcher = googleReMatcher(regex);
+  matcher.mutable_google_re2()->mutable_max_program_size()->set_value(1000);
+  EXPECT_TRUE(Utility::parseRegex(matcher)->match("/asdf/1/asdf/2/asdf/3/asdf/4/asdf/5/asdf/6/"
+                                                  "asdf/7/asdf/8"));
+
+  matcher.mutable_google_re2()->mutable_max_program_size()->set_value(1);
+  EXPECT_THROW_WITH_REGEX(Utility::parseRegex(matcher), EnvoyException,
+                          "RE2 program size of [0-9]+ > max program size of 1");
+}
+
+} // namespace
+} // namespace Regex
+} // namespace Envoy
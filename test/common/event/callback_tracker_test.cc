@@ -0,0 +1,178 @@
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "common/event/callback_tracker.h"
+
+#include "test/mocks/stats/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::HasSubstr;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+class TestDeferredDeletable : public DeferredDeletable {};
+
+class CallbackTrackerTest : public testing::Test {
+protected:
+  CallbackTrackerTest()
+      : stats_{ALL_DISPATCHER_STATS(POOL_HISTOGRAM_PREFIX(store_, "test.dispatcher."))},
+        tracker_("test.dispatcher", stats_, time_system_) {
+    CallbackTracker::setCurrent(&tracker_);
+  }
+
+  ~CallbackTrackerTest() { CallbackTracker::setCurrent(nullptr); }
+
+  Stats::MockHistogram& histogram(Stats::Histogram& histogram) {
+    return dynamic_cast<Stats::MockHistogram&>(histogram);
+  }
+
+  NiceMock<Stats::MockStore> store_;
+  DispatcherStats stats_;
+  SimulatedTimeSystem time_system_;
+  CallbackTracker tracker_;
+};
+
+TEST_F(CallbackTrackerTest, RecordsCallbackDuration) {
+  std::function<void()> callback = [this]() { time_system_.sleep(std::chrono::microseconds(200)); };
+  EXPECT_CALL(histogram(stats_.callback_duration_us_), recordValue(200));
+  {
+    CallbackTracker::Scope scope("timer", callback);
+    callback();
+  }
+  // Not slow enough to be kept.
+  EXPECT_TRUE(tracker_.slowCallbacks().empty());
+}
+
+TEST_F(CallbackTrackerTest, RecordsTimeToFirstCallback) {
+  std::function<void()> callback = []() {};
+  tracker_.onPollDone();
+  time_system_.sleep(std::chrono::microseconds(30));
+  EXPECT_CALL(histogram(stats_.time_to_first_callback_us_), recordValue(30));
+  { CallbackTracker::Scope scope("timer", callback); }
+
+  // Only the first callback after polling counts.
+  EXPECT_CALL(histogram(stats_.time_to_first_callback_us_), recordValue(_)).Times(0);
+  { CallbackTracker::Scope scope("timer", callback); }
+}
+
+TEST_F(CallbackTrackerTest, KeepsSlowCallbacks) {
+  const SystemTime start_time = time_system_.systemTime();
+  std::function<void(uint32_t)> file_event_cb = [this](uint32_t) {
+    time_system_.sleep(std::chrono::milliseconds(5));
+  };
+  {
+    CallbackTracker::Scope scope("file_event", file_event_cb);
+    file_event_cb(0);
+  }
+  TestDeferredDeletable deletable;
+  {
+    CallbackTracker::Scope scope("deferred_delete", deletable);
+    time_system_.sleep(std::chrono::milliseconds(2));
+  }
+
+  const auto slow_callbacks = tracker_.slowCallbacks();
+  ASSERT_EQ(2, slow_callbacks.size());
+  EXPECT_EQ(start_time, slow_callbacks[0].start_time_);
+  EXPECT_EQ(std::chrono::milliseconds(5), slow_callbacks[0].duration_);
+  EXPECT_STREQ("file_event", slow_callbacks[0].kind_);
+  EXPECT_THAT(CallbackTracker::sourceName(*slow_callbacks[0].source_),
+              HasSubstr("KeepsSlowCallbacks"));
+  EXPECT_STREQ("deferred_delete", slow_callbacks[1].kind_);
+  EXPECT_THAT(CallbackTracker::sourceName(*slow_callbacks[1].source_),
+              HasSubstr("TestDeferredDeletable"));
+}
+
+// Nested callbacks are kept when slow, but only the outer one is counted in the stats.
+TEST_F(CallbackTrackerTest, NestedCallbacks) {
+  std::function<void()> post_timer_cb = []() {};
+  std::function<void()> posted_cb = []() {};
+  EXPECT_CALL(histogram(stats_.callback_duration_us_), recordValue(3000));
+  {
+    CallbackTracker::Scope outer("timer", post_timer_cb);
+    time_system_.sleep(std::chrono::milliseconds(1));
+    CallbackTracker::Scope inner("post", posted_cb);
+    time_system_.sleep(std::chrono::milliseconds(2));
+  }
+
+  const auto slow_callbacks = tracker_.slowCallbacks();
+  ASSERT_EQ(2, slow_callbacks.size());
+  EXPECT_STREQ("post", slow_callbacks[0].kind_);
+  EXPECT_EQ(std::chrono::milliseconds(2), slow_callbacks[0].duration_);
+  EXPECT_STREQ("timer", slow_callbacks[1].kind_);
+  EXPECT_EQ(std::chrono::milliseconds(3), slow_callbacks[1].duration_);
+}
+
+// A driver scope that is untracked leaves its callbacks to be timed as outer callbacks.
+TEST_F(CallbackTrackerTest, UntrackedDriver) {
+  std::function<void()> post_timer_cb = []() {};
+  std::function<void()> posted_cb = []() {};
+  tracker_.onPollDone();
+  EXPECT_CALL(histogram(stats_.time_to_first_callback_us_), recordValue(0));
+  EXPECT_CALL(histogram(stats_.callback_duration_us_), recordValue(2000)).Times(2);
+  {
+    CallbackTracker::Scope outer("timer", post_timer_cb);
+    CallbackTracker::untrackCurrentScope();
+    time_system_.sleep(std::chrono::milliseconds(1));
+    for (int i = 0; i < 2; i++) {
+      CallbackTracker::Scope inner("post", posted_cb);
+      time_system_.sleep(std::chrono::milliseconds(2));
+    }
+  }
+
+  const auto slow_callbacks = tracker_.slowCallbacks();
+  ASSERT_EQ(2, slow_callbacks.size());
+  EXPECT_STREQ("post", slow_callbacks[0].kind_);
+  EXPECT_STREQ("post", slow_callbacks[1].kind_);
+}
+
+TEST_F(CallbackTrackerTest, RingKeepsMostRecent) {
+  std::function<void()> callback = []() {};
+  const uint32_t num_callbacks = CallbackTracker::SlowCallbackRingSize + 5;
+  for (uint32_t i = 1; i <= num_callbacks; i++) {
+    CallbackTracker::Scope scope("timer", callback);
+    time_system_.sleep(std::chrono::milliseconds(i));
+  }
+
+  const auto slow_callbacks = tracker_.slowCallbacks();
+  ASSERT_EQ(CallbackTracker::SlowCallbackRingSize, slow_callbacks.size());
+  EXPECT_EQ(std::chrono::milliseconds(6), slow_callbacks.front().duration_);
+  EXPECT_EQ(std::chrono::milliseconds(num_callbacks), slow_callbacks.back().duration_);
+}
+
+TEST_F(CallbackTrackerTest, NotCurrent) {
+  CallbackTracker::setCurrent(nullptr);
+  std::function<void()> callback = []() {};
+  EXPECT_CALL(histogram(stats_.callback_duration_us_), recordValue(_)).Times(0);
+  CallbackTracker::Scope scope("timer", callback);
+  time_system_.sleep(std::chrono::milliseconds(5));
+}
+
+TEST_F(CallbackTrackerTest, Registry) {
+  std::vector<std::string> names;
+  auto list = [&names]() {
+    names.clear();
+    CallbackTracker::forEach(
+        [&names](const CallbackTracker& tracker) { names.push_back(tracker.name()); });
+  };
+
+  {
+    CallbackTracker other("other.dispatcher", stats_, time_system_);
+    list();
+    EXPECT_THAT(names, testing::ElementsAre("test.dispatcher", "other.dispatcher"));
+  }
+  list();
+  EXPECT_THAT(names, testing::ElementsAre("test.dispatcher"));
+}
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
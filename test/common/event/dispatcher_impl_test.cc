@@ -1,4 +1,5 @@
 #include <functional>
+#include <vector>
 
 #include "envoy/thread/thread.h"
 
@@ -65,6 +66,52 @@ TEST(DeferredDeleteTest, DeferredDelete) {
   dispatcher->clearDeferredDeleteList();
 }
 
+// When run from the event loop, deferred deletes are spread over iterations, oldest first.
+TEST(DeferredDeleteTest, BoundedPerIteration) {
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher(api->allocateDispatcher());
+  const uint32_t num_deletes = DispatcherImpl::MaxDeferredDeletesPerIteration + 10;
+  std::vector<uint32_t> deleted;
+
+  for (uint32_t i = 0; i < num_deletes; i++) {
+    dispatcher->deferredDelete(DeferredDeletablePtr{
+        new TestDeferredDeletable([&deleted, i]() -> void { deleted.push_back(i); })});
+  }
+
+  dispatcher->run(Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(DispatcherImpl::MaxDeferredDeletesPerIteration, deleted.size());
+
+  // Items deferred meanwhile wait for the ones ahead of them.
+  dispatcher->deferredDelete(DeferredDeletablePtr{new TestDeferredDeletable(
+      [&deleted, num_deletes]() -> void { deleted.push_back(num_deletes); })});
+  dispatcher->run(Dispatcher::RunType::NonBlock);
+  dispatcher->run(Dispatcher::RunType::NonBlock);
+  ASSERT_EQ(num_deletes + 1, deleted.size());
+  for (uint32_t i = 0; i <= num_deletes; i++) {
+    EXPECT_EQ(i, deleted[i]);
+  }
+}
+
+// A clear deletes everything deferred so far, even if a bounded run stopped part way.
+TEST(DeferredDeleteTest, ClearAfterBoundedRun) {
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher(api->allocateDispatcher());
+  const uint32_t num_deletes = DispatcherImpl::MaxDeferredDeletesPerIteration * 2;
+  uint32_t deleted = 0;
+
+  for (uint32_t i = 0; i < num_deletes; i++) {
+    dispatcher->deferredDelete(
+        DeferredDeletablePtr{new TestDeferredDeletable([&deleted]() -> void { deleted++; })});
+  }
+  dispatcher->run(Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(DispatcherImpl::MaxDeferredDeletesPerIteration, deleted);
+
+  dispatcher->deferredDelete(
+      DeferredDeletablePtr{new TestDeferredDeletable([&deleted]() -> void { deleted++; })});
+  dispatcher->clearDeferredDeleteList();
+  EXPECT_EQ(num_deletes + 1, deleted);
+}
+
 class DispatcherImplTest : public testing::Test {
 protected:
   DispatcherImplTest()
@@ -100,8 +147,13 @@ protected:
 // TODO(mergeconflict): We also need integration testing to validate that the expected histograms
 // are written when `enable_dispatcher_stats` is true. See issue #6582.
 TEST_F(DispatcherImplTest, InitializeStats) {
+  EXPECT_CALL(scope_, histogram("test.dispatcher.callback_duration_us"));
   EXPECT_CALL(scope_, histogram("test.dispatcher.loop_duration_us"));
   EXPECT_CALL(scope_, histogram("test.dispatcher.poll_delay_us"));
+  EXPECT_CALL(scope_, histogram("test.dispatcher.poll_duration_us"));
+  EXPECT_CALL(scope_, histogram("test.dispatcher.post_latency_us"));
+  EXPECT_CALL(scope_, histogram("test.dispatcher.post_queue_depth"));
+  EXPECT_CALL(scope_, histogram("test.dispatcher.time_to_first_callback_us"));
   dispatcher_->initializeStats(scope_, "test.");
 }
 
@@ -137,7 +189,7 @@ TEST_F(DispatcherImplTest, RunPostCallbacksLocking) {
     // Block dispatcher first to ensure that both posted events below are handled
     // by a single call to runPostCallbacks().
     //
-    // This also ensures that the post_lock_ is not held while callbacks are called,
+    // This also ensures that no lock is held while callbacks are called,
     // or else this would deadlock.
     Thread::LockGuard lock(mu_);
     dispatcher_->post([this]() { Thread::LockGuard lock(mu_); });
@@ -159,6 +211,44 @@ TEST_F(DispatcherImplTest, RunPostCallbacksLocking) {
   }
 }
 
+// Callbacks posted from several threads at once all run, and in order for each thread.
+TEST_F(DispatcherImplTest, PostFromManyThreads) {
+  const uint32_t num_threads = 4;
+  const uint32_t posts_per_thread = 10000;
+  std::vector<uint32_t> next(num_threads);
+  uint32_t out_of_order = 0;
+  uint32_t ran = 0;
+
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t t = 0; t < num_threads; t++) {
+    threads.push_back(api_->threadFactory().createThread([&, t]() {
+      for (uint32_t i = 0; i < posts_per_thread; i++) {
+        dispatcher_->post([&, t, i]() {
+          if (next[t]++ != i) {
+            out_of_order++;
+          }
+          if (++ran == num_threads * posts_per_thread) {
+            {
+              Thread::LockGuard lock(mu_);
+              work_finished_ = true;
+            }
+            cv_.notifyOne();
+          }
+        });
+      }
+    }));
+  }
+  for (auto& thread : threads) {
+    thread->join();
+  }
+
+  Thread::LockGuard lock(mu_);
+  while (!work_finished_) {
+    cv_.wait(mu_);
+  }
+  EXPECT_EQ(0, out_of_order);
+}
+
 TEST_F(DispatcherImplTest, Timer) {
   TimerPtr timer;
   dispatcher_->post([this, &timer]() {
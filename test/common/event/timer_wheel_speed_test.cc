@@ -0,0 +1,67 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// NOLINT(namespace-envoy)
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "common/common/logger.h"
+#include "common/common/thread.h"
+#include "common/event/libevent.h"
+#include "common/event/libevent_scheduler.h"
+#include "common/event/real_time_system.h"
+#include "common/event/timer_wheel.h"
+
+#include "benchmark/benchmark.h"
+
+namespace {
+
+// Re-arms each of state.range(0) timers once per iteration, with a spread of timeouts, the way
+// idle and stream timeouts are re-armed on every read or write.
+void rearmTimers(benchmark::State& state, Envoy::Event::Scheduler& scheduler) {
+  const size_t num_timers = state.range(0);
+  std::vector<Envoy::Event::TimerPtr> timers;
+  timers.reserve(num_timers);
+  for (size_t i = 0; i < num_timers; i++) {
+    timers.push_back(scheduler.createTimer([]() -> void {}));
+    timers.back()->enableTimer(std::chrono::milliseconds(60000 + i % 1000));
+  }
+
+  size_t i = 0;
+  for (auto _ : state) {
+    timers[i % num_timers]->enableTimer(std::chrono::milliseconds(60000 + i % 1000));
+    i++;
+  }
+}
+
+} // namespace
+
+static void BM_LibeventRearm(benchmark::State& state) {
+  Envoy::Event::Libevent::Global::initialize();
+  Envoy::Event::LibeventScheduler scheduler;
+  rearmTimers(state, scheduler);
+}
+BENCHMARK(BM_LibeventRearm)->Arg(10000)->Arg(100000)->Arg(500000);
+
+static void BM_TimerWheelRearm(benchmark::State& state) {
+  Envoy::Event::Libevent::Global::initialize();
+  Envoy::Event::LibeventScheduler base_scheduler;
+  Envoy::Event::RealTimeSystem time_system;
+  Envoy::Event::TimerWheel wheel(base_scheduler, time_system, std::chrono::milliseconds(1));
+  rearmTimers(state, wheel);
+}
+BENCHMARK(BM_TimerWheelRearm)->Arg(10000)->Arg(100000)->Arg(500000);
+
+int main(int argc, char** argv) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logger_context(spdlog::level::warn,
+                                        Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock);
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,252 @@
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "common/event/callback_tracker.h"
+#include "common/event/real_time_system.h"
+#include "common/event/timer_wheel.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/stats/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+// Hands out the timer that drives the wheel, so that tests can see what it is armed for.
+class DriverScheduler : public Scheduler {
+public:
+  TimerPtr createTimer(const TimerCb& cb) override {
+    auto timer = std::make_unique<NiceMock<MockTimer>>();
+    timer->callback_ = cb;
+    driver_ = timer.get();
+    return timer;
+  }
+
+  MockTimer* driver_{};
+};
+
+class TimerWheelTest : public testing::Test {
+protected:
+  TimerWheelTest() { createWheel(std::chrono::milliseconds(1)); }
+
+  void createWheel(std::chrono::milliseconds tick) {
+    timers_.clear();
+    fired_at_.clear();
+    wheel_ = std::make_unique<TimerWheel>(scheduler_, time_system_, tick);
+  }
+
+  // Creates a timer that records the time since the wheel was created when it fires.
+  Timer& addTimer() {
+    const size_t index = timers_.size();
+    fired_at_.push_back(-1);
+    timers_.push_back(wheel_->createTimer([this, index]() -> void {
+      fired_at_[index] = std::chrono::duration_cast<std::chrono::milliseconds>(
+                             time_system_.monotonicTime() - start_)
+                             .count();
+    }));
+    return *timers_.back();
+  }
+
+  // Moves time forward and runs the wheel, as the driver would.
+  void advanceTo(int64_t ms) {
+    time_system_.setMonotonicTime(start_ + std::chrono::milliseconds(ms));
+    wheel_->advance();
+  }
+
+  SimulatedTimeSystem time_system_;
+  const MonotonicTime start_{time_system_.monotonicTime()};
+  DriverScheduler scheduler_;
+  std::unique_ptr<TimerWheel> wheel_;
+  std::vector<TimerPtr> timers_;
+  std::vector<int64_t> fired_at_;
+};
+
+TEST_F(TimerWheelTest, FiresAfterDuration) {
+  Timer& timer = addTimer();
+  EXPECT_CALL(*scheduler_.driver_, enableTimer(std::chrono::milliseconds(10)));
+  timer.enableTimer(std::chrono::milliseconds(10));
+  testing::Mock::VerifyAndClearExpectations(scheduler_.driver_);
+  EXPECT_TRUE(timer.enabled());
+  EXPECT_EQ(1, wheel_->size());
+
+  advanceTo(9);
+  EXPECT_EQ(-1, fired_at_[0]);
+  advanceTo(10);
+  EXPECT_EQ(10, fired_at_[0]);
+  EXPECT_FALSE(timer.enabled());
+  EXPECT_EQ(0, wheel_->size());
+}
+
+TEST_F(TimerWheelTest, ZeroDurationRunsOnNextAdvance) {
+  Timer& timer = addTimer();
+  EXPECT_CALL(*scheduler_.driver_, enableTimer(std::chrono::milliseconds(0)));
+  timer.enableTimer(std::chrono::milliseconds(0));
+  wheel_->advance();
+  EXPECT_EQ(0, fired_at_[0]);
+}
+
+TEST_F(TimerWheelTest, DisableAndRearm) {
+  Timer& timer = addTimer();
+  timer.enableTimer(std::chrono::milliseconds(10));
+  timer.disableTimer();
+  EXPECT_FALSE(timer.enabled());
+  EXPECT_EQ(0, wheel_->size());
+  advanceTo(20);
+  EXPECT_EQ(-1, fired_at_[0]);
+
+  // Re-arming replaces the previous expiry.
+  timer.enableTimer(std::chrono::milliseconds(100));
+  timer.enableTimer(std::chrono::milliseconds(5));
+  EXPECT_EQ(1, wheel_->size());
+  advanceTo(25);
+  EXPECT_EQ(25, fired_at_[0]);
+  EXPECT_EQ(0, wheel_->size());
+}
+
+// Timers on every level, and beyond the top one, fire at their expiry even when time jumps.
+TEST_F(TimerWheelTest, AllLevels) {
+  const std::vector<int64_t> durations{3, 63, 64, 100, 4096, 5000, 300000, 20000000, 2000000000};
+  for (int64_t duration : durations) {
+    addTimer().enableTimer(std::chrono::milliseconds(duration));
+  }
+  for (size_t i = 0; i < durations.size(); i++) {
+    advanceTo(durations[i] - 1);
+    EXPECT_EQ(-1, fired_at_[i]) << durations[i];
+    advanceTo(durations[i]);
+    EXPECT_EQ(durations[i], fired_at_[i]) << durations[i];
+  }
+  EXPECT_EQ(0, wheel_->size());
+
+  // A jump over many expiries runs all of them.
+  for (int64_t duration : durations) {
+    addTimer().enableTimer(std::chrono::milliseconds(duration));
+  }
+  advanceTo(durations.back() + 3000000000);
+  for (size_t i = durations.size(); i < fired_at_.size(); i++) {
+    EXPECT_NE(-1, fired_at_[i]);
+  }
+}
+
+TEST_F(TimerWheelTest, CallbacksArmAndDestroyTimers) {
+  addTimer();
+  addTimer();
+  Timer& rearmed = addTimer();
+  // The first timer destroys the second, which expires on the same tick, and re-arms the third.
+  timers_[0] = wheel_->createTimer([this, &rearmed]() -> void {
+    timers_[1].reset();
+    rearmed.enableTimer(std::chrono::milliseconds(5));
+  });
+  timers_[0]->enableTimer(std::chrono::milliseconds(10));
+  timers_[1]->enableTimer(std::chrono::milliseconds(10));
+  rearmed.enableTimer(std::chrono::milliseconds(10));
+
+  advanceTo(10);
+  EXPECT_EQ(-1, fired_at_[1]);
+  EXPECT_EQ(-1, fired_at_[2]);
+  EXPECT_TRUE(rearmed.enabled());
+  advanceTo(15);
+  EXPECT_EQ(15, fired_at_[2]);
+}
+
+TEST_F(TimerWheelTest, CoarseTick) {
+  createWheel(std::chrono::milliseconds(10));
+  Timer& timer = addTimer();
+  timer.enableTimer(std::chrono::milliseconds(1));
+  advanceTo(5);
+  EXPECT_EQ(-1, fired_at_[0]);
+  advanceTo(10);
+  EXPECT_EQ(10, fired_at_[0]);
+}
+
+// The driver is armed for the earliest expiry, and not re-armed for later ones.
+TEST_F(TimerWheelTest, DriverFollowsEarliestTimer) {
+  MockTimer& driver = *scheduler_.driver_;
+  EXPECT_CALL(driver, enableTimer(std::chrono::milliseconds(50)));
+  addTimer().enableTimer(std::chrono::milliseconds(50));
+  EXPECT_CALL(driver, enableTimer(std::chrono::milliseconds(20)));
+  addTimer().enableTimer(std::chrono::milliseconds(20));
+  EXPECT_CALL(driver, enableTimer(std::chrono::milliseconds(30))).Times(0);
+  addTimer().enableTimer(std::chrono::milliseconds(30));
+
+  testing::Mock::VerifyAndClearExpectations(&driver);
+  EXPECT_CALL(driver, enableTimer(std::chrono::milliseconds(10)));
+  advanceTo(20);
+  EXPECT_CALL(driver, disableTimer());
+  advanceTo(50);
+}
+
+// Wheel timers are timed like libevent timers, by the tracker current on the thread.
+TEST_F(TimerWheelTest, CallbacksTracked) {
+  NiceMock<Stats::MockStore> store;
+  DispatcherStats stats{ALL_DISPATCHER_STATS(POOL_HISTOGRAM_PREFIX(store, "test.dispatcher."))};
+  CallbackTracker tracker("test.dispatcher", stats, time_system_);
+  CallbackTracker::setCurrent(&tracker);
+
+  TimerPtr timer = wheel_->createTimer(
+      [this]() -> void { time_system_.sleep(std::chrono::milliseconds(2)); });
+  timer->enableTimer(std::chrono::milliseconds(10));
+  advanceTo(10);
+  CallbackTracker::setCurrent(nullptr);
+
+  const auto slow_callbacks = tracker.slowCallbacks();
+  ASSERT_EQ(1, slow_callbacks.size());
+  EXPECT_STREQ("timer", slow_callbacks[0].kind_);
+  EXPECT_EQ(std::chrono::milliseconds(2), slow_callbacks[0].duration_);
+}
+
+// The timer that drives the wheel is not timed itself, so each wheel timer is an outer callback.
+TEST_F(TimerWheelTest, DriverNotTracked) {
+  NiceMock<Stats::MockStore> store;
+  DispatcherStats stats{ALL_DISPATCHER_STATS(POOL_HISTOGRAM_PREFIX(store, "test.dispatcher."))};
+  CallbackTracker tracker("test.dispatcher", stats, time_system_);
+  CallbackTracker::setCurrent(&tracker);
+
+  TimerPtr timer1 = wheel_->createTimer(
+      [this]() -> void { time_system_.sleep(std::chrono::milliseconds(2)); });
+  TimerPtr timer2 = wheel_->createTimer(
+      [this]() -> void { time_system_.sleep(std::chrono::milliseconds(3)); });
+  timer1->enableTimer(std::chrono::milliseconds(10));
+  timer2->enableTimer(std::chrono::milliseconds(10));
+  EXPECT_CALL(dynamic_cast<Stats::MockHistogram&>(stats.callback_duration_us_), recordValue(2000));
+  EXPECT_CALL(dynamic_cast<Stats::MockHistogram&>(stats.callback_duration_us_), recordValue(3000));
+  time_system_.setMonotonicTime(start_ + std::chrono::milliseconds(10));
+  {
+    // As the libevent timer does.
+    CallbackTracker::Scope scope("timer", scheduler_.driver_->callback_);
+    scheduler_.driver_->callback_();
+  }
+  CallbackTracker::setCurrent(nullptr);
+
+  const auto slow_callbacks = tracker.slowCallbacks();
+  ASSERT_EQ(2, slow_callbacks.size());
+  EXPECT_EQ(std::chrono::milliseconds(2), slow_callbacks[0].duration_);
+  EXPECT_EQ(std::chrono::milliseconds(3), slow_callbacks[1].duration_);
+}
+
+// Dispatchers use the wheel when it is selected, and run its timers from the event loop.
+TEST(TimerWheelDispatcherTest, RealTimeSystem) {
+  RealTimeSystem::useTimerWheel(std::chrono::milliseconds(1));
+  RealTimeSystem time_system;
+  Api::ApiPtr api = Api::createApiForTest(time_system);
+  DispatcherPtr dispatcher = api->allocateDispatcher();
+  RealTimeSystem::useTimerWheel(std::chrono::milliseconds(0));
+
+  const MonotonicTime start = time_system.monotonicTime();
+  TimerPtr timer = dispatcher->createTimer([&dispatcher]() -> void { dispatcher->exit(); });
+  EXPECT_NE(nullptr, dynamic_cast<WheelTimerImpl*>(timer.get()));
+  timer->enableTimer(std::chrono::milliseconds(5));
+  dispatcher->run(Dispatcher::RunType::RunUntilExit);
+  EXPECT_GE(time_system.monotonicTime() - start, std::chrono::milliseconds(5));
+}
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
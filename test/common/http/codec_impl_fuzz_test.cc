@@ -47,6 +47,7 @@ Http1Settings fromHttp1Settings(const test::common::http::Http1ServerSettings& s
   h1_settings.allow_absolute_url_ = settings.allow_absolute_url();
   h1_settings.accept_http_10_ = settings.accept_http_10();
   h1_settings.default_host_for_http_10_ = settings.default_host_for_http_10();
+  h1_settings.fast_request_parsing_ = settings.fast_request_parsing();
 
   return h1_settings;
 }
@@ -3191,10 +3191,16 @@ TEST_F(HttpConnectionManagerImplTest, HitFilterWatermarkLimits) {
   // unregister callbacks2
   decoder_filters_[0]->callbacks_->removeDownstreamWatermarkCallbacks(callbacks2);
 
+  // Callbacks registered in place of callbacks2, as a retry does, are told about the watermark.
+  MockDownstreamWatermarkCallbacks callbacks3;
+  EXPECT_CALL(callbacks3, onAboveWriteBufferHighWatermark());
+  decoder_filters_[0]->callbacks_->addDownstreamWatermarkCallbacks(callbacks3);
+
   // Change the limit so the buffered data is below the new watermark.
   buffer_len = encoder_filters_[1]->callbacks_->encodingBuffer()->length();
   EXPECT_CALL(callbacks, onBelowWriteBufferLowWatermark());
   EXPECT_CALL(callbacks2, onBelowWriteBufferLowWatermark()).Times(0);
+  EXPECT_CALL(callbacks3, onBelowWriteBufferLowWatermark());
   encoder_filters_[1]->callbacks_->setEncoderBufferLimit((buffer_len + 1) * 2);
 }
 
@@ -347,6 +347,21 @@ TEST(HeaderStringTest, All) {
     EXPECT_EQ(HeaderString::Type::Reference, string.type());
   }
 
+  // Set reference to a span of memory, then copy over it.
+  {
+    const std::string static_string = "hello world";
+    HeaderString string;
+    string.setReference(absl::string_view(static_string).substr(6));
+    EXPECT_EQ("world", string.getStringView());
+    EXPECT_EQ(static_string.data() + 6, string.getStringView().data());
+    EXPECT_EQ(HeaderString::Type::Reference, string.type());
+
+    string.append("!", 1);
+    EXPECT_EQ("world!", string.getStringView());
+    EXPECT_EQ(HeaderString::Type::Dynamic, string.type());
+    EXPECT_EQ("hello world", static_string);
+  }
+
   // getString
   {
     std::string static_string("HELLO");
@@ -1025,6 +1040,31 @@ TEST(HeaderMapImplTest, PseudoHeaderOrder) {
   }
 }
 
+TEST(HeaderMapImplTest, PinMemory) {
+  auto memory = std::make_shared<std::string>("foo: bar");
+  const absl::string_view data(*memory);
+  std::weak_ptr<std::string> weak_memory = memory;
+  {
+    HeaderMapImpl headers;
+    EXPECT_EQ(0U, headers.pinnedByteSize());
+    headers.pinMemory(memory, memory->size());
+    headers.pinMemory(memory, memory->size());
+    EXPECT_EQ(8U, headers.pinnedByteSize());
+
+    HeaderString key;
+    key.setCopy("foo");
+    HeaderString value;
+    value.setReference(data.substr(5));
+    headers.addViaMove(std::move(key), std::move(value));
+
+    memory.reset();
+    EXPECT_FALSE(weak_memory.expired());
+    EXPECT_EQ("bar", headers.get(LowerCaseString("foo"))->value().getStringView());
+    EXPECT_EQ(HeaderString::Type::Reference, headers.get(LowerCaseString("foo"))->value().type());
+  }
+  EXPECT_TRUE(weak_memory.expired());
+}
+
 // Validate that TestHeaderMapImpl copy construction and assignment works. This is a
 // regression for where we were missing a valid copy constructor and had the
 // default (dangerous) move semantics takeover.
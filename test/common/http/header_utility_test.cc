@@ -71,6 +71,22 @@ regex_match: value
   EXPECT_EQ("", header_data.value_);
 }
 
+TEST(HeaderDataConstructorTest, SafeRegexMatchSpecifier) {
+  const std::string yaml = R"EOF(
+name: test-header
+safe_regex_match:
+  google_re2: {}
+  regex: value
+  )EOF";
+
+  HeaderUtility::HeaderData header_data =
+      HeaderUtility::HeaderData(parseHeaderMatcherFromYaml(yaml));
+
+  EXPECT_EQ("test-header", header_data.name_.get());
+  EXPECT_EQ(HeaderUtility::HeaderMatchType::Regex, header_data.header_match_type_);
+  EXPECT_EQ("", header_data.value_);
+}
+
 TEST(HeaderDataConstructorTest, RangeMatchSpecifier) {
   const std::string yaml = R"EOF(
 name: test-header
@@ -252,6 +268,22 @@ regex_match: \d{3}
   EXPECT_FALSE(HeaderUtility::matchHeaders(unmatching_headers, header_data));
 }
 
+TEST(MatchHeadersTest, HeaderSafeRegexMatch) {
+  TestHeaderMapImpl matching_headers{{"match-header", "123"}};
+  TestHeaderMapImpl unmatching_headers{{"match-header", "1234"}, {"match-header", "123.456"}};
+  const std::string yaml = R"EOF(
+name: match-header
+safe_regex_match:
+  google_re2: {}
+  regex: \d{3}
+  )EOF";
+
+  std::vector<HeaderUtility::HeaderData> header_data;
+  header_data.push_back(HeaderUtility::HeaderData(parseHeaderMatcherFromYaml(yaml)));
+  EXPECT_TRUE(HeaderUtility::matchHeaders(matching_headers, header_data));
+  EXPECT_FALSE(HeaderUtility::matchHeaders(unmatching_headers, header_data));
+}
+
 TEST(MatchHeadersTest, HeaderRegexInverseMatch) {
   TestHeaderMapImpl matching_headers{{"match-header", "1234"}, {"match-header", "123.456"}};
   TestHeaderMapImpl unmatching_headers{{"match-header", "123"}};
@@ -1,5 +1,6 @@
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/buffer/buffer.h"
 #include "envoy/event/dispatcher.h"
@@ -28,8 +29,11 @@ namespace Envoy {
 namespace Http {
 namespace Http1 {
 
-class Http1ServerConnectionImplTest : public testing::Test {
+// Parameterized on whether fast request parsing is enabled, which must not change the behavior.
+class Http1ServerConnectionImplTest : public testing::TestWithParam<bool> {
 public:
+  Http1ServerConnectionImplTest() { codec_settings_.fast_request_parsing_ = GetParam(); }
+
   void initialize() {
     codec_ = std::make_unique<ServerConnectionImpl>(connection_, callbacks_, codec_settings_,
                                                     max_request_headers_kb_);
@@ -48,6 +52,8 @@ protected:
   uint32_t max_request_headers_kb_{Http::DEFAULT_MAX_REQUEST_HEADERS_KB};
 };
 
+INSTANTIATE_TEST_SUITE_P(FastRequestParsing, Http1ServerConnectionImplTest, testing::Bool());
+
 void Http1ServerConnectionImplTest::expect400(Protocol p, bool allow_absolute_url,
                                               Buffer::OwnedImpl& buffer) {
   InSequence sequence;
@@ -90,7 +96,7 @@ void Http1ServerConnectionImplTest::expectHeadersTest(Protocol p, bool allow_abs
   EXPECT_EQ(p, codec_->protocol());
 }
 
-TEST_F(Http1ServerConnectionImplTest, EmptyHeader) {
+TEST_P(Http1ServerConnectionImplTest, EmptyHeader) {
   initialize();
 
   InSequence sequence;
@@ -111,7 +117,7 @@ TEST_F(Http1ServerConnectionImplTest, EmptyHeader) {
   EXPECT_EQ(0U, buffer.length());
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http10) {
+TEST_P(Http1ServerConnectionImplTest, Http10) {
   initialize();
 
   InSequence sequence;
@@ -128,7 +134,7 @@ TEST_F(Http1ServerConnectionImplTest, Http10) {
   EXPECT_EQ(Protocol::Http10, codec_->protocol());
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http10AbsoluteNoOp) {
+TEST_P(Http1ServerConnectionImplTest, Http10AbsoluteNoOp) {
   initialize();
 
   TestHeaderMapImpl expected_headers{{":path", "/"}, {":method", "GET"}};
@@ -136,7 +142,7 @@ TEST_F(Http1ServerConnectionImplTest, Http10AbsoluteNoOp) {
   expectHeadersTest(Protocol::Http10, true, buffer, expected_headers);
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http10Absolute) {
+TEST_P(Http1ServerConnectionImplTest, Http10Absolute) {
   initialize();
 
   TestHeaderMapImpl expected_headers{
@@ -145,7 +151,7 @@ TEST_F(Http1ServerConnectionImplTest, Http10Absolute) {
   expectHeadersTest(Protocol::Http10, true, buffer, expected_headers);
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http11AbsolutePath1) {
+TEST_P(Http1ServerConnectionImplTest, Http11AbsolutePath1) {
   initialize();
 
   TestHeaderMapImpl expected_headers{
@@ -154,7 +160,7 @@ TEST_F(Http1ServerConnectionImplTest, Http11AbsolutePath1) {
   expectHeadersTest(Protocol::Http11, true, buffer, expected_headers);
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http11AbsolutePath2) {
+TEST_P(Http1ServerConnectionImplTest, Http11AbsolutePath2) {
   initialize();
 
   TestHeaderMapImpl expected_headers{
@@ -163,7 +169,7 @@ TEST_F(Http1ServerConnectionImplTest, Http11AbsolutePath2) {
   expectHeadersTest(Protocol::Http11, true, buffer, expected_headers);
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http11AbsolutePathWithPort) {
+TEST_P(Http1ServerConnectionImplTest, Http11AbsolutePathWithPort) {
   TestHeaderMapImpl expected_headers{
       {":authority", "www.somewhere.com:4532"}, {":path", "/foo/bar"}, {":method", "GET"}};
   Buffer::OwnedImpl buffer(
@@ -171,7 +177,7 @@ TEST_F(Http1ServerConnectionImplTest, Http11AbsolutePathWithPort) {
   expectHeadersTest(Protocol::Http11, true, buffer, expected_headers);
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http11AbsoluteEnabledNoOp) {
+TEST_P(Http1ServerConnectionImplTest, Http11AbsoluteEnabledNoOp) {
   initialize();
 
   TestHeaderMapImpl expected_headers{
@@ -180,7 +186,7 @@ TEST_F(Http1ServerConnectionImplTest, Http11AbsoluteEnabledNoOp) {
   expectHeadersTest(Protocol::Http11, true, buffer, expected_headers);
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http11InvalidRequest) {
+TEST_P(Http1ServerConnectionImplTest, Http11InvalidRequest) {
   initialize();
 
   // Invalid because www.somewhere.com is not an absolute path nor an absolute url
@@ -188,7 +194,7 @@ TEST_F(Http1ServerConnectionImplTest, Http11InvalidRequest) {
   expect400(Protocol::Http11, true, buffer);
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http11AbsolutePathNoSlash) {
+TEST_P(Http1ServerConnectionImplTest, Http11AbsolutePathNoSlash) {
   initialize();
 
   TestHeaderMapImpl expected_headers{
@@ -197,21 +203,21 @@ TEST_F(Http1ServerConnectionImplTest, Http11AbsolutePathNoSlash) {
   expectHeadersTest(Protocol::Http11, true, buffer, expected_headers);
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http11AbsolutePathBad) {
+TEST_P(Http1ServerConnectionImplTest, Http11AbsolutePathBad) {
   initialize();
 
   Buffer::OwnedImpl buffer("GET * HTTP/1.1\r\nHost: bah\r\n\r\n");
   expect400(Protocol::Http11, true, buffer);
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http11AbsolutePortTooLarge) {
+TEST_P(Http1ServerConnectionImplTest, Http11AbsolutePortTooLarge) {
   initialize();
 
   Buffer::OwnedImpl buffer("GET http://foobar.com:1000000 HTTP/1.1\r\nHost: bah\r\n\r\n");
   expect400(Protocol::Http11, true, buffer);
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http11RelativeOnly) {
+TEST_P(Http1ServerConnectionImplTest, Http11RelativeOnly) {
   initialize();
 
   TestHeaderMapImpl expected_headers{
@@ -220,7 +226,7 @@ TEST_F(Http1ServerConnectionImplTest, Http11RelativeOnly) {
   expectHeadersTest(Protocol::Http11, false, buffer, expected_headers);
 }
 
-TEST_F(Http1ServerConnectionImplTest, Http11Options) {
+TEST_P(Http1ServerConnectionImplTest, Http11Options) {
   initialize();
 
   TestHeaderMapImpl expected_headers{
@@ -229,7 +235,7 @@ TEST_F(Http1ServerConnectionImplTest, Http11Options) {
   expectHeadersTest(Protocol::Http11, true, buffer, expected_headers);
 }
 
-TEST_F(Http1ServerConnectionImplTest, SimpleGet) {
+TEST_P(Http1ServerConnectionImplTest, SimpleGet) {
   initialize();
 
   InSequence sequence;
@@ -245,7 +251,7 @@ TEST_F(Http1ServerConnectionImplTest, SimpleGet) {
   EXPECT_EQ(0U, buffer.length());
 }
 
-TEST_F(Http1ServerConnectionImplTest, BadRequestNoStream) {
+TEST_P(Http1ServerConnectionImplTest, BadRequestNoStream) {
   initialize();
 
   std::string output;
@@ -256,7 +262,7 @@ TEST_F(Http1ServerConnectionImplTest, BadRequestNoStream) {
   EXPECT_EQ("HTTP/1.1 400 Bad Request\r\ncontent-length: 0\r\nconnection: close\r\n\r\n", output);
 }
 
-TEST_F(Http1ServerConnectionImplTest, BadRequestStartedStream) {
+TEST_P(Http1ServerConnectionImplTest, BadRequestStartedStream) {
   initialize();
 
   std::string output;
@@ -273,7 +279,7 @@ TEST_F(Http1ServerConnectionImplTest, BadRequestStartedStream) {
   EXPECT_EQ("HTTP/1.1 400 Bad Request\r\ncontent-length: 0\r\nconnection: close\r\n\r\n", output);
 }
 
-TEST_F(Http1ServerConnectionImplTest, HostHeaderTranslation) {
+TEST_P(Http1ServerConnectionImplTest, HostHeaderTranslation) {
   initialize();
 
   InSequence sequence;
@@ -291,7 +297,7 @@ TEST_F(Http1ServerConnectionImplTest, HostHeaderTranslation) {
 
 // Regression test for http-parser allowing embedded NULs in header values,
 // verify we reject them.
-TEST_F(Http1ServerConnectionImplTest, HeaderEmbeddedNulRejection) {
+TEST_P(Http1ServerConnectionImplTest, HeaderEmbeddedNulRejection) {
   initialize();
 
   InSequence sequence;
@@ -307,7 +313,7 @@ TEST_F(Http1ServerConnectionImplTest, HeaderEmbeddedNulRejection) {
 
 // Mutate an HTTP GET with embedded NULs, this should always be rejected in some
 // way (not necessarily with "head value contains NUL" though).
-TEST_F(Http1ServerConnectionImplTest, HeaderMutateEmbeddedNul) {
+TEST_P(Http1ServerConnectionImplTest, HeaderMutateEmbeddedNul) {
   const std::string example_input = "GET / HTTP/1.1\r\nHOST: h.com\r\nfoo: barbaz\r\n";
 
   for (size_t n = 1; n < example_input.size(); ++n) {
@@ -328,7 +334,7 @@ TEST_F(Http1ServerConnectionImplTest, HeaderMutateEmbeddedNul) {
 // Mutate an HTTP GET with CR or LF. These can cause an exception or maybe
 // result in a valid decodeHeaders(). In any case, the validHeaderString()
 // ASSERTs should validate we never have any embedded CR or LF.
-TEST_F(Http1ServerConnectionImplTest, HeaderMutateEmbeddedCRLF) {
+TEST_P(Http1ServerConnectionImplTest, HeaderMutateEmbeddedCRLF) {
   const std::string example_input = "GET / HTTP/1.1\r\nHOST: h.com\r\nfoo: barbaz\r\n";
 
   for (const char c : {'\r', '\n'}) {
@@ -350,7 +356,7 @@ TEST_F(Http1ServerConnectionImplTest, HeaderMutateEmbeddedCRLF) {
   }
 }
 
-TEST_F(Http1ServerConnectionImplTest, CloseDuringHeadersComplete) {
+TEST_P(Http1ServerConnectionImplTest, CloseDuringHeadersComplete) {
   initialize();
 
   InSequence sequence;
@@ -370,7 +376,7 @@ TEST_F(Http1ServerConnectionImplTest, CloseDuringHeadersComplete) {
   EXPECT_NE(0U, buffer.length());
 }
 
-TEST_F(Http1ServerConnectionImplTest, PostWithContentLength) {
+TEST_P(Http1ServerConnectionImplTest, PostWithContentLength) {
   initialize();
 
   InSequence sequence;
@@ -392,7 +398,7 @@ TEST_F(Http1ServerConnectionImplTest, PostWithContentLength) {
   EXPECT_EQ(0U, buffer.length());
 }
 
-TEST_F(Http1ServerConnectionImplTest, HeaderOnlyResponse) {
+TEST_P(Http1ServerConnectionImplTest, HeaderOnlyResponse) {
   initialize();
 
   NiceMock<Http::MockStreamDecoder> decoder;
@@ -415,7 +421,7 @@ TEST_F(Http1ServerConnectionImplTest, HeaderOnlyResponse) {
   EXPECT_EQ("HTTP/1.1 200 OK\r\ncontent-length: 0\r\n\r\n", output);
 }
 
-TEST_F(Http1ServerConnectionImplTest, HeaderOnlyResponseWith204) {
+TEST_P(Http1ServerConnectionImplTest, HeaderOnlyResponseWith204) {
   initialize();
 
   NiceMock<Http::MockStreamDecoder> decoder;
@@ -438,7 +444,7 @@ TEST_F(Http1ServerConnectionImplTest, HeaderOnlyResponseWith204) {
   EXPECT_EQ("HTTP/1.1 204 No Content\r\n\r\n", output);
 }
 
-TEST_F(Http1ServerConnectionImplTest, HeaderOnlyResponseWith100Then200) {
+TEST_P(Http1ServerConnectionImplTest, HeaderOnlyResponseWith100Then200) {
   initialize();
 
   NiceMock<Http::MockStreamDecoder> decoder;
@@ -470,7 +476,9 @@ TEST_F(Http1ServerConnectionImplTest, HeaderOnlyResponseWith100Then200) {
 
 class Http1ServerConnectionImplDeathTest : public Http1ServerConnectionImplTest {};
 
-TEST_F(Http1ServerConnectionImplDeathTest, MetadataTest) {
+INSTANTIATE_TEST_SUITE_P(FastRequestParsing, Http1ServerConnectionImplDeathTest, testing::Bool());
+
+TEST_P(Http1ServerConnectionImplDeathTest, MetadataTest) {
   initialize();
 
   NiceMock<Http::MockStreamDecoder> decoder;
@@ -491,7 +499,7 @@ TEST_F(Http1ServerConnectionImplDeathTest, MetadataTest) {
   EXPECT_DEATH_LOG_TO_STDERR(response_encoder->encodeMetadata(metadata_map_vector), "");
 }
 
-TEST_F(Http1ServerConnectionImplTest, ChunkedResponse) {
+TEST_P(Http1ServerConnectionImplTest, ChunkedResponse) {
   initialize();
 
   NiceMock<Http::MockStreamDecoder> decoder;
@@ -518,7 +526,7 @@ TEST_F(Http1ServerConnectionImplTest, ChunkedResponse) {
             output);
 }
 
-TEST_F(Http1ServerConnectionImplTest, ContentLengthResponse) {
+TEST_P(Http1ServerConnectionImplTest, ContentLengthResponse) {
   initialize();
 
   NiceMock<Http::MockStreamDecoder> decoder;
@@ -544,7 +552,7 @@ TEST_F(Http1ServerConnectionImplTest, ContentLengthResponse) {
   EXPECT_EQ("HTTP/1.1 200 OK\r\ncontent-length: 11\r\n\r\nHello World", output);
 }
 
-TEST_F(Http1ServerConnectionImplTest, HeadRequestResponse) {
+TEST_P(Http1ServerConnectionImplTest, HeadRequestResponse) {
   initialize();
 
   NiceMock<Http::MockStreamDecoder> decoder;
@@ -567,7 +575,7 @@ TEST_F(Http1ServerConnectionImplTest, HeadRequestResponse) {
   EXPECT_EQ("HTTP/1.1 200 OK\r\ncontent-length: 5\r\n\r\n", output);
 }
 
-TEST_F(Http1ServerConnectionImplTest, HeadChunkedRequestResponse) {
+TEST_P(Http1ServerConnectionImplTest, HeadChunkedRequestResponse) {
   initialize();
 
   NiceMock<Http::MockStreamDecoder> decoder;
@@ -590,7 +598,7 @@ TEST_F(Http1ServerConnectionImplTest, HeadChunkedRequestResponse) {
   EXPECT_EQ("HTTP/1.1 200 OK\r\ntransfer-encoding: chunked\r\n\r\n", output);
 }
 
-TEST_F(Http1ServerConnectionImplTest, DoubleRequest) {
+TEST_P(Http1ServerConnectionImplTest, DoubleRequest) {
   initialize();
 
   NiceMock<Http::MockStreamDecoder> decoder;
@@ -615,7 +623,7 @@ TEST_F(Http1ServerConnectionImplTest, DoubleRequest) {
   EXPECT_EQ(0U, buffer.length());
 }
 
-TEST_F(Http1ServerConnectionImplTest, RequestWithTrailers) {
+TEST_P(Http1ServerConnectionImplTest, RequestWithTrailers) {
   initialize();
 
   NiceMock<Http::MockStreamDecoder> decoder;
@@ -632,7 +640,7 @@ TEST_F(Http1ServerConnectionImplTest, RequestWithTrailers) {
   EXPECT_EQ(0U, buffer.length());
 }
 
-TEST_F(Http1ServerConnectionImplTest, UpgradeRequest) {
+TEST_P(Http1ServerConnectionImplTest, UpgradeRequest) {
   initialize();
 
   InSequence sequence;
@@ -655,7 +663,7 @@ TEST_F(Http1ServerConnectionImplTest, UpgradeRequest) {
   codec_->dispatch(websocket_payload);
 }
 
-TEST_F(Http1ServerConnectionImplTest, UpgradeRequestWithEarlyData) {
+TEST_P(Http1ServerConnectionImplTest, UpgradeRequestWithEarlyData) {
   initialize();
 
   InSequence sequence;
@@ -670,7 +678,7 @@ TEST_F(Http1ServerConnectionImplTest, UpgradeRequestWithEarlyData) {
   codec_->dispatch(buffer);
 }
 
-TEST_F(Http1ServerConnectionImplTest, UpgradeRequestWithTEChunked) {
+TEST_P(Http1ServerConnectionImplTest, UpgradeRequestWithTEChunked) {
   initialize();
 
   InSequence sequence;
@@ -687,7 +695,7 @@ TEST_F(Http1ServerConnectionImplTest, UpgradeRequestWithTEChunked) {
   codec_->dispatch(buffer);
 }
 
-TEST_F(Http1ServerConnectionImplTest, UpgradeRequestWithNoBody) {
+TEST_P(Http1ServerConnectionImplTest, UpgradeRequestWithNoBody) {
   initialize();
 
   InSequence sequence;
@@ -704,7 +712,7 @@ TEST_F(Http1ServerConnectionImplTest, UpgradeRequestWithNoBody) {
   codec_->dispatch(buffer);
 }
 
-TEST_F(Http1ServerConnectionImplTest, WatermarkTest) {
+TEST_P(Http1ServerConnectionImplTest, WatermarkTest) {
   EXPECT_CALL(connection_, bufferLimit()).Times(1).WillOnce(Return(10));
   initialize();
 
@@ -1085,7 +1093,7 @@ TEST_F(Http1ClientConnectionImplTest, HighwatermarkMultipleResponses) {
   static_cast<ClientConnection*>(codec_.get())
       ->onUnderlyingConnectionBelowWriteBufferLowWatermark();
 }
-TEST_F(Http1ServerConnectionImplTest, TestLargeRequestHeadersRejected) {
+TEST_P(Http1ServerConnectionImplTest, TestLargeRequestHeadersRejected) {
   // Default limit of 60 KiB
   initialize();
 
@@ -1105,7 +1113,7 @@ TEST_F(Http1ServerConnectionImplTest, TestLargeRequestHeadersRejected) {
   EXPECT_THROW_WITH_MESSAGE(codec_->dispatch(buffer), EnvoyException, "headers size exceeds limit");
 }
 
-TEST_F(Http1ServerConnectionImplTest, TestLargeRequestHeadersSplitRejected) {
+TEST_P(Http1ServerConnectionImplTest, TestLargeRequestHeadersSplitRejected) {
   // Default limit of 60 KiB
   initialize();
 
@@ -1130,7 +1138,271 @@ TEST_F(Http1ServerConnectionImplTest, TestLargeRequestHeadersSplitRejected) {
   EXPECT_THROW_WITH_MESSAGE(codec_->dispatch(buffer), EnvoyException, "headers size exceeds limit");
 }
 
-TEST_F(Http1ServerConnectionImplTest, TestLargeRequestHeadersAccepted) {
+// The header size limit applies per request, not per connection.
+TEST_P(Http1ServerConnectionImplTest, TestLargeRequestHeadersOnKeepAliveAccepted) {
+  initialize();
+
+  NiceMock<Http::MockStreamDecoder> decoder;
+  EXPECT_CALL(callbacks_, newStream(_, _))
+      .Times(2)
+      .WillRepeatedly(Invoke([&](Http::StreamEncoder& encoder, bool) -> Http::StreamDecoder& {
+        TestHeaderMapImpl response_headers{{":status", "200"}};
+        encoder.encodeHeaders(response_headers, true);
+        return decoder;
+      }));
+  EXPECT_CALL(decoder, decodeHeaders_(_, true)).Times(2);
+
+  const std::string long_string = std::string(40 * 1024, 'q');
+  for (int i = 0; i < 2; i++) {
+    Buffer::OwnedImpl buffer(fmt::format("GET / HTTP/1.1\r\nbig: {}\r\n\r\n", long_string));
+    codec_->dispatch(buffer);
+  }
+}
+
+// Header values too large for inline storage reference the received data, which the header map
+// keeps alive, rather than being copied.
+TEST_P(Http1ServerConnectionImplTest, LargeHeaderValueReferencesReceivedData) {
+  initialize();
+
+  NiceMock<Http::MockStreamDecoder> decoder;
+  EXPECT_CALL(callbacks_, newStream(_, _))
+      .WillOnce(Invoke(
+          [&](Http::StreamEncoder&, bool) -> Http::StreamDecoder& { return decoder; }));
+  HeaderMapPtr headers;
+  EXPECT_CALL(decoder, decodeHeaders_(_, true))
+      .WillOnce(Invoke([&](HeaderMapPtr& decoded, bool) { headers = std::move(decoded); }));
+
+  const std::string small_value(16, 's');
+  const std::string large_value(1024, 'l');
+  {
+    Buffer::OwnedImpl buffer(fmt::format("GET / HTTP/1.1\r\nsmall: {}\r\nlarge: {}\r\n\r\n",
+                                         small_value, large_value));
+    codec_->dispatch(buffer);
+    EXPECT_EQ(0U, buffer.length());
+  }
+
+  const HeaderEntry* small = headers->get(LowerCaseString("small"));
+  EXPECT_EQ(small_value, small->value().getStringView());
+  EXPECT_EQ(HeaderString::Type::Inline, small->value().type());
+  const HeaderEntry* large = headers->get(LowerCaseString("large"));
+  EXPECT_EQ(large_value, large->value().getStringView());
+  EXPECT_EQ(HeaderString::Type::Reference, large->value().type());
+  EXPECT_LT(large_value.size(), dynamic_cast<HeaderMapImpl&>(*headers).pinnedByteSize());
+}
+
+// Pipelined requests are parsed from the received slices in place, and only the parsed request
+// is drained, even when a header value of that request pins the slice.
+TEST_P(Http1ServerConnectionImplTest, PipelinedRequestsParsedInPlace) {
+  initialize();
+
+  NiceMock<Http::MockStreamDecoder> decoder;
+  EXPECT_CALL(callbacks_, newStream(_, _))
+      .WillOnce(Invoke(
+          [&](Http::StreamEncoder&, bool) -> Http::StreamDecoder& { return decoder; }));
+  HeaderMapPtr headers;
+  EXPECT_CALL(decoder, decodeHeaders_(_, true))
+      .WillOnce(Invoke([&](HeaderMapPtr& decoded, bool) { headers = std::move(decoded); }));
+
+  const std::string large_value(1024, 'l');
+  const std::string first = fmt::format("GET / HTTP/1.1\r\nlarge: {}\r\n\r\n", large_value);
+  const std::string second = "GET /second HTTP/1.1\r\n\r\n";
+  Buffer::OwnedImpl buffer(first + second);
+  Buffer::RawSlice received;
+  ASSERT_EQ(1, buffer.getRawSlices(&received, 1));
+
+  codec_->dispatch(buffer);
+  EXPECT_EQ(second, buffer.toString());
+  Buffer::RawSlice remaining;
+  ASSERT_EQ(1, buffer.getRawSlices(&remaining, 1));
+  EXPECT_EQ(static_cast<const char*>(received.mem_) + first.size(), remaining.mem_);
+
+  const HeaderEntry* large = headers->get(LowerCaseString("large"));
+  EXPECT_EQ(large_value, large->value().getStringView());
+  EXPECT_EQ(HeaderString::Type::Reference, large->value().type());
+}
+
+// Requests that only http_parser handles, such as one with a body, may come between those that
+// fast request parsing handles on a keep-alive connection.
+TEST_P(Http1ServerConnectionImplTest, KeepAliveRequestsAroundBody) {
+  initialize();
+
+  NiceMock<Http::MockStreamDecoder> decoder;
+  Http::StreamEncoder* response_encoder = nullptr;
+  EXPECT_CALL(callbacks_, newStream(_, _))
+      .Times(3)
+      .WillRepeatedly(Invoke([&](Http::StreamEncoder& encoder, bool) -> Http::StreamDecoder& {
+        response_encoder = &encoder;
+        return decoder;
+      }));
+  std::vector<std::string> paths;
+  EXPECT_CALL(decoder, decodeHeaders_(_, _))
+      .Times(3)
+      .WillRepeatedly(Invoke([&](HeaderMapPtr& headers, bool) {
+        paths.emplace_back(headers->Path()->value().getStringView());
+      }));
+  EXPECT_CALL(decoder, decodeData(BufferStringEqual("hi"), false));
+
+  Buffer::OwnedImpl buffer("GET /a HTTP/1.1\r\nConnection: keep-alive\r\n\r\n"
+                           "POST /b HTTP/1.1\r\ncontent-length: 2\r\n\r\nhi"
+                           "GET /c HTTP/1.1\r\nHost: h\r\n\r\n");
+  for (int i = 0; i < 3; i++) {
+    codec_->dispatch(buffer);
+    response_encoder->encodeHeaders(TestHeaderMapImpl{{":status", "200"}}, true);
+  }
+  EXPECT_EQ(0U, buffer.length());
+  EXPECT_EQ((std::vector<std::string>{"/a", "/b", "/c"}), paths);
+}
+
+// No request is parsed after one that closes the connection.
+TEST_P(Http1ServerConnectionImplTest, RequestAfterConnectionClose) {
+  initialize();
+
+  NiceMock<Http::MockStreamDecoder> decoder;
+  Http::StreamEncoder* response_encoder = nullptr;
+  EXPECT_CALL(callbacks_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamEncoder& encoder, bool) -> Http::StreamDecoder& {
+        response_encoder = &encoder;
+        return decoder;
+      }));
+  EXPECT_CALL(decoder, decodeHeaders_(_, true));
+
+  Buffer::OwnedImpl buffer("GET / HTTP/1.1\r\nConnection: close\r\n\r\nGET / HTTP/1.1\r\n\r\n");
+  codec_->dispatch(buffer);
+  response_encoder->encodeHeaders(TestHeaderMapImpl{{":status", "200"}}, true);
+  EXPECT_THROW_WITH_MESSAGE(codec_->dispatch(buffer), CodecProtocolException,
+                            "http/1.1 protocol error: HPE_CLOSED_CONNECTION");
+}
+
+// Pinned received data counts against the buffer limit of the connection, which stops reading
+// while the header maps referencing it hold more than that.
+TEST_P(Http1ServerConnectionImplTest, PinnedHeaderValuesReadDisable) {
+  ON_CALL(connection_, bufferLimit()).WillByDefault(Return(512));
+  initialize();
+
+  NiceMock<Http::MockStreamDecoder> decoder;
+  EXPECT_CALL(callbacks_, newStream(_, _))
+      .WillOnce(Invoke(
+          [&](Http::StreamEncoder&, bool) -> Http::StreamDecoder& { return decoder; }));
+  HeaderMapPtr headers;
+  EXPECT_CALL(decoder, decodeHeaders_(_, true))
+      .WillOnce(Invoke([&](HeaderMapPtr& decoded, bool) { headers = std::move(decoded); }));
+
+  Buffer::OwnedImpl buffer(
+      fmt::format("GET / HTTP/1.1\r\nlarge: {}\r\n\r\n", std::string(1024, 'l')));
+  EXPECT_CALL(connection_, readDisable(true));
+  codec_->dispatch(buffer);
+  testing::Mock::VerifyAndClearExpectations(&connection_);
+
+  EXPECT_CALL(connection_, readDisable(false));
+  headers.reset();
+}
+
+// The headers of a request do not hold back the reading of its own body.
+TEST_P(Http1ServerConnectionImplTest, PinnedHeaderValuesDoNotBlockOwnBody) {
+  ON_CALL(connection_, bufferLimit()).WillByDefault(Return(512));
+  initialize();
+
+  NiceMock<Http::MockStreamDecoder> decoder;
+  EXPECT_CALL(callbacks_, newStream(_, _))
+      .WillOnce(Invoke(
+          [&](Http::StreamEncoder&, bool) -> Http::StreamDecoder& { return decoder; }));
+  HeaderMapPtr headers;
+  EXPECT_CALL(decoder, decodeHeaders_(_, false))
+      .WillOnce(Invoke([&](HeaderMapPtr& decoded, bool) { headers = std::move(decoded); }));
+
+  Buffer::OwnedImpl buffer(fmt::format(
+      "POST / HTTP/1.1\r\nlarge: {}\r\ncontent-length: 4\r\n\r\nab", std::string(1024, 'l')));
+  EXPECT_CALL(connection_, readDisable(true)).Times(0);
+  codec_->dispatch(buffer);
+  EXPECT_NE(nullptr, headers);
+  testing::Mock::VerifyAndClearExpectations(&connection_);
+
+  // Once the request is complete, its pinned headers count against the limit.
+  InSequence sequence;
+  EXPECT_CALL(decoder, decodeData(BufferStringEqual("cd"), false));
+  EXPECT_CALL(decoder, decodeData(BufferStringEqual(""), true));
+  EXPECT_CALL(connection_, readDisable(true));
+  Buffer::OwnedImpl rest("cd");
+  codec_->dispatch(rest);
+
+  EXPECT_CALL(connection_, readDisable(false));
+  headers.reset();
+}
+
+// Reading is not enabled again on a connection that closed while header maps pinned its data.
+TEST_P(Http1ServerConnectionImplTest, PinnedHeaderValuesOutliveConnection) {
+  ON_CALL(connection_, bufferLimit()).WillByDefault(Return(512));
+  initialize();
+
+  NiceMock<Http::MockStreamDecoder> decoder;
+  EXPECT_CALL(callbacks_, newStream(_, _))
+      .WillOnce(Invoke(
+          [&](Http::StreamEncoder&, bool) -> Http::StreamDecoder& { return decoder; }));
+  HeaderMapPtr headers;
+  EXPECT_CALL(decoder, decodeHeaders_(_, true))
+      .WillOnce(Invoke([&](HeaderMapPtr& decoded, bool) { headers = std::move(decoded); }));
+
+  Buffer::OwnedImpl buffer(
+      fmt::format("GET / HTTP/1.1\r\nlarge: {}\r\n\r\n", std::string(1024, 'l')));
+  EXPECT_CALL(connection_, readDisable(true));
+  codec_->dispatch(buffer);
+  testing::Mock::VerifyAndClearExpectations(&connection_);
+
+  connection_.state_ = Network::Connection::State::Closed;
+  EXPECT_CALL(connection_, readDisable(_)).Times(0);
+  headers.reset();
+}
+
+// Header maps pinning received data may outlive the codec.
+TEST_P(Http1ServerConnectionImplTest, PinnedHeaderValuesOutliveCodec) {
+  ON_CALL(connection_, bufferLimit()).WillByDefault(Return(512));
+  initialize();
+
+  NiceMock<Http::MockStreamDecoder> decoder;
+  EXPECT_CALL(callbacks_, newStream(_, _))
+      .WillOnce(Invoke(
+          [&](Http::StreamEncoder&, bool) -> Http::StreamDecoder& { return decoder; }));
+  HeaderMapPtr headers;
+  EXPECT_CALL(decoder, decodeHeaders_(_, true))
+      .WillOnce(Invoke([&](HeaderMapPtr& decoded, bool) { headers = std::move(decoded); }));
+
+  const std::string large_value(1024, 'l');
+  Buffer::OwnedImpl buffer(fmt::format("GET / HTTP/1.1\r\nlarge: {}\r\n\r\n", large_value));
+  EXPECT_CALL(connection_, readDisable(true));
+  codec_->dispatch(buffer);
+  codec_.reset();
+  buffer.drain(buffer.length());
+
+  EXPECT_EQ(large_value, headers->get(LowerCaseString("large"))->value().getStringView());
+  EXPECT_CALL(connection_, readDisable(false)).Times(0);
+  headers.reset();
+}
+
+// A large header value split across reads is copied.
+TEST_P(Http1ServerConnectionImplTest, LargeHeaderValueSplitAcrossReadsCopied) {
+  initialize();
+
+  NiceMock<Http::MockStreamDecoder> decoder;
+  EXPECT_CALL(callbacks_, newStream(_, _))
+      .WillOnce(Invoke(
+          [&](Http::StreamEncoder&, bool) -> Http::StreamDecoder& { return decoder; }));
+  HeaderMapPtr headers;
+  EXPECT_CALL(decoder, decodeHeaders_(_, true))
+      .WillOnce(Invoke([&](HeaderMapPtr& decoded, bool) { headers = std::move(decoded); }));
+
+  const std::string large_value(1024, 'l');
+  Buffer::OwnedImpl buffer(fmt::format("GET / HTTP/1.1\r\nlarge: {}", large_value.substr(0, 512)));
+  codec_->dispatch(buffer);
+  buffer.add(fmt::format("{}\r\n\r\n", large_value.substr(512)));
+  codec_->dispatch(buffer);
+  EXPECT_EQ(0U, buffer.length());
+
+  const HeaderEntry* large = headers->get(LowerCaseString("large"));
+  EXPECT_EQ(large_value, large->value().getStringView());
+  EXPECT_EQ(HeaderString::Type::Dynamic, large->value().type());
+}
+
+TEST_P(Http1ServerConnectionImplTest, TestLargeRequestHeadersAccepted) {
   max_request_headers_kb_ = 65;
   initialize();
 
@@ -1149,7 +1421,7 @@ TEST_F(Http1ServerConnectionImplTest, TestLargeRequestHeadersAccepted) {
   codec_->dispatch(buffer);
 }
 
-TEST_F(Http1ServerConnectionImplTest, TestLargeRequestHeadersAcceptedMaxConfigurable) {
+TEST_P(Http1ServerConnectionImplTest, TestLargeRequestHeadersAcceptedMaxConfigurable) {
   max_request_headers_kb_ = 96;
   initialize();
 
@@ -1168,6 +1440,40 @@ TEST_F(Http1ServerConnectionImplTest, TestLargeRequestHeadersAcceptedMaxConfigur
   codec_->dispatch(buffer);
 }
 
+// Unwinding the read disables of a keep-alive connection includes the one for pinned bytes, which
+// is then not undone a second time.
+TEST_F(Http1ClientConnectionImplTest, PinnedHeaderValuesReadDisableUnwound) {
+  ON_CALL(connection_, bufferLimit()).WillByDefault(Return(512));
+  initialize();
+
+  NiceMock<Http::MockStreamDecoder> response_decoder1;
+  Http::StreamEncoder& request_encoder1 = codec_->newStream(response_decoder1);
+  request_encoder1.encodeHeaders(TestHeaderMapImpl{{":method", "GET"}, {":path", "/"}}, true);
+  NiceMock<Http::MockStreamDecoder> response_decoder2;
+  Http::StreamEncoder& request_encoder2 = codec_->newStream(response_decoder2);
+  request_encoder2.encodeHeaders(TestHeaderMapImpl{{":method", "GET"}, {":path", "/"}}, true);
+
+  HeaderMapPtr headers;
+  EXPECT_CALL(response_decoder1, decodeHeaders_(_, true))
+      .WillOnce(Invoke([&](HeaderMapPtr& decoded, bool) { headers = std::move(decoded); }));
+  EXPECT_CALL(connection_, readDisable(true)).WillOnce(Invoke([&](bool) {
+    connection_.read_enabled_ = false;
+  }));
+  EXPECT_CALL(connection_, readDisable(false)).WillOnce(Invoke([&](bool) {
+    connection_.read_enabled_ = true;
+  }));
+  Buffer::OwnedImpl response(
+      fmt::format("HTTP/1.1 200 OK\r\nlarge: {}\r\nContent-Length: 0\r\n\r\n"
+                  "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n",
+                  std::string(1024, 'l')));
+  codec_->dispatch(response);
+  EXPECT_EQ(0U, response.length());
+  testing::Mock::VerifyAndClearExpectations(&connection_);
+
+  EXPECT_CALL(connection_, readDisable(_)).Times(0);
+  headers.reset();
+}
+
 TEST_F(Http1ClientConnectionImplTest, TestLargeResponseHeadersRejected) {
   initialize();
 
@@ -0,0 +1,127 @@
+#include <string>
+
+#include "common/http/http1/fast_request_parser.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+TEST(FastRequestParserTest, SimpleGet) {
+  const std::string data = "GET /index.html?a=b HTTP/1.1\r\n"
+                           "Host: www.example.com\r\n"
+                           "Accept:*/*\r\n"
+                           "Empty:\r\n"
+                           "Spaces: \t a\tb\r\n"
+                           "Connection: Keep-Alive\r\n"
+                           "\r\n"
+                           "GET /next HTTP/1.1\r\n";
+  FastRequestParser::Request request;
+  ASSERT_TRUE(FastRequestParser::parse(data, request));
+  EXPECT_EQ(HTTP_GET, request.method_);
+  EXPECT_EQ("/index.html?a=b", request.url_);
+  ASSERT_EQ(5, request.headers_.size());
+  EXPECT_EQ("Host", request.headers_[0].field_);
+  EXPECT_EQ("www.example.com", request.headers_[0].value_);
+  EXPECT_EQ("Accept", request.headers_[1].field_);
+  EXPECT_EQ("*/*", request.headers_[1].value_);
+  EXPECT_EQ("Empty", request.headers_[2].field_);
+  EXPECT_EQ("", request.headers_[2].value_);
+  EXPECT_EQ("a\tb", request.headers_[3].value_);
+  EXPECT_TRUE(request.keep_alive_header_);
+  EXPECT_EQ(data.find("GET /next"), request.size_);
+}
+
+TEST(FastRequestParserTest, NoHeaders) {
+  FastRequestParser::Request request;
+  ASSERT_TRUE(FastRequestParser::parse("DELETE /a HTTP/1.1\r\n\r\n", request));
+  EXPECT_EQ(HTTP_DELETE, request.method_);
+  EXPECT_TRUE(request.headers_.empty());
+  EXPECT_FALSE(request.keep_alive_header_);
+}
+
+// The header vector is reused, not appended to.
+TEST(FastRequestParserTest, Reuse) {
+  FastRequestParser::Request request;
+  ASSERT_TRUE(FastRequestParser::parse("GET / HTTP/1.1\r\na: b\r\nc: d\r\n\r\n", request));
+  ASSERT_TRUE(FastRequestParser::parse("HEAD / HTTP/1.1\r\ne: f\r\n\r\n", request));
+  EXPECT_EQ(HTTP_HEAD, request.method_);
+  ASSERT_EQ(1, request.headers_.size());
+  EXPECT_EQ("e", request.headers_[0].field_);
+}
+
+// Everything that http_parser might treat differently is left to it.
+TEST(FastRequestParserTest, Rejected) {
+  const char* const rejected[] = {
+      // Incomplete.
+      "",
+      "GET / HTTP/1.1\r\n",
+      "GET / HTTP/1.1\r\nHost: a\r\n",
+      "GET / HTTP/1.1\r\nHost: a\r\n\r",
+      // Request line.
+      "\r\nGET / HTTP/1.1\r\n\r\n",
+      "get / HTTP/1.1\r\n\r\n",
+      "BREW / HTTP/1.1\r\n\r\n",
+      "CONNECT host:443 HTTP/1.1\r\n\r\n",
+      "GET http://host/ HTTP/1.1\r\n\r\n",
+      "OPTIONS * HTTP/1.1\r\n\r\n",
+      "GET  / HTTP/1.1\r\n\r\n",
+      "GET / a HTTP/1.1\r\n\r\n",
+      "GET /\t HTTP/1.1\r\n\r\n",
+      "GET /\xc3\xa9 HTTP/1.1\r\n\r\n",
+      "GET HTTP/1.1\r\n\r\n",
+      "GET / HTTP/1.0\r\n\r\n",
+      "GET / HTTP/1.1 \r\n\r\n",
+      "GET / HTTP/1.1\n\r\n",
+      // Headers.
+      "GET / HTTP/1.1\r\nHost: a\n\r\n",
+      "GET / HTTP/1.1\r\nHost: a\r\r\n\r\n",
+      "GET / HTTP/1.1\r\nHost: a\r\n folded\r\n\r\n",
+      "GET / HTTP/1.1\r\nHost : a\r\n\r\n",
+      "GET / HTTP/1.1\r\n: a\r\n\r\n",
+      "GET / HTTP/1.1\r\nHost\r\n\r\n",
+      "GET / HTTP/1.1\r\nHost: a \r\n\r\n",
+      "GET / HTTP/1.1\r\nHost: \xc3\xa9\r\n\r\n",
+      "GET / HTTP/1.1\r\nHost: a\x7f\r\n\r\n",
+      "GET / HTTP/1.1\r\nContent-Length: 0\r\n\r\n",
+      "GET / HTTP/1.1\r\ntransfer-encoding: chunked\r\n\r\n",
+      "GET / HTTP/1.1\r\nConnection: close\r\n\r\n",
+      "GET / HTTP/1.1\r\nConnection: keep-alive, Upgrade\r\nUpgrade: websocket\r\n\r\n",
+      "GET / HTTP/1.1\r\nUPGRADE: h2c\r\n\r\n",
+      "GET / HTTP/1.1\r\nProxy-Connection: close\r\n\r\n",
+  };
+  for (const char* data : rejected) {
+    FastRequestParser::Request request;
+    EXPECT_FALSE(FastRequestParser::parse(data, request)) << data;
+  }
+  FastRequestParser::Request request;
+  EXPECT_FALSE(FastRequestParser::parse(absl::string_view("GET / HTTP/1.1\r\na: \0\r\n\r\n", 24),
+                                        request));
+}
+
+// The vectorized scan agrees with a byte by byte one at every offset and alignment.
+TEST(FastRequestParserTest, FindControlCharacter) {
+  const std::string text(64, 'a');
+  for (const char c : {'\0', '\t', '\r', '\n', '\x1f', '\x7f', '\x80', '\xff'}) {
+    for (size_t start = 0; start < 16; start++) {
+      for (size_t position = start; position < text.size(); position++) {
+        std::string data = text;
+        data[position] = c;
+        const char* begin = data.data() + start;
+        EXPECT_EQ(data.data() + position,
+                  FastRequestParser::findControlCharacter(begin, data.data() + data.size()));
+      }
+    }
+  }
+  const std::string printable = " ~azAZ09";
+  EXPECT_EQ(printable.data() + printable.size(),
+            FastRequestParser::findControlCharacter(printable.data(),
+                                                    printable.data() + printable.size()));
+}
+
+} // namespace
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
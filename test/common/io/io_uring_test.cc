@@ -0,0 +1,141 @@
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <map>
+#include <vector>
+
+#include "common/io/io_uring.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Io {
+namespace {
+
+class IoUringTest : public testing::Test {
+protected:
+  IoUringTest() : supported_(IoUring::isSupported()) {
+    if (supported_) {
+      ring_ = std::make_unique<IoUring>(4);
+      EXPECT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds_));
+    }
+  }
+
+  ~IoUringTest() {
+    if (supported_) {
+      ::close(fds_[0]);
+      ::close(fds_[1]);
+    }
+  }
+
+  // Wait for the given number of completions and return them by user data.
+  std::map<uint64_t, int32_t> waitForCompletions(uint32_t count) {
+    std::map<uint64_t, int32_t> completions;
+    while (completions.size() < count) {
+      ring_->waitForCompletion();
+      ring_->forEveryCompletion(
+          [&completions](uint64_t user_data, int32_t result) { completions[user_data] = result; });
+    }
+    return completions;
+  }
+
+  // io_uring may be unavailable (old kernel, seccomp), in which case the tests have nothing to do.
+  const bool supported_;
+  std::unique_ptr<IoUring> ring_;
+  int fds_[2];
+};
+
+TEST_F(IoUringTest, ReadvAndWritevCompleteInOneSubmit) {
+  if (!supported_) {
+    return;
+  }
+
+  char read_buffer[16];
+  iovec read_iovec{read_buffer, sizeof(read_buffer)};
+  char data[] = "hello";
+  iovec write_iovec{data, 5};
+  EXPECT_TRUE(ring_->prepareReadv(fds_[0], &read_iovec, 1, 1));
+  EXPECT_TRUE(ring_->prepareWritev(fds_[1], &write_iovec, 1, 2));
+  EXPECT_EQ(2, ring_->pendingSubmissions());
+  EXPECT_EQ(2, ring_->submit().rc_);
+  EXPECT_EQ(0, ring_->pendingSubmissions());
+
+  std::map<uint64_t, int32_t> completions = waitForCompletions(2);
+  EXPECT_EQ(5, completions[1]);
+  EXPECT_EQ(5, completions[2]);
+  EXPECT_EQ("hello", std::string(read_buffer, 5));
+}
+
+TEST_F(IoUringTest, CancelPendingRead) {
+  if (!supported_) {
+    return;
+  }
+
+  char read_buffer[16];
+  iovec read_iovec{read_buffer, sizeof(read_buffer)};
+  EXPECT_TRUE(ring_->prepareReadv(fds_[0], &read_iovec, 1, 1));
+  ring_->submit();
+  EXPECT_TRUE(ring_->prepareCancel(1, 2));
+  ring_->submit();
+
+  std::map<uint64_t, int32_t> completions = waitForCompletions(2);
+  EXPECT_EQ(-ECANCELED, completions[1]);
+  EXPECT_EQ(0, completions[2]);
+}
+
+TEST_F(IoUringTest, FullSubmissionQueue) {
+  if (!supported_) {
+    return;
+  }
+
+  char data[] = "x";
+  iovec write_iovec{data, 1};
+  for (uint64_t i = 0; i < 4; i++) {
+    EXPECT_TRUE(ring_->prepareWritev(fds_[1], &write_iovec, 1, i));
+  }
+  EXPECT_FALSE(ring_->prepareWritev(fds_[1], &write_iovec, 1, 4));
+  EXPECT_EQ(4, ring_->submit().rc_);
+  EXPECT_TRUE(ring_->prepareWritev(fds_[1], &write_iovec, 1, 4));
+  EXPECT_EQ(1, ring_->submit().rc_);
+  EXPECT_EQ(5, waitForCompletions(5).size());
+}
+
+// A completion is handed back to the kernel before its callback runs, so a callback that reaps
+// again does not see it twice.
+TEST_F(IoUringTest, CompletionReleasedBeforeCallback) {
+  if (!supported_) {
+    return;
+  }
+
+  char data[] = "x";
+  iovec write_iovec{data, 1};
+  EXPECT_TRUE(ring_->prepareWritev(fds_[1], &write_iovec, 1, 1));
+  EXPECT_TRUE(ring_->prepareWritev(fds_[1], &write_iovec, 1, 2));
+  EXPECT_EQ(2, ring_->submit().rc_);
+
+  std::vector<uint64_t> reaped;
+  while (reaped.size() < 2) {
+    ring_->waitForCompletion();
+    ring_->forEveryCompletion([this, &reaped](uint64_t user_data, int32_t) {
+      reaped.push_back(user_data);
+      ring_->forEveryCompletion(
+          [&reaped](uint64_t nested_user_data, int32_t) { reaped.push_back(nested_user_data); });
+    });
+  }
+  EXPECT_EQ(2, reaped.size());
+  EXPECT_NE(reaped[0], reaped[1]);
+}
+
+TEST_F(IoUringTest, SubmitWithNothingQueued) {
+  if (!supported_) {
+    return;
+  }
+
+  const Api::SysCallIntResult result = ring_->submit();
+  EXPECT_EQ(0, result.rc_);
+  EXPECT_EQ(0, result.errno_);
+}
+
+} // namespace
+} // namespace Io
+} // namespace Envoy
@@ -486,6 +486,34 @@ TEST_P(ConnectionImplTest, ConnectionStats) {
   dispatcher_->run(Event::Dispatcher::RunType::Block);
 }
 
+// Only connections whose bytes no filter or transport socket needs to see can be spliced, and
+// spliced bytes are accounted like read and written ones.
+TEST_P(ConnectionImplTest, SpliceableIoHandle) {
+  setUpBasicConnection();
+  connect();
+
+  EXPECT_NE(nullptr, client_connection_->spliceableIoHandle());
+  ASSERT_NE(nullptr, server_connection_->spliceableIoHandle());
+  EXPECT_TRUE(server_connection_->spliceableIoHandle()->isOpen());
+
+  MockConnectionStats server_connection_stats;
+  server_connection_->setConnectionStats(server_connection_stats.toBufferStats());
+  uint64_t bytes_sent = 0;
+  server_connection_->addBytesSentCallback([&](uint64_t bytes) { bytes_sent += bytes; });
+  EXPECT_CALL(server_connection_stats.rx_total_, add(3));
+  EXPECT_CALL(server_connection_stats.tx_total_, add(4));
+  server_connection_->addSplicedBytes(3, 4);
+  EXPECT_EQ(4, bytes_sent);
+
+  // A second read filter, or any write filter, needs to see the bytes.
+  server_connection_->addReadFilter(std::make_shared<NiceMock<MockReadFilter>>());
+  EXPECT_EQ(nullptr, server_connection_->spliceableIoHandle());
+  client_connection_->addWriteFilter(std::make_shared<NiceMock<MockWriteFilter>>());
+  EXPECT_EQ(nullptr, client_connection_->spliceableIoHandle());
+
+  disconnect(true);
+}
+
 // Ensure the new counter logic in ReadDisable avoids tripping asserts in ReadDisable guarding
 // against actual enabling twice in a row.
 TEST_P(ConnectionImplTest, ReadDisable) {
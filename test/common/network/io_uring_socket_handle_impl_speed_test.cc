@@ -0,0 +1,151 @@
+// Measures an echo server running on one dispatcher, with the server side of every connection
+// driven either by libevent readiness and readv()/writev() or by io_uring. Each iteration every
+// client sends one message and waits for the echo. Run with --benchmark_counters_tabular=true to
+// compare the round trips per second.
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/event/dispatcher_impl.h"
+#include "common/io/io_uring.h"
+#include "common/network/io_uring_socket_handle_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Network {
+
+class EchoConnection {
+public:
+  EchoConnection(Event::Dispatcher& dispatcher, IoUringWorker* worker) {
+    int fds[2];
+    RELEASE_ASSERT(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0, "");
+    RELEASE_ASSERT(::fcntl(fds[0], F_SETFL, O_NONBLOCK) == 0, "");
+    RELEASE_ASSERT(::fcntl(fds[1], F_SETFL, O_NONBLOCK) == 0, "");
+    if (worker != nullptr) {
+      io_handle_ = std::make_unique<IoUringSocketHandleImpl>(*worker, fds[0]);
+    } else {
+      io_handle_ = std::make_unique<IoSocketHandleImpl>(fds[0]);
+    }
+    client_fd_ = fds[1];
+    file_event_ = io_handle_->createFileEvent(
+        dispatcher, [this](uint32_t events) { onEvent(events); }, Event::FileTriggerType::Edge,
+        Event::FileReadyType::Read | Event::FileReadyType::Write);
+  }
+
+  ~EchoConnection() {
+    file_event_.reset();
+    io_handle_->close();
+    ::close(client_fd_);
+  }
+
+  void send(const std::string& message) {
+    const ssize_t rc = ::write(client_fd_, message.data(), message.size());
+    RELEASE_ASSERT(rc == static_cast<ssize_t>(message.size()), "");
+    outstanding_ += message.size();
+  }
+
+  // @return bool whether the whole echo arrived.
+  bool receive() {
+    char buffer[16384];
+    ssize_t rc;
+    while (outstanding_ > 0 && (rc = ::read(client_fd_, buffer, sizeof(buffer))) > 0) {
+      outstanding_ -= rc;
+    }
+    return outstanding_ == 0;
+  }
+
+private:
+  void onEvent(uint32_t events) {
+    if (events & Event::FileReadyType::Read) {
+      while (true) {
+        Api::IoCallUint64Result result = pending_.read(*io_handle_, 16384);
+        if (!result.ok() || result.rc_ == 0) {
+          break;
+        }
+      }
+    }
+    while (pending_.length() > 0) {
+      Api::IoCallUint64Result result = pending_.write(*io_handle_);
+      if (!result.ok()) {
+        break;
+      }
+    }
+  }
+
+  IoHandlePtr io_handle_;
+  Event::FileEventPtr file_event_;
+  Buffer::OwnedImpl pending_;
+  int client_fd_;
+  uint64_t outstanding_{};
+};
+
+// Arg 0 selects io_uring, arg 1 is the number of connections, arg 2 the message size.
+static void EchoRoundTrip(benchmark::State& state) {
+  if (state.range(0) != 0 && !Io::IoUring::isSupported()) {
+    state.SkipWithError("io_uring is not supported");
+    return;
+  }
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher();
+  IoUringWorkerPtr worker;
+  if (state.range(0) != 0) {
+    worker = std::make_unique<IoUringWorker>(dynamic_cast<Event::DispatcherImpl&>(*dispatcher));
+  }
+
+  std::vector<std::unique_ptr<EchoConnection>> connections;
+  for (int64_t i = 0; i < state.range(1); i++) {
+    connections.emplace_back(std::make_unique<EchoConnection>(*dispatcher, worker.get()));
+  }
+  const std::string message(state.range(2), 'a');
+
+  uint64_t round_trips = 0;
+  for (auto _ : state) {
+    for (auto& connection : connections) {
+      connection->send(message);
+    }
+    size_t done = 0;
+    while (done < connections.size()) {
+      dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+      done = 0;
+      for (auto& connection : connections) {
+        done += connection->receive() ? 1 : 0;
+      }
+    }
+    round_trips += connections.size();
+  }
+
+  state.counters["round_trips_per_second"] =
+      benchmark::Counter(round_trips, benchmark::Counter::kIsRate);
+  if (worker != nullptr) {
+    state.counters["operations_per_submit"] =
+        worker->submitCalls() == 0
+            ? 0
+            : static_cast<double>(worker->submittedOperations()) / worker->submitCalls();
+  }
+  connections.clear();
+}
+BENCHMARK(EchoRoundTrip)
+    ->Args({0, 1, 128})
+    ->Args({1, 1, 128})
+    ->Args({0, 64, 128})
+    ->Args({1, 64, 128})
+    ->Args({0, 256, 4096})
+    ->Args({1, 256, 4096});
+
+} // namespace Network
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,377 @@
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/event/dispatcher_impl.h"
+#include "common/io/io_uring.h"
+#include "common/network/io_uring_socket_handle_impl.h"
+
+#include "test/test_common/test_time.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class IoUringSocketHandleImplTest : public testing::Test {
+protected:
+  IoUringSocketHandleImplTest()
+      : supported_(Io::IoUring::isSupported()), api_(Api::createApiForTest()),
+        dispatcher_(api_->allocateDispatcher()) {
+    if (!supported_) {
+      return;
+    }
+    worker_ = std::make_unique<IoUringWorker>(dispatcherImpl());
+    int fds[2];
+    RELEASE_ASSERT(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0, "");
+    RELEASE_ASSERT(::fcntl(fds[0], F_SETFL, O_NONBLOCK) == 0, "");
+    RELEASE_ASSERT(::fcntl(fds[1], F_SETFL, O_NONBLOCK) == 0, "");
+    io_handle_ = std::make_unique<IoUringSocketHandleImpl>(*worker_, fds[0]);
+    peer_fd_ = fds[1];
+  }
+
+  ~IoUringSocketHandleImplTest() {
+    if (!supported_) {
+      return;
+    }
+    file_event_.reset();
+    if (io_handle_ != nullptr && io_handle_->isOpen()) {
+      io_handle_->close();
+    }
+    io_handle_.reset();
+    worker_.reset();
+    ::close(peer_fd_);
+  }
+
+  Event::DispatcherImpl& dispatcherImpl() {
+    return dynamic_cast<Event::DispatcherImpl&>(*dispatcher_);
+  }
+
+  void createFileEvent(uint32_t events) {
+    file_event_ = io_handle_->createFileEvent(
+        *dispatcher_, [this](uint32_t events) { onFileEvent(events); },
+        Event::FileTriggerType::Edge, events);
+  }
+
+  // Read until EAGAIN, like RawBufferSocket does.
+  void onFileEvent(uint32_t events) {
+    events_ |= events;
+    if (!(events & Event::FileReadyType::Read)) {
+      return;
+    }
+    while (true) {
+      Buffer::OwnedImpl buffer;
+      Api::IoCallUint64Result result = buffer.read(*io_handle_, 4096);
+      if (!result.ok()) {
+        EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+        return;
+      }
+      if (result.rc_ == 0) {
+        eof_ = true;
+        return;
+      }
+      received_ += buffer.toString();
+    }
+  }
+
+  // Write as much of data as the handle accepts.
+  uint64_t writeSome(const std::string& data) {
+    Buffer::RawSlice slice{const_cast<char*>(data.data()), data.size()};
+    Api::IoCallUint64Result result = io_handle_->writev(&slice, 1);
+    if (!result.ok()) {
+      EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+      return 0;
+    }
+    return result.rc_;
+  }
+
+  // Run the loop and read from the peer until expected_size bytes, or EOF if expected_size is
+  // zero, arrived.
+  std::string readFromPeer(uint64_t expected_size) {
+    std::string data;
+    for (int i = 0; i < 10000; i++) {
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+      char buffer[65536];
+      ssize_t rc;
+      while ((rc = ::read(peer_fd_, buffer, sizeof(buffer))) > 0) {
+        data.append(buffer, rc);
+      }
+      if ((expected_size != 0 && data.size() >= expected_size) ||
+          (expected_size == 0 && rc == 0)) {
+        break;
+      }
+    }
+    return data;
+  }
+
+  void runUntil(std::function<bool()> condition) {
+    for (int i = 0; i < 10000 && !condition(); i++) {
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    }
+  }
+
+  // io_uring may be unavailable (old kernel, seccomp), in which case the tests have nothing to do.
+  const bool supported_;
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  std::unique_ptr<IoUringWorker> worker_;
+  std::unique_ptr<IoUringSocketHandleImpl> io_handle_;
+  Event::FileEventPtr file_event_;
+  int peer_fd_{-1};
+  uint32_t events_{};
+  std::string received_;
+  bool eof_{};
+};
+
+// Without a file event the handle does plain system calls.
+TEST_F(IoUringSocketHandleImplTest, PlainIoWithoutFileEvent) {
+  if (!supported_) {
+    return;
+  }
+
+  EXPECT_EQ(2, ::write(peer_fd_, "ab", 2));
+  Buffer::OwnedImpl buffer;
+  Api::IoCallUint64Result result = buffer.read(*io_handle_, 100);
+  EXPECT_EQ(2, result.rc_);
+  EXPECT_EQ("ab", buffer.toString());
+  EXPECT_FALSE(io_handle_->usesIoUring());
+  EXPECT_EQ(0, worker_->submittedOperations());
+}
+
+TEST_F(IoUringSocketHandleImplTest, Read) {
+  if (!supported_) {
+    return;
+  }
+
+  createFileEvent(Event::FileReadyType::Read | Event::FileReadyType::Write);
+  EXPECT_EQ(5, ::write(peer_fd_, "hello", 5));
+  runUntil([this]() { return received_ == "hello"; });
+  EXPECT_EQ("hello", received_);
+  EXPECT_TRUE(io_handle_->usesIoUring());
+
+  EXPECT_EQ(5, ::write(peer_fd_, "world", 5));
+  runUntil([this]() { return received_ == "helloworld"; });
+  EXPECT_EQ("helloworld", received_);
+  EXPECT_GT(worker_->submitCalls(), 0);
+
+  ::shutdown(peer_fd_, SHUT_WR);
+  runUntil([this]() { return eof_; });
+  EXPECT_TRUE(eof_);
+}
+
+// Data that arrives while reads are disabled is reported once they are enabled again.
+TEST_F(IoUringSocketHandleImplTest, ReadDisabled) {
+  if (!supported_) {
+    return;
+  }
+
+  createFileEvent(Event::FileReadyType::Read | Event::FileReadyType::Write);
+  EXPECT_EQ(2, ::write(peer_fd_, "ab", 2));
+  runUntil([this]() { return received_ == "ab"; });
+
+  file_event_->setEnabled(Event::FileReadyType::Write);
+  EXPECT_EQ(2, ::write(peer_fd_, "cd", 2));
+  for (int i = 0; i < 100; i++) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  EXPECT_EQ("ab", received_);
+
+  file_event_->setEnabled(Event::FileReadyType::Read | Event::FileReadyType::Write);
+  runUntil([this]() { return received_ == "abcd"; });
+  EXPECT_EQ("abcd", received_);
+}
+
+// writev() buffers up to the limit, fails with EAGAIN beyond it, and reports Write once the
+// buffer drains.
+TEST_F(IoUringSocketHandleImplTest, WriteBackpressure) {
+  if (!supported_) {
+    return;
+  }
+
+  createFileEvent(Event::FileReadyType::Read | Event::FileReadyType::Write);
+  std::string data(1 << 20, 'a');
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = 'a' + i % 26;
+  }
+
+  uint64_t offset = 0;
+  uint64_t blocked = 0;
+  std::string peer_data;
+  for (int i = 0; i < 100000 && peer_data.size() < data.size(); i++) {
+    while (offset < data.size()) {
+      const uint64_t written = writeSome(data.substr(offset, 100000));
+      if (written == 0) {
+        blocked++;
+        break;
+      }
+      offset += written;
+    }
+    events_ = 0;
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    char buffer[65536];
+    ssize_t rc;
+    while ((rc = ::read(peer_fd_, buffer, sizeof(buffer))) > 0) {
+      peer_data.append(buffer, rc);
+    }
+  }
+  EXPECT_EQ(data, peer_data);
+  EXPECT_GT(blocked, 0);
+}
+
+// shutdown() waits for buffered data to be written.
+TEST_F(IoUringSocketHandleImplTest, ShutdownAfterBufferedWrites) {
+  if (!supported_) {
+    return;
+  }
+
+  createFileEvent(Event::FileReadyType::Read | Event::FileReadyType::Write);
+  const std::string data(60000, 'x');
+  EXPECT_EQ(60000, writeSome(data));
+  EXPECT_EQ(0, io_handle_->shutdown(SHUT_WR).rc_);
+  EXPECT_EQ(data, readFromPeer(0));
+}
+
+// Closing the handle after flushWritesOnClose() flushes buffered writes before the fd is closed.
+TEST_F(IoUringSocketHandleImplTest, CloseFlushesWrites) {
+  if (!supported_) {
+    return;
+  }
+
+  createFileEvent(Event::FileReadyType::Read | Event::FileReadyType::Write);
+  const std::string data(60000, 'x');
+  EXPECT_EQ(60000, writeSome(data));
+  file_event_.reset();
+  io_handle_->flushWritesOnClose();
+  io_handle_->close();
+  EXPECT_FALSE(io_handle_->isOpen());
+  EXPECT_EQ(data, readFromPeer(0));
+}
+
+// Otherwise closing the handle cancels buffered writes and closes the fd right away.
+TEST_F(IoUringSocketHandleImplTest, CloseDropsWrites) {
+  if (!supported_) {
+    return;
+  }
+
+  // Fill the socket buffers so that a write stays in flight.
+  createFileEvent(Event::FileReadyType::Read | Event::FileReadyType::Write);
+  const std::string data(65536, 'x');
+  uint64_t written = 0;
+  for (int i = 0; i < 1000; i++) {
+    const uint64_t accepted = writeSome(data);
+    if (accepted == 0) {
+      break;
+    }
+    written += accepted;
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  file_event_.reset();
+  io_handle_->close();
+  EXPECT_LT(readFromPeer(0).size(), written);
+}
+
+// Destroying the worker cancels the writes of closed sockets that can not make progress.
+TEST_F(IoUringSocketHandleImplTest, WorkerDestroyedWithStuckWrites) {
+  if (!supported_) {
+    return;
+  }
+
+  createFileEvent(Event::FileReadyType::Read | Event::FileReadyType::Write);
+  const std::string data(1 << 20, 'x');
+  for (int i = 0; i < 50; i++) {
+    writeSome(data);
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  file_event_.reset();
+  io_handle_->close();
+  worker_.reset();
+}
+
+// Sockets keep working when a small ring can not hold all of their operations at once and their
+// completions overflow the completion queue.
+TEST(IoUringWorkerTest, OperationsOverflowSmallRing) {
+  if (!Io::IoUring::isSupported()) {
+    return;
+  }
+
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher();
+  auto worker =
+      std::make_unique<IoUringWorker>(dynamic_cast<Event::DispatcherImpl&>(*dispatcher), 1);
+  constexpr int NumSockets = 16;
+  std::vector<std::unique_ptr<IoUringSocketHandleImpl>> handles;
+  std::vector<Event::FileEventPtr> file_events;
+  std::vector<int> peer_fds;
+  std::vector<std::string> received(NumSockets);
+  for (int i = 0; i < NumSockets; i++) {
+    int fds[2];
+    RELEASE_ASSERT(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0, "");
+    RELEASE_ASSERT(::fcntl(fds[0], F_SETFL, O_NONBLOCK) == 0, "");
+    handles.push_back(std::make_unique<IoUringSocketHandleImpl>(*worker, fds[0]));
+    peer_fds.push_back(fds[1]);
+    IoUringSocketHandleImpl& handle = *handles.back();
+    std::string& data = received[i];
+    file_events.push_back(handle.createFileEvent(
+        *dispatcher,
+        [&handle, &data](uint32_t) {
+          Buffer::OwnedImpl buffer;
+          while (buffer.read(handle, 4096).rc_ > 0) {
+          }
+          data += buffer.toString();
+        },
+        Event::FileTriggerType::Edge, Event::FileReadyType::Read | Event::FileReadyType::Write));
+    // Engage the handle, which queues a read and a write on the one entry ring.
+    Buffer::RawSlice slice{const_cast<char*>("ping"), 4};
+    EXPECT_EQ(4, handle.writev(&slice, 1).rc_);
+  }
+
+  for (int i = 0; i < NumSockets; i++) {
+    EXPECT_EQ(4, ::write(peer_fds[i], "pong", 4));
+  }
+  auto done = [&]() {
+    return std::all_of(received.begin(), received.end(),
+                       [](const std::string& data) { return data == "pong"; });
+  };
+  for (int i = 0; i < 10000 && !done(); i++) {
+    dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  EXPECT_TRUE(done());
+  EXPECT_EQ(0, worker->overflowedOperations());
+  for (int i = 0; i < NumSockets; i++) {
+    char buffer[8];
+    EXPECT_EQ(4, ::read(peer_fds[i], buffer, sizeof(buffer)));
+    EXPECT_EQ("ping", std::string(buffer, 4));
+  }
+
+  file_events.clear();
+  for (auto& handle : handles) {
+    handle->close();
+  }
+  handles.clear();
+  worker.reset();
+  for (int fd : peer_fds) {
+    ::close(fd);
+  }
+}
+
+TEST(DispatcherIoUringTest, WorkerFollowsSelection) {
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher();
+  auto& dispatcher_impl = dynamic_cast<Event::DispatcherImpl&>(*dispatcher);
+  EXPECT_EQ(nullptr, dispatcher_impl.ioUringWorker());
+
+  Event::GlobalTimeSystem time_system;
+  Event::DispatcherImpl io_uring_dispatcher(*api, time_system, true);
+  EXPECT_EQ(Io::IoUring::isSupported(), io_uring_dispatcher.ioUringWorker() != nullptr);
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,294 @@
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/network/io_socket_handle_impl.h"
+#include "common/network/raw_buffer_socket.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/mocks/network/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+TEST(ReadSizerTest, GrowsOnFullReads) {
+  ReadSizer sizer;
+  EXPECT_EQ(ReadSizer::InitialReadSize, sizer.readSize());
+  sizer.onRead(ReadSizer::InitialReadSize);
+  EXPECT_EQ(2 * ReadSizer::InitialReadSize, sizer.readSize());
+
+  for (int i = 0; i < 10; i++) {
+    sizer.onRead(sizer.readSize());
+  }
+  EXPECT_EQ(ReadSizer::MaxReadSize, sizer.readSize());
+}
+
+TEST(ReadSizerTest, ShrinksOnRepeatedSmallReads) {
+  ReadSizer sizer;
+
+  // A single small read, or small reads that are not consecutive, keep the size.
+  sizer.onRead(100);
+  EXPECT_EQ(ReadSizer::InitialReadSize, sizer.readSize());
+  sizer.onRead(ReadSizer::InitialReadSize - 1);
+  sizer.onRead(100);
+  EXPECT_EQ(ReadSizer::InitialReadSize, sizer.readSize());
+
+  sizer.onRead(100);
+  EXPECT_EQ(ReadSizer::InitialReadSize / 2, sizer.readSize());
+
+  for (int i = 0; i < 10; i++) {
+    sizer.onRead(100);
+  }
+  EXPECT_EQ(ReadSizer::MinReadSize, sizer.readSize());
+}
+
+class RawBufferSocketTest : public testing::Test {
+public:
+  RawBufferSocketTest() : factory_(store_) {
+    int fds[2];
+    RELEASE_ASSERT(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0, "");
+    RELEASE_ASSERT(::fcntl(fds[0], F_SETFL, O_NONBLOCK) == 0, "");
+    io_handle_ = std::make_unique<IoSocketHandleImpl>(fds[0]);
+    peer_fd_ = fds[1];
+    ON_CALL(callbacks_, ioHandle()).WillByDefault(ReturnRef(*io_handle_));
+    socket_ = factory_.createTransportSocket(nullptr);
+    socket_->setTransportSocketCallbacks(callbacks_);
+  }
+  ~RawBufferSocketTest() { ::close(peer_fd_); }
+
+  void writeToPeer(uint64_t length) {
+    const std::string data(length, 'a');
+    ASSERT_EQ(static_cast<ssize_t>(length), ::write(peer_fd_, data.data(), data.size()));
+  }
+
+  uint64_t counter(const std::string& name) {
+    return store_.counter("raw_buffer." + name).value();
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  RawBufferSocketFactory factory_;
+  std::unique_ptr<IoSocketHandleImpl> io_handle_;
+  int peer_fd_;
+  NiceMock<MockTransportSocketCallbacks> callbacks_;
+  TransportSocketPtr socket_;
+};
+
+TEST_F(RawBufferSocketTest, ReadGrowsAndCountsSyscalls) {
+  // 16K and 32K reads fill up and grow the read size, a 64K read returns the last 16K and one
+  // more read finds the socket drained.
+  writeToPeer(65536);
+  Buffer::OwnedImpl buffer;
+  IoResult result = socket_->doRead(buffer);
+  EXPECT_EQ(PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ(65536, result.bytes_processed_);
+  EXPECT_FALSE(result.end_stream_read_);
+  EXPECT_EQ(65536, buffer.length());
+  EXPECT_EQ(65536, counter("read_bytes"));
+  EXPECT_EQ(4, counter("read_syscalls"));
+  EXPECT_EQ(4 * ReadSizer::InitialReadSize,
+            dynamic_cast<RawBufferSocket&>(*socket_).readSize());
+
+  ::shutdown(peer_fd_, SHUT_WR);
+  result = socket_->doRead(buffer);
+  EXPECT_TRUE(result.end_stream_read_);
+  EXPECT_EQ(5, counter("read_syscalls"));
+}
+
+// Reads stop at the connection's buffer limit, or a default sized read past it, even once they
+// have grown larger.
+TEST_F(RawBufferSocketTest, ReadSizeLimitedByBufferLimit) {
+  writeToPeer(65536);
+  Buffer::OwnedImpl buffer;
+  socket_->doRead(buffer);
+  ASSERT_EQ(4 * ReadSizer::InitialReadSize,
+            dynamic_cast<RawBufferSocket&>(*socket_).readSize());
+
+  // 20K leaves room for a 20K read, after which the buffer is over the limit and the next read
+  // is a default sized one.
+  ON_CALL(callbacks_.connection_, bufferLimit()).WillByDefault(Return(20480));
+  EXPECT_CALL(callbacks_, shouldDrainReadBuffer())
+      .WillOnce(Return(false))
+      .WillOnce(Return(true));
+  buffer.drain(buffer.length());
+  writeToPeer(65536);
+  socket_->doRead(buffer);
+  EXPECT_EQ(20480 + ReadSizer::InitialReadSize, buffer.length());
+  // Full reads that were cut short don't change the read size.
+  EXPECT_EQ(4 * ReadSizer::InitialReadSize,
+            dynamic_cast<RawBufferSocket&>(*socket_).readSize());
+}
+
+TEST_F(RawBufferSocketTest, WriteCountsSyscalls) {
+  Buffer::OwnedImpl buffer(std::string(1000, 'a'));
+  IoResult result = socket_->doWrite(buffer, false);
+  EXPECT_EQ(PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ(1000, result.bytes_processed_);
+  EXPECT_EQ(1000, counter("write_bytes"));
+  EXPECT_EQ(1, counter("write_syscalls"));
+}
+
+// Zero copy is only supported on TCP sockets, so unix sockets always copy.
+TEST_F(RawBufferSocketTest, ZerocopyUnavailable) {
+  RawBufferSocketFactory factory(store_, 1);
+  TransportSocketPtr socket = factory.createTransportSocket(nullptr);
+  socket->setTransportSocketCallbacks(callbacks_);
+
+  Buffer::OwnedImpl buffer(std::string(1000, 'a'));
+  IoResult result = socket->doWrite(buffer, false);
+  EXPECT_EQ(1000, result.bytes_processed_);
+  EXPECT_EQ(0, buffer.length());
+  EXPECT_EQ(0, dynamic_cast<RawBufferSocket&>(*socket).pinnedBytes());
+}
+
+// A plain socket handle that can be made to disallow direct fd I/O, as a handle that switched to
+// io_uring does.
+class TestIoSocketHandle : public IoSocketHandleImpl {
+public:
+  using IoSocketHandleImpl::IoSocketHandleImpl;
+
+  bool allowsDirectFdIo() const override { return allows_direct_fd_io_; }
+
+  bool allows_direct_fd_io_{true};
+};
+
+class RawBufferSocketZerocopyTest : public testing::Test {
+public:
+  RawBufferSocketZerocopyTest() : factory_(store_, 4096) {
+    const int listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    RELEASE_ASSERT(listen_fd >= 0, "");
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t address_length = sizeof(address);
+    RELEASE_ASSERT(::bind(listen_fd, reinterpret_cast<sockaddr*>(&address), address_length) == 0,
+                   "");
+    RELEASE_ASSERT(::listen(listen_fd, 1) == 0, "");
+    RELEASE_ASSERT(
+        ::getsockname(listen_fd, reinterpret_cast<sockaddr*>(&address), &address_length) == 0, "");
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    RELEASE_ASSERT(::connect(fd, reinterpret_cast<sockaddr*>(&address), address_length) == 0, "");
+    peer_fd_ = ::accept(listen_fd, nullptr, nullptr);
+    RELEASE_ASSERT(peer_fd_ >= 0, "");
+    ::close(listen_fd);
+    RELEASE_ASSERT(::fcntl(fd, F_SETFL, O_NONBLOCK) == 0, "");
+    RELEASE_ASSERT(::fcntl(peer_fd_, F_SETFL, O_NONBLOCK) == 0, "");
+
+    io_handle_ = std::make_unique<TestIoSocketHandle>(fd);
+    ON_CALL(callbacks_, ioHandle()).WillByDefault(ReturnRef(*io_handle_));
+    socket_ = factory_.createTransportSocket(nullptr);
+    socket_->setTransportSocketCallbacks(callbacks_);
+  }
+  ~RawBufferSocketZerocopyTest() { ::close(peer_fd_); }
+
+  uint64_t pinnedBytes() { return dynamic_cast<RawBufferSocket&>(*socket_).pinnedBytes(); }
+
+  uint64_t counter(const std::string& name) {
+    return store_.counter("raw_buffer." + name).value();
+  }
+
+  std::string readFromPeer() {
+    std::string data;
+    char chunk[65536];
+    ssize_t rc;
+    while ((rc = ::read(peer_fd_, chunk, sizeof(chunk))) > 0) {
+      data.append(chunk, rc);
+    }
+    return data;
+  }
+
+  // Write until the kernel has released all pinned bytes. The peer acknowledges everything it
+  // receives right away on loopback.
+  void writeUntilReleased(Buffer::Instance& buffer) {
+    for (int i = 0; i < 1000 && pinnedBytes() > 0; i++) {
+      socket_->doWrite(buffer, false);
+      ::usleep(1000);
+    }
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  RawBufferSocketFactory factory_;
+  std::unique_ptr<TestIoSocketHandle> io_handle_;
+  int peer_fd_;
+  NiceMock<MockTransportSocketCallbacks> callbacks_;
+  TransportSocketPtr socket_;
+};
+
+// Large writes stay in the buffer until the kernel reports them complete. Loopback cannot send
+// from user memory, so the kernel reports the bytes as copied.
+TEST_F(RawBufferSocketZerocopyTest, PinsUntilCompleted) {
+  Buffer::OwnedImpl buffer(std::string(65536, 'a'));
+  IoResult result = socket_->doWrite(buffer, false);
+  if (pinnedBytes() == 0) {
+    // SO_ZEROCOPY is not supported by this kernel.
+    EXPECT_EQ(0, buffer.length());
+    return;
+  }
+  EXPECT_EQ(PostIoAction::KeepOpen, result.action_);
+  EXPECT_EQ(65536, result.bytes_processed_);
+  EXPECT_EQ(65536, buffer.length());
+  EXPECT_EQ(65536, pinnedBytes());
+  EXPECT_EQ(std::string(65536, 'a'), readFromPeer());
+
+  writeUntilReleased(buffer);
+  EXPECT_EQ(0, pinnedBytes());
+  EXPECT_EQ(0, buffer.length());
+  EXPECT_EQ(65536, counter("write_zerocopy_copied_bytes") + counter("write_zerocopy_bytes"));
+  EXPECT_EQ(65536, counter("write_bytes"));
+}
+
+// Small writes are copied, and if pinned bytes are still ahead of them they are drained only once
+// those are released. End of stream is sent without waiting for the release.
+TEST_F(RawBufferSocketZerocopyTest, SmallWriteAfterLarge) {
+  Buffer::OwnedImpl buffer(std::string(8192, 'a'));
+  socket_->doWrite(buffer, false);
+  if (pinnedBytes() == 0) {
+    return;
+  }
+
+  buffer.add(std::string(100, 'b'));
+  IoResult result = socket_->doWrite(buffer, true);
+  EXPECT_EQ(100, result.bytes_processed_);
+  EXPECT_EQ(buffer.length(), pinnedBytes());
+  EXPECT_EQ(std::string(8192, 'a') + std::string(100, 'b'), readFromPeer());
+  char byte;
+  EXPECT_EQ(0, ::read(peer_fd_, &byte, 1));
+
+  writeUntilReleased(buffer);
+  EXPECT_EQ(0, buffer.length());
+  EXPECT_EQ(8192, counter("write_zerocopy_copied_bytes") + counter("write_zerocopy_bytes"));
+  EXPECT_EQ(8292, counter("write_bytes"));
+}
+
+// Once the handle no longer allows direct fd I/O, large writes are copied through the handle.
+TEST_F(RawBufferSocketZerocopyTest, HandleModeChange) {
+  Buffer::OwnedImpl buffer(std::string(8192, 'a'));
+  socket_->doWrite(buffer, false);
+  if (pinnedBytes() == 0) {
+    return;
+  }
+  writeUntilReleased(buffer);
+  EXPECT_EQ(0, buffer.length());
+
+  io_handle_->allows_direct_fd_io_ = false;
+  buffer.add(std::string(8192, 'b'));
+  IoResult result = socket_->doWrite(buffer, false);
+  EXPECT_EQ(8192, result.bytes_processed_);
+  EXPECT_EQ(0, pinnedBytes());
+  EXPECT_EQ(0, buffer.length());
+  EXPECT_EQ(std::string(8192, 'a') + std::string(8192, 'b'), readFromPeer());
+  EXPECT_EQ(8192, counter("write_zerocopy_copied_bytes") + counter("write_zerocopy_bytes"));
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
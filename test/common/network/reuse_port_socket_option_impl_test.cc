@@ -0,0 +1,64 @@
+#ifdef __linux__
+#include <linux/filter.h>
+#endif
+
+#include "common/network/reuse_port_socket_option_impl.h"
+
+#include "test/common/network/socket_option_test.h"
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class ReusePortCpuSteeringSocketOptionImplTest : public SocketOptionTest {};
+
+// The program is only attached once the socket is bound.
+TEST_F(ReusePortCpuSteeringSocketOptionImplTest, OnlySetWhenBound) {
+  ReusePortCpuSteeringSocketOptionImpl socket_option{4};
+  EXPECT_CALL(os_sys_calls_, setsockopt_(_, _, _, _, _)).Times(0);
+  EXPECT_TRUE(
+      socket_option.setOption(socket_, envoy::api::v2::core::SocketOption::STATE_PREBIND));
+  EXPECT_TRUE(
+      socket_option.setOption(socket_, envoy::api::v2::core::SocketOption::STATE_LISTENING));
+  EXPECT_FALSE(socket_option
+                   .getOptionDetails(socket_, envoy::api::v2::core::SocketOption::STATE_PREBIND)
+                   .has_value());
+}
+
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+// The attached program returns the receiving CPU modulo the group size.
+TEST_F(ReusePortCpuSteeringSocketOptionImplTest, AttachProgram) {
+  ReusePortCpuSteeringSocketOptionImpl socket_option{4};
+  EXPECT_CALL(os_sys_calls_,
+              setsockopt_(_, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, _, sizeof(sock_fprog)))
+      .WillOnce(Invoke([](int, int, int, const void* optval, socklen_t) -> int {
+        const sock_fprog* program = static_cast<const sock_fprog*>(optval);
+        EXPECT_EQ(3, program->len);
+        EXPECT_EQ(static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU), program->filter[0].k);
+        EXPECT_EQ(BPF_ALU | BPF_MOD | BPF_K, program->filter[1].code);
+        EXPECT_EQ(4, program->filter[1].k);
+        EXPECT_EQ(BPF_RET | BPF_A, program->filter[2].code);
+        return 0;
+      }));
+  EXPECT_TRUE(socket_option.setOption(socket_, envoy::api::v2::core::SocketOption::STATE_BOUND));
+
+  auto details =
+      socket_option.getOptionDetails(socket_, envoy::api::v2::core::SocketOption::STATE_BOUND);
+  ASSERT_TRUE(details.has_value());
+  EXPECT_EQ(ENVOY_SOCKET_SO_ATTACH_REUSEPORT_CBPF, details->name_);
+}
+
+// Failing to attach the program fails the option.
+TEST_F(ReusePortCpuSteeringSocketOptionImplTest, AttachFailure) {
+  ReusePortCpuSteeringSocketOptionImpl socket_option{4};
+  EXPECT_CALL(os_sys_calls_, setsockopt_(_, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, _, _))
+      .WillOnce(Return(-1));
+  EXPECT_LOG_CONTAINS("warning", "Attaching reuse port CPU steering program failed",
+                      EXPECT_FALSE(socket_option.setOption(
+                          socket_, envoy::api::v2::core::SocketOption::STATE_BOUND)));
+}
+#endif
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -7,10 +7,12 @@
 #include "common/network/utility.h"
 
 #include "test/common/network/listener_impl_test_base.h"
+#include "test/mocks/api/mocks.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/server/mocks.h"
 #include "test/test_common/environment.h"
 #include "test/test_common/network_utility.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -18,6 +20,7 @@
 
 using testing::_;
 using testing::Invoke;
+using testing::NiceMock;
 using testing::Return;
 
 namespace Envoy {
@@ -51,6 +54,19 @@ protected:
 
     return nullptr;
   }
+
+  // Receive a datagram on a client socket, retrying for up to ~100ms.
+  std::string recvDatagram(Socket& socket) {
+    char buffer[256];
+    for (int retry = 0; retry < 10; retry++) {
+      const ssize_t rc = ::recv(socket.ioHandle().fd(), buffer, sizeof(buffer), 0);
+      if (rc >= 0) {
+        return std::string(buffer, rc);
+      }
+      ::usleep(10000);
+    }
+    return "";
+  }
 };
 INSTANTIATE_TEST_CASE_P(IpVersions, UdpListenerImplTest,
                         testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
@@ -143,6 +159,47 @@ TEST_P(UdpListenerImplTest, UseActualDstUdp) {
   dispatcher_->run(Event::Dispatcher::RunType::Block);
 }
 
+/**
+ * Tests that datagrams received in recvmmsg batches are delivered in order.
+ */
+TEST_P(UdpListenerImplTest, BatchedReceive) {
+  SocketPtr server_socket =
+      getSocket(Address::SocketType::Datagram, Network::Test::getCanonicalLoopbackAddress(version_),
+                nullptr, true);
+  ASSERT_NE(server_socket, nullptr);
+
+  Network::MockUdpListenerCallbacks listener_callbacks;
+  UdpListenerImpl listener(dispatcherImpl(), *server_socket, listener_callbacks, true);
+
+  SocketPtr client_socket =
+      getSocket(Address::SocketType::Datagram, Network::Test::getCanonicalLoopbackAddress(version_),
+                nullptr, false);
+
+  const std::vector<std::string> payloads{"first", "second", "third"};
+  for (const std::string& payload : payloads) {
+    Buffer::RawSlice slice{const_cast<char*>(payload.data()), payload.length()};
+    auto send_rc = client_socket->ioHandle().sendto(slice, 0, *server_socket->localAddress());
+    ASSERT_EQ(send_rc.rc_, payload.length());
+  }
+
+  std::vector<std::string> received;
+  EXPECT_CALL(listener_callbacks, onData_(_))
+      .Times(3)
+      .WillRepeatedly(Invoke([&](const UdpRecvData& data) -> void {
+        EXPECT_EQ(data.peer_address_->ip()->addressAsString(),
+                  client_socket->localAddress()->ip()->addressAsString());
+        EXPECT_EQ(*data.local_address_, *server_socket->localAddress());
+        received.push_back(data.buffer_->toString());
+        if (received.size() == payloads.size()) {
+          dispatcher_->exit();
+        }
+      }));
+  EXPECT_CALL(listener_callbacks, onWriteReady_(_)).Times(testing::AnyNumber());
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(payloads, received);
+}
+
 /**
  * Tests UDP listener for read and write callbacks with actual data.
  */
@@ -509,6 +566,93 @@ TEST_P(UdpListenerImplTest, SendDataError) {
   dispatcher_->exit();
 }
 
+/**
+ * Tests that a batch of datagrams is sent with sendmmsg and each buffer is drained.
+ */
+TEST_P(UdpListenerImplTest, SendBatch) {
+  SocketPtr server_socket =
+      getSocket(Address::SocketType::Datagram, Network::Test::getCanonicalLoopbackAddress(version_),
+                nullptr, true);
+  Network::MockUdpListenerCallbacks server_listener_callbacks;
+  UdpListenerImpl server_listener(dispatcherImpl(), *server_socket, server_listener_callbacks);
+
+  SocketPtr client_socket =
+      getSocket(Address::SocketType::Datagram, Network::Test::getCanonicalLoopbackAddress(version_),
+                nullptr, true);
+
+  Buffer::OwnedImpl first("hello");
+  Buffer::OwnedImpl second("world");
+  const std::vector<UdpSendData> batch{{client_socket->localAddress(), first},
+                                       {client_socket->localAddress(), second}};
+  auto send_result = server_listener.sendBatch(batch);
+  EXPECT_TRUE(send_result.ok());
+  EXPECT_EQ(2, send_result.rc_);
+  EXPECT_EQ(0, first.length());
+  EXPECT_EQ(0, second.length());
+
+  EXPECT_EQ("hello", recvDatagram(*client_socket));
+  EXPECT_EQ("world", recvDatagram(*client_socket));
+}
+
+/**
+ * Tests that sendBatch falls back to one sendmsg per datagram without sendmmsg.
+ */
+TEST_P(UdpListenerImplTest, SendBatchWithoutSendmmsg) {
+  SocketPtr server_socket =
+      getSocket(Address::SocketType::Datagram, Network::Test::getCanonicalLoopbackAddress(version_),
+                nullptr, true);
+  Network::MockUdpListenerCallbacks server_listener_callbacks;
+  UdpListenerImpl server_listener(dispatcherImpl(), *server_socket, server_listener_callbacks);
+
+  SocketPtr client_socket =
+      getSocket(Address::SocketType::Datagram, Network::Test::getCanonicalLoopbackAddress(version_),
+                nullptr, true);
+
+  NiceMock<Api::MockOsSysCalls> os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  EXPECT_CALL(os_sys_calls, sendmmsg(_, _, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, ENOSYS}));
+
+  Buffer::OwnedImpl first("hello");
+  Buffer::OwnedImpl second("world");
+  const std::vector<UdpSendData> batch{{client_socket->localAddress(), first},
+                                       {client_socket->localAddress(), second}};
+  auto send_result = server_listener.sendBatch(batch);
+  EXPECT_TRUE(send_result.ok());
+  EXPECT_EQ(2, send_result.rc_);
+
+  // sendmmsg is not tried again.
+  Buffer::OwnedImpl third("again");
+  send_result = server_listener.sendBatch({{client_socket->localAddress(), third}});
+  EXPECT_EQ(1, send_result.rc_);
+
+  EXPECT_EQ("hello", recvDatagram(*client_socket));
+  EXPECT_EQ("world", recvDatagram(*client_socket));
+  EXPECT_EQ("again", recvDatagram(*client_socket));
+}
+
+/**
+ * Tests that a send error on the first datagram of a batch is returned to the caller.
+ */
+TEST_P(UdpListenerImplTest, SendBatchError) {
+  SocketPtr server_socket =
+      getSocket(Address::SocketType::Datagram, Network::Test::getCanonicalLoopbackAddress(version_),
+                nullptr, true);
+  Network::MockUdpListenerCallbacks server_listener_callbacks;
+  UdpListenerImpl server_listener(dispatcherImpl(), *server_socket, server_listener_callbacks);
+
+  NiceMock<Api::MockOsSysCalls> os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  EXPECT_CALL(os_sys_calls, sendmmsg(_, _, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, EAGAIN}));
+
+  Buffer::OwnedImpl first("hello");
+  auto send_result = server_listener.sendBatch({{server_socket->localAddress(), first}});
+  EXPECT_FALSE(send_result.ok());
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again, send_result.err_->getErrorCode());
+  EXPECT_EQ(5, first.length());
+}
+
 } // namespace
 } // namespace Network
 } // namespace Envoy
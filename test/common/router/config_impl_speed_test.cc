@@ -0,0 +1,210 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+#include <vector>
+
+#include "envoy/api/v2/rds.pb.h"
+
+#include "common/router/config_impl.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+#include "gmock/gmock.h"
+
+namespace Envoy {
+namespace Router {
+
+using testing::NiceMock;
+using testing::ReturnRef;
+
+class ConfigImplSpeedTest {
+public:
+  ConfigImplSpeedTest() : api_(Api::createApiForTest()) {
+    ON_CALL(factory_context_, api()).WillByDefault(ReturnRef(*api_));
+  }
+
+  // Builds a route configuration with one virtual host per tenant. Each virtual host owns a suffix
+  // wildcard "*.tenant<N>.example.com" and a prefix wildcard "api-<N>.*", plus a catch-all virtual
+  // host so that misses are routed too.
+  std::unique_ptr<ConfigImpl> wildcardConfig(uint64_t num_tenants) {
+    envoy::api::v2::RouteConfiguration route_config;
+    for (uint64_t i = 0; i < num_tenants; i++) {
+      auto* virtual_host = route_config.add_virtual_hosts();
+      virtual_host->set_name(fmt::format("tenant{}", i));
+      virtual_host->add_domains(fmt::format("*.tenant{}.example.com", i));
+      virtual_host->add_domains(fmt::format("api-{}.*", i));
+      addCatchAllRoute(*virtual_host, virtual_host->name());
+    }
+    auto* default_host = route_config.add_virtual_hosts();
+    default_host->set_name("default");
+    default_host->add_domains("*");
+    addCatchAllRoute(*default_host, "default");
+    return std::make_unique<ConfigImpl>(route_config, factory_context_, false);
+  }
+
+  // Builds a single virtual host with one regex route per service, in the shape of
+  // "/api/v<N>/service<M>/[0-9]+/details". Routes are either std::regex or RE2 based.
+  std::unique_ptr<ConfigImpl> regexConfig(uint64_t num_routes, bool safe_regex) {
+    envoy::api::v2::RouteConfiguration route_config;
+    auto* virtual_host = route_config.add_virtual_hosts();
+    virtual_host->set_name("regex");
+    virtual_host->add_domains("*");
+    for (uint64_t i = 0; i < num_routes; i++) {
+      auto* route = virtual_host->add_routes();
+      const std::string regex = fmt::format("/api/v{}/service{}/[0-9]+/details", i % 3, i);
+      if (safe_regex) {
+        route->mutable_match()->mutable_safe_regex()->mutable_google_re2();
+        route->mutable_match()->mutable_safe_regex()->set_regex(regex);
+      } else {
+        route->mutable_match()->set_regex(regex);
+      }
+      route->mutable_route()->set_cluster(fmt::format("service{}", i));
+    }
+    return std::make_unique<ConfigImpl>(route_config, factory_context_, false);
+  }
+
+  // Builds a single virtual host with, for each service, an exact path route for
+  // "/service<N>/health" followed by a prefix route for "/service<N>/". The catch-all prefix route
+  // is last.
+  std::unique_ptr<ConfigImpl> prefixConfig(uint64_t num_services) {
+    envoy::api::v2::RouteConfiguration route_config;
+    auto* virtual_host = route_config.add_virtual_hosts();
+    virtual_host->set_name("services");
+    virtual_host->add_domains("*");
+    for (uint64_t i = 0; i < num_services; i++) {
+      auto* path_route = virtual_host->add_routes();
+      path_route->mutable_match()->set_path(fmt::format("/service{}/health", i));
+      path_route->mutable_route()->set_cluster("health");
+      auto* prefix_route = virtual_host->add_routes();
+      prefix_route->mutable_match()->set_prefix(fmt::format("/service{}/", i));
+      prefix_route->mutable_route()->set_cluster(fmt::format("service{}", i));
+    }
+    addCatchAllRoute(*virtual_host, "default");
+    return std::make_unique<ConfigImpl>(route_config, factory_context_, false);
+  }
+
+  static void addCatchAllRoute(envoy::api::v2::route::VirtualHost& virtual_host,
+                               const std::string& cluster) {
+    auto* route = virtual_host.add_routes();
+    route->mutable_match()->set_prefix("/");
+    route->mutable_route()->set_cluster(cluster);
+  }
+
+  static Http::TestHeaderMapImpl genHeaders(const std::string& host,
+                                            const std::string& path = "/") {
+    return Http::TestHeaderMapImpl{
+        {":authority", host}, {":path", path}, {":method", "GET"}, {"x-forwarded-proto", "http"}};
+  }
+
+  Api::ApiPtr api_;
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context_;
+};
+
+static void runWildcardLookup(benchmark::State& state,
+                              const std::function<std::string(uint64_t)>& host_for_tenant) {
+  ConfigImplSpeedTest context;
+  const uint64_t num_tenants = state.range(0);
+  std::unique_ptr<ConfigImpl> config = context.wildcardConfig(num_tenants);
+
+  std::vector<Http::TestHeaderMapImpl> requests;
+  for (uint64_t i = 0; i < 1024; i++) {
+    requests.push_back(ConfigImplSpeedTest::genHeaders(host_for_tenant((i * 7919) % num_tenants)));
+  }
+
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(config->route(requests[i++ % requests.size()], 0));
+  }
+}
+
+static void BM_WildcardSuffixLookup(benchmark::State& state) {
+  runWildcardLookup(state, [](uint64_t tenant) {
+    return fmt::format("www.tenant{}.example.com", tenant);
+  });
+}
+BENCHMARK(BM_WildcardSuffixLookup)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+
+static void BM_WildcardPrefixLookup(benchmark::State& state) {
+  runWildcardLookup(state, [](uint64_t tenant) { return fmt::format("api-{}.lyft.com", tenant); });
+}
+BENCHMARK(BM_WildcardPrefixLookup)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+
+static void BM_WildcardMissLookup(benchmark::State& state) {
+  runWildcardLookup(state, [](uint64_t tenant) {
+    return fmt::format("www.tenant{}.example.org", tenant);
+  });
+}
+BENCHMARK(BM_WildcardMissLookup)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+
+static void BM_WildcardConfigLoad(benchmark::State& state) {
+  ConfigImplSpeedTest context;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(context.wildcardConfig(state.range(0)));
+  }
+}
+BENCHMARK(BM_WildcardConfigLoad)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+// The route count doubles the service count (one exact path and one prefix route per service).
+// With the route index, lookup time should stay roughly flat as the route table grows.
+static void BM_PrefixRouteLookup(benchmark::State& state) {
+  ConfigImplSpeedTest context;
+  const uint64_t num_services = state.range(0);
+  std::unique_ptr<ConfigImpl> config = context.prefixConfig(num_services);
+
+  std::vector<Http::TestHeaderMapImpl> requests;
+  for (uint64_t i = 0; i < 1024; i++) {
+    const uint64_t service = (i * 7919) % num_services;
+    const std::string path = i % 4 == 0 ? fmt::format("/service{}/health", service)
+                                        : fmt::format("/service{}/users/{}?x=y", service, i);
+    requests.push_back(ConfigImplSpeedTest::genHeaders("www.lyft.com", path));
+  }
+
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(config->route(requests[i++ % requests.size()], 0));
+  }
+}
+BENCHMARK(BM_PrefixRouteLookup)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+
+static void runRegexLookup(benchmark::State& state, bool safe_regex) {
+  ConfigImplSpeedTest context;
+  const uint64_t num_routes = state.range(0);
+  std::unique_ptr<ConfigImpl> config = context.regexConfig(num_routes, safe_regex);
+
+  // Requests are spread over the whole table so that, on average, half of the routes are tried
+  // before a match is found.
+  std::vector<Http::TestHeaderMapImpl> requests;
+  for (uint64_t i = 0; i < 1024; i++) {
+    const uint64_t service = (i * 7919) % num_routes;
+    requests.push_back(ConfigImplSpeedTest::genHeaders(
+        "www.lyft.com",
+        fmt::format("/api/v{}/service{}/{}/details?verbose=true", service % 3, service, i)));
+  }
+
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(config->route(requests[i++ % requests.size()], 0));
+  }
+}
+
+static void BM_StdRegexRouteLookup(benchmark::State& state) { runRegexLookup(state, false); }
+BENCHMARK(BM_StdRegexRouteLookup)->Arg(10)->Arg(100)->Arg(1000);
+
+static void BM_GoogleReRouteLookup(benchmark::State& state) { runRegexLookup(state, true); }
+BENCHMARK(BM_GoogleReRouteLookup)->Arg(10)->Arg(100)->Arg(1000);
+
+} // namespace Router
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
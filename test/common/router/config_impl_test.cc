@@ -611,6 +611,53 @@ virtual_hosts:
                           EnvoyException, "Invalid regex '\\^/\\(\\+invalid\\)':");
 }
 
+TEST_F(RouteMatcherTest, TestRoutesWithSafeRegex) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: regex
+    domains: ["*"]
+    routes:
+      - match:
+          safe_regex:
+            google_re2: {}
+            regex: "/api/v[0-9]+/users/[0-9]+"
+        route: { cluster: "users" }
+      - match: { prefix: "/" }
+        route: { cluster: "default" }
+  )EOF";
+
+  TestConfigImpl config(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, true);
+
+  EXPECT_EQ("users", config.route(genHeaders("www.lyft.com", "/api/v1/users/123?foo=bar", "GET"), 0)
+                         ->routeEntry()
+                         ->clusterName());
+  EXPECT_EQ("default", config.route(genHeaders("www.lyft.com", "/api/v1/users/abc", "GET"), 0)
+                           ->routeEntry()
+                           ->clusterName());
+  EXPECT_EQ("default", config.route(genHeaders("www.lyft.com", "/foo/api/v1/users/1", "GET"), 0)
+                           ->routeEntry()
+                           ->clusterName());
+}
+
+TEST_F(RouteMatcherTest, TestRoutesWithSafeRegexOverProgramSize) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: regex
+    domains: ["*"]
+    routes:
+      - match:
+          safe_regex:
+            google_re2:
+              max_program_size: 5
+            regex: "/api/v[0-9]+/users/[0-9]+"
+        route: { cluster: "users" }
+  )EOF";
+
+  EXPECT_THROW_WITH_REGEX(
+      TestConfigImpl(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, true),
+      EnvoyException, "RE2 program size of [0-9]+ > max program size of 5");
+}
+
 // Validates behavior of request_headers_to_add at router, vhost, and route levels.
 TEST_F(RouteMatcherTest, TestAddRemoveRequestHeaders) {
   const std::string yaml = R"EOF(
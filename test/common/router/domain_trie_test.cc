@@ -0,0 +1,71 @@
+#include <string>
+
+#include "common/router/domain_trie.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+using StringTrie = DomainTrie<std::string>;
+
+std::string find(const StringTrie& trie, absl::string_view host) {
+  const std::string* value = trie.findLongestMatch(host);
+  return value == nullptr ? "" : *value;
+}
+
+TEST(DomainTrieTest, SuffixLongestMatch) {
+  StringTrie trie(StringTrie::Direction::Reverse);
+  EXPECT_TRUE(trie.empty());
+  EXPECT_TRUE(trie.add(".foo.com", "dot"));
+  EXPECT_TRUE(trie.add("-bar.foo.com", "dash"));
+  EXPECT_TRUE(trie.add(".baz.foo.com", "baz"));
+  EXPECT_FALSE(trie.add(".foo.com", "duplicate"));
+  trie.compile();
+  EXPECT_FALSE(trie.empty());
+
+  EXPECT_EQ("dot", find(trie, "a.foo.com"));
+  EXPECT_EQ("dash", find(trie, "a-bar.foo.com"));
+  EXPECT_EQ("baz", find(trie, "a.baz.foo.com"));
+  EXPECT_EQ("dot", find(trie, "a.bar.foo.com"));
+  EXPECT_EQ("", find(trie, "foo.com"));
+  EXPECT_EQ("", find(trie, "a.foo.org"));
+  EXPECT_EQ("", find(trie, ""));
+}
+
+TEST(DomainTrieTest, SuffixRequiresNonEmptyWildcard) {
+  StringTrie trie(StringTrie::Direction::Reverse);
+  EXPECT_TRUE(trie.add(".foo.com", "dot"));
+  EXPECT_TRUE(trie.add("foo.com", "bare"));
+  trie.compile();
+
+  // *.foo.com must not match .foo.com, but the shorter *foo.com does.
+  EXPECT_EQ("bare", find(trie, ".foo.com"));
+  EXPECT_EQ("", find(trie, "foo.com"));
+}
+
+TEST(DomainTrieTest, PrefixLongestMatch) {
+  StringTrie trie(StringTrie::Direction::Forward);
+  EXPECT_TRUE(trie.add("api.", "api"));
+  EXPECT_TRUE(trie.add("api.v2.", "v2"));
+  EXPECT_FALSE(trie.add("api.", "duplicate"));
+  trie.compile();
+
+  EXPECT_EQ("api", find(trie, "api.lyft.com"));
+  EXPECT_EQ("v2", find(trie, "api.v2.lyft.com"));
+  EXPECT_EQ("api", find(trie, "api.v2."));
+  EXPECT_EQ("", find(trie, "api."));
+  EXPECT_EQ("", find(trie, "www.lyft.com"));
+}
+
+TEST(DomainTrieTest, Empty) {
+  StringTrie trie(StringTrie::Direction::Forward);
+  trie.compile();
+  EXPECT_TRUE(trie.empty());
+  EXPECT_EQ("", find(trie, "api.lyft.com"));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
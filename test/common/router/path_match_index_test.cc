@@ -0,0 +1,96 @@
+#include "common/router/path_match_index.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+PathMatchIndex::Candidates find(const PathMatchIndex& index, absl::string_view path) {
+  PathMatchIndex::Candidates candidates;
+  index.findCandidates(path, candidates);
+  return candidates;
+}
+
+TEST(PathMatchIndexTest, Prefix) {
+  PathMatchIndex index;
+  index.addPrefix("/api", true, 0);
+  index.addPrefix("/", true, 1);
+  index.addPrefix("/api/v1", true, 2);
+  index.addPrefix("/foo", true, 3);
+  index.addPrefix("", true, 4);
+  index.addPrefix("/api", true, 5);
+  index.compile();
+
+  EXPECT_THAT(find(index, "/api/v1/users"), ElementsAre(0, 1, 2, 4, 5));
+  EXPECT_THAT(find(index, "/api/v2"), ElementsAre(0, 1, 4, 5));
+  EXPECT_THAT(find(index, "/API"), ElementsAre(1, 4));
+  EXPECT_THAT(find(index, "/foo?bar"), ElementsAre(1, 3, 4));
+  EXPECT_THAT(find(index, "bar"), ElementsAre(4));
+  EXPECT_THAT(find(index, ""), ElementsAre(4));
+}
+
+TEST(PathMatchIndexTest, PrefixMatchesQueryString) {
+  PathMatchIndex index;
+  index.addPrefix("/foo?bar", true, 0);
+  index.compile();
+
+  EXPECT_THAT(find(index, "/foo?bar=baz"), ElementsAre(0));
+  EXPECT_THAT(find(index, "/foo"), IsEmpty());
+}
+
+TEST(PathMatchIndexTest, Path) {
+  PathMatchIndex index;
+  index.addPath("/api", true, 0);
+  index.addPath("/api/v1", true, 1);
+  index.addPath("/", true, 2);
+  index.compile();
+
+  EXPECT_THAT(find(index, "/api"), ElementsAre(0));
+  EXPECT_THAT(find(index, "/api?foo=bar"), ElementsAre(0));
+  EXPECT_THAT(find(index, "/api/v1"), ElementsAre(1));
+  EXPECT_THAT(find(index, "/api/"), IsEmpty());
+  EXPECT_THAT(find(index, "/ap"), IsEmpty());
+  EXPECT_THAT(find(index, "/"), ElementsAre(2));
+  EXPECT_THAT(find(index, "/?api"), ElementsAre(2));
+}
+
+TEST(PathMatchIndexTest, CaseInsensitive) {
+  PathMatchIndex index;
+  index.addPrefix("/API", false, 0);
+  index.addPath("/Api/V1", false, 1);
+  index.addPrefix("/api", true, 2);
+  index.compile();
+
+  EXPECT_THAT(find(index, "/api/v1"), ElementsAre(0, 1, 2));
+  EXPECT_THAT(find(index, "/aPi/V1?x"), ElementsAre(0, 1));
+  EXPECT_THAT(find(index, "/apx"), IsEmpty());
+}
+
+TEST(PathMatchIndexTest, Unindexed) {
+  PathMatchIndex index;
+  index.addPrefix("/api", true, 0);
+  index.addUnindexed(1);
+  index.addPath("/foo", true, 2);
+  index.addUnindexed(3);
+  index.compile();
+
+  EXPECT_THAT(find(index, "/api"), ElementsAre(0, 1, 3));
+  EXPECT_THAT(find(index, "/foo"), ElementsAre(1, 2, 3));
+  EXPECT_THAT(find(index, "/bar"), ElementsAre(1, 3));
+}
+
+TEST(PathMatchIndexTest, Empty) {
+  PathMatchIndex index;
+  index.compile();
+
+  EXPECT_THAT(find(index, "/"), IsEmpty());
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
@@ -174,6 +174,7 @@ public:
               // When metadataMatchCriteria() is computed from dynamic metadata, the result should
               // be cached.
               EXPECT_EQ(context->metadataMatchCriteria(), context->metadataMatchCriteria());
+              EXPECT_TRUE(context->metadataMatchCriteriaPerRequest());
 
               return &cm_.conn_pool_;
             }));
@@ -638,6 +639,7 @@ TEST_F(RouterTest, MetadataMatchCriteria) {
                      Upstream::LoadBalancerContext* context) -> Http::ConnectionPool::Instance* {
             EXPECT_EQ(context->metadataMatchCriteria(),
                       &callbacks_.route_->route_entry_.metadata_matches_criteria_);
+            EXPECT_FALSE(context->metadataMatchCriteriaPerRequest());
             return &cm_.conn_pool_;
           }));
   EXPECT_CALL(cm_.conn_pool_, newStream(_, _)).WillOnce(Return(&cancellable_));
@@ -2933,6 +2935,110 @@ TEST_F(RouterTest, UpstreamTimingSingleRequest) {
             std::chrono::milliseconds(32));
 }
 
+// Verify that the upstream response time is reported to a load balancer that steers by it.
+TEST_F(RouterTest, UpstreamResponseTime) {
+  cm_.thread_local_cluster_.cluster_.info_->lb_type_ = Upstream::LoadBalancerType::PeakEwma;
+  NiceMock<Http::MockStreamEncoder> encoder;
+  Http::StreamDecoder* response_decoder = nullptr;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder& decoder, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        response_decoder = &decoder;
+        callbacks.onPoolReady(encoder, cm_.conn_pool_.host_);
+        return nullptr;
+      }));
+  expectResponseTimerCreate();
+
+  Http::TestHeaderMapImpl headers{};
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, false);
+
+  test_time_.sleep(std::chrono::milliseconds(32));
+  Buffer::OwnedImpl data;
+  router_.decodeData(data, true);
+
+  Http::HeaderMapPtr response_headers(new Http::TestHeaderMapImpl{{":status", "200"}});
+  response_decoder->decodeHeaders(std::move(response_headers), false);
+  test_time_.sleep(std::chrono::milliseconds(43));
+
+  EXPECT_CALL(cm_.thread_local_cluster_.lb_,
+              putResponseTime(Ref(*cm_.conn_pool_.host_), std::chrono::microseconds(75000)));
+  response_decoder->decodeData(data, true);
+}
+
+// Verify that the upstream response time is not reported to load balancers that don't use it.
+TEST_F(RouterTest, UpstreamResponseTimeNotReported) {
+  NiceMock<Http::MockStreamEncoder> encoder;
+  Http::StreamDecoder* response_decoder = nullptr;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder& decoder, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        response_decoder = &decoder;
+        callbacks.onPoolReady(encoder, cm_.conn_pool_.host_);
+        return nullptr;
+      }));
+  expectResponseTimerCreate();
+
+  Http::TestHeaderMapImpl headers{};
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, true);
+
+  EXPECT_CALL(cm_.thread_local_cluster_.lb_, putResponseTime(_, _)).Times(0);
+  Http::HeaderMapPtr response_headers(new Http::TestHeaderMapImpl{{":status", "200"}});
+  response_decoder->decodeHeaders(std::move(response_headers), true);
+}
+
+// Verify that the time until a per try timeout is reported to the load balancer.
+TEST_F(RouterTest, UpstreamPerTryTimeoutResponseTime) {
+  cm_.thread_local_cluster_.cluster_.info_->lb_type_ = Upstream::LoadBalancerType::PeakEwma;
+  NiceMock<Http::MockStreamEncoder> encoder;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder&, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        callbacks.onPoolReady(encoder, cm_.conn_pool_.host_);
+        return nullptr;
+      }));
+
+  Http::TestHeaderMapImpl headers{{"x-envoy-upstream-rq-per-try-timeout-ms", "5"}};
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, false);
+  expectPerTryTimerCreate();
+  expectResponseTimerCreate();
+  Buffer::OwnedImpl data;
+  router_.decodeData(data, true);
+
+  test_time_.sleep(std::chrono::milliseconds(5));
+  EXPECT_CALL(cm_.thread_local_cluster_.lb_,
+              putResponseTime(Ref(*cm_.conn_pool_.host_), std::chrono::microseconds(5000)));
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, false));
+  EXPECT_CALL(callbacks_, encodeData(_, true));
+  per_try_timeout_->callback_();
+}
+
+// Verify that the time until an upstream reset is reported to the load balancer.
+TEST_F(RouterTest, UpstreamResetResponseTime) {
+  cm_.thread_local_cluster_.cluster_.info_->lb_type_ = Upstream::LoadBalancerType::PeakEwma;
+  NiceMock<Http::MockStreamEncoder> encoder;
+  EXPECT_CALL(cm_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke([&](Http::StreamDecoder&, Http::ConnectionPool::Callbacks& callbacks)
+                           -> Http::ConnectionPool::Cancellable* {
+        callbacks.onPoolReady(encoder, cm_.conn_pool_.host_);
+        return nullptr;
+      }));
+  expectResponseTimerCreate();
+
+  Http::TestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, true);
+
+  test_time_.sleep(std::chrono::milliseconds(12));
+  EXPECT_CALL(cm_.thread_local_cluster_.lb_,
+              putResponseTime(Ref(*cm_.conn_pool_.host_), std::chrono::microseconds(12000)));
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, false));
+  EXPECT_CALL(callbacks_, encodeData(_, true));
+  encoder.stream_.resetStream(Http::StreamResetReason::RemoteReset);
+}
+
 // Verify that upstream timing information is set into the StreamInfo when a
 // retry occurs (and not before).
 TEST_F(RouterTest, UpstreamTimingRetry) {
@@ -418,20 +418,11 @@ TEST_P(StatNameTest, RacingSymbolCreation) {
   access.setReady();
   accesses.Wait();
 
-  // In a perfect world, we could use reader-locks in the SymbolTable
-  // implementation, and there should be zero additional contentions
-  // after latching 'create_contentions' above. And we can definitely
-  // have this world, but this slows down BM_CreateRace in
-  // symbol_table_speed_test.cc, even on a 72-core machine.
-  //
-  // Thus it is better to avoid symbol-table contention by refactoring
-  // all stat-creation code to symbolize all stat string elements at
-  // construction, as composition does not require a lock.
-  //
-  // See this commit
-  // https://github.com/envoyproxy/envoy/pull/5321/commits/ef712d0f5a11ff49831c1935e8a2ef8a0a935bc9
-  // for a working reader-lock implementation, which would pass this EXPECT:
-  //     EXPECT_EQ(create_contentions, mutex_tracer.numContentions());
+  // Encoding already-existing symbols only takes the SymbolTable lock
+  // shared, so it adds no contention on it after latching
+  // 'create_contentions' above. We cannot EXPECT that the total is
+  // unchanged though, as the tracer also counts contentions on the
+  // BlockingCounter and ConditionalInitializer mutexes used here.
   //
   // Note also that we cannot guarantee there *will* be contentions
   // as a machine or OS is free to run all threads serially.
@@ -486,20 +477,11 @@ TEST_P(StatNameTest, MutexContentionOnExistingSymbols) {
   access.setReady();
   accesses.Wait();
 
-  // In a perfect world, we could use reader-locks in the SymbolTable
-  // implementation, and there should be zero additional contentions
-  // after latching 'create_contentions' above. And we can definitely
-  // have this world, but this slows down BM_CreateRace in
-  // symbol_table_speed_test.cc, even on a 72-core machine.
-  //
-  // Thus it is better to avoid symbol-table contention by refactoring
-  // all stat-creation code to symbolize all stat string elements at
-  // construction, as composition does not require a lock.
-  //
-  // See this commit
-  // https://github.com/envoyproxy/envoy/pull/5321/commits/ef712d0f5a11ff49831c1935e8a2ef8a0a935bc9
-  // for a working reader-lock implementation, which would pass this EXPECT:
-  //     EXPECT_EQ(create_contentions, mutex_tracer.numContentions());
+  // Encoding already-existing symbols only takes the SymbolTable lock
+  // shared, so it adds no contention on it after latching
+  // 'create_contentions' above. We cannot EXPECT that the total is
+  // unchanged though, as the tracer also counts contentions on the
+  // BlockingCounter and ConditionalInitializer mutexes used here.
   //
   // Note also that we cannot guarantee there *will* be contentions
   // as a machine or OS is free to run all threads serially.
@@ -510,6 +492,36 @@ TEST_P(StatNameTest, MutexContentionOnExistingSymbols) {
   }
 }
 
+// Races symbols dropping to a zero ref-count against other threads encoding
+// them again, which must neither lose a referenced symbol nor leak an
+// unreferenced one.
+TEST_P(StatNameTest, RacingFreeAndEncode) {
+  Thread::ThreadFactory& thread_factory = Thread::threadFactoryForTest();
+  constexpr int num_threads = 8;
+  std::vector<Thread::ThreadPtr> threads;
+  threads.reserve(num_threads);
+  ConditionalInitializer start;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(thread_factory.createThread([this, i, &start]() {
+      start.wait();
+      for (int j = 0; j < 1000; ++j) {
+        const std::string name = absl::StrCat("shared.name", j % 5, ".thread", (i + j) % 3);
+        StatNameStorage storage(name, *table_);
+        EXPECT_EQ(name, table_->toString(storage.statName()));
+        StatNameStorage copy(storage.statName(), *table_);
+        storage.free(*table_);
+        EXPECT_EQ(name, table_->toString(copy.statName()));
+        copy.free(*table_);
+      }
+    }));
+  }
+  start.setReady();
+  for (auto& thread : threads) {
+    thread->join();
+  }
+  EXPECT_EQ(0, table_->numSymbols());
+}
+
 TEST_P(StatNameTest, SharedStatNameStorageSetInsertAndFind) {
   StatNameStorageSet set;
   const int iters = 10;
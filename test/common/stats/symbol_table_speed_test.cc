@@ -9,6 +9,7 @@
 
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/blocking_counter.h"
 #include "benchmark/benchmark.h"
 
@@ -54,6 +55,62 @@ static void BM_CreateRace(benchmark::State& state) {
 }
 BENCHMARK(BM_CreateRace);
 
+// Measures contention between workers creating and freeing stat names, as with
+// dynamic per-route or per-cluster stats. The first argument is the number of
+// threads. If the second argument is non-zero, all the tokens of the names are
+// already interned, so encoding only looks up existing symbols. Otherwise each
+// thread's names end with a token of its own that is added and removed again.
+static void BM_EncodeContention(benchmark::State& state) {
+  Envoy::Thread::ThreadFactory& thread_factory = Envoy::Thread::threadFactoryForTest();
+  const int num_threads = state.range(0);
+  const bool interned = state.range(1) != 0;
+  constexpr int num_names = 100;
+  constexpr int encodes_per_thread = 10000;
+
+  Envoy::Stats::SymbolTableImpl table;
+  std::vector<std::vector<std::string>> names(num_threads);
+  std::vector<Envoy::Stats::StatNameStorage> initial;
+  for (int i = 0; i < num_threads; ++i) {
+    for (int j = 0; j < num_names; ++j) {
+      names[i].push_back(
+          absl::StrCat("cluster.service_", j, ".upstream_rq_total.thread_", interned ? 0 : i));
+    }
+  }
+  if (interned) {
+    for (const std::string& name : names[0]) {
+      initial.emplace_back(name, table);
+    }
+  }
+
+  for (auto _ : state) {
+    std::vector<Envoy::Thread::ThreadPtr> threads;
+    threads.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+      threads.push_back(thread_factory.createThread([&table, &names, i]() {
+        for (int j = 0; j < encodes_per_thread; ++j) {
+          Envoy::Stats::StatNameStorage storage(names[i][j % num_names], table);
+          storage.free(table);
+        }
+      }));
+    }
+    for (auto& thread : threads) {
+      thread->join();
+    }
+  }
+
+  for (Envoy::Stats::StatNameStorage& storage : initial) {
+    storage.free(table);
+  }
+}
+BENCHMARK(BM_EncodeContention)
+    ->Args({1, 1})
+    ->Args({4, 1})
+    ->Args({16, 1})
+    ->Args({1, 0})
+    ->Args({4, 0})
+    ->Args({16, 0})
+    ->Unit(benchmark::kMillisecond);
+
 int main(int argc, char** argv) {
   Envoy::Thread::MutexBasicLockable lock;
   Envoy::Logger::Context logger_context(spdlog::level::warn,
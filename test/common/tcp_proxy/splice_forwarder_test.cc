@@ -0,0 +1,195 @@
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "common/event/dispatcher_impl.h"
+#include "common/network/io_socket_handle_impl.h"
+#include "common/tcp_proxy/splice_forwarder.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace TcpProxy {
+namespace {
+
+// Forwards between the proxy ends of two socket pairs: client <-> downstream and
+// upstream <-> server.
+class SpliceForwarderTest : public testing::Test, public SpliceForwarder::Callbacks {
+protected:
+  SpliceForwarderTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher()) {
+    int fds[2];
+    RELEASE_ASSERT(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0, "");
+    client_fd_ = fds[0];
+    downstream_ = std::make_unique<Network::IoSocketHandleImpl>(fds[1]);
+    RELEASE_ASSERT(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0, "");
+    upstream_ = std::make_unique<Network::IoSocketHandleImpl>(fds[0]);
+    server_fd_ = fds[1];
+    for (int fd : {client_fd_, downstream_->fd(), upstream_->fd(), server_fd_}) {
+      RELEASE_ASSERT(::fcntl(fd, F_SETFL, O_NONBLOCK) == 0, "");
+    }
+  }
+
+  ~SpliceForwarderTest() {
+    forwarder_.reset();
+    downstream_->close();
+    upstream_->close();
+    ::close(client_fd_);
+    ::close(server_fd_);
+  }
+
+  // TcpProxy::SpliceForwarder::Callbacks
+  void onSpliceRead(SpliceForwarder::Side side, uint64_t bytes) override {
+    (side == SpliceForwarder::Side::Downstream ? downstream_read_ : upstream_read_) += bytes;
+  }
+  void onSpliceWritten(SpliceForwarder::Side side, uint64_t bytes) override {
+    (side == SpliceForwarder::Side::Downstream ? downstream_written_ : upstream_written_) += bytes;
+  }
+  void onSpliceDone(bool error) override {
+    done_ = true;
+    error_ = error;
+    forwarder_.reset();
+  }
+
+  void start() {
+    forwarder_ = SpliceForwarder::create(*dispatcher_, *downstream_, *upstream_, *this);
+    ASSERT_NE(nullptr, forwarder_);
+  }
+
+  // Run the loop and read from fd until expected_size bytes, or EOF if expected_size is zero,
+  // arrived.
+  std::string readAll(int fd, uint64_t expected_size) {
+    std::string data;
+    for (int i = 0; i < 10000; i++) {
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+      char buffer[65536];
+      ssize_t rc;
+      while ((rc = ::read(fd, buffer, sizeof(buffer))) > 0) {
+        data.append(buffer, rc);
+      }
+      if ((expected_size != 0 && data.size() >= expected_size) ||
+          (expected_size == 0 && rc == 0)) {
+        break;
+      }
+    }
+    return data;
+  }
+
+  void runUntil(std::function<bool()> condition) {
+    for (int i = 0; i < 10000 && !condition(); i++) {
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    }
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  int client_fd_;
+  int server_fd_;
+  Network::IoHandlePtr downstream_;
+  Network::IoHandlePtr upstream_;
+  SpliceForwarderPtr forwarder_;
+  uint64_t downstream_read_{};
+  uint64_t downstream_written_{};
+  uint64_t upstream_read_{};
+  uint64_t upstream_written_{};
+  bool done_{};
+  bool error_{};
+};
+
+TEST_F(SpliceForwarderTest, ForwardsBothDirections) {
+  if (!SpliceForwarder::isSupported()) {
+    return;
+  }
+
+  // Bytes written before the forwarder starts are forwarded too.
+  EXPECT_EQ(5, ::write(client_fd_, "hello", 5));
+  start();
+  EXPECT_EQ("hello", readAll(server_fd_, 5));
+  EXPECT_EQ(5, downstream_read_);
+  EXPECT_EQ(5, upstream_written_);
+
+  EXPECT_EQ(6, ::write(server_fd_, "world!", 6));
+  EXPECT_EQ("world!", readAll(client_fd_, 6));
+  EXPECT_EQ(6, upstream_read_);
+  EXPECT_EQ(6, downstream_written_);
+  EXPECT_FALSE(done_);
+}
+
+// A slow reader holds the bytes in the pipe and the socket buffers, and nothing is lost.
+TEST_F(SpliceForwarderTest, Backpressure) {
+  if (!SpliceForwarder::isSupported()) {
+    return;
+  }
+
+  start();
+  std::string data(4 << 20, 'a');
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = 'a' + i % 26;
+  }
+
+  size_t offset = 0;
+  std::string received;
+  for (int i = 0; i < 100000 && received.size() < data.size(); i++) {
+    const ssize_t rc = ::write(client_fd_, data.data() + offset, data.size() - offset);
+    if (rc > 0) {
+      offset += rc;
+    }
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    // Read less than is written per iteration so that the upstream side blocks.
+    char buffer[16384];
+    const ssize_t read = ::read(server_fd_, buffer, sizeof(buffer));
+    if (read > 0) {
+      received.append(buffer, read);
+    }
+  }
+  EXPECT_EQ(data, received);
+  EXPECT_EQ(data.size(), downstream_read_);
+  EXPECT_EQ(data.size(), upstream_written_);
+}
+
+// End of stream is forwarded as a write shutdown, and the other direction keeps working until it
+// ends too.
+TEST_F(SpliceForwarderTest, HalfClose) {
+  if (!SpliceForwarder::isSupported()) {
+    return;
+  }
+
+  start();
+  EXPECT_EQ(3, ::write(client_fd_, "foo", 3));
+  ::shutdown(client_fd_, SHUT_WR);
+  EXPECT_EQ("foo", readAll(server_fd_, 0));
+  EXPECT_FALSE(done_);
+
+  EXPECT_EQ(3, ::write(server_fd_, "bar", 3));
+  EXPECT_EQ("bar", readAll(client_fd_, 3));
+  ::shutdown(server_fd_, SHUT_WR);
+  runUntil([this]() { return done_; });
+  EXPECT_TRUE(done_);
+  EXPECT_FALSE(error_);
+}
+
+// Writing to a socket whose peer went away fails the forwarder.
+TEST_F(SpliceForwarderTest, WriteError) {
+  if (!SpliceForwarder::isSupported()) {
+    return;
+  }
+
+  start();
+  ::close(server_fd_);
+  server_fd_ = -1;
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_FALSE(done_);
+
+  EXPECT_EQ(3, ::write(client_fd_, "foo", 3));
+  runUntil([this]() { return done_; });
+  EXPECT_TRUE(done_);
+  EXPECT_TRUE(error_);
+}
+
+} // namespace
+} // namespace TcpProxy
+} // namespace Envoy
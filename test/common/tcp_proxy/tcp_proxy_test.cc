@@ -7,6 +7,7 @@
 #include "common/buffer/buffer_impl.h"
 #include "common/config/filter_json.h"
 #include "common/network/address_impl.h"
+#include "common/network/io_socket_handle_impl.h"
 #include "common/network/transport_socket_options_impl.h"
 #include "common/network/upstream_server_name.h"
 #include "common/router/metadatamatchcriteria_impl.h"
@@ -921,6 +922,69 @@ TEST_F(TcpProxyTest, IdleTimeoutWithOutstandingDataFlushed) {
   idle_timer->callback_();
 }
 
+// Tests that the buffered path is used when a connection does not allow splicing.
+TEST_F(TcpProxyTest, SpliceNotPossible) {
+  envoy::config::filter::network::tcp_proxy::v2::TcpProxy config = defaultConfig();
+  config.set_splice(true);
+  setup(1, config);
+
+  EXPECT_CALL(filter_callbacks_.connection_, spliceableIoHandle()).WillOnce(Return(nullptr));
+  raiseEventUpstreamConnected(0);
+  EXPECT_EQ(0U, config_->stats().downstream_cx_splice_total_.value());
+
+  Buffer::OwnedImpl buffer("hello");
+  EXPECT_CALL(*upstream_connections_.at(0), write(BufferEqual(&buffer), false));
+  filter_->onData(buffer, false);
+}
+
+// Tests that spliced bytes are accounted like proxied ones, and that both connections are closed
+// once splicing is done.
+TEST_F(TcpProxyTest, Splice) {
+  if (!SpliceForwarder::isSupported()) {
+    return;
+  }
+  envoy::config::filter::network::tcp_proxy::v2::TcpProxy config = defaultConfig();
+  config.set_splice(true);
+  config.mutable_idle_timeout()->set_seconds(1);
+  setup(1, config);
+
+  // The file events are mocks, so the handles never see a system call.
+  Network::IoSocketHandleImpl downstream_io_handle;
+  Network::IoSocketHandleImpl upstream_io_handle;
+  EXPECT_CALL(filter_callbacks_.connection_, spliceableIoHandle())
+      .WillOnce(Return(&downstream_io_handle));
+  EXPECT_CALL(*upstream_connections_.at(0), spliceableIoHandle())
+      .WillOnce(Return(&upstream_io_handle));
+  EXPECT_CALL(filter_callbacks_.connection_.dispatcher_, createFileEvent_(_, _, _, _))
+      .Times(2)
+      .WillRepeatedly(InvokeWithoutArgs([]() { return new NiceMock<Event::MockFileEvent>(); }));
+  EXPECT_CALL(filter_callbacks_.connection_, readDisable(true));
+  EXPECT_CALL(*upstream_connections_.at(0), readDisable(true));
+  Event::MockTimer* idle_timer = new Event::MockTimer(&filter_callbacks_.connection_.dispatcher_);
+  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(1000)));
+  raiseEventUpstreamConnected(0);
+  EXPECT_EQ(1U, config_->stats().downstream_cx_splice_total_.value());
+
+  EXPECT_CALL(filter_callbacks_.connection_, addSplicedBytes(5, 0));
+  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(1000)));
+  filter_->onSpliceRead(SpliceForwarder::Side::Downstream, 5);
+
+  EXPECT_CALL(*upstream_connections_.at(0), addSplicedBytes(0, 5));
+  filter_->onSpliceWritten(SpliceForwarder::Side::Upstream, 5);
+
+  EXPECT_CALL(*upstream_connections_.at(0), addSplicedBytes(6, 0));
+  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(1000)));
+  filter_->onSpliceRead(SpliceForwarder::Side::Upstream, 6);
+
+  EXPECT_CALL(filter_callbacks_.connection_, addSplicedBytes(0, 6));
+  filter_->onSpliceWritten(SpliceForwarder::Side::Downstream, 6);
+
+  EXPECT_CALL(*upstream_connections_.at(0), close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(filter_callbacks_.connection_, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(*idle_timer, disableTimer());
+  filter_->onSpliceDone(false);
+}
+
 // Test that access log fields %UPSTREAM_HOST% and %UPSTREAM_CLUSTER% are correctly logged.
 TEST_F(TcpProxyTest, AccessLogUpstreamHost) {
   setup(1, accessLogConfig("%UPSTREAM_HOST% %UPSTREAM_CLUSTER%"));
@@ -7,6 +7,7 @@
 #include "envoy/upstream/upstream.h"
 
 #include "common/api/api_impl.h"
+#include "common/common/hash.h"
 #include "common/config/utility.h"
 #include "common/http/context_impl.h"
 #include "common/network/socket_option_factory.h"
@@ -37,6 +38,7 @@
 #include "test/test_common/threadsafe_singleton_injector.h"
 #include "test/test_common/utility.h"
 
+#include "absl/synchronization/notification.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -154,6 +156,7 @@ public:
 class TestClusterManagerImpl : public ClusterManagerImpl {
 public:
   using ClusterManagerImpl::ClusterManagerImpl;
+  using ClusterManagerImpl::lbTableBuilder;
 
   std::map<std::string, std::reference_wrapper<Cluster>> activeClusters() {
     std::map<std::string, std::reference_wrapper<Cluster>> clusters;
@@ -180,10 +183,10 @@ public:
         local_cluster_update_(local_cluster_update), local_hosts_removed_(local_hosts_removed) {}
 
 protected:
-  void postThreadLocalClusterUpdate(const Cluster&, uint32_t priority,
-                                    const HostVector& hosts_added,
-                                    const HostVector& hosts_removed) override {
-    local_cluster_update_.post(priority, hosts_added, hosts_removed);
+  void postThreadLocalClusterUpdate(const Cluster&, ThreadLocalClusterUpdates&& updates) override {
+    for (const ThreadLocalClusterUpdate& update : updates) {
+      local_cluster_update_.post(update.priority_, update.hosts_added_, update.hosts_removed_);
+    }
   }
 
   void postThreadLocalHostRemoval(const Cluster&, const HostVector& hosts_removed) override {
@@ -217,7 +220,8 @@ public:
         factory_.local_info_, log_manager_, factory_.dispatcher_, admin_, *api_, http_context_);
   }
 
-  void createWithLocalClusterUpdate(const bool enable_merge_window = true) {
+  void createWithLocalClusterUpdate(const bool enable_merge_window = true,
+                                    const bool merge_membership_updates = false) {
     std::string yaml = R"EOF(
   static_resources:
     clusters:
@@ -243,6 +247,9 @@ public:
   )EOF";
 
     yaml += enable_merge_window ? merge_window_enabled : merge_window_disabled;
+    if (merge_membership_updates) {
+      yaml += "        merge_membership_updates: true\n";
+    }
 
     const auto& bootstrap = parseBootstrapFromV2Yaml(yaml);
 
@@ -771,6 +778,60 @@ public:
     EXPECT_EQ(cluster1->prioritySet().getMockHostSet(0)->hosts_[0],
               cluster_manager_->get("cluster_0")->loadBalancer().chooseHost(nullptr));
   }
+
+  // Workers drain the connection pools of removed hosts right away, while the tables without them
+  // are still being built. Until those tables are published, the removed hosts must not be picked.
+  void doRemovedHostTest(LoadBalancerType lb_type) {
+    const std::string json = fmt::sprintf("{\"static_resources\":{%s}}",
+                                          clustersJson({defaultStaticClusterJson("cluster_0")}));
+
+    std::shared_ptr<MockClusterMockPrioritySet> cluster1(
+        new NiceMock<MockClusterMockPrioritySet>());
+    cluster1->info_->name_ = "cluster_0";
+    cluster1->info_->lb_type_ = lb_type;
+
+    EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+        .WillOnce(Return(std::make_pair(cluster1, nullptr)));
+    ON_CALL(*cluster1, initializePhase()).WillByDefault(Return(Cluster::InitializePhase::Primary));
+    create(parseBootstrapFromV2Json(json));
+
+    MockHostSet& host_set = *cluster1->prioritySet().getMockHostSet(0);
+    HostSharedPtr host1 = makeTestHost(cluster1->info_, "tcp://127.0.0.1:80");
+    HostSharedPtr host2 = makeTestHost(cluster1->info_, "tcp://127.0.0.2:80");
+    host_set.hosts_ = {host1, host2};
+    host_set.runCallbacks(host_set.hosts_, {});
+    cluster1->initialize_callback_();
+
+    NiceMock<MockLoadBalancerContext> context;
+    auto choose_hosts = [this, &context]() -> std::vector<HostConstSharedPtr> {
+      std::vector<HostConstSharedPtr> hosts;
+      for (uint32_t i = 0; i < 100; i++) {
+        ON_CALL(context, computeHashKey())
+            .WillByDefault(Return(HashUtil::xxHash64(std::to_string(i))));
+        hosts.push_back(cluster_manager_->get("cluster_0")->loadBalancer().chooseHost(&context));
+      }
+      return hosts;
+    };
+    EXPECT_THAT(choose_hosts(), testing::Contains(host1));
+
+    // Keep the table builder busy, so that the tables without host1 wait.
+    absl::Notification blocking;
+    absl::Notification release;
+    const int blocker{};
+    cluster_manager_->lbTableBuilder().schedule(&blocker, [&blocking, &release]() -> void {
+      blocking.Notify();
+      release.WaitForNotification();
+    });
+    blocking.WaitForNotification();
+
+    host_set.hosts_ = {host2};
+    host_set.runCallbacks({}, {host1});
+    EXPECT_THAT(choose_hosts(), testing::Each(host2));
+
+    release.Notify();
+    cluster_manager_->lbTableBuilder().waitForIdle();
+    EXPECT_THAT(choose_hosts(), testing::Each(host2));
+  }
 };
 
 // Test that the cluster manager correctly re-creates the worker local LB when there is a host
@@ -785,6 +846,14 @@ TEST_F(ClusterManagerImplThreadAwareLbTest, MaglevLoadBalancerThreadAwareUpdate)
   doTest(LoadBalancerType::Maglev);
 }
 
+TEST_F(ClusterManagerImplThreadAwareLbTest, RingHashLoadBalancerSkipsRemovedHostsWhileBuilding) {
+  doRemovedHostTest(LoadBalancerType::RingHash);
+}
+
+TEST_F(ClusterManagerImplThreadAwareLbTest, MaglevLoadBalancerSkipsRemovedHostsWhileBuilding) {
+  doRemovedHostTest(LoadBalancerType::Maglev);
+}
+
 TEST_F(ClusterManagerImplTest, TcpHealthChecker) {
   const std::string yaml = R"EOF(
 static_resources:
@@ -2256,6 +2325,8 @@ TEST_F(ClusterManagerImplTest, OriginalDstInitialization) {
 // happen and the scheduled update will be cancelled.
 TEST_F(ClusterManagerImplTest, MergedUpdates) {
   createWithLocalClusterUpdate();
+  // The initial hosts are delivered as one batch when the cluster initializes.
+  EXPECT_EQ(1, factory_.stats_.counter("cluster_manager.update_delivered").value());
 
   // Ensure we see the right set of added/removed hosts on every call.
   EXPECT_CALL(local_cluster_update_, post(_, _, _))
@@ -2390,6 +2461,83 @@ TEST_F(ClusterManagerImplTest, MergedUpdates) {
   EXPECT_EQ(1, factory_.stats_.counter("cluster_manager.update_merge_cancelled").value());
 }
 
+// Tests that with merge_membership_updates, host adds/removes are merged as well and only their
+// net change is delivered, along with the drain of the removed hosts.
+TEST_F(ClusterManagerImplTest, MergedMembershipUpdates) {
+  createWithLocalClusterUpdate(true, true);
+
+  Cluster& cluster = cluster_manager_->activeClusters().begin()->second;
+  HostVectorSharedPtr hosts(
+      new HostVector(cluster.prioritySet().hostSetsPerPriority()[0]->hosts()));
+  HostSharedPtr host1 = (*hosts)[0];
+  HostSharedPtr host2 = (*hosts)[1];
+
+  EXPECT_CALL(local_cluster_update_, post(_, _, _))
+      .WillOnce(Invoke([&](uint32_t priority, const HostVector& hosts_added,
+                           const HostVector& hosts_removed) -> void {
+        // 1st removal, out of the merge window.
+        EXPECT_EQ(0, priority);
+        EXPECT_EQ(0, hosts_added.size());
+        EXPECT_EQ(HostVector{host1}, hosts_removed);
+      }))
+      .WillOnce(Invoke([&](uint32_t priority, const HostVector& hosts_added,
+                           const HostVector& hosts_removed) -> void {
+        // host1 was added back and host2 was removed and added back: only host1 is added.
+        EXPECT_EQ(0, priority);
+        EXPECT_EQ(HostVector{host1}, hosts_added);
+        EXPECT_EQ(0, hosts_removed.size());
+      }))
+      .WillOnce(Invoke([&](uint32_t priority, const HostVector& hosts_added,
+                           const HostVector& hosts_removed) -> void {
+        // host2 removed.
+        EXPECT_EQ(0, priority);
+        EXPECT_EQ(0, hosts_added.size());
+        EXPECT_EQ(HostVector{host2}, hosts_removed);
+      }));
+
+  EXPECT_CALL(local_hosts_removed_, post(_))
+      .WillOnce(Invoke(
+          [&](const HostVector& hosts_removed) { EXPECT_EQ(HostVector{host1}, hosts_removed); }))
+      .WillOnce(Invoke(
+          [&](const HostVector& hosts_removed) { EXPECT_EQ(HostVector{host2}, hosts_removed); }));
+
+  Event::MockTimer* timer = new NiceMock<Event::MockTimer>(&factory_.dispatcher_);
+  HostsPerLocalitySharedPtr hosts_per_locality = std::make_shared<HostsPerLocalityImpl>();
+  auto update = [&](const HostVector& hosts_added, const HostVector& hosts_removed) {
+    cluster.prioritySet().updateHosts(
+        0,
+        updateHostsParams(hosts, hosts_per_locality,
+                          std::make_shared<const HealthyHostVector>(*hosts), hosts_per_locality),
+        {}, hosts_added, hosts_removed, absl::nullopt);
+  };
+
+  // The initial hosts were delivered as one batch when the cluster initialized.
+  EXPECT_EQ(1, factory_.stats_.counter("cluster_manager.update_delivered").value());
+
+  // The first update is out of the merge window and applied immediately.
+  update({}, {host1});
+  EXPECT_EQ(1, factory_.stats_.counter("cluster_manager.cluster_updated").value());
+  EXPECT_EQ(2, factory_.stats_.counter("cluster_manager.update_delivered").value());
+
+  // These are all merged into one pending update.
+  update({host1}, {});
+  update({}, {host2});
+  update({host2}, {});
+  EXPECT_EQ(2, factory_.stats_.counter("cluster_manager.update_delivered").value());
+  EXPECT_EQ(2, factory_.stats_.counter("cluster_manager.update_merged").value());
+
+  timer->callback_();
+  EXPECT_EQ(1, factory_.stats_.counter("cluster_manager.cluster_updated").value());
+  EXPECT_EQ(1, factory_.stats_.counter("cluster_manager.cluster_updated_via_merge").value());
+  EXPECT_EQ(3, factory_.stats_.counter("cluster_manager.update_delivered").value());
+
+  update({}, {host2});
+  timer->callback_();
+  EXPECT_EQ(2, factory_.stats_.counter("cluster_manager.cluster_updated_via_merge").value());
+  EXPECT_EQ(4, factory_.stats_.counter("cluster_manager.update_delivered").value());
+  EXPECT_EQ(0, factory_.stats_.counter("cluster_manager.update_merge_cancelled").value());
+}
+
 // Tests that mergeable updates outside of a window get applied immediately.
 TEST_F(ClusterManagerImplTest, MergedUpdatesOutOfWindow) {
   createWithLocalClusterUpdate();
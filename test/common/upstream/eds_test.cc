@@ -373,6 +373,53 @@ TEST_F(EdsTest, EndpointMetadata) {
             "v2");
 }
 
+// Validate that an update which only changes the weight of an endpoint updates the host set, so
+// that load balancers which build a weighted schedule on host set updates see the new weight.
+TEST_F(EdsTest, EndpointWeightChangeCausesRebuild) {
+  envoy::api::v2::ClusterLoadAssignment cluster_load_assignment;
+  cluster_load_assignment.set_cluster_name("fare");
+  auto* endpoints = cluster_load_assignment.add_endpoints();
+  auto* endpoint = endpoints->add_lb_endpoints();
+  endpoint->mutable_endpoint()->mutable_address()->mutable_socket_address()->set_address("1.2.3.4");
+  endpoint->mutable_endpoint()->mutable_address()->mutable_socket_address()->set_port_value(80);
+  endpoint->mutable_load_balancing_weight()->set_value(30);
+
+  bool initialized = false;
+  cluster_->initialize([&initialized] { initialized = true; });
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  EXPECT_TRUE(initialized);
+  EXPECT_EQ(0UL, stats_.counter("cluster.name.update_no_rebuild").value());
+  EXPECT_EQ(30UL,
+            stats_.gauge("cluster.name.max_host_weight", Stats::Gauge::ImportMode::NeverImport)
+                .value());
+
+  uint32_t priority_updates = 0;
+  cluster_->prioritySet().addPriorityUpdateCb(
+      [&](uint32_t priority, const HostVector& added, const HostVector& removed) {
+        EXPECT_EQ(0, priority);
+        EXPECT_TRUE(added.empty());
+        EXPECT_TRUE(removed.empty());
+        ++priority_updates;
+      });
+
+  // We don't rebuild with the exact same config.
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  EXPECT_EQ(1UL, stats_.counter("cluster.name.update_no_rebuild").value());
+  EXPECT_EQ(0, priority_updates);
+
+  // The host is kept and its weight is updated in place.
+  const HostSharedPtr host = cluster_->prioritySet().hostSetsPerPriority()[0]->hosts()[0];
+  endpoint->mutable_load_balancing_weight()->set_value(40);
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+  EXPECT_EQ(1UL, stats_.counter("cluster.name.update_no_rebuild").value());
+  EXPECT_EQ(1, priority_updates);
+  EXPECT_EQ(host, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts()[0]);
+  EXPECT_EQ(40, host->weight());
+  EXPECT_EQ(40UL,
+            stats_.gauge("cluster.name.max_host_weight", Stats::Gauge::ImportMode::NeverImport)
+                .value());
+}
+
 // Validate that onConfigUpdate() updates endpoint health status.
 TEST_F(EdsTest, EndpointHealthStatus) {
   envoy::api::v2::ClusterLoadAssignment cluster_load_assignment;
@@ -1079,6 +1126,79 @@ TEST_F(EdsTest, EndpointLocalityWeights) {
   EXPECT_EQ(37, locality_weights[2]);
 }
 
+// Validate that an update which only changes the health of a host and the locality weights
+// reuses the locality buckets of the priority, while a membership change rebuilds them.
+TEST_F(EdsTest, EndpointLocalityBucketsReusedWithoutMembershipChange) {
+  envoy::api::v2::ClusterLoadAssignment cluster_load_assignment;
+  cluster_load_assignment.set_cluster_name("fare");
+  resetCluster(R"EOF(
+      name: name
+      connect_timeout: 0.25s
+      type: EDS
+      lb_policy: ROUND_ROBIN
+      common_lb_config:
+        locality_weighted_lb_config: {}
+      eds_cluster_config:
+        service_name: fare
+        eds_config:
+          api_config_source:
+            api_type: REST
+            cluster_names:
+            - eds
+            refresh_delay: 1s
+    )EOF");
+
+  auto add_endpoints = [&cluster_load_assignment](const std::string& zone, uint32_t weight) {
+    auto* endpoints = cluster_load_assignment.add_endpoints();
+    endpoints->mutable_locality()->set_zone(zone);
+    endpoints->mutable_load_balancing_weight()->set_value(weight);
+    return endpoints;
+  };
+  auto add_endpoint = [](envoy::api::v2::endpoint::LocalityLbEndpoints* endpoints,
+                         const std::string& address) {
+    auto* endpoint_address = endpoints->add_lb_endpoints()
+                                 ->mutable_endpoint()
+                                 ->mutable_address()
+                                 ->mutable_socket_address();
+    endpoint_address->set_address(address);
+    endpoint_address->set_port_value(80);
+  };
+  auto* zone_a = add_endpoints("A", 1);
+  add_endpoint(zone_a, "1.2.3.4");
+  add_endpoint(zone_a, "1.2.3.5");
+  auto* zone_b = add_endpoints("B", 2);
+  add_endpoint(zone_b, "1.2.3.6");
+
+  cluster_->initialize([] {});
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+
+  const auto& host_set = *cluster_->prioritySet().hostSetsPerPriority()[0];
+  const HostsPerLocalityConstSharedPtr hosts_per_locality = host_set.hostsPerLocalityPtr();
+  EXPECT_EQ(2, hosts_per_locality->get().size());
+  EXPECT_EQ(3, host_set.healthyHosts().size());
+
+  // Flip a host to unhealthy and change a locality weight.
+  zone_a->mutable_lb_endpoints(0)->set_health_status(envoy::api::v2::core::HealthStatus::UNHEALTHY);
+  zone_b->mutable_load_balancing_weight()->set_value(5);
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+
+  EXPECT_EQ(hosts_per_locality, host_set.hostsPerLocalityPtr());
+  EXPECT_EQ(2, host_set.healthyHosts().size());
+  EXPECT_EQ(1, host_set.healthyHostsPerLocality().get()[0].size());
+  EXPECT_EQ(1, host_set.healthyHostsPerLocality().get()[1].size());
+  EXPECT_EQ(1, (*host_set.localityWeights())[0]);
+  EXPECT_EQ(5, (*host_set.localityWeights())[1]);
+
+  // Adding a host rebuilds the buckets.
+  add_endpoint(zone_b, "1.2.3.7");
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+
+  EXPECT_NE(hosts_per_locality, host_set.hostsPerLocalityPtr());
+  EXPECT_EQ(2, host_set.hostsPerLocality().get()[0].size());
+  EXPECT_EQ(2, host_set.hostsPerLocality().get()[1].size());
+  EXPECT_EQ(5, (*host_set.localityWeights())[1]);
+}
+
 // Validate that onConfigUpdate() removes any locality not referenced in the
 // config update in each priority.
 TEST_F(EdsTest, RemoveUnreferencedLocalities) {
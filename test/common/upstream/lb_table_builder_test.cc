@@ -0,0 +1,84 @@
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "common/upstream/lb_table_builder.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "absl/synchronization/notification.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+class LoadBalancerTableBuilderTest : public testing::Test {
+protected:
+  // Keep the builder thread busy until release() is called, so that builds wait.
+  void block() {
+    builder_.schedule(&blocker_, [this]() -> void {
+      blocking_.Notify();
+      release_.WaitForNotification();
+    });
+    blocking_.WaitForNotification();
+  }
+  void release() { release_.Notify(); }
+
+  LoadBalancerTableBuilder builder_{Thread::threadFactoryForTest()};
+  const int blocker_{};
+  const int owner_{};
+  const int other_owner_{};
+  absl::Notification blocking_;
+  absl::Notification release_;
+  std::vector<std::string> ran_;
+};
+
+TEST_F(LoadBalancerTableBuilderTest, RunsBuilds) {
+  builder_.schedule(&owner_, [this]() -> void { ran_.push_back("owner"); });
+  builder_.schedule(&other_owner_, [this]() -> void { ran_.push_back("other"); });
+  builder_.waitForIdle();
+  EXPECT_THAT(ran_, testing::ElementsAre("owner", "other"));
+}
+
+// Only the latest of the builds an owner schedules while the builder is busy runs.
+TEST_F(LoadBalancerTableBuilderTest, ReplacesWaitingBuild) {
+  block();
+  builder_.schedule(&owner_, [this]() -> void { ran_.push_back("first"); });
+  builder_.schedule(&other_owner_, [this]() -> void { ran_.push_back("other"); });
+  builder_.schedule(&owner_, [this]() -> void { ran_.push_back("second"); });
+  release();
+  builder_.waitForIdle();
+  EXPECT_THAT(ran_, testing::ElementsAre("second", "other"));
+}
+
+TEST_F(LoadBalancerTableBuilderTest, CancelDropsWaitingBuild) {
+  block();
+  builder_.schedule(&owner_, [this]() -> void { ran_.push_back("owner"); });
+  builder_.schedule(&other_owner_, [this]() -> void { ran_.push_back("other"); });
+  builder_.cancel(&owner_);
+  release();
+  builder_.waitForIdle();
+  EXPECT_THAT(ran_, testing::ElementsAre("other"));
+}
+
+TEST_F(LoadBalancerTableBuilderTest, CancelWaitsForRunningBuild) {
+  std::atomic<bool> done{};
+  absl::Notification started;
+  builder_.schedule(&owner_, [&done, &started, this]() -> void {
+    started.Notify();
+    release_.WaitForNotification();
+    done = true;
+  });
+  started.WaitForNotification();
+
+  auto thread = Thread::threadFactoryForTest().createThread([this]() -> void { release(); });
+  builder_.cancel(&owner_);
+  EXPECT_TRUE(done);
+  thread->join();
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
@@ -2,7 +2,10 @@
 
 #include <memory>
 
+#include "common/event/real_time_system.h"
+#include "common/memory/stats.h"
 #include "common/runtime/runtime_impl.h"
+#include "common/upstream/load_balancer_impl.h"
 #include "common/upstream/maglev_lb.h"
 #include "common/upstream/ring_hash_lb.h"
 #include "common/upstream/upstream_impl.h"
@@ -178,6 +181,43 @@ BENCHMARK(BM_RingHashLoadBalancerChooseHost)
     ->Args({500, 256000, 100000})
     ->Unit(benchmark::kMillisecond);
 
+// Times a single lookup in rings from 1k to 8M entries, which is when the ring stops fitting in
+// the caches. Also reports the memory the ring takes, when built with tcmalloc.
+void BM_RingHashLoadBalancerLookup(benchmark::State& state) {
+  const uint64_t num_hosts = 100;
+  const uint64_t min_ring_size = state.range(0);
+  RingHashTester tester(num_hosts, min_ring_size);
+  const uint64_t allocated_before = Memory::Stats::totalCurrentlyAllocated();
+  tester.ring_hash_lb_->initialize();
+  const uint64_t ring_bytes = Memory::Stats::totalCurrentlyAllocated() - allocated_before;
+  LoadBalancerPtr lb = tester.ring_hash_lb_->factory()->create();
+  TestLoadBalancerContext context;
+
+  // Hash the keys up front, so that only the lookups are timed.
+  std::vector<uint64_t> keys(65536);
+  for (uint64_t i = 0; i < keys.size(); i++) {
+    keys[i] = hashInt(i);
+  }
+
+  uint64_t i = 0;
+  for (auto _ : state) {
+    context.hash_key_ = keys[i++ % keys.size()];
+    benchmark::DoNotOptimize(lb->chooseHost(&context));
+  }
+
+  const uint64_t ring_size =
+      tester.stats_store_.gauge("ring_hash_lb.size", Stats::Gauge::ImportMode::Accumulate).value();
+  state.counters["ring_size"] = ring_size;
+  state.counters["ring_bytes"] = ring_bytes;
+  state.counters["bytes_per_entry"] = static_cast<double>(ring_bytes) / ring_size;
+}
+BENCHMARK(BM_RingHashLoadBalancerLookup)
+    ->Arg(1024)
+    ->Arg(16 * 1024)
+    ->Arg(256 * 1024)
+    ->Arg(1024 * 1024)
+    ->Arg(8 * 1024 * 1024);
+
 void BM_MaglevLoadBalancerChooseHost(benchmark::State& state) {
   for (auto _ : state) {
     // Do not time the creation of the table.
@@ -361,6 +401,150 @@ BENCHMARK(BM_MaglevLoadBalancerWeighted)
     ->Args({500, 95, 75, 25, 10000})
     ->Unit(benchmark::kMillisecond);
 
+// Weighted picks over hosts whose weights only change along with the host set. Round robin picks
+// from a precomputed interleaved schedule, while least request, which scales the weights by the
+// active requests at pick time, reinserts each pick into an EDF schedule and is the baseline.
+void BM_WeightedLoadBalancerChooseHost(benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t weighted_subset_percent = state.range(1);
+  const uint64_t weight = state.range(2);
+  const bool round_robin = state.range(3) != 0;
+  BaseTester tester(num_hosts, weighted_subset_percent, weight);
+  tester.stats_.max_host_weight_.set(weight);
+  LoadBalancerPtr lb;
+  if (round_robin) {
+    lb = std::make_unique<RoundRobinLoadBalancer>(tester.priority_set_, nullptr, tester.stats_,
+                                                  tester.runtime_, tester.random_,
+                                                  tester.common_config_);
+  } else {
+    lb = std::make_unique<LeastRequestLoadBalancer>(
+        tester.priority_set_, nullptr, tester.stats_, tester.runtime_, tester.random_,
+        tester.common_config_, envoy::api::v2::Cluster::LeastRequestLbConfig());
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lb->chooseHost(nullptr));
+  }
+}
+BENCHMARK(BM_WeightedLoadBalancerChooseHost)
+    ->Args({100, 50, 5, 0})
+    ->Args({100, 50, 5, 1})
+    ->Args({10000, 50, 5, 0})
+    ->Args({10000, 50, 5, 1})
+    ->Args({10000, 5, 127, 0})
+    ->Args({10000, 5, 127, 1});
+
+// The cost of building the weighted schedules, which is also paid on each host set update.
+void BM_RoundRobinLoadBalancerBuildSchedule(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    const uint64_t num_hosts = state.range(0);
+    BaseTester tester(num_hosts, 50, 5);
+    tester.stats_.max_host_weight_.set(5);
+    state.ResumeTiming();
+
+    RoundRobinLoadBalancer lb(tester.priority_set_, nullptr, tester.stats_, tester.runtime_,
+                              tester.random_, tester.common_config_);
+  }
+}
+BENCHMARK(BM_RoundRobinLoadBalancerBuildSchedule)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMicrosecond);
+
+// Each pick is followed by the response time of the host, as the router reports it, so this
+// includes the moving average updates. Least request, which does the same two random picks but
+// keeps no state, is the baseline.
+void BM_PeakEwmaLoadBalancerChooseHost(benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const bool peak_ewma = state.range(1) != 0;
+  BaseTester tester(num_hosts);
+  Event::RealTimeSystem time_system;
+  LoadBalancerPtr lb;
+  if (peak_ewma) {
+    lb = std::make_unique<PeakEwmaLoadBalancer>(tester.priority_set_, nullptr, tester.stats_,
+                                                tester.runtime_, tester.random_,
+                                                tester.common_config_, time_system);
+  } else {
+    lb = std::make_unique<LeastRequestLoadBalancer>(
+        tester.priority_set_, nullptr, tester.stats_, tester.runtime_, tester.random_,
+        tester.common_config_, envoy::api::v2::Cluster::LeastRequestLbConfig());
+  }
+
+  uint64_t i = 0;
+  for (auto _ : state) {
+    HostConstSharedPtr host = lb->chooseHost(nullptr);
+    lb->putResponseTime(*host, std::chrono::microseconds(1000 + i++ % 1000));
+  }
+}
+BENCHMARK(BM_PeakEwmaLoadBalancerChooseHost)
+    ->Args({10, 0})
+    ->Args({10, 1})
+    ->Args({1000, 0})
+    ->Args({1000, 1})
+    ->Args({10000, 0})
+    ->Args({10000, 1});
+
+// Models the worker side of EDS churn: each EDS update replaces one host of the cluster. Unmerged,
+// every update is applied to the worker's priority set (refreshing the attached load balancer);
+// with merge_membership_updates, the net change of all of them is applied once.
+void BM_EdsChurnWorkerUpdates(benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t num_updates = state.range(1);
+  const bool merged = state.range(2) != 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    // Half of the hosts are weighted so the load balancer maintains an EDF schedule.
+    BaseTester tester(num_hosts, 50, 2);
+    RoundRobinLoadBalancer lb(tester.priority_set_, nullptr, tester.stats_, tester.runtime_,
+                              tester.random_, tester.common_config_);
+    HostVector replacements;
+    for (uint64_t i = 0; i < num_updates; i++) {
+      replacements.push_back(
+          makeTestHost(tester.info_, fmt::format("tcp://10.1.{}.{}:6379", i / 256, i % 256)));
+    }
+    state.ResumeTiming();
+
+    HostVector hosts = tester.priority_set_.hostSetsPerPriority()[0]->hosts();
+    HostVector merged_added;
+    HostVector merged_removed;
+    for (uint64_t i = 0; i < num_updates; i++) {
+      const uint64_t index = i % num_hosts;
+      const HostVector hosts_added{replacements[i]};
+      const HostVector hosts_removed{hosts[index]};
+      hosts[index] = replacements[i];
+      if (merged) {
+        merged_added.push_back(replacements[i]);
+        merged_removed.push_back(hosts_removed[0]);
+        continue;
+      }
+      HostVectorConstSharedPtr updated_hosts{new HostVector(hosts)};
+      tester.priority_set_.updateHosts(
+          0,
+          updateHostsParams(updated_hosts, nullptr,
+                            std::make_shared<const HealthyHostVector>(*updated_hosts), nullptr),
+          {}, hosts_added, hosts_removed, absl::nullopt);
+    }
+    if (merged) {
+      HostVectorConstSharedPtr updated_hosts{new HostVector(hosts)};
+      tester.priority_set_.updateHosts(
+          0,
+          updateHostsParams(updated_hosts, nullptr,
+                            std::make_shared<const HealthyHostVector>(*updated_hosts), nullptr),
+          {}, merged_added, merged_removed, absl::nullopt);
+    }
+  }
+}
+BENCHMARK(BM_EdsChurnWorkerUpdates)
+    ->Args({1000, 10, 0})
+    ->Args({1000, 10, 1})
+    ->Args({1000, 100, 0})
+    ->Args({1000, 100, 1})
+    ->Args({10000, 100, 0})
+    ->Args({10000, 100, 1})
+    ->Unit(benchmark::kMillisecond);
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
@@ -11,6 +11,7 @@
 #include "test/common/upstream/utility.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/simulated_time_system.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -739,10 +740,10 @@ TEST_P(RoundRobinLoadBalancerTest, Weighted) {
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
   EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
-  // Modify weights, we converge on new weighting after one pick cycle.
+  // Modify weights and refresh the host set, the new weighting is used from the next pick.
   hostSet().healthy_hosts_[0]->weight(2);
   hostSet().healthy_hosts_[1]->weight(1);
-  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
+  hostSet().runCallbacks({}, {});
   EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
   EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
@@ -750,22 +751,23 @@ TEST_P(RoundRobinLoadBalancerTest, Weighted) {
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
   EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
   EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
   // Add a host, it should participate in next round of scheduling.
   hostSet().healthy_hosts_.push_back(makeTestHost(info_, "tcp://127.0.0.1:82", 3));
   hostSet().hosts_.push_back(hostSet().healthy_hosts_.back());
   hostSet().runCallbacks({hostSet().healthy_hosts_.back()}, {});
   EXPECT_EQ(hostSet().healthy_hosts_[2], lb_->chooseHost(nullptr));
   EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
-  EXPECT_EQ(hostSet().healthy_hosts_[2], lb_->chooseHost(nullptr));
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
-  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
-  EXPECT_EQ(hostSet().healthy_hosts_[2], lb_->chooseHost(nullptr));
   EXPECT_EQ(hostSet().healthy_hosts_[2], lb_->chooseHost(nullptr));
   EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
   EXPECT_EQ(hostSet().healthy_hosts_[2], lb_->chooseHost(nullptr));
   EXPECT_EQ(hostSet().healthy_hosts_[2], lb_->chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[2], lb_->chooseHost(nullptr));
   EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[2], lb_->chooseHost(nullptr));
   // Remove last two hosts, add a new one with different weights.
   HostVector removed_hosts = {hostSet().hosts_[1], hostSet().hosts_[2]};
   hostSet().healthy_hosts_.pop_back();
@@ -777,8 +779,6 @@ TEST_P(RoundRobinLoadBalancerTest, Weighted) {
   hostSet().healthy_hosts_[0]->weight(1);
   hostSet().runCallbacks({hostSet().healthy_hosts_.back()}, removed_hosts);
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
-  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
-  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
   EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
@@ -786,6 +786,8 @@ TEST_P(RoundRobinLoadBalancerTest, Weighted) {
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
   EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
 }
 
 // Validate that the RNG seed influences pick order when weighted RR.
@@ -1391,6 +1393,156 @@ TEST_P(RandomLoadBalancerTest, Normal) {
 
 INSTANTIATE_TEST_SUITE_P(PrimaryOrFailover, RandomLoadBalancerTest, ::testing::Values(true, false));
 
+class PeakEwmaLoadBalancerTest : public LoadBalancerTestBase {
+public:
+  void addHosts(HostVector hosts) {
+    hostSet().healthy_hosts_ = hosts;
+    hostSet().hosts_ = hosts;
+    hostSet().runCallbacks(hosts, {});
+  }
+
+  // The first random value chooses the priority, the next two the hosts to compare.
+  void expectPick(uint64_t first, uint64_t second) {
+    EXPECT_CALL(random_, random())
+        .WillOnce(Return(0))
+        .WillOnce(Return(first))
+        .WillOnce(Return(second));
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  PeakEwmaLoadBalancer lb_{priority_set_, nullptr,        stats_,      runtime_,
+                           random_,       common_config_, time_system_};
+};
+
+TEST_P(PeakEwmaLoadBalancerTest, NoHosts) { EXPECT_EQ(nullptr, lb_.chooseHost(nullptr)); }
+
+TEST_P(PeakEwmaLoadBalancerTest, SingleHost) {
+  addHosts({makeTestHost(info_, "tcp://127.0.0.1:80")});
+  lb_.putResponseTime(*hostSet().hosts_[0], std::chrono::milliseconds(10));
+  EXPECT_CALL(random_, random()).WillOnce(Return(0));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
+}
+
+// The two hosts compared are always distinct.
+TEST_P(PeakEwmaLoadBalancerTest, ComparesDistinctHosts) {
+  addHosts({makeTestHost(info_, "tcp://127.0.0.1:80"), makeTestHost(info_, "tcp://127.0.0.1:81"),
+            makeTestHost(info_, "tcp://127.0.0.1:82")});
+  lb_.putResponseTime(*hostSet().hosts_[0], std::chrono::milliseconds(3));
+  lb_.putResponseTime(*hostSet().hosts_[1], std::chrono::milliseconds(2));
+  lb_.putResponseTime(*hostSet().hosts_[2], std::chrono::milliseconds(1));
+
+  expectPick(0, 0);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
+  expectPick(1, 1);
+  EXPECT_EQ(hostSet().healthy_hosts_[2], lb_.chooseHost(nullptr));
+  expectPick(2, 0);
+  EXPECT_EQ(hostSet().healthy_hosts_[2], lb_.chooseHost(nullptr));
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, PicksLowerCost) {
+  addHosts({makeTestHost(info_, "tcp://127.0.0.1:80"), makeTestHost(info_, "tcp://127.0.0.1:81")});
+  lb_.putResponseTime(*hostSet().hosts_[0], std::chrono::milliseconds(10));
+  lb_.putResponseTime(*hostSet().hosts_[1], std::chrono::milliseconds(2));
+
+  expectPick(0, 0);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
+  expectPick(1, 0);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
+
+  // The cost scales with the requests outstanding: 2ms * 6 > 10ms * 1.
+  hostSet().healthy_hosts_[1]->stats().rq_active_.set(5);
+  expectPick(1, 0);
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, WeightScalesCost) {
+  addHosts({makeTestHost(info_, "tcp://127.0.0.1:80", 3),
+            makeTestHost(info_, "tcp://127.0.0.1:81", 1)});
+  lb_.putResponseTime(*hostSet().hosts_[0], std::chrono::milliseconds(2));
+  lb_.putResponseTime(*hostSet().hosts_[1], std::chrono::milliseconds(1));
+
+  // 2ms / 3 < 1ms / 1.
+  expectPick(1, 0);
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
+}
+
+// A response slower than the average replaces it, while faster ones are averaged in.
+TEST_P(PeakEwmaLoadBalancerTest, PeakReplacesAverage) {
+  addHosts({makeTestHost(info_, "tcp://127.0.0.1:80"), makeTestHost(info_, "tcp://127.0.0.1:81")});
+  lb_.putResponseTime(*hostSet().hosts_[0], std::chrono::milliseconds(1));
+  lb_.putResponseTime(*hostSet().hosts_[1], std::chrono::milliseconds(5));
+  expectPick(0, 0);
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
+
+  lb_.putResponseTime(*hostSet().hosts_[0], std::chrono::milliseconds(10));
+  expectPick(0, 0);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
+
+  // Without time passing, a fast response doesn't move the average.
+  lb_.putResponseTime(*hostSet().hosts_[0], std::chrono::milliseconds(1));
+  expectPick(0, 0);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
+
+  // A decay time later, it mostly does: 10ms / e + 1ms * (1 - 1 / e) < 5ms.
+  time_system_.sleep(PeakEwmaLoadBalancer::DefaultDecayTime);
+  lb_.putResponseTime(*hostSet().hosts_[1], std::chrono::milliseconds(5));
+  lb_.putResponseTime(*hostSet().hosts_[0], std::chrono::milliseconds(1));
+  expectPick(0, 0);
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
+}
+
+// The average of a host that isn't responding decays, so that it gets tried again.
+TEST_P(PeakEwmaLoadBalancerTest, IdleHostDecays) {
+  addHosts({makeTestHost(info_, "tcp://127.0.0.1:80"), makeTestHost(info_, "tcp://127.0.0.1:81")});
+  lb_.putResponseTime(*hostSet().hosts_[0], std::chrono::milliseconds(100));
+  lb_.putResponseTime(*hostSet().hosts_[1], std::chrono::milliseconds(10));
+  expectPick(0, 0);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
+
+  // While the other host keeps responding in 10ms: 100ms * e^-3 < 10ms.
+  time_system_.sleep(std::chrono::seconds(30));
+  lb_.putResponseTime(*hostSet().hosts_[1], std::chrono::milliseconds(10));
+  expectPick(0, 0);
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
+}
+
+// Hosts without a response time yet get one request at a time.
+TEST_P(PeakEwmaLoadBalancerTest, NewHostPenalty) {
+  addHosts({makeTestHost(info_, "tcp://127.0.0.1:80"), makeTestHost(info_, "tcp://127.0.0.1:81")});
+  lb_.putResponseTime(*hostSet().hosts_[1], std::chrono::seconds(1));
+  expectPick(1, 0);
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
+
+  hostSet().healthy_hosts_[0]->stats().rq_active_.set(1);
+  hostSet().healthy_hosts_[1]->stats().rq_active_.set(10);
+  expectPick(1, 0);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_.chooseHost(nullptr));
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, RemovedHost) {
+  addHosts({makeTestHost(info_, "tcp://127.0.0.1:80"), makeTestHost(info_, "tcp://127.0.0.1:81")});
+  lb_.putResponseTime(*hostSet().hosts_[0], std::chrono::milliseconds(1));
+  lb_.putResponseTime(*hostSet().hosts_[1], std::chrono::milliseconds(2));
+
+  // Responses of hosts removed while requests were outstanding are dropped.
+  HostSharedPtr removed = hostSet().hosts_[0];
+  hostSet().healthy_hosts_ = {hostSet().hosts_[1]};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({}, {removed});
+  lb_.putResponseTime(*removed, std::chrono::milliseconds(1));
+
+  // Added back, the host starts over.
+  hostSet().healthy_hosts_ = {hostSet().hosts_[0], removed};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({removed}, {});
+  removed->stats().rq_active_.set(1);
+  expectPick(0, 0);
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_.chooseHost(nullptr));
+}
+
+INSTANTIATE_TEST_SUITE_P(PrimaryOrFailover, PeakEwmaLoadBalancerTest,
+                         ::testing::Values(true, false));
+
 TEST(LoadBalancerSubsetInfoImplTest, DefaultConfigIsDiabled) {
   auto subset_info =
       LoadBalancerSubsetInfoImpl(envoy::api::v2::Cluster::LbSubsetConfig::default_instance());
@@ -1,4 +1,8 @@
+#include <chrono>
 #include <cstdint>
+#include <functional>
+#include <queue>
+#include <random>
 #include <string>
 #include <vector>
 
@@ -11,10 +15,12 @@
 #include "test/common/upstream/utility.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/simulated_time_system.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+using testing::Invoke;
 using testing::NiceMock;
 using testing::Return;
 
@@ -91,6 +97,83 @@ TEST(DISABLED_LeastRequestLoadBalancerWeightTest, Weight) {
   }
 }
 
+// Simulate the peak EWMA load balancer in front of a few slow hosts. Requests arrive at a fixed
+// rate, and each host takes a fixed time to respond. The slow hosts should get well under their
+// share of requests.
+TEST(PeakEwmaLoadBalancerSimulationTest, SlowHosts) {
+  const uint64_t num_hosts = 10;
+  const uint64_t num_slow_hosts = 2;
+  const std::chrono::microseconds fast_response_time(5000);
+  const std::chrono::microseconds slow_response_time(50000);
+  const std::chrono::microseconds request_interval(500);
+  const uint64_t total_requests = 20000;
+
+  PrioritySetImpl priority_set;
+  std::shared_ptr<MockClusterInfo> info_{new NiceMock<MockClusterInfo>()};
+  HostVector hosts;
+  std::unordered_map<HostConstSharedPtr, std::chrono::microseconds> response_times;
+  for (uint64_t i = 0; i < num_hosts; i++) {
+    hosts.push_back(makeTestHost(info_, fmt::format("tcp://10.0.{}.{}:6379", i / 256, i % 256)));
+    response_times[hosts.back()] = i < num_slow_hosts ? slow_response_time : fast_response_time;
+  }
+  HostVectorConstSharedPtr updated_hosts{new HostVector(hosts)};
+  HostsPerLocalitySharedPtr updated_locality_hosts{new HostsPerLocalityImpl(hosts)};
+  priority_set.updateHosts(
+      0,
+      updateHostsParams(updated_hosts, updated_locality_hosts,
+                        std::make_shared<const HealthyHostVector>(*updated_hosts),
+                        updated_locality_hosts),
+      {}, hosts, {}, absl::nullopt);
+
+  Stats::IsolatedStoreImpl stats_store;
+  ClusterStats stats{ClusterInfoImpl::generateStats(stats_store)};
+  NiceMock<Runtime::MockLoader> runtime;
+  // Seeded, so that the simulation is the same on every run.
+  std::mt19937_64 prng(1);
+  NiceMock<Runtime::MockRandomGenerator> random;
+  ON_CALL(random, random()).WillByDefault(Invoke([&prng]() -> uint64_t { return prng(); }));
+  envoy::api::v2::Cluster::CommonLbConfig common_config;
+  Event::SimulatedTimeSystem time_system;
+  PeakEwmaLoadBalancer lb{priority_set, nullptr, stats, runtime, random, common_config,
+                          time_system};
+
+  // The outstanding requests, by the time they complete.
+  using Completion = std::pair<MonotonicTime, HostConstSharedPtr>;
+  std::priority_queue<Completion, std::vector<Completion>, std::greater<Completion>> outstanding;
+  const MonotonicTime start = time_system.monotonicTime();
+  std::unordered_map<HostConstSharedPtr, uint64_t> host_hits;
+  std::chrono::microseconds total_response_time(0);
+  for (uint64_t i = 0; i < total_requests; i++) {
+    const MonotonicTime now = start + i * request_interval;
+    while (!outstanding.empty() && outstanding.top().first <= now) {
+      const Completion completion = outstanding.top();
+      outstanding.pop();
+      time_system.setMonotonicTime(completion.first);
+      completion.second->stats().rq_active_.dec();
+      lb.putResponseTime(*completion.second, response_times[completion.second]);
+    }
+    time_system.setMonotonicTime(now);
+
+    HostConstSharedPtr host = lb.chooseHost(nullptr);
+    ASSERT_NE(nullptr, host);
+    host->stats().rq_active_.inc();
+    host_hits[host]++;
+    total_response_time += response_times[host];
+    outstanding.emplace(now + response_times[host], host);
+  }
+
+  uint64_t slow_hits = 0;
+  for (uint64_t i = 0; i < num_slow_hosts; i++) {
+    slow_hits += host_hits[hosts[i]];
+  }
+  const double slow_percent = 100.0 * slow_hits / total_requests;
+  const double fair_percent = 100.0 * num_slow_hosts / num_hosts;
+  const std::chrono::microseconds mean_response_time = total_response_time / total_requests;
+  EXPECT_LT(slow_percent, fair_percent / 2);
+  EXPECT_LT(mean_response_time, 2 * fast_response_time)
+      << "mean response time: " << mean_response_time.count() << "us";
+}
+
 /**
  * This test is for simulation only and should not be run as part of unit tests.
  */
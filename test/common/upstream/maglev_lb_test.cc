@@ -4,6 +4,9 @@
 
 #include "test/common/upstream/utility.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "absl/synchronization/notification.h"
 
 namespace Envoy {
 namespace Upstream {
@@ -299,6 +302,68 @@ TEST_F(MaglevLoadBalancerTest, LocalityWeightedLopsided) {
   EXPECT_EQ(MaglevTable::DefaultTableSize - 1023, counts[0]);
 }
 
+// A table built from the previous one, reusing the permutations of the hosts that are still there,
+// is the same as one built from scratch.
+TEST_F(MaglevLoadBalancerTest, TableFromPrevious) {
+  HostVector hosts;
+  for (uint32_t i = 0; i < 8; i++) {
+    hosts.push_back(makeTestHost(info_, fmt::format("tcp://127.0.0.1:{}", 90 + i)));
+  }
+  NormalizedHostWeightVector previous_weights;
+  NormalizedHostWeightVector weights;
+  for (uint32_t i = 0; i < 6; i++) {
+    previous_weights.push_back({hosts[i], 1.0 / 6});
+    weights.push_back({hosts[i + 2], 1.0 / 6});
+  }
+
+  MaglevLoadBalancerStats stats{ALL_MAGLEV_LOAD_BALANCER_STATS(POOL_GAUGE(stats_store_))};
+  MaglevTable previous(previous_weights, 1.0 / 6, MaglevTable::DefaultTableSize, stats);
+  MaglevTable from_previous(weights, 1.0 / 6, MaglevTable::DefaultTableSize, stats, &previous);
+  MaglevTable from_scratch(weights, 1.0 / 6, MaglevTable::DefaultTableSize, stats);
+  EXPECT_FALSE(previous.builtFor(weights, 1.0 / 6));
+  EXPECT_TRUE(from_previous.builtFor(weights, 1.0 / 6));
+  for (uint64_t i = 0; i < MaglevTable::DefaultTableSize; i++) {
+    EXPECT_EQ(from_scratch.chooseHost(i), from_previous.chooseHost(i));
+  }
+}
+
+// After initialize(), tables are built on the table builder thread, and load balancers keep using
+// the previous tables until the new ones are built.
+TEST_F(MaglevLoadBalancerTest, TablesBuiltInBackground) {
+  LoadBalancerTableBuilder builder(Thread::threadFactoryForTest());
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90")};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  auto maglev_lb = std::make_unique<MaglevLoadBalancer>(priority_set_, stats_, stats_store_,
+                                                        runtime_, random_, common_config_, 7,
+                                                        &builder);
+  maglev_lb->initialize();
+  LoadBalancerPtr lb = maglev_lb->factory()->create();
+  const HostSharedPtr old_host = host_set_.hosts_[0];
+  TestLoadBalancerContext context(0);
+  EXPECT_EQ(old_host, lb->chooseHost(&context));
+
+  // Keep the builder busy, so that the build for the new hosts waits.
+  const int blocker = 0;
+  absl::Notification blocking;
+  absl::Notification release;
+  builder.schedule(&blocker, [&blocking, &release]() -> void {
+    blocking.Notify();
+    release.WaitForNotification();
+  });
+  blocking.WaitForNotification();
+
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:91")};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(old_host, lb->chooseHost(&context));
+  EXPECT_EQ(old_host, maglev_lb->factory()->create()->chooseHost(&context));
+
+  release.Notify();
+  builder.waitForIdle();
+  EXPECT_EQ(host_set_.hosts_[0], lb->chooseHost(&context));
+}
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
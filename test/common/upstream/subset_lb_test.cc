@@ -46,6 +46,11 @@ private:
   std::shared_ptr<SubsetLoadBalancer> lb_;
 };
 
+class SubsetLoadBalancerCacheTester {
+public:
+  static size_t size(const SubsetLoadBalancer& lb) { return lb.subset_cache_.size(); }
+};
+
 namespace SubsetLoadBalancerTest {
 
 class TestMetadataMatchCriterion : public Router::MetadataMatchCriterion {
@@ -93,15 +98,20 @@ public:
       std::initializer_list<std::map<std::string, std::string>::value_type> metadata_matches)
       : matches_(
             new TestMetadataMatchCriteria(std::map<std::string, std::string>(metadata_matches))) {}
+  TestLoadBalancerContext(const std::shared_ptr<Router::MetadataMatchCriteria>& matches,
+                          bool per_request = false)
+      : matches_(matches), per_request_(per_request) {}
 
   // Upstream::LoadBalancerContext
   absl::optional<uint64_t> computeHashKey() override { return {}; }
   const Network::Connection* downstreamConnection() const override { return nullptr; }
   const Router::MetadataMatchCriteria* metadataMatchCriteria() override { return matches_.get(); }
+  bool metadataMatchCriteriaPerRequest() const override { return per_request_; }
   const Http::HeaderMap* downstreamHeaders() const override { return nullptr; }
 
 private:
   const std::shared_ptr<Router::MetadataMatchCriteria> matches_;
+  const bool per_request_{};
 };
 
 enum UpdateOrder { REMOVES_FIRST, SIMULTANEOUS };
@@ -655,6 +665,85 @@ TEST_P(SubsetLoadBalancerTest, UpdateFailover) {
   EXPECT_FALSE(nullptr == lb_->chooseHost(&context_10).get());
 }
 
+// Subset lookups are cached by the criteria object. Criteria at the same address, but with other
+// contents, must not get the cached subset.
+TEST_F(SubsetLoadBalancerTest, CachedSubsetOfReusedCriteria) {
+  EXPECT_CALL(subset_info_, fallbackPolicy())
+      .WillRepeatedly(Return(envoy::api::v2::Cluster::LbSubsetConfig::NO_FALLBACK));
+
+  std::vector<std::set<std::string>> subset_keys = {{"version"}};
+  EXPECT_CALL(subset_info_, subsetKeys()).WillRepeatedly(ReturnRef(subset_keys));
+
+  init({
+      {"tcp://127.0.0.1:80", {{"version", "1.0"}}},
+      {"tcp://127.0.0.1:81", {{"version", "1.1"}}},
+  });
+
+  auto criteria = std::make_shared<TestMetadataMatchCriteria>(
+      std::map<std::string, std::string>{{"version", "1.0"}});
+  TestLoadBalancerContext context(criteria);
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context));
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context));
+
+  *criteria = TestMetadataMatchCriteria(std::map<std::string, std::string>{{"version", "1.1"}});
+  EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(&context));
+
+  *criteria = TestMetadataMatchCriteria(std::map<std::string, std::string>{{"version", "1.2"}});
+  EXPECT_EQ(nullptr, lb_->chooseHost(&context));
+}
+
+// Criteria created per request are not cached, so they do not evict the cached lookups of the
+// criteria shared by requests.
+TEST_F(SubsetLoadBalancerTest, PerRequestCriteriaNotCached) {
+  EXPECT_CALL(subset_info_, fallbackPolicy())
+      .WillRepeatedly(Return(envoy::api::v2::Cluster::LbSubsetConfig::NO_FALLBACK));
+
+  std::vector<std::set<std::string>> subset_keys = {{"version"}};
+  EXPECT_CALL(subset_info_, subsetKeys()).WillRepeatedly(ReturnRef(subset_keys));
+
+  init({
+      {"tcp://127.0.0.1:80", {{"version", "1.0"}}},
+      {"tcp://127.0.0.1:81", {{"version", "1.1"}}},
+  });
+
+  TestLoadBalancerContext route_context({{"version", "1.0"}});
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&route_context));
+  EXPECT_EQ(1, SubsetLoadBalancerCacheTester::size(*lb_));
+
+  for (int i = 0; i < 10; i++) {
+    TestLoadBalancerContext request_context(
+        std::make_shared<TestMetadataMatchCriteria>(
+            std::map<std::string, std::string>{{"version", "1.1"}}),
+        true);
+    EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(&request_context));
+  }
+  EXPECT_EQ(1, SubsetLoadBalancerCacheTester::size(*lb_));
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&route_context));
+}
+
+// A lookup that found no subset is not cached past the hosts changing.
+TEST_P(SubsetLoadBalancerTest, CachedSubsetAfterUpdate) {
+  EXPECT_CALL(subset_info_, fallbackPolicy())
+      .WillRepeatedly(Return(envoy::api::v2::Cluster::LbSubsetConfig::NO_FALLBACK));
+
+  std::vector<std::set<std::string>> subset_keys = {{"version"}};
+  EXPECT_CALL(subset_info_, subsetKeys()).WillRepeatedly(ReturnRef(subset_keys));
+
+  init({
+      {"tcp://127.0.0.1:80", {{"version", "1.0"}}},
+  });
+
+  TestLoadBalancerContext context_11({{"version", "1.1"}});
+  EXPECT_EQ(nullptr, lb_->chooseHost(&context_11));
+
+  HostSharedPtr host_v11 = makeHost("tcp://127.0.0.1:8001", {{"version", "1.1"}});
+  modifyHosts({host_v11}, {});
+  EXPECT_EQ(host_v11, lb_->chooseHost(&context_11));
+
+  modifyHosts({}, {host_v11});
+  EXPECT_EQ(nullptr, lb_->chooseHost(&context_11));
+}
+
 TEST_P(SubsetLoadBalancerTest, OnlyMetadataChanged) {
   TestLoadBalancerContext context_10({{"version", "1.0"}});
   TestLoadBalancerContext context_12({{"version", "1.2"}});
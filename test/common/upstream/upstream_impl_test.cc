@@ -1874,6 +1874,35 @@ TEST_F(ClusterInfoImplTest, Metadata) {
   EXPECT_EQ(LoadBalancerType::Maglev, cluster->info()->lbType());
 }
 
+TEST_F(ClusterInfoImplTest, PeakEwmaLbType) {
+  const std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 0.25s
+    type: STRICT_DNS
+    lb_policy: PEAK_EWMA
+    hosts: [{ socket_address: { address: foo.bar.com, port_value: 443 }}]
+  )EOF";
+
+  auto cluster = makeCluster(yaml);
+  EXPECT_EQ(LoadBalancerType::PeakEwma, cluster->info()->lbType());
+}
+
+TEST_F(ClusterInfoImplTest, PeakEwmaLbTypeWithSubsets) {
+  const std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 0.25s
+    type: STRICT_DNS
+    lb_policy: PEAK_EWMA
+    hosts: [{ socket_address: { address: foo.bar.com, port_value: 443 }}]
+    lb_subset_config:
+      subset_selectors:
+        - keys: [ "x" ]
+  )EOF";
+
+  EXPECT_THROW_WITH_MESSAGE(makeCluster(yaml), EnvoyException,
+                            "cluster: LB type 'peak_ewma' may not be used with lb_subset_config");
+}
+
 // Eds service_name is populated.
 TEST_F(ClusterInfoImplTest, EdsServiceNamePopulation) {
   const std::string yaml = R"EOF(
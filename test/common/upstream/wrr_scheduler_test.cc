@@ -0,0 +1,121 @@
+#include "common/upstream/wrr_scheduler.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+TEST(WrrSchedulerTest, Empty) {
+  WrrScheduler<uint32_t> sched;
+  EXPECT_TRUE(sched.empty());
+  EXPECT_EQ(nullptr, sched.pick());
+  sched.seek(42);
+  EXPECT_EQ(nullptr, sched.pick());
+}
+
+// Validate we get regular RR behavior when all weights are the same.
+TEST(WrrSchedulerTest, Unweighted) {
+  WrrScheduler<uint32_t> sched;
+  constexpr uint32_t num_entries = 128;
+  std::shared_ptr<uint32_t> entries[num_entries];
+
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    entries[i] = std::make_shared<uint32_t>(i);
+    sched.add(1, entries[i]);
+  }
+  EXPECT_FALSE(sched.empty());
+
+  for (uint32_t rounds = 0; rounds < 128; ++rounds) {
+    for (uint32_t i = 0; i < num_entries; ++i) {
+      EXPECT_EQ(i, *sched.pick());
+    }
+  }
+}
+
+// Validate we get weighted RR behavior when weights are distinct.
+TEST(WrrSchedulerTest, Weighted) {
+  WrrScheduler<uint32_t> sched;
+  constexpr uint32_t num_entries = 128;
+  std::shared_ptr<uint32_t> entries[num_entries];
+  uint32_t pick_count[num_entries];
+
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    entries[i] = std::make_shared<uint32_t>(i);
+    sched.add(i + 1, entries[i]);
+    pick_count[i] = 0;
+  }
+
+  for (uint32_t i = 0; i < (num_entries * (1 + num_entries)) / 2; ++i) {
+    ++pick_count[*sched.pick()];
+  }
+
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    EXPECT_EQ(i + 1, pick_count[i]);
+  }
+}
+
+// Validate that the picks of heavier entries are interleaved with the picks of lighter ones, and
+// that entries of the same weight keep their insertion order.
+TEST(WrrSchedulerTest, Interleaved) {
+  WrrScheduler<uint32_t> sched;
+  std::shared_ptr<uint32_t> entries[4];
+  const uint32_t weights[4] = {1, 3, 2, 3};
+
+  for (uint32_t i = 0; i < 4; ++i) {
+    entries[i] = std::make_shared<uint32_t>(i);
+    sched.add(weights[i], entries[i]);
+  }
+
+  const uint32_t expected[] = {1, 3, 2, 0, 1, 3, 2, 1, 3};
+  for (uint32_t rounds = 0; rounds < 2; ++rounds) {
+    for (uint32_t i : expected) {
+      EXPECT_EQ(i, *sched.pick());
+    }
+  }
+}
+
+// Validate that seek() moves the position of the schedule modulo its total weight.
+TEST(WrrSchedulerTest, Seek) {
+  WrrScheduler<uint32_t> sched;
+  std::shared_ptr<uint32_t> entries[3];
+  const uint32_t weights[3] = {1, 3, 2};
+
+  for (uint32_t i = 0; i < 3; ++i) {
+    entries[i] = std::make_shared<uint32_t>(i);
+    sched.add(weights[i], entries[i]);
+  }
+
+  // The schedule is 1 2 0 1 2 1.
+  sched.seek(4);
+  EXPECT_EQ(2, *sched.pick());
+  EXPECT_EQ(1, *sched.pick());
+  EXPECT_EQ(1, *sched.pick());
+
+  sched.seek(6 * 1000 + 3);
+  EXPECT_EQ(1, *sched.pick());
+  EXPECT_EQ(2, *sched.pick());
+  EXPECT_EQ(1, *sched.pick());
+  EXPECT_EQ(1, *sched.pick());
+}
+
+// Validate that adding an entry restarts the schedule.
+TEST(WrrSchedulerTest, AddRestarts) {
+  WrrScheduler<uint32_t> sched;
+  auto first = std::make_shared<uint32_t>(0);
+  auto second = std::make_shared<uint32_t>(1);
+
+  sched.add(1, first);
+  EXPECT_EQ(0, *sched.pick());
+  EXPECT_EQ(0, *sched.pick());
+
+  sched.add(2, second);
+  EXPECT_EQ(1, *sched.pick());
+  EXPECT_EQ(0, *sched.pick());
+  EXPECT_EQ(1, *sched.pick());
+  EXPECT_EQ(1, *sched.pick());
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
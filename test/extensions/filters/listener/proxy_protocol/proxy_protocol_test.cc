@@ -67,6 +67,7 @@ public:
   Network::FilterChainFactory& filterChainFactory() override { return factory_; }
   Network::Socket& socket() override { return socket_; }
   const Network::Socket& socket() const override { return socket_; }
+  Network::Socket* workerSocket(uint32_t) override { return nullptr; }
   bool bindToPort() override { return true; }
   bool handOffRestoredDestinationConnections() const override { return false; }
   uint32_t perConnectionBufferLimitBytes() const override { return 0; }
@@ -895,6 +896,7 @@ public:
   Network::FilterChainFactory& filterChainFactory() override { return factory_; }
   Network::Socket& socket() override { return socket_; }
   const Network::Socket& socket() const override { return socket_; }
+  Network::Socket* workerSocket(uint32_t) override { return nullptr; }
   bool bindToPort() override { return true; }
   bool handOffRestoredDestinationConnections() const override { return false; }
   uint32_t perConnectionBufferLimitBytes() const override { return 0; }
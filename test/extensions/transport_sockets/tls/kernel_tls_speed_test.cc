@@ -0,0 +1,159 @@
+// Measures TLS 1.2 AES-128-GCM throughput over a loopback TCP connection, with records encrypted
+// and decrypted by BoringSSL versus by the kernel. Each iteration sends one message from the server
+// to the client. Run with --benchmark_counters_tabular=true to compare the bytes per second. The
+// kernel variants report an error unless the tls kernel module is loaded.
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "common/common/assert.h"
+
+#include "extensions/transport_sockets/tls/kernel_tls.h"
+
+#include "test/test_common/environment.h"
+
+#include "benchmark/benchmark.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+class TlsConnectionPair {
+public:
+  TlsConnectionPair() {
+    const int listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t address_length = sizeof(address);
+    RELEASE_ASSERT(::bind(listen_fd, reinterpret_cast<sockaddr*>(&address), address_length) == 0,
+                   "");
+    RELEASE_ASSERT(::listen(listen_fd, 1) == 0, "");
+    ::getsockname(listen_fd, reinterpret_cast<sockaddr*>(&address), &address_length);
+    client_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    RELEASE_ASSERT(
+        ::connect(client_fd_, reinterpret_cast<sockaddr*>(&address), address_length) == 0, "");
+    server_fd_ = ::accept(listen_fd, nullptr, nullptr);
+    ::close(listen_fd);
+
+    const std::string test_data = TestEnvironment::runfilesPath(
+        "test/extensions/transport_sockets/tls/test_data");
+    server_ctx_.reset(SSL_CTX_new(TLS_method()));
+    RELEASE_ASSERT(SSL_CTX_use_certificate_chain_file(
+                       server_ctx_.get(), (test_data + "/san_dns_cert.pem").c_str()) == 1,
+                   "");
+    RELEASE_ASSERT(SSL_CTX_use_PrivateKey_file(server_ctx_.get(),
+                                               (test_data + "/san_dns_key.pem").c_str(),
+                                               SSL_FILETYPE_PEM) == 1,
+                   "");
+    client_ctx_.reset(SSL_CTX_new(TLS_method()));
+    SSL_CTX_set_max_proto_version(client_ctx_.get(), TLS1_2_VERSION);
+    SSL_CTX_set_strict_cipher_list(client_ctx_.get(), "ECDHE-RSA-AES128-GCM-SHA256");
+
+    client_.reset(SSL_new(client_ctx_.get()));
+    server_.reset(SSL_new(server_ctx_.get()));
+    SSL_set_fd(client_.get(), client_fd_);
+    SSL_set_fd(server_.get(), server_fd_);
+    SSL_set_connect_state(client_.get());
+    SSL_set_accept_state(server_.get());
+
+    // Both ends run on this thread, so step their handshakes in turn on non-blocking sockets.
+    ::fcntl(client_fd_, F_SETFL, O_NONBLOCK);
+    ::fcntl(server_fd_, F_SETFL, O_NONBLOCK);
+    bool client_done = false;
+    bool server_done = false;
+    for (int i = 0; i < 1000 && !(client_done && server_done); i++) {
+      client_done = client_done || SSL_do_handshake(client_.get()) == 1;
+      server_done = server_done || SSL_do_handshake(server_.get()) == 1;
+    }
+    RELEASE_ASSERT(client_done && server_done, "");
+    ::fcntl(client_fd_, F_SETFL, 0);
+    ::fcntl(server_fd_, F_SETFL, 0);
+  }
+
+  ~TlsConnectionPair() {
+    client_.reset();
+    server_.reset();
+    ::close(client_fd_);
+    ::close(server_fd_);
+  }
+
+  int client_fd_;
+  int server_fd_;
+  bssl::UniquePtr<SSL_CTX> server_ctx_;
+  bssl::UniquePtr<SSL_CTX> client_ctx_;
+  bssl::UniquePtr<SSL> client_;
+  bssl::UniquePtr<SSL> server_;
+};
+
+// Arg 0 selects kernel TLS on both ends, arg 1 is the message size.
+static void TlsLoopbackThroughput(benchmark::State& state) {
+  TlsConnectionPair pair;
+  const bool kernel_tls = state.range(0) != 0;
+  if (kernel_tls &&
+      (KernelTls::offload(pair.server_.get(), pair.server_fd_) !=
+           KernelTls::OffloadResult::Offloaded ||
+       KernelTls::offload(pair.client_.get(), pair.client_fd_) !=
+           KernelTls::OffloadResult::Offloaded)) {
+    state.SkipWithError("kernel TLS is not available");
+    return;
+  }
+
+  const std::string message(state.range(1), 'a');
+  std::vector<char> buffer(65536);
+  uint64_t bytes = 0;
+  for (auto _ : state) {
+    // Write in 16KiB pieces, and read each back before the next, so neither end blocks for long.
+    for (size_t offset = 0; offset < message.size(); offset += 16384) {
+      const size_t length = std::min<size_t>(16384, message.size() - offset);
+      if (kernel_tls) {
+        RELEASE_ASSERT(::write(pair.server_fd_, message.data() + offset, length) ==
+                           static_cast<ssize_t>(length),
+                       "");
+      } else {
+        RELEASE_ASSERT(SSL_write(pair.server_.get(), message.data() + offset, length) ==
+                           static_cast<int>(length),
+                       "");
+      }
+      size_t received = 0;
+      while (received < length) {
+        const ssize_t rc = kernel_tls ? ::read(pair.client_fd_, buffer.data(), buffer.size())
+                                      : SSL_read(pair.client_.get(), buffer.data(), buffer.size());
+        RELEASE_ASSERT(rc > 0, "");
+        received += rc;
+      }
+    }
+    bytes += message.size();
+  }
+
+  state.counters["bytes_per_second"] = benchmark::Counter(bytes, benchmark::Counter::kIsRate);
+}
+BENCHMARK(TlsLoopbackThroughput)
+    ->Args({0, 1024})
+    ->Args({1, 1024})
+    ->Args({0, 16384})
+    ->Args({1, 16384})
+    ->Args({0, 1 << 20})
+    ->Args({1, 1 << 20});
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,162 @@
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "common/common/assert.h"
+
+#include "extensions/transport_sockets/tls/kernel_tls.h"
+
+#include "test/test_common/environment.h"
+
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+// Runs a BoringSSL client and server over a loopback TCP connection, the ULP only being available
+// on TCP sockets.
+class KernelTlsTest : public testing::Test {
+protected:
+  KernelTlsTest() {
+    const int listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    RELEASE_ASSERT(listen_fd >= 0, "");
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t address_length = sizeof(address);
+    RELEASE_ASSERT(::bind(listen_fd, reinterpret_cast<sockaddr*>(&address), address_length) == 0,
+                   "");
+    RELEASE_ASSERT(::listen(listen_fd, 1) == 0, "");
+    RELEASE_ASSERT(::getsockname(listen_fd, reinterpret_cast<sockaddr*>(&address),
+                                 &address_length) == 0,
+                   "");
+    client_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    RELEASE_ASSERT(
+        ::connect(client_fd_, reinterpret_cast<sockaddr*>(&address), address_length) == 0, "");
+    server_fd_ = ::accept(listen_fd, nullptr, nullptr);
+    RELEASE_ASSERT(server_fd_ >= 0, "");
+    ::close(listen_fd);
+
+    server_ctx_.reset(SSL_CTX_new(TLS_method()));
+    const std::string test_data = TestEnvironment::substitute(
+        "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data");
+    RELEASE_ASSERT(SSL_CTX_use_certificate_chain_file(
+                       server_ctx_.get(), (test_data + "/san_dns_cert.pem").c_str()) == 1,
+                   "");
+    RELEASE_ASSERT(SSL_CTX_use_PrivateKey_file(server_ctx_.get(),
+                                               (test_data + "/san_dns_key.pem").c_str(),
+                                               SSL_FILETYPE_PEM) == 1,
+                   "");
+    client_ctx_.reset(SSL_CTX_new(TLS_method()));
+  }
+
+  ~KernelTlsTest() {
+    client_.reset();
+    server_.reset();
+    ::close(client_fd_);
+    ::close(server_fd_);
+  }
+
+  void handshake(uint16_t max_version, const char* ciphers) {
+    RELEASE_ASSERT(SSL_CTX_set_max_proto_version(client_ctx_.get(), max_version) == 1, "");
+    RELEASE_ASSERT(SSL_CTX_set_strict_cipher_list(client_ctx_.get(), ciphers) == 1, "");
+    client_.reset(SSL_new(client_ctx_.get()));
+    server_.reset(SSL_new(server_ctx_.get()));
+    SSL_set_fd(client_.get(), client_fd_);
+    SSL_set_fd(server_.get(), server_fd_);
+    SSL_set_connect_state(client_.get());
+    SSL_set_accept_state(server_.get());
+    RELEASE_ASSERT(::fcntl(client_fd_, F_SETFL, O_NONBLOCK) == 0, "");
+    RELEASE_ASSERT(::fcntl(server_fd_, F_SETFL, O_NONBLOCK) == 0, "");
+
+    bool client_done = false;
+    bool server_done = false;
+    for (int i = 0; i < 1000 && !(client_done && server_done); i++) {
+      client_done = client_done || SSL_do_handshake(client_.get()) == 1;
+      server_done = server_done || SSL_do_handshake(server_.get()) == 1;
+    }
+    RELEASE_ASSERT(client_done && server_done, "");
+    RELEASE_ASSERT(::fcntl(client_fd_, F_SETFL, 0) == 0, "");
+    RELEASE_ASSERT(::fcntl(server_fd_, F_SETFL, 0) == 0, "");
+  }
+
+  std::string serverRecv(uint8_t& record_type) {
+    char buffer[1024];
+    iovec iov{buffer, sizeof(buffer)};
+    const Api::SysCallSizeResult result = KernelTls::recv(server_fd_, &iov, 1, record_type);
+    EXPECT_GE(result.rc_, 0);
+    return std::string(buffer, std::max<ssize_t>(result.rc_, 0));
+  }
+
+  int client_fd_;
+  int server_fd_;
+  bssl::UniquePtr<SSL_CTX> server_ctx_;
+  bssl::UniquePtr<SSL_CTX> client_ctx_;
+  bssl::UniquePtr<SSL> client_;
+  bssl::UniquePtr<SSL> server_;
+};
+
+TEST_F(KernelTlsTest, Tls13Unsupported) {
+  handshake(TLS1_3_VERSION, "ALL");
+  ASSERT_EQ(TLS1_3_VERSION, SSL_version(server_.get()));
+  EXPECT_EQ(KernelTls::OffloadResult::Unsupported, KernelTls::offload(server_.get(), server_fd_));
+
+  // The connection keeps working through BoringSSL.
+  EXPECT_EQ(5, SSL_write(client_.get(), "hello", 5));
+  char buffer[5];
+  EXPECT_EQ(5, SSL_read(server_.get(), buffer, sizeof(buffer)));
+  EXPECT_EQ("hello", std::string(buffer, sizeof(buffer)));
+}
+
+TEST_F(KernelTlsTest, ChaCha20Unsupported) {
+  handshake(TLS1_2_VERSION, "ECDHE-RSA-CHACHA20-POLY1305");
+  EXPECT_EQ(KernelTls::OffloadResult::Unsupported, KernelTls::offload(server_.get(), server_fd_));
+}
+
+class KernelTlsAesGcmTest : public KernelTlsTest,
+                            public testing::WithParamInterface<const char*> {};
+
+INSTANTIATE_TEST_SUITE_P(Ciphers, KernelTlsAesGcmTest,
+                         testing::Values("ECDHE-RSA-AES128-GCM-SHA256",
+                                         "ECDHE-RSA-AES256-GCM-SHA384"));
+
+TEST_P(KernelTlsAesGcmTest, Offloaded) {
+  handshake(TLS1_2_VERSION, GetParam());
+  const KernelTls::OffloadResult result = KernelTls::offload(server_.get(), server_fd_);
+  if (result == KernelTls::OffloadResult::Unavailable) {
+    // The tls kernel module is not loaded.
+    return;
+  }
+  ASSERT_EQ(KernelTls::OffloadResult::Offloaded, result);
+
+  // The kernel decrypts what BoringSSL encrypts, and the other way around.
+  uint8_t record_type;
+  EXPECT_EQ(5, SSL_write(client_.get(), "hello", 5));
+  EXPECT_EQ("hello", serverRecv(record_type));
+  EXPECT_EQ(KernelTls::RecordTypeApplicationData, record_type);
+
+  EXPECT_EQ(5, ::write(server_fd_, "world", 5));
+  char buffer[5];
+  EXPECT_EQ(5, SSL_read(client_.get(), buffer, sizeof(buffer)));
+  EXPECT_EQ("world", std::string(buffer, sizeof(buffer)));
+
+  // Alerts are reported as such in both directions.
+  EXPECT_EQ(0, SSL_shutdown(client_.get()));
+  EXPECT_EQ(std::string("\x01\x00", 2), serverRecv(record_type));
+  EXPECT_EQ(KernelTls::RecordTypeAlert, record_type);
+  EXPECT_EQ(2, KernelTls::sendCloseNotify(server_fd_).rc_);
+  EXPECT_EQ(1, SSL_shutdown(client_.get()));
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
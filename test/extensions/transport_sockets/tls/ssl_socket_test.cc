@@ -753,6 +753,31 @@ TEST_P(SslSocketTest, GetCertDigest) {
                .setExpectedSerialNumber(TEST_NO_SAN_CERT_SERIAL));
 }
 
+// Kernel TLS only takes TLS 1.2 keys, so a TLS 1.3 connection keeps using BoringSSL.
+TEST_P(SslSocketTest, KernelTlsUnsupportedVersion) {
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_3
+      tls_maximum_protocol_version: TLSv1_3
+)EOF";
+
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_key.pem"
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_3
+    enable_kernel_tls: true
+)EOF";
+
+  TestUtilOptions test_options(client_ctx_yaml, server_ctx_yaml, true, GetParam());
+  testUtil(test_options.setExpectedServerStats("ssl.kernel_tls_unsupported").setExpectNoCert());
+}
+
 TEST_P(SslSocketTest, GetCertDigestInline) {
   envoy::api::v2::Listener listener;
   envoy::api::v2::listener::FilterChain* filter_chain = listener.add_filter_chains();
@@ -38,6 +38,7 @@ private:
     Upstream::HostConstSharedPtr chooseHost(Upstream::LoadBalancerContext*) override {
       return host_;
     }
+    void putResponseTime(const Upstream::HostDescription&, std::chrono::microseconds) override {}
 
     const Upstream::HostSharedPtr host_;
   };
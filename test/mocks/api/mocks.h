@@ -74,6 +74,10 @@ public:
   MOCK_METHOD5(getsockopt_,
                int(int sockfd, int level, int optname, void* optval, socklen_t* optlen));
   MOCK_METHOD3(socket, SysCallIntResult(int domain, int type, int protocol));
+  MOCK_METHOD4(recvmmsg, SysCallIntResult(int sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                          int flags));
+  MOCK_METHOD4(sendmmsg, SysCallIntResult(int sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                          int flags));
 
   // Map from (sockfd,level,optname) to boolean socket option.
   using SockOptKey = std::tuple<int, int, int>;
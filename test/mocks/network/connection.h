@@ -85,6 +85,8 @@ public:
   MOCK_METHOD1(setDelayedCloseTimeout, void(std::chrono::milliseconds));
   MOCK_CONST_METHOD0(delayedCloseTimeout, std::chrono::milliseconds());
   MOCK_CONST_METHOD0(transportFailureReason, absl::string_view());
+  MOCK_METHOD0(spliceableIoHandle, IoHandle*());
+  MOCK_METHOD2(addSplicedBytes, void(uint64_t bytes_read, uint64_t bytes_written));
 };
 
 /**
@@ -131,6 +133,8 @@ public:
   MOCK_METHOD1(setDelayedCloseTimeout, void(std::chrono::milliseconds));
   MOCK_CONST_METHOD0(delayedCloseTimeout, std::chrono::milliseconds());
   MOCK_CONST_METHOD0(transportFailureReason, absl::string_view());
+  MOCK_METHOD0(spliceableIoHandle, IoHandle*());
+  MOCK_METHOD2(addSplicedBytes, void(uint64_t bytes_read, uint64_t bytes_written));
 
   // Network::ClientConnection
   MOCK_METHOD0(connect, void());
@@ -180,6 +184,8 @@ public:
   MOCK_METHOD1(setDelayedCloseTimeout, void(std::chrono::milliseconds));
   MOCK_CONST_METHOD0(delayedCloseTimeout, std::chrono::milliseconds());
   MOCK_CONST_METHOD0(transportFailureReason, absl::string_view());
+  MOCK_METHOD0(spliceableIoHandle, IoHandle*());
+  MOCK_METHOD2(addSplicedBytes, void(uint64_t bytes_read, uint64_t bytes_written));
 
   // Network::FilterManagerConnection
   MOCK_METHOD0(getReadBuffer, StreamBuffer());
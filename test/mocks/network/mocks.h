@@ -303,6 +303,7 @@ public:
   MOCK_METHOD0(filterChainFactory, FilterChainFactory&());
   MOCK_METHOD0(socket, Socket&());
   MOCK_CONST_METHOD0(socket, const Socket&());
+  MOCK_METHOD1(workerSocket, Socket*(uint32_t worker_index));
   MOCK_METHOD0(bindToPort, bool());
   MOCK_CONST_METHOD0(handOffRestoredDestinationConnections, bool());
   MOCK_CONST_METHOD0(perConnectionBufferLimitBytes, uint32_t());
@@ -396,6 +397,7 @@ public:
   MOCK_METHOD2(doWrite, IoResult(Buffer::Instance& buffer, bool end_stream));
   MOCK_METHOD0(onConnected, void());
   MOCK_CONST_METHOD0(ssl, const Ssl::ConnectionInfo*());
+  MOCK_CONST_METHOD0(passthrough, bool());
 
   TransportSocketCallbacks* callbacks_{};
 };
@@ -435,6 +437,7 @@ public:
   MOCK_METHOD0(dispatcher, Event::Dispatcher&());
   MOCK_CONST_METHOD0(localAddress, Address::InstanceConstSharedPtr&());
   MOCK_METHOD1(send, Api::IoCallUint64Result(const UdpSendData&));
+  MOCK_METHOD1(sendBatch, Api::IoCallUint64Result(const std::vector<UdpSendData>&));
 };
 
 class MockUdpReadFilterCallbacks : public UdpReadFilterCallbacks {
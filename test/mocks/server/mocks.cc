@@ -33,6 +33,8 @@ MockOptions::MockOptions(const std::string& config_path) : config_path_(config_p
   ON_CALL(*this, signalHandlingEnabled()).WillByDefault(ReturnPointee(&signal_handling_enabled_));
   ON_CALL(*this, mutexTracingEnabled()).WillByDefault(ReturnPointee(&mutex_tracing_enabled_));
   ON_CALL(*this, cpusetThreadsEnabled()).WillByDefault(ReturnPointee(&cpuset_threads_enabled_));
+  ON_CALL(*this, ioUringEnabled()).WillByDefault(ReturnPointee(&io_uring_enabled_));
+  ON_CALL(*this, timerWheelResolution()).WillByDefault(ReturnPointee(&timer_wheel_resolution_));
   ON_CALL(*this, toCommandLineOptions()).WillByDefault(Invoke([] {
     return std::make_unique<envoy::admin::v2alpha::CommandLineOptions>();
   }));
@@ -94,6 +96,18 @@ MockListenerComponentFactory::MockListenerComponentFactory()
             }
             return socket_;
           }));
+  ON_CALL(*this, createWorkerListenSocket(_, _, _, _))
+      .WillByDefault(Invoke([](Network::Address::InstanceConstSharedPtr,
+                               Network::Address::SocketType,
+                               const Network::Socket::OptionsSharedPtr& options,
+                               uint32_t) -> Network::SocketSharedPtr {
+        auto socket = std::make_shared<NiceMock<Network::MockListenSocket>>();
+        if (!Network::Socket::applyOptions(options, *socket,
+                                           envoy::api::v2::core::SocketOption::STATE_PREBIND)) {
+          throw EnvoyException("MockListenerComponentFactory: Setting socket options failed");
+        }
+        return socket;
+      }));
 }
 MockListenerComponentFactory::~MockListenerComponentFactory() = default;
 
@@ -80,6 +80,8 @@ public:
   MOCK_CONST_METHOD0(mutexTracingEnabled, bool());
   MOCK_CONST_METHOD0(libeventBufferEnabled, bool());
   MOCK_CONST_METHOD0(cpusetThreadsEnabled, bool());
+  MOCK_CONST_METHOD0(ioUringEnabled, bool());
+  MOCK_CONST_METHOD0(timerWheelResolution, std::chrono::milliseconds());
   MOCK_CONST_METHOD0(toCommandLineOptions, Server::CommandLineOptionsPtr());
 
   std::string config_path_;
@@ -96,6 +98,8 @@ public:
   bool signal_handling_enabled_{true};
   bool mutex_tracing_enabled_{};
   bool cpuset_threads_enabled_{};
+  bool io_uring_enabled_{};
+  std::chrono::milliseconds timer_wheel_resolution_{};
 };
 
 class MockConfigTracker : public ConfigTracker {
@@ -195,7 +199,8 @@ public:
 
   // Server::HotRestart
   MOCK_METHOD0(drainParentListeners, void());
-  MOCK_METHOD1(duplicateParentListenSocket, int(const std::string& address));
+  MOCK_METHOD2(duplicateParentListenSocket,
+               int(const std::string& address, uint32_t worker_index));
   MOCK_METHOD0(getParentStats, std::unique_ptr<envoy::HotRestartMessage>());
   MOCK_METHOD2(initialize, void(Event::Dispatcher& dispatcher, Server::Instance& server));
   MOCK_METHOD1(sendParentAdminShutdownRequest, void(time_t& original_start_time));
@@ -244,6 +249,11 @@ public:
                                         Network::Address::SocketType socket_type,
                                         const Network::Socket::OptionsSharedPtr& options,
                                         bool bind_to_port));
+  MOCK_METHOD4(createWorkerListenSocket,
+               Network::SocketSharedPtr(Network::Address::InstanceConstSharedPtr address,
+                                        Network::Address::SocketType socket_type,
+                                        const Network::Socket::OptionsSharedPtr& options,
+                                        uint32_t worker_index));
   MOCK_METHOD1(createDrainManager_, DrainManager*(envoy::api::v2::Listener::DrainType drain_type));
   MOCK_METHOD0(nextListenerTag, uint64_t());
 
@@ -282,7 +292,7 @@ public:
   ~MockWorkerFactory();
 
   // Server::WorkerFactory
-  WorkerPtr createWorker(OverloadManager&) override { return WorkerPtr{createWorker_()}; }
+  WorkerPtr createWorker(uint32_t, OverloadManager&) override { return WorkerPtr{createWorker_()}; }
 
   MOCK_METHOD0(createWorker_, Worker*());
 };
@@ -12,6 +12,7 @@ public:
 
   MOCK_METHOD0(computeHashKey, absl::optional<uint64_t>());
   MOCK_METHOD0(metadataMatchCriteria, Router::MetadataMatchCriteria*());
+  MOCK_CONST_METHOD0(metadataMatchCriteriaPerRequest, bool());
   MOCK_CONST_METHOD0(downstreamConnection, const Network::Connection*());
   MOCK_CONST_METHOD0(downstreamHeaders, const Http::HeaderMap*());
   MOCK_METHOD2(determinePriorityLoad,
@@ -211,6 +211,8 @@ public:
 
   // Upstream::LoadBalancer
   MOCK_METHOD1(chooseHost, HostConstSharedPtr(LoadBalancerContext* context));
+  MOCK_METHOD2(putResponseTime,
+               void(const HostDescription& host, std::chrono::microseconds response_time));
 
   std::shared_ptr<MockHost> host_{new MockHost()};
 };
@@ -10,6 +10,7 @@
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/server/mocks.h"
 #include "test/test_common/network_utility.h"
+#include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -20,6 +21,7 @@ using testing::HasSubstr;
 using testing::InSequence;
 using testing::Invoke;
 using testing::NiceMock;
+using testing::Ref;
 using testing::Return;
 using testing::ReturnRef;
 
@@ -50,6 +52,7 @@ public:
     Network::FilterChainFactory& filterChainFactory() override { return parent_.factory_; }
     Network::Socket& socket() override { return socket_; }
     const Network::Socket& socket() const override { return socket_; }
+    Network::Socket* workerSocket(uint32_t) override { return worker_socket_; }
     bool bindToPort() override { return bind_to_port_; }
     bool handOffRestoredDestinationConnections() const override {
       return hand_off_restored_destination_connections_;
@@ -64,6 +67,7 @@ public:
 
     ConnectionHandlerTest& parent_;
     Network::MockListenSocket socket_;
+    Network::Socket* worker_socket_{};
     uint64_t tag_;
     bool bind_to_port_;
     const bool hand_off_restored_destination_connections_;
@@ -130,6 +134,59 @@ TEST_F(ConnectionHandlerTest, RemoveListener) {
   handler_->removeListeners(0);
 }
 
+TEST_F(ConnectionHandlerTest, WorkerSocketAndStats) {
+  handler_.reset(new ConnectionHandlerImpl(ENVOY_LOGGER(), dispatcher_, 2));
+
+  Network::MockListener* listener = new NiceMock<Network::MockListener>();
+  Network::ListenerCallbacks* listener_callbacks;
+  NiceMock<Network::MockListenSocket> worker_socket;
+  TestListener* test_listener = addListener(1, true, false, "test_listener");
+  test_listener->worker_socket_ = &worker_socket;
+  EXPECT_CALL(dispatcher_, createListener_(Ref(worker_socket), _, _, false))
+      .WillOnce(Invoke(
+          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
+            listener_callbacks = &cb;
+            return listener;
+          }));
+  handler_->addListener(*test_listener);
+
+  Network::MockConnection* connection = new NiceMock<Network::MockConnection>();
+  listener_callbacks->onNewConnection(Network::ConnectionPtr{connection});
+  EXPECT_EQ(1UL, stats_store_.counter("worker_2.downstream_cx_total").value());
+  Stats::Gauge& cx_active =
+      stats_store_.gauge("worker_2.downstream_cx_active", Stats::Gauge::ImportMode::Accumulate);
+  EXPECT_EQ(1UL, cx_active.value());
+
+  EXPECT_CALL(*listener, onDestroy());
+  handler_->removeListeners(1);
+  EXPECT_EQ(0UL, cx_active.value());
+}
+
+// Workers accepting on the socket a listener shares between them do not get their own stats.
+TEST_F(ConnectionHandlerTest, SharedSocketNoPerWorkerStats) {
+  handler_.reset(new ConnectionHandlerImpl(ENVOY_LOGGER(), dispatcher_, 2));
+
+  Network::MockListener* listener = new NiceMock<Network::MockListener>();
+  Network::ListenerCallbacks* listener_callbacks;
+  TestListener* test_listener = addListener(1, true, false, "test_listener");
+  EXPECT_CALL(dispatcher_, createListener_(Ref(test_listener->socket_), _, _, false))
+      .WillOnce(Invoke(
+          [&](Network::Socket&, Network::ListenerCallbacks& cb, bool, bool) -> Network::Listener* {
+            listener_callbacks = &cb;
+            return listener;
+          }));
+  handler_->addListener(*test_listener);
+
+  Network::MockConnection* connection = new NiceMock<Network::MockConnection>();
+  listener_callbacks->onNewConnection(Network::ConnectionPtr{connection});
+  EXPECT_EQ(1UL, stats_store_.counter("downstream_cx_total").value());
+  EXPECT_EQ(nullptr, TestUtility::findCounter(stats_store_, "worker_2.downstream_cx_total"));
+  EXPECT_EQ(nullptr, TestUtility::findGauge(stats_store_, "worker_2.downstream_cx_active"));
+
+  EXPECT_CALL(*listener, onDestroy());
+  handler_->removeListeners(1);
+}
+
 TEST_F(ConnectionHandlerTest, DisableListener) {
   InSequence s;
 
@@ -7,6 +7,7 @@
 #include "gtest/gtest.h"
 
 using testing::_;
+using testing::NiceMock;
 using testing::Return;
 using testing::ReturnRef;
 
@@ -41,6 +42,37 @@ TEST_F(HotRestartingParentTest, getListenSocketsForChildNotFound) {
   EXPECT_EQ(-1, message.reply().pass_listen_socket().fd());
 }
 
+TEST_F(HotRestartingParentTest, getListenSocketsForChildWorkerSocket) {
+  MockListenerManager listener_manager;
+  Network::MockListenerConfig listener_config;
+  NiceMock<Network::MockListenSocket> worker_socket;
+  std::vector<std::reference_wrapper<Network::ListenerConfig>> listeners{listener_config};
+  EXPECT_CALL(server_, listenerManager()).WillRepeatedly(ReturnRef(listener_manager));
+  EXPECT_CALL(listener_manager, listeners()).WillRepeatedly(Return(listeners));
+  EXPECT_CALL(listener_config, socket()).WillRepeatedly(ReturnRef(listener_config.socket_));
+
+  HotRestartMessage::Request request;
+  request.mutable_pass_listen_socket()->set_address("tcp://0.0.0.0:80");
+
+  // A worker with its own socket gets that socket.
+  request.mutable_pass_listen_socket()->set_worker_index(1);
+  EXPECT_CALL(listener_config, workerSocket(1)).WillOnce(Return(&worker_socket));
+  EXPECT_CALL(worker_socket, ioHandle());
+  hot_restarting_parent_.getListenSocketsForChild(request);
+
+  // Only worker 0 falls back to the shared listener socket.
+  request.mutable_pass_listen_socket()->set_worker_index(2);
+  EXPECT_CALL(listener_config, workerSocket(2)).WillOnce(Return(nullptr));
+  EXPECT_CALL(listener_config.socket_, ioHandle()).Times(0);
+  HotRestartMessage message = hot_restarting_parent_.getListenSocketsForChild(request);
+  EXPECT_EQ(-1, message.reply().pass_listen_socket().fd());
+
+  request.mutable_pass_listen_socket()->set_worker_index(0);
+  EXPECT_CALL(listener_config, workerSocket(0)).WillOnce(Return(nullptr));
+  EXPECT_CALL(listener_config.socket_, ioHandle());
+  hot_restarting_parent_.getListenSocketsForChild(request);
+}
+
 TEST_F(HotRestartingParentTest, exportStatsToChild) {
   Stats::IsolatedStoreImpl store;
   MockListenerManager listener_manager;
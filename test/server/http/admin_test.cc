@@ -1,19 +1,21 @@
 #include <algorithm>
 #include <fstream>
-#include <regex>
 #include <unordered_map>
 
 #include "envoy/admin/v2alpha/memory.pb.h"
 #include "envoy/admin/v2alpha/server_info.pb.h"
+#include "envoy/admin/v2alpha/slow_callbacks.pb.h"
 #include "envoy/json/json_object.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/stats.h"
 
+#include "common/event/callback_tracker.h"
 #include "common/http/message_impl.h"
 #include "common/json/json_loader.h"
 #include "common/profiler/profiler.h"
 #include "common/protobuf/protobuf.h"
 #include "common/protobuf/utility.h"
+#include "common/stats/isolated_store_impl.h"
 #include "common/stats/thread_local_store.h"
 
 #include "server/http/admin.h"
@@ -26,9 +28,12 @@
 #include "test/test_common/logging.h"
 #include "test/test_common/network_utility.h"
 #include "test/test_common/printers.h"
+#include "test/test_common/test_time.h"
 #include "test/test_common/utility.h"
 
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -44,6 +49,7 @@ using testing::Ref;
 using testing::Return;
 using testing::ReturnPointee;
 using testing::ReturnRef;
+using testing::StartsWith;
 
 namespace Envoy {
 namespace Server {
@@ -58,11 +64,17 @@ public:
   static std::string
   statsAsJsonHandler(std::map<std::string, uint64_t>& all_stats,
                      const std::vector<Stats::ParentHistogramSharedPtr>& all_histograms,
-                     const bool used_only, const absl::optional<std::regex> regex = absl::nullopt) {
+                     const bool used_only, const re2::RE2* regex = nullptr) {
     return AdminImpl::statsAsJson(all_stats, all_histograms, used_only, regex,
                                   true /*pretty_print*/);
   }
 
+  AdminImpl::StatsPage selectStats(const re2::RE2* regex, absl::string_view prefix,
+                                   absl::optional<uint64_t> page_size, absl::string_view after) {
+    return AdminImpl::selectStats(store_->counters(), store_->gauges(), store_->histograms(),
+                                  false, regex, prefix, page_size, after);
+  }
+
   Stats::FakeSymbolTableImpl symbol_table_;
   NiceMock<Event::MockDispatcher> main_thread_dispatcher_;
   NiceMock<ThreadLocal::MockInstance> tls_;
@@ -358,8 +370,8 @@ TEST_P(AdminStatsTest, StatsAsJsonFilterString) {
   store_->mergeHistograms([]() -> void {});
 
   std::map<std::string, uint64_t> all_stats;
-  std::string actual_json = statsAsJsonHandler(all_stats, store_->histograms(), false,
-                                               absl::optional<std::regex>{std::regex("[a-z]1")});
+  const re2::RE2 regex("[a-z]1");
+  std::string actual_json = statsAsJsonHandler(all_stats, store_->histograms(), false, &regex);
 
   // Because this is a filter case, we don't expect to see any stats except for those containing
   // "h1" in their name.
@@ -464,8 +476,8 @@ TEST_P(AdminStatsTest, UsedOnlyStatsAsJsonFilterString) {
   store_->mergeHistograms([]() -> void {});
 
   std::map<std::string, uint64_t> all_stats;
-  std::string actual_json = statsAsJsonHandler(all_stats, store_->histograms(), true,
-                                               absl::optional<std::regex>{std::regex("h[12]")});
+  const re2::RE2 regex("h[12]");
+  std::string actual_json = statsAsJsonHandler(all_stats, store_->histograms(), true, &regex);
 
   // Expected JSON should not have h2 values as it is not used, and should not have h3 values as
   // they are used but do not match.
@@ -541,6 +553,75 @@ TEST_P(AdminStatsTest, UsedOnlyStatsAsJsonFilterString) {
   store_->shutdownThreading();
 }
 
+TEST_P(AdminStatsTest, SelectStatsPages) {
+  store_->initializeThreading(main_thread_dispatcher_, tls_);
+
+  store_->counter("a.c4");
+  store_->counter("a.c2");
+  store_->gauge("a.g3", Stats::Gauge::ImportMode::Accumulate);
+  store_->counter("b.c1");
+  store_->histogram("a.h1");
+
+  auto names = [](const auto& page) {
+    std::vector<std::string> names;
+    for (const auto& stat : page.stats_) {
+      names.push_back(stat.first);
+    }
+    for (const Stats::ParentHistogramSharedPtr& histogram : page.histograms_) {
+      names.push_back(histogram->name());
+    }
+    return names;
+  };
+
+  // Pages are taken in name order across counters, gauges and histograms.
+  EXPECT_EQ(std::vector<std::string>({"a.c2", "a.c4"}),
+            names(selectStats(nullptr, "a.", 2, "")));
+  EXPECT_EQ(std::vector<std::string>({"a.g3", "a.h1"}),
+            names(selectStats(nullptr, "a.", 2, "a.c4")));
+  EXPECT_TRUE(names(selectStats(nullptr, "a.", 2, "a.h1")).empty());
+
+  // The filter only has to match part of the name.
+  const re2::RE2 regex("c[12]");
+  EXPECT_EQ(std::vector<std::string>({"a.c2", "b.c1"}),
+            names(selectStats(&regex, "", absl::nullopt, "")));
+
+  store_->shutdownThreading();
+}
+
+// Walking the plain text pages with the last name of each page as the cursor visits every stat
+// and histogram exactly once.
+TEST_P(AdminStatsTest, PlainTextPagesInNameOrder) {
+  store_->initializeThreading(main_thread_dispatcher_, tls_);
+
+  store_->counter("paged.b");
+  store_->histogram("paged.a");
+  store_->histogram("paged.c");
+  store_->gauge("paged.d", Stats::Gauge::ImportMode::Accumulate);
+
+  NiceMock<MockInstance> server;
+  ON_CALL(server, stats()).WillByDefault(ReturnRef(*store_));
+  AdminImpl admin(TestEnvironment::temporaryPath("envoy.prof"), server);
+  std::vector<std::string> names;
+  std::string after;
+  for (int i = 0; i < 10; i++) {
+    Http::HeaderMapImpl response_headers;
+    std::string body;
+    EXPECT_EQ(Http::Code::OK,
+              admin.request(absl::StrCat("/stats?prefix=paged.&page_size=2&after=", after), "GET",
+                            response_headers, body));
+    if (body.empty()) {
+      break;
+    }
+    for (absl::string_view line : absl::StrSplit(body, '\n', absl::SkipEmpty())) {
+      names.emplace_back(line.substr(0, line.find(':')));
+    }
+    after = names.back();
+  }
+  EXPECT_EQ(std::vector<std::string>({"paged.a", "paged.b", "paged.c", "paged.d"}), names);
+
+  store_->shutdownThreading();
+}
+
 INSTANTIATE_TEST_SUITE_P(IpVersions, AdminFilterTest,
                          testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
                          TestUtility::ipTestParamsToString);
@@ -1275,6 +1356,45 @@ TEST_P(AdminInstanceTest, GetReadyRequest) {
               HasSubstr("text/plain"));
 }
 
+TEST_P(AdminInstanceTest, SlowCallbacks) {
+  {
+    Http::HeaderMapImpl response_headers;
+    std::string body;
+    EXPECT_EQ(Http::Code::OK, admin_.request("/slow_callbacks", "GET", response_headers, body));
+    EXPECT_THAT(body, HasSubstr("Slow callbacks are not tracked"));
+  }
+
+  Stats::IsolatedStoreImpl store;
+  Event::DispatcherStats stats{
+      ALL_DISPATCHER_STATS(POOL_HISTOGRAM_PREFIX(store, "listener_manager.worker_0.dispatcher."))};
+  Event::GlobalTimeSystem time_system;
+  Event::CallbackTracker tracker("listener_manager.worker_0.dispatcher", stats, time_system);
+  Event::CallbackTracker::setCurrent(&tracker);
+  std::function<void()> callback = []() {};
+  {
+    Event::CallbackTracker::Scope scope("timer", callback);
+    time_system.sleep(std::chrono::milliseconds(3));
+  }
+  Event::CallbackTracker::setCurrent(nullptr);
+
+  Http::HeaderMapImpl response_headers;
+  std::string body;
+  EXPECT_EQ(Http::Code::OK, admin_.request("/slow_callbacks", "GET", response_headers, body));
+  EXPECT_THAT(std::string(response_headers.ContentType()->value().getStringView()),
+              HasSubstr("application/json"));
+
+  envoy::admin::v2alpha::SlowCallbacks slow_callbacks;
+  MessageUtil::loadFromJson(body, slow_callbacks);
+  ASSERT_EQ(1, slow_callbacks.dispatchers_size());
+  const auto& dispatcher = slow_callbacks.dispatchers(0);
+  EXPECT_EQ("listener_manager.worker_0.dispatcher", dispatcher.name());
+  ASSERT_EQ(1, dispatcher.callbacks_size());
+  EXPECT_EQ("timer", dispatcher.callbacks(0).kind());
+  EXPECT_LE(3,
+            Protobuf::util::TimeUtil::DurationToMilliseconds(dispatcher.callbacks(0).duration()));
+  EXPECT_THAT(dispatcher.callbacks(0).source(), HasSubstr("SlowCallbacks"));
+}
+
 TEST_P(AdminInstanceTest, GetRequestJson) {
   Http::HeaderMapImpl response_headers;
   std::string body;
@@ -1284,6 +1404,61 @@ TEST_P(AdminInstanceTest, GetRequestJson) {
               HasSubstr("application/json"));
 }
 
+TEST_P(AdminInstanceTest, StatsInvalidParams) {
+  Http::HeaderMapImpl response_headers;
+  std::string body;
+  EXPECT_EQ(Http::Code::BadRequest,
+            admin_.request("/stats?filter=(", "GET", response_headers, body));
+  EXPECT_THAT(body, HasSubstr("invalid filter regex"));
+  EXPECT_EQ(Http::Code::BadRequest,
+            admin_.request("/stats?page_size=0", "GET", response_headers, body));
+  EXPECT_EQ(Http::Code::BadRequest,
+            admin_.request("/stats?page_size=abc", "GET", response_headers, body));
+  EXPECT_EQ("usage: /stats?page_size=<positive integer>\n", body);
+}
+
+TEST_P(AdminInstanceTest, StatsInvalidParamsInRequestedFormat) {
+  {
+    Http::HeaderMapImpl response_headers;
+    std::string body;
+    EXPECT_EQ(Http::Code::BadRequest,
+              admin_.request("/stats?format=json&page_size=0", "GET", response_headers, body));
+    EXPECT_EQ("{\"error\":\"usage: /stats?page_size=<positive integer>\"}", body);
+    EXPECT_THAT(std::string(response_headers.ContentType()->value().getStringView()),
+                HasSubstr("application/json"));
+  }
+  {
+    Http::HeaderMapImpl response_headers;
+    std::string body;
+    EXPECT_EQ(Http::Code::BadRequest,
+              admin_.request("/stats?format=json&filter=(", "GET", response_headers, body));
+    EXPECT_THAT(body, StartsWith("{\"error\":\"invalid filter regex: "));
+  }
+  {
+    Http::HeaderMapImpl response_headers;
+    std::string body;
+    EXPECT_EQ(Http::Code::BadRequest, admin_.request("/stats?format=prometheus&page_size=abc",
+                                                     "GET", response_headers, body));
+    EXPECT_EQ("# usage: /stats?page_size=<positive integer>\n", body);
+  }
+}
+
+TEST_P(AdminInstanceTest, StatsPrometheusRejectsPrefixAndPaging) {
+  for (const std::string url :
+       {"/stats?format=prometheus&prefix=server.", "/stats?format=prometheus&page_size=10",
+        "/stats?format=prometheus&after=server.live"}) {
+    Http::HeaderMapImpl response_headers;
+    std::string body;
+    EXPECT_EQ(Http::Code::BadRequest, admin_.request(url, "GET", response_headers, body)) << url;
+    EXPECT_EQ("# prefix, page_size and after are not supported in prometheus format\n", body);
+  }
+  Http::HeaderMapImpl response_headers;
+  std::string body;
+  EXPECT_EQ(Http::Code::BadRequest,
+            admin_.request("/stats/prometheus?prefix=server.", "GET", response_headers, body));
+  EXPECT_EQ("prefix, page_size and after are not supported in prometheus format\n", body);
+}
+
 TEST_P(AdminInstanceTest, PostRequest) {
   Http::HeaderMapImpl response_headers;
   std::string body;
@@ -3011,6 +3011,37 @@ TEST_F(ListenerManagerImplWithRealFiltersTest, FreebindListenerEnabled) {
                    ENVOY_SOCKET_IP_FREEBIND, /* expected_value */ 1);
 }
 
+// Validate that when reuse_port is set in the Listener, we see the socket option
+// propagated to setsockopt().
+TEST_F(ListenerManagerImplWithRealFiltersTest, ReusePortListenerEnabled) {
+  auto listener = createIPv4Listener("ReusePortListener");
+  listener.set_reuse_port(true);
+
+  testSocketOption(listener, envoy::api::v2::core::SocketOption::STATE_PREBIND,
+                   ENVOY_SOCKET_SO_REUSEPORT, /* expected_value */ 1);
+
+  // With a single worker the worker shares the listener socket.
+  Network::ListenerConfig& config = manager_->listeners()[0].get();
+  EXPECT_EQ(&config.socket(), config.workerSocket(0));
+  EXPECT_EQ(nullptr, config.workerSocket(1));
+
+  // reuse_port can not be toggled on a live listener since the sockets would have to be rebuilt.
+  listener.set_reuse_port(false);
+  EXPECT_THROW_WITH_MESSAGE(manager_->addOrUpdateListener(listener, "", true), EnvoyException,
+                            "error updating listener: 'ReusePortListener' can not change "
+                            "reuse_port");
+}
+
+// Without reuse_port all workers share the listener socket.
+TEST_F(ListenerManagerImplWithRealFiltersTest, ReusePortListenerDisabled) {
+  auto listener = createIPv4Listener("SharedSocketListener");
+
+  EXPECT_CALL(listener_factory_, createListenSocket(_, _, _, true));
+  EXPECT_CALL(listener_factory_, createWorkerListenSocket(_, _, _, _)).Times(0);
+  manager_->addOrUpdateListener(listener, "", true);
+  EXPECT_EQ(nullptr, manager_->listeners()[0].get().workerSocket(0));
+}
+
 // Validate that when tcp_fast_open_queue_length is set in the Listener, we see the socket option
 // propagated to setsockopt(). This is as close to an end-to-end test as we have
 // for this feature, due to the complexity of creating an integration test
@@ -75,7 +75,8 @@ TEST_F(OptionsImplTest, All) {
       "--service-cluster cluster --service-node node --service-zone zone "
       "--file-flush-interval-msec 9000 "
       "--drain-time-s 60 --log-format [%v] --parent-shutdown-time-s 90 --log-path /foo/bar "
-      "--disable-hot-restart --cpuset-threads");
+      "--disable-hot-restart --cpuset-threads --enable-io-uring "
+      "--timer-wheel-resolution-msec 10");
   EXPECT_EQ(Server::Mode::Validate, options->mode());
   EXPECT_EQ(2U, options->concurrency());
   EXPECT_EQ("hello", options->configPath());
@@ -95,6 +96,8 @@ TEST_F(OptionsImplTest, All) {
   EXPECT_EQ(true, options->hotRestartDisabled());
   EXPECT_EQ(true, options->libeventBufferEnabled());
   EXPECT_EQ(true, options->cpusetThreadsEnabled());
+  EXPECT_EQ(true, options->ioUringEnabled());
+  EXPECT_EQ(std::chrono::milliseconds(10), options->timerWheelResolution());
 
   options = createOptionsImpl("envoy --mode init_only");
   EXPECT_EQ(Server::Mode::InitOnly, options->mode());
@@ -185,6 +188,8 @@ TEST_F(OptionsImplTest, DefaultParams) {
   EXPECT_EQ(Server::Mode::Serve, options->mode());
   EXPECT_EQ(false, options->hotRestartDisabled());
   EXPECT_EQ(false, options->cpusetThreadsEnabled());
+  EXPECT_EQ(false, options->ioUringEnabled());
+  EXPECT_EQ(std::chrono::milliseconds(0), options->timerWheelResolution());
 
   // Validate that CommandLineOptions is constructed correctly with default params.
   Server::CommandLineOptionsPtr command_line_options = options->toCommandLineOptions();